@@ -405,6 +405,22 @@ ifneq ($(strip $(INTROSPECTION_KEYMAP_C)),)
 OPT_DEFS += -DINTROSPECTION_KEYMAP_C=\"$(strip $(INTROSPECTION_KEYMAP_C))\"
 endif
 
+# Generate the compressed keymap from the keymap.json if there is one, otherwise from the keymap.c
+ifeq ($(strip $(KEYMAP_COMPRESSION)), yes)
+    ifneq ("$(wildcard $(KEYMAP_JSON))", "")
+        COMPRESSED_KEYMAP_SOURCE := $(KEYMAP_JSON)
+    else
+        COMPRESSED_KEYMAP_SOURCE := $(KEYMAP_C)
+    endif
+
+$(KEYMAP_OUTPUT)/src/compressed_keymap.h: $(COMPRESSED_KEYMAP_SOURCE) $(INFO_JSON_FILES)
+	@$(SILENT) || printf "$(MSG_GENERATING) $@" | $(AWK_CMD)
+	$(eval CMD=$(QMK_BIN) generate-compressed-keymap --quiet --keyboard $(KEYBOARD) --output $(KEYMAP_OUTPUT)/src/compressed_keymap.h $(COMPRESSED_KEYMAP_SOURCE))
+	@$(BUILD_CMD)
+
+generated-files: $(KEYMAP_OUTPUT)/src/compressed_keymap.h
+endif
+
 # project specific files
 SRC += \
     $(KEYBOARD_SRC) \
@@ -37,6 +37,15 @@ else
     include $(PLATFORM_PATH)/$(PLATFORM_KEY)/printf.mk
 endif
 
+ifeq ($(strip $(CONSOLE_BINARY_ENABLE)), yes)
+    ifneq ($(strip $(PLATFORM_KEY)), chibios)
+        $(call CATASTROPHIC_ERROR,Invalid CONSOLE_BINARY_ENABLE,CONSOLE_BINARY_ENABLE is only supported on ChibiOS)
+    endif
+    CONSOLE_ENABLE = yes
+    OPT_DEFS += -DCONSOLE_BINARY_ENABLE
+    QUANTUM_SRC += $(QUANTUM_DIR)/logging/binary_log.c
+endif
+
 ifeq ($(strip $(DEBUG_MATRIX_SCAN_RATE_ENABLE)), yes)
     OPT_DEFS += -DDEBUG_MATRIX_SCAN_RATE
     CONSOLE_ENABLE = yes
@@ -138,6 +147,7 @@ ifeq ($(strip $(POINTING_DEVICE_ENABLE)), yes)
         SRC += $(QUANTUM_DIR)/pointing_device/pointing_device.c
         SRC += $(QUANTUM_DIR)/pointing_device/pointing_device_drivers.c
         SRC += $(QUANTUM_DIR)/pointing_device/pointing_device_auto_mouse.c
+        SRC += $(QUANTUM_DIR)/pointing_device/pointing_device_motion.c
         ifneq ($(strip $(POINTING_DEVICE_DRIVER)), custom)
             SRC += drivers/sensors/$(strip $(POINTING_DEVICE_DRIVER)).c
             OPT_DEFS += -DPOINTING_DEVICE_DRIVER_$(strip $(shell echo $(POINTING_DEVICE_DRIVER) | tr '[:lower:]' '[:upper:]'))
@@ -261,6 +271,14 @@ else
   endif
 endif
 
+ifeq ($(strip $(EEPROM_WRITE_CACHE_ENABLE)), yes)
+  ifeq ($(filter $(EEPROM_DRIVER),i2c spi),)
+    $(call CATASTROPHIC_ERROR,Invalid EEPROM_WRITE_CACHE_ENABLE,EEPROM_WRITE_CACHE_ENABLE requires EEPROM_DRIVER = i2c or spi)
+  endif
+  OPT_DEFS += -DEEPROM_WRITE_CACHE_ENABLE
+  SRC += eeprom_write_cache.c
+endif
+
 VALID_WEAR_LEVELING_DRIVER_TYPES := custom embedded_flash spi_flash rp2040_flash legacy
 WEAR_LEVELING_DRIVER ?= none
 ifneq ($(strip $(WEAR_LEVELING_DRIVER)),none)
@@ -293,14 +311,18 @@ ifneq ($(strip $(WEAR_LEVELING_DRIVER)),none)
   endif
 endif
 
-VALID_FLASH_DRIVER_TYPES := spi
+VALID_FLASH_DRIVER_TYPES := spi custom
 FLASH_DRIVER ?= none
 ifneq ($(strip $(FLASH_DRIVER)), none)
     ifeq ($(filter $(FLASH_DRIVER),$(VALID_FLASH_DRIVER_TYPES)),)
         $(call CATASTROPHIC_ERROR,Invalid FLASH_DRIVER,FLASH_DRIVER="$(FLASH_DRIVER)" is not a valid flash driver)
     else
         OPT_DEFS += -DFLASH_ENABLE
-        ifeq ($(strip $(FLASH_DRIVER)),spi)
+        ifeq ($(strip $(FLASH_DRIVER)),custom)
+            # Custom FLASH implementation -- needs to implement the functions in flash_spi.h
+            OPT_DEFS += -DFLASH_DRIVER -DFLASH_CUSTOM
+            COMMON_VPATH += $(DRIVER_PATH)/flash
+        else ifeq ($(strip $(FLASH_DRIVER)),spi)
             OPT_DEFS += -DFLASH_DRIVER -DFLASH_SPI
             COMMON_VPATH += $(DRIVER_PATH)/flash
             SRC += flash_spi.c
@@ -617,6 +639,14 @@ ifeq ($(strip $(VIA_ENABLE)), yes)
     OPT_DEFS += -DVIA_ENABLE
 endif
 
+ifeq ($(strip $(RAW_ENABLE)), yes)
+    SRC += $(QUANTUM_DIR)/raw_hid.c
+endif
+
+ifeq ($(strip $(KEYMAP_COMPRESSION)), yes)
+    OPT_DEFS += -DKEYMAP_COMPRESSED
+endif
+
 VALID_MAGIC_TYPES := yes
 BOOTMAGIC_ENABLE ?= no
 ifneq ($(strip $(BOOTMAGIC_ENABLE)), no)
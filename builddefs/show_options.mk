@@ -3,12 +3,14 @@ BUILD_OPTION_NAMES = \
   MOUSEKEY_ENABLE \
   EXTRAKEY_ENABLE \
   CONSOLE_ENABLE \
+  CONSOLE_BINARY_ENABLE \
   COMMAND_ENABLE \
   NKRO_ENABLE \
   CUSTOM_MATRIX \
   DEBOUNCE_TYPE \
   SPLIT_KEYBOARD \
   DYNAMIC_KEYMAP_ENABLE \
+  KEYMAP_COMPRESSION \
   USB_HID_ENABLE \
   VIA_ENABLE
 
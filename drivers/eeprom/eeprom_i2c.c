@@ -38,6 +38,11 @@
 #include "eeprom.h"
 #include "eeprom_i2c.h"
 
+#if defined(EEPROM_WRITE_CACHE_ENABLE)
+#    define EEPROM_WRITE_CACHE_BACKEND
+#    include "eeprom_write_cache.h"
+#endif
+
 // #define DEBUG_EEPROM_OUTPUT
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
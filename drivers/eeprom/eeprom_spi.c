@@ -37,6 +37,11 @@
 #include "eeprom.h"
 #include "eeprom_spi.h"
 
+#if defined(EEPROM_WRITE_CACHE_ENABLE)
+#    define EEPROM_WRITE_CACHE_BACKEND
+#    include "eeprom_write_cache.h"
+#endif
+
 #define CMD_WREN 6
 #define CMD_WRDI 4
 #define CMD_RDSR 5
@@ -4,7 +4,13 @@
 #include <string.h>
 
 #include "eeprom_driver.h"
+#include "eeprom_wear_leveling.h"
 #include "wear_leveling.h"
+#include "timer.h"
+
+#ifdef WEAR_LEVELING_BATCH_WRITES
+static uint16_t last_write;
+#endif // WEAR_LEVELING_BATCH_WRITES
 
 void eeprom_driver_init(void) {
     wear_leveling_init();
@@ -20,4 +26,26 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
 
 void eeprom_write_block(const void *buf, void *addr, size_t len) {
     wear_leveling_write((uint32_t)addr, buf, len);
+#ifdef WEAR_LEVELING_BATCH_WRITES
+    last_write = timer_read();
+#endif // WEAR_LEVELING_BATCH_WRITES
+}
+
+/** \brief Commits batched writes once writes have settled, and advances any background consolidation
+ */
+void eeprom_wear_leveling_task(void) {
+#ifdef WEAR_LEVELING_BATCH_WRITES
+    if (timer_elapsed(last_write) >= WEAR_LEVELING_COMMIT_DELAY_MS) {
+        wear_leveling_commit();
+    }
+#endif // WEAR_LEVELING_BATCH_WRITES
+    wear_leveling_task();
+}
+
+/** \brief Writes everything through to the backing store
+ *
+ * Call before anything that relies on the backing store being up to date, such as a reset or power down.
+ */
+void eeprom_wear_leveling_flush(void) {
+    wear_leveling_flush();
 }
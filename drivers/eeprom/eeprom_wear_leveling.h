@@ -0,0 +1,22 @@
+// Copyright 2022 Nick Brassel (@tzarc)
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+/*
+    Housekeeping for the wear-leveling EEPROM driver. With
+    WEAR_LEVELING_BATCH_WRITES, writes are committed to the write log once no
+    write happened for WEAR_LEVELING_COMMIT_DELAY_MS. With
+    WEAR_LEVELING_BACKGROUND_CONSOLIDATION, a full write log is consolidated
+    one step per task invocation instead of stalling the write that filled it.
+*/
+
+/*
+    How long after the last write batched writes are committed, in
+    milliseconds.
+*/
+#ifndef WEAR_LEVELING_COMMIT_DELAY_MS
+#    define WEAR_LEVELING_COMMIT_DELAY_MS 100
+#endif
+
+void eeprom_wear_leveling_task(void);
+void eeprom_wear_leveling_flush(void);
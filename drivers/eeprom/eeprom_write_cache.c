@@ -0,0 +1,168 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "eeprom_driver.h"
+#include "eeprom_write_cache.h"
+#include "timer.h"
+
+typedef struct {
+    bool      valid;
+    uintptr_t page;
+    uint32_t  last_used;
+    // dirty bytes are [dirty_start, dirty_end), empty when dirty_end is 0
+    uint16_t dirty_start;
+    uint16_t dirty_end;
+    uint8_t  data[EEPROM_WRITE_CACHE_PAGE_SIZE];
+} eeprom_cache_line_t;
+
+static eeprom_cache_line_t cache[EEPROM_WRITE_CACHE_PAGES];
+static uint32_t            use_counter;
+static uint16_t            last_write;
+static bool                dirty;
+
+static void cache_line_flush(eeprom_cache_line_t *line) {
+    if (line->dirty_end) {
+        eeprom_backend_write_block(&line->data[line->dirty_start], (void *)(line->page + line->dirty_start), line->dirty_end - line->dirty_start);
+        line->dirty_start = 0;
+        line->dirty_end   = 0;
+    }
+}
+
+static eeprom_cache_line_t *cache_line_find(uintptr_t page) {
+    for (uint8_t i = 0; i < EEPROM_WRITE_CACHE_PAGES; i++) {
+        if (cache[i].valid && cache[i].page == page) {
+            cache[i].last_used = ++use_counter;
+            return &cache[i];
+        }
+    }
+    return NULL;
+}
+
+/* Assigns the least recently used line to a page, reading the page in unless the caller overwrites it completely */
+static eeprom_cache_line_t *cache_line_load(uintptr_t page, bool fill) {
+    eeprom_cache_line_t *line = &cache[0];
+    for (uint8_t i = 1; i < EEPROM_WRITE_CACHE_PAGES; i++) {
+        if (!line->valid) {
+            break;
+        }
+        if (!cache[i].valid || cache[i].last_used < line->last_used) {
+            line = &cache[i];
+        }
+    }
+
+    if (line->valid) {
+        cache_line_flush(line);
+    }
+    if (fill) {
+        eeprom_backend_read_block(line->data, (const void *)page, EEPROM_WRITE_CACHE_PAGE_SIZE);
+    }
+    line->valid     = true;
+    line->page      = page;
+    line->last_used = ++use_counter;
+    return line;
+}
+
+void eeprom_read_block(void *buf, const void *addr, size_t len) {
+    uint8_t * dst    = (uint8_t *)buf;
+    uintptr_t target = (uintptr_t)addr;
+
+    while (len > 0) {
+        uintptr_t offset = target % EEPROM_WRITE_CACHE_PAGE_SIZE;
+        size_t    length = EEPROM_WRITE_CACHE_PAGE_SIZE - offset;
+        if (length > len) {
+            length = len;
+        }
+
+        eeprom_cache_line_t *line = cache_line_find(target - offset);
+        if (!line && length == EEPROM_WRITE_CACHE_PAGE_SIZE) {
+            // whole pages are not worth caching for reads
+            eeprom_backend_read_block(dst, (const void *)target, length);
+        } else {
+            if (!line) {
+                line = cache_line_load(target - offset, true);
+            }
+            memcpy(dst, &line->data[offset], length);
+        }
+
+        dst += length;
+        target += length;
+        len -= length;
+    }
+}
+
+void eeprom_write_block(const void *buf, void *addr, size_t len) {
+    const uint8_t *src    = (const uint8_t *)buf;
+    uintptr_t      target = (uintptr_t)addr;
+
+    while (len > 0) {
+        uintptr_t offset = target % EEPROM_WRITE_CACHE_PAGE_SIZE;
+        size_t    length = EEPROM_WRITE_CACHE_PAGE_SIZE - offset;
+        if (length > len) {
+            length = len;
+        }
+
+        eeprom_cache_line_t *line = cache_line_find(target - offset);
+        if (!line) {
+            line = cache_line_load(target - offset, length < EEPROM_WRITE_CACHE_PAGE_SIZE);
+        }
+        memcpy(&line->data[offset], src, length);
+        if (!line->dirty_end || offset < line->dirty_start) {
+            line->dirty_start = offset;
+        }
+        if (offset + length > line->dirty_end) {
+            line->dirty_end = offset + length;
+        }
+
+        src += length;
+        target += length;
+        len -= length;
+    }
+
+    dirty      = true;
+    last_write = timer_read();
+}
+
+/** \brief Writes back all dirty cache lines
+ *
+ * Call before anything that relies on the EEPROM contents outside of the EEPROM API, such as a reset.
+ */
+void eeprom_write_cache_flush(void) {
+    for (uint8_t i = 0; i < EEPROM_WRITE_CACHE_PAGES; i++) {
+        cache_line_flush(&cache[i]);
+    }
+    dirty = false;
+}
+
+/** \brief Writes back dirty cache lines once writes have settled
+ */
+void eeprom_write_cache_task(void) {
+    if (dirty && timer_elapsed(last_write) >= EEPROM_WRITE_CACHE_FLUSH_MS) {
+        eeprom_write_cache_flush();
+    }
+}
+
+void eeprom_driver_erase(void) {
+    for (uint8_t i = 0; i < EEPROM_WRITE_CACHE_PAGES; i++) {
+        cache[i].valid     = false;
+        cache[i].dirty_end = 0;
+    }
+    dirty = false;
+    eeprom_backend_erase();
+}
@@ -0,0 +1,73 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "eeprom.h"
+
+/*
+    Write-combining cache in front of external EEPROMs. Accesses are gathered
+    into page sized lines, so that a run of byte updates costs one page read
+    and one page write on the bus instead of a transaction per byte. Dirty
+    lines are written back once no write happened for
+    EEPROM_WRITE_CACHE_FLUSH_MS, when they are evicted, or on an explicit
+    eeprom_write_cache_flush().
+*/
+
+/*
+    The cache line size, matching the page size of the EEPROM so that each
+    write back is a single page write.
+*/
+#ifndef EEPROM_WRITE_CACHE_PAGE_SIZE
+#    define EEPROM_WRITE_CACHE_PAGE_SIZE EXTERNAL_EEPROM_PAGE_SIZE
+#endif
+
+/*
+    The number of cache lines.
+*/
+#ifndef EEPROM_WRITE_CACHE_PAGES
+#    define EEPROM_WRITE_CACHE_PAGES 2
+#endif
+
+/*
+    How long the cache waits after the last write before writing back dirty
+    lines, in milliseconds.
+*/
+#ifndef EEPROM_WRITE_CACHE_FLUSH_MS
+#    define EEPROM_WRITE_CACHE_FLUSH_MS 100
+#endif
+
+void eeprom_write_cache_flush(void);
+void eeprom_write_cache_task(void);
+
+/*
+    Uncached accessors, implemented by the EEPROM driver behind the cache.
+*/
+void eeprom_backend_erase(void);
+void eeprom_backend_read_block(void *buf, const void *addr, size_t len);
+void eeprom_backend_write_block(const void *buf, void *addr, size_t len);
+
+#if defined(EEPROM_WRITE_CACHE_BACKEND)
+/*
+    Included by the driver behind the cache: its implementations of the
+    EEPROM API become the uncached accessors.
+*/
+#    define eeprom_driver_erase eeprom_backend_erase
+#    define eeprom_read_block eeprom_backend_read_block
+#    define eeprom_write_block eeprom_backend_write_block
+#endif
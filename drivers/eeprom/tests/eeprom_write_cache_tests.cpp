@@ -0,0 +1,139 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "gtest/gtest.h"
+#include "i2c_mock.hpp"
+
+extern "C" {
+#include "eeprom_driver.h"
+#include "eeprom_write_cache.h"
+void advance_time(uint32_t ms);
+}
+
+class EepromWriteCache : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        auto& eeprom = MockI2cEeprom::Instance();
+        // Drop whatever a previous test left in the cache
+        eeprom_driver_erase();
+        eeprom.reset_instance();
+    }
+};
+
+static uint8_t* address(uintptr_t addr) {
+    return (uint8_t*)addr;
+}
+
+TEST_F(EepromWriteCache, ByteUpdatesCombineIntoOnePageWrite) {
+    auto& eeprom = MockI2cEeprom::Instance();
+
+    for (uint8_t i = 0; i < 20; i++) {
+        eeprom_update_byte(address(4 + i), i);
+    }
+    EXPECT_EQ(eeprom.reads, 1);
+    EXPECT_EQ(eeprom.writes, 0);
+
+    eeprom_write_cache_flush();
+    EXPECT_EQ(eeprom.reads, 1);
+    EXPECT_EQ(eeprom.writes, 1);
+    for (uint8_t i = 0; i < 20; i++) {
+        EXPECT_EQ(eeprom.memory[4 + i], i);
+    }
+    EXPECT_EQ(eeprom.memory[3], 0xFF);
+    EXPECT_EQ(eeprom.memory[24], 0xFF);
+}
+
+TEST_F(EepromWriteCache, ReadsReturnCachedWrites) {
+    auto& eeprom = MockI2cEeprom::Instance();
+
+    eeprom_write_dword((uint32_t*)address(8), 0x12345678);
+    eeprom.clear_counts();
+    EXPECT_EQ(eeprom_read_dword((const uint32_t*)address(8)), 0x12345678);
+    EXPECT_EQ(eeprom_read_byte(address(9)), 0x56);
+    EXPECT_EQ(eeprom.transactions(), 0);
+    EXPECT_EQ(eeprom.memory[8], 0xFF);
+}
+
+TEST_F(EepromWriteCache, UnchangedUpdatesDoNotWrite) {
+    auto& eeprom = MockI2cEeprom::Instance();
+
+    eeprom_update_byte(address(0), 0xFF);
+    eeprom_update_word((uint16_t*)address(2), 0xFFFF);
+    eeprom_write_cache_flush();
+    EXPECT_EQ(eeprom.writes, 0);
+}
+
+TEST_F(EepromWriteCache, FlushesWhenIdle) {
+    auto& eeprom = MockI2cEeprom::Instance();
+
+    eeprom_write_byte(address(0), 1);
+    advance_time(EEPROM_WRITE_CACHE_FLUSH_MS - 1);
+    eeprom_write_cache_task();
+    EXPECT_EQ(eeprom.writes, 0);
+
+    // another write restarts the idle time
+    eeprom_write_byte(address(1), 2);
+    advance_time(EEPROM_WRITE_CACHE_FLUSH_MS - 1);
+    eeprom_write_cache_task();
+    EXPECT_EQ(eeprom.writes, 0);
+
+    advance_time(1);
+    eeprom_write_cache_task();
+    EXPECT_EQ(eeprom.writes, 1);
+    EXPECT_EQ(eeprom.memory[0], 1);
+    EXPECT_EQ(eeprom.memory[1], 2);
+
+    advance_time(EEPROM_WRITE_CACHE_FLUSH_MS);
+    eeprom_write_cache_task();
+    EXPECT_EQ(eeprom.writes, 1);
+}
+
+TEST_F(EepromWriteCache, BlockWriteSplitsAtPages) {
+    auto&                eeprom = MockI2cEeprom::Instance();
+    std::vector<uint8_t> data(40);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = i;
+    }
+
+    eeprom_update_block(data.data(), address(EXTERNAL_EEPROM_PAGE_SIZE - 8), data.size());
+    eeprom_write_cache_flush();
+    EXPECT_EQ(eeprom.reads, 2);
+    EXPECT_EQ(eeprom.writes, 2);
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), eeprom.memory.begin() + EXTERNAL_EEPROM_PAGE_SIZE - 8));
+}
+
+TEST_F(EepromWriteCache, WholePagesAreNotReadBeforeWriting) {
+    auto&                eeprom = MockI2cEeprom::Instance();
+    std::vector<uint8_t> data(EXTERNAL_EEPROM_PAGE_SIZE, 0x55);
+
+    eeprom_write_block(data.data(), address(EXTERNAL_EEPROM_PAGE_SIZE), data.size());
+    eeprom_write_cache_flush();
+    EXPECT_EQ(eeprom.reads, 0);
+    EXPECT_EQ(eeprom.writes, 1);
+    EXPECT_EQ(eeprom.memory[EXTERNAL_EEPROM_PAGE_SIZE], 0x55);
+}
+
+TEST_F(EepromWriteCache, EvictionWritesBackLeastRecentlyUsed) {
+    auto& eeprom = MockI2cEeprom::Instance();
+
+    for (uint8_t page = 0; page < EEPROM_WRITE_CACHE_PAGES; page++) {
+        eeprom_write_byte(address(page * EXTERNAL_EEPROM_PAGE_SIZE), page);
+    }
+    // touch the first page so that the second one is the oldest
+    eeprom_read_byte(address(0));
+    EXPECT_EQ(eeprom.writes, 0);
+
+    eeprom_write_byte(address(EEPROM_WRITE_CACHE_PAGES * EXTERNAL_EEPROM_PAGE_SIZE), 0xAA);
+    EXPECT_EQ(eeprom.writes, 1);
+    EXPECT_EQ(eeprom.memory[EXTERNAL_EEPROM_PAGE_SIZE], 1);
+    EXPECT_EQ(eeprom.memory[0], 0xFF);
+}
+
+TEST_F(EepromWriteCache, EraseDiscardsCachedWrites) {
+    auto& eeprom = MockI2cEeprom::Instance();
+
+    eeprom_write_byte(address(0), 0x42);
+    eeprom_driver_erase();
+    eeprom_write_cache_flush();
+    EXPECT_EQ(eeprom.memory[0], 0x00);
+    EXPECT_EQ(eeprom_read_byte(address(0)), 0x00);
+}
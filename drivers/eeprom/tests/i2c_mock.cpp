@@ -0,0 +1,46 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "gtest/gtest.h"
+#include "i2c_mock.hpp"
+
+void MockI2cEeprom::transmit(const uint8_t* data, uint16_t length) {
+    ASSERT_GE(length, EXTERNAL_EEPROM_ADDRESS_SIZE);
+    pointer = 0;
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_ADDRESS_SIZE; i++) {
+        pointer = (pointer << 8) | data[i];
+    }
+    data += EXTERNAL_EEPROM_ADDRESS_SIZE;
+    length -= EXTERNAL_EEPROM_ADDRESS_SIZE;
+    if (length == 0) {
+        address_sets++;
+        return;
+    }
+
+    writes++;
+    EXPECT_EQ(pointer / EXTERNAL_EEPROM_PAGE_SIZE, (pointer + length - 1) / EXTERNAL_EEPROM_PAGE_SIZE) << "Page write crosses a page boundary";
+    for (uint16_t i = 0; i < length; i++) {
+        memory[(pointer + i) % EXTERNAL_EEPROM_BYTE_COUNT] = data[i];
+    }
+}
+
+void MockI2cEeprom::receive(uint8_t* data, uint16_t length) {
+    reads++;
+    for (uint16_t i = 0; i < length; i++) {
+        data[i] = memory[(pointer + i) % EXTERNAL_EEPROM_BYTE_COUNT];
+    }
+}
+
+extern "C" {
+
+void i2c_init(void) {}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    MockI2cEeprom::Instance().transmit(data, length);
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
+    MockI2cEeprom::Instance().receive(data, length);
+    return I2C_STATUS_SUCCESS;
+}
+}
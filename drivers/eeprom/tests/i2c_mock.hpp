@@ -0,0 +1,54 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include "i2c_master.h"
+#include "eeprom_i2c.h"
+};
+
+/* Emulates an I2C EEPROM and counts the bus transactions made to it. */
+class MockI2cEeprom {
+   private:
+    MockI2cEeprom() {
+        reset_instance();
+    }
+
+    // Address set by the last transmit
+    uint32_t pointer;
+
+   public:
+    std::vector<uint8_t> memory;
+    // Transmits carrying data, i.e. page writes
+    uint32_t writes;
+    // Transmits only setting the address
+    uint32_t address_sets;
+    // Receives
+    uint32_t reads;
+
+    static MockI2cEeprom& Instance() {
+        static MockI2cEeprom instance;
+        return instance;
+    }
+
+    void reset_instance() {
+        memory.assign(EXTERNAL_EEPROM_BYTE_COUNT, 0xFF);
+        pointer = 0;
+        clear_counts();
+    }
+    void clear_counts() {
+        writes       = 0;
+        address_sets = 0;
+        reads        = 0;
+    }
+    uint32_t transactions() const {
+        return writes + address_sets + reads;
+    }
+
+    // Internal helpers for the mocked API
+    void transmit(const uint8_t* data, uint16_t length);
+    void receive(uint8_t* data, uint16_t length);
+};
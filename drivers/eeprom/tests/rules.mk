@@ -0,0 +1,14 @@
+eeprom_write_cache_DEFS := \
+	-DEEPROM_DRIVER -DEEPROM_I2C -DEEPROM_WRITE_CACHE_ENABLE \
+	-DEXTERNAL_EEPROM_BYTE_COUNT=1024 -DEXTERNAL_EEPROM_PAGE_SIZE=32 -DEXTERNAL_EEPROM_WRITE_TIME=0
+eeprom_write_cache_INC := \
+	$(DRIVER_PATH)/eeprom/tests \
+	$(DRIVER_PATH)/eeprom
+
+eeprom_write_cache_SRC := \
+	platforms/test/timer.c \
+	$(DRIVER_PATH)/eeprom/tests/i2c_mock.cpp \
+	$(DRIVER_PATH)/eeprom/tests/eeprom_write_cache_tests.cpp \
+	$(DRIVER_PATH)/eeprom/eeprom_driver.c \
+	$(DRIVER_PATH)/eeprom/eeprom_i2c.c \
+	$(DRIVER_PATH)/eeprom/eeprom_write_cache.c
@@ -0,0 +1 @@
+TEST_LIST += eeprom_write_cache
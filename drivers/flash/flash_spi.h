@@ -22,8 +22,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 /*
     The slave select pin of the FLASH.
     This needs to be a normal GPIO pin_t value, such as B14.
+    Not required for custom FLASH drivers.
 */
-#ifndef EXTERNAL_FLASH_SPI_SLAVE_SELECT_PIN
+#if !defined(EXTERNAL_FLASH_SPI_SLAVE_SELECT_PIN) && !defined(FLASH_CUSTOM)
 #    error "No chip select pin defined -- missing EXTERNAL_FLASH_SPI_SLAVE_SELECT_PIN"
 #endif
 
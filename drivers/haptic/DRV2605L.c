@@ -16,8 +16,10 @@
  */
 #include "DRV2605L.h"
 #include "print.h"
+#include "util.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 
 uint8_t DRV2605L_transfer_buffer[2];
@@ -116,7 +118,17 @@ void DRV_amplitude(uint8_t amplitude) {
 }
 
 void DRV_pulse(uint8_t sequence) {
+    DRV_sequence(&sequence, 1);
+}
+
+void DRV_sequence(const uint8_t *sequence, uint8_t length) {
+    // The waveform sequencer registers are followed by GO, so the whole sequence is written
+    // and started in a single transfer, with the slots after it cleared to end it
+    uint8_t registers[DRV_SEQUENCE_LENGTH + 1] = {0};
+    memcpy(registers, sequence, MIN(length, DRV_SEQUENCE_LENGTH));
+    registers[DRV_SEQUENCE_LENGTH] = 0x01;
+
+    // Stop what is playing, so that the sequence starts from the first slot
     DRV_write(DRV_GO, 0x00);
-    DRV_write(DRV_WAVEFORM_SEQ_1, sequence);
-    DRV_write(DRV_GO, 0x01);
+    i2c_writeReg(DRV2605L_BASE_ADDRESS << 1, DRV_WAVEFORM_SEQ_1, registers, sizeof(registers), 100);
 }
@@ -173,6 +173,11 @@ uint8_t DRV_read(const uint8_t regaddress);
 void    DRV_rtp_init(void);
 void    DRV_amplitude(const uint8_t amplitude);
 void    DRV_pulse(const uint8_t sequence);
+void    DRV_sequence(const uint8_t *sequence, uint8_t length);
+
+/* Waveform sequencer slots, each an effect or a wait */
+#define DRV_SEQUENCE_LENGTH (DRV_GO - DRV_WAVEFORM_SEQ_1)
+#define DRV_WAIT_MS(ms) (0x80 | ((ms) / 10))
 
 typedef enum DRV_EFFECT {
     clear_sequence                       = 0,
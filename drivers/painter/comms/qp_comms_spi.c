@@ -3,12 +3,67 @@
 
 #ifdef QUANTUM_PAINTER_SPI_ENABLE
 
+#    include <string.h>
+
 #    include "spi_master.h"
+#    include "timer.h"
 #    include "qp_comms_spi.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Base SPI support
 
+#    if QUANTUM_PAINTER_SPI_ASYNC
+// Data is gathered in one buffer while the other is transmitted in the background
+__attribute__((__aligned__(4))) static uint8_t spi_async_buffers[2][QUANTUM_PAINTER_SPI_ASYNC_BUFFER_SIZE];
+static uint8_t                                 spi_async_fill        = 0; // the buffer being gathered
+static uint16_t                                spi_async_fill_length = 0;
+static painter_device_t                        spi_async_device      = NULL; // the display the gathered and in-flight data is for
+
+// Waits for the transfer in flight to finish, giving up after QUANTUM_PAINTER_SPI_ASYNC_TIMEOUT_MS
+static bool qp_comms_spi_wait_transfer(void) {
+    uint32_t start = timer_read32();
+    while (!spi_transfer_complete()) {
+        if (timer_elapsed32(start) >= QUANTUM_PAINTER_SPI_ASYNC_TIMEOUT_MS) {
+            qp_dprintf("qp_comms_spi_wait_transfer: timed out\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+// Starts transmitting the gathered data, once the transfer in flight is out
+static bool qp_comms_spi_kick(void) {
+    if (spi_async_fill_length == 0) {
+        return true;
+    }
+
+    // A stuck transfer can't be queued behind, the gathered data is dropped instead
+    bool ok = qp_comms_spi_wait_transfer();
+    if (ok) {
+        spi_transmit_async(spi_async_buffers[spi_async_fill], spi_async_fill_length);
+        spi_async_fill ^= 1;
+    }
+    spi_async_fill_length = 0;
+    return ok;
+}
+
+// Whether nothing is gathered or in flight
+static bool qp_comms_spi_idle(void) {
+    return spi_async_fill_length == 0 && spi_transfer_complete();
+}
+#    endif // QUANTUM_PAINTER_SPI_ASYNC
+
+// Sends anything still gathered and waits for it, before the bus is used for anything else
+static bool qp_comms_spi_wait(void) {
+#    if QUANTUM_PAINTER_SPI_ASYNC
+    bool ok = qp_comms_spi_kick() && qp_comms_spi_wait_transfer();
+    spi_async_device = NULL;
+    return ok;
+#    else  // QUANTUM_PAINTER_SPI_ASYNC
+    return true;
+#    endif // QUANTUM_PAINTER_SPI_ASYNC
+}
+
 bool qp_comms_spi_init(painter_device_t device) {
     struct painter_driver_t *     driver       = (struct painter_driver_t *)device;
     struct qp_comms_spi_config_t *comms_config = (struct qp_comms_spi_config_t *)driver->comms_config;
@@ -33,28 +88,72 @@ bool qp_comms_spi_start(painter_device_t device) {
 uint32_t qp_comms_spi_send_data(painter_device_t device, const void *data, uint32_t byte_count) {
     uint32_t       bytes_remaining = byte_count;
     const uint8_t *p               = (const uint8_t *)data;
+#    if QUANTUM_PAINTER_SPI_ASYNC
+    spi_async_device = device;
+#    endif // QUANTUM_PAINTER_SPI_ASYNC
     while (bytes_remaining > 0) {
+#    if QUANTUM_PAINTER_SPI_ASYNC
+        // Gather into the free buffer, only a full buffer has to wait for the one in flight
+        uint32_t bytes_this_loop = QP_MIN(bytes_remaining, (uint32_t)(QUANTUM_PAINTER_SPI_ASYNC_BUFFER_SIZE - spi_async_fill_length));
+        memcpy(&spi_async_buffers[spi_async_fill][spi_async_fill_length], p, bytes_this_loop);
+        spi_async_fill_length += bytes_this_loop;
+        if (spi_async_fill_length == QUANTUM_PAINTER_SPI_ASYNC_BUFFER_SIZE) {
+            qp_comms_spi_kick();
+        }
+#    else  // QUANTUM_PAINTER_SPI_ASYNC
         uint32_t bytes_this_loop = bytes_remaining < 1024 ? bytes_remaining : 1024;
         spi_transmit(p, bytes_this_loop);
+#    endif // QUANTUM_PAINTER_SPI_ASYNC
         p += bytes_this_loop;
         bytes_remaining -= bytes_this_loop;
     }
 
+#    if QUANTUM_PAINTER_SPI_ASYNC
+    // Nothing to wait for if the bus is idle, otherwise the rest goes out once the transfer in flight is done
+    if (spi_transfer_complete()) {
+        qp_comms_spi_kick();
+    }
+#    endif // QUANTUM_PAINTER_SPI_ASYNC
     return byte_count - bytes_remaining;
 }
 
 void qp_comms_spi_stop(painter_device_t device) {
     struct painter_driver_t *     driver       = (struct painter_driver_t *)device;
     struct qp_comms_spi_config_t *comms_config = (struct qp_comms_spi_config_t *)driver->comms_config;
+    qp_comms_spi_wait();
     spi_stop();
     writePinHigh(comms_config->chip_select_pin);
 }
 
+#    if QUANTUM_PAINTER_SPI_ASYNC
+bool qp_comms_spi_busy(painter_device_t device) {
+    if (device != spi_async_device) {
+        return false;
+    }
+
+    if (!spi_transfer_complete()) {
+        return true;
+    }
+
+    // Hand over the gathered data as soon as the bus is free
+    if (spi_async_fill_length > 0) {
+        qp_comms_spi_kick();
+        return true;
+    }
+
+    spi_async_device = NULL;
+    return false;
+}
+#    endif // QUANTUM_PAINTER_SPI_ASYNC
+
 const struct painter_comms_vtable_t spi_comms_vtable = {
     .comms_init  = qp_comms_spi_init,
     .comms_start = qp_comms_spi_start,
     .comms_send  = qp_comms_spi_send_data,
     .comms_stop  = qp_comms_spi_stop,
+#    if QUANTUM_PAINTER_SPI_ASYNC
+    .comms_busy = qp_comms_spi_busy,
+#    endif // QUANTUM_PAINTER_SPI_ASYNC
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -91,13 +190,21 @@ bool qp_comms_spi_dc_reset_init(painter_device_t device) {
 uint32_t qp_comms_spi_dc_reset_send_data(painter_device_t device, const void *data, uint32_t byte_count) {
     struct painter_driver_t *              driver       = (struct painter_driver_t *)device;
     struct qp_comms_spi_dc_reset_config_t *comms_config = (struct qp_comms_spi_dc_reset_config_t *)driver->comms_config;
-    writePinHigh(comms_config->dc_pin);
+#        if QUANTUM_PAINTER_SPI_ASYNC
+    // Commands send everything before them, so data still gathered or in flight for this display was sent with D/C high
+    if (spi_async_device != device || qp_comms_spi_idle())
+#        endif // QUANTUM_PAINTER_SPI_ASYNC
+    {
+        qp_comms_spi_wait();
+        writePinHigh(comms_config->dc_pin);
+    }
     return qp_comms_spi_send_data(device, data, byte_count);
 }
 
 void qp_comms_spi_dc_reset_send_command(painter_device_t device, uint8_t cmd) {
     struct painter_driver_t *              driver       = (struct painter_driver_t *)device;
     struct qp_comms_spi_dc_reset_config_t *comms_config = (struct qp_comms_spi_dc_reset_config_t *)driver->comms_config;
+    qp_comms_spi_wait();
     writePinLow(comms_config->dc_pin);
     spi_write(cmd);
 }
@@ -112,6 +219,8 @@ void qp_comms_spi_dc_reset_bulk_command_sequence(painter_device_t device, const
             qp_comms_spi_dc_reset_send_data(device, &sequence[i + 3], num_bytes);
         }
         if (delay > 0) {
+            // The delay is counted from the end of the data
+            qp_comms_spi_wait();
             wait_ms(delay);
         }
         i += (3 + num_bytes);
@@ -125,6 +234,9 @@ const struct painter_comms_with_command_vtable_t spi_comms_with_dc_vtable = {
             .comms_start = qp_comms_spi_start,
             .comms_send  = qp_comms_spi_dc_reset_send_data,
             .comms_stop  = qp_comms_spi_stop,
+#        if QUANTUM_PAINTER_SPI_ASYNC
+            .comms_busy = qp_comms_spi_busy,
+#        endif // QUANTUM_PAINTER_SPI_ASYNC
         },
     .send_command          = qp_comms_spi_dc_reset_send_command,
     .bulk_command_sequence = qp_comms_spi_dc_reset_bulk_command_sequence,
@@ -31,8 +31,8 @@ bool qp_tft_panel_flush(painter_device_t device) {
     return true;
 }
 
-// Viewport to draw to
-bool qp_tft_panel_viewport(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom) {
+// Sets the window in GRAM that pixel data is written to
+static void qp_tft_panel_set_window(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom) {
     struct painter_driver_t *                          driver = (struct painter_driver_t *)device;
     struct tft_panel_dc_reset_painter_driver_vtable_t *vtable = (struct tft_panel_dc_reset_painter_driver_vtable_t *)driver->driver_vtable;
 
@@ -75,13 +75,78 @@ bool qp_tft_panel_viewport(painter_device_t device, uint16_t left, uint16_t top,
 
     // Lock in the window
     qp_comms_command(device, vtable->opcodes.enable_writes);
+}
+
+// Viewport to draw to
+bool qp_tft_panel_viewport(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom) {
+    tft_panel_dc_reset_painter_device_t *tft = (tft_panel_dc_reset_painter_device_t *)device;
+
+    // Keep track of the write position, in case the display gets deselected before the viewport is filled
+    tft->pixdata_pending = true;
+    tft->viewport_l      = left;
+    tft->viewport_t      = top;
+    tft->viewport_r      = right;
+    tft->viewport_b      = bottom;
+    tft->pixels_written  = 0;
+    tft->row_break       = 0;
+
+    qp_tft_panel_set_window(device, left, top, right, bottom);
     return true;
 }
 
 // Stream pixel data to the current write position in GRAM
 bool qp_tft_panel_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count) {
-    struct painter_driver_t *driver = (struct painter_driver_t *)device;
-    qp_comms_send(device, pixel_data, native_pixel_count * driver->native_bits_per_pixel / 8);
+    struct painter_driver_t *            driver = (struct painter_driver_t *)device;
+    tft_panel_dc_reset_painter_device_t *tft    = (tft_panel_dc_reset_painter_device_t *)device;
+    const uint8_t *                      p      = (const uint8_t *)pixel_data;
+
+    while (native_pixel_count > 0) {
+        uint32_t count = native_pixel_count;
+        if (tft->pixdata_pending) {
+            uint32_t width = tft->viewport_r - tft->viewport_l + 1;
+            uint32_t total = width * (tft->viewport_b - tft->viewport_t + 1);
+
+            // A re-addressed partial row only covers itself, the rows after it need the full viewport width again
+            if (tft->row_break) {
+                if (tft->pixels_written == tft->row_break) {
+                    qp_tft_panel_set_window(device, tft->viewport_l, tft->viewport_t + tft->pixels_written / width, tft->viewport_r, tft->viewport_b);
+                    tft->row_break = 0;
+                } else {
+                    count = QP_MIN(count, tft->row_break - tft->pixels_written);
+                }
+            }
+
+            tft->pixels_written += count;
+            if (tft->pixels_written >= total) {
+                tft->pixdata_pending = false;
+            }
+        }
+
+        qp_comms_send(device, p, count * driver->native_bits_per_pixel / 8);
+        p += count * driver->native_bits_per_pixel / 8;
+        native_pixel_count -= count;
+    }
+    return true;
+}
+
+// Re-address the rest of the viewport, after the display was deselected in the middle of a pixel write
+bool qp_tft_panel_resume_pixdata(painter_device_t device) {
+    tft_panel_dc_reset_painter_device_t *tft = (tft_panel_dc_reset_painter_device_t *)device;
+    if (!tft->pixdata_pending) {
+        return true;
+    }
+
+    uint32_t width = tft->viewport_r - tft->viewport_l + 1;
+    uint16_t x     = tft->viewport_l + tft->pixels_written % width;
+    uint16_t y     = tft->viewport_t + tft->pixels_written / width;
+    if (x == tft->viewport_l) {
+        qp_tft_panel_set_window(device, tft->viewport_l, y, tft->viewport_r, tft->viewport_b);
+        tft->row_break = 0;
+    } else {
+        // The window can't start part way along a row, so the rest of this row is addressed on its own first
+        qp_tft_panel_set_window(device, x, y, tft->viewport_r, y);
+        tft->row_break = tft->pixels_written + (tft->viewport_r - x + 1);
+    }
     return true;
 }
 
@@ -89,21 +154,16 @@ bool qp_tft_panel_pixdata(painter_device_t device, const void *pixel_data, uint3
 // Convert supplied palette entries into their native equivalents
 
 bool qp_tft_panel_palette_convert_rgb565_swapped(painter_device_t device, int16_t palette_size, qp_pixel_t *palette) {
+    qp_internal_palette_hsv888_to_rgb888(palette_size, palette);
     for (int16_t i = 0; i < palette_size; ++i) {
-        RGB      rgb      = hsv_to_rgb_nocie((HSV){palette[i].hsv888.h, palette[i].hsv888.s, palette[i].hsv888.v});
-        uint16_t rgb565   = (((uint16_t)rgb.r) >> 3) << 11 | (((uint16_t)rgb.g) >> 2) << 5 | (((uint16_t)rgb.b) >> 3);
+        uint16_t rgb565   = (((uint16_t)palette[i].rgb888.r) >> 3) << 11 | (((uint16_t)palette[i].rgb888.g) >> 2) << 5 | (((uint16_t)palette[i].rgb888.b) >> 3);
         palette[i].rgb565 = __builtin_bswap16(rgb565);
     }
     return true;
 }
 
 bool qp_tft_panel_palette_convert_rgb888(painter_device_t device, int16_t palette_size, qp_pixel_t *palette) {
-    for (int16_t i = 0; i < palette_size; ++i) {
-        RGB rgb             = hsv_to_rgb_nocie((HSV){palette[i].hsv888.h, palette[i].hsv888.s, palette[i].hsv888.v});
-        palette[i].rgb888.r = rgb.r;
-        palette[i].rgb888.g = rgb.g;
-        palette[i].rgb888.b = rgb.b;
-    }
+    qp_internal_palette_hsv888_to_rgb888(palette_size, palette);
     return true;
 }
 
@@ -43,6 +43,15 @@ typedef struct tft_panel_dc_reset_painter_device_t {
 
         // TODO: I2C/parallel etc.
     };
+
+    // Pixel write in progress, so it can be re-addressed after the display has been deselected mid-write
+    bool     pixdata_pending;
+    uint16_t viewport_l;
+    uint16_t viewport_t;
+    uint16_t viewport_r;
+    uint16_t viewport_b;
+    uint32_t pixels_written;
+    uint32_t row_break; // pixel count at which a re-addressed partial row ends and the rest of the viewport needs addressing, 0 if none
 } tft_panel_dc_reset_painter_device_t;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -53,6 +62,7 @@ bool qp_tft_panel_clear(painter_device_t device);
 bool qp_tft_panel_flush(painter_device_t device);
 bool qp_tft_panel_viewport(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom);
 bool qp_tft_panel_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count);
+bool qp_tft_panel_resume_pixdata(painter_device_t device);
 
 bool qp_tft_panel_palette_convert_rgb565_swapped(painter_device_t device, int16_t palette_size, qp_pixel_t *palette);
 bool qp_tft_panel_palette_convert_rgb888(painter_device_t device, int16_t palette_size, qp_pixel_t *palette);
@@ -20,6 +20,11 @@
 bool     touchpad_init;
 uint16_t scale_data = CIRQUE_PINNACLE_DEFAULT_SCALE;
 
+// When the flags were last cleared after reading data. The wait for them to clear is only needed if the Pinnacle is
+// accessed again too soon, the timer counts whole milliseconds so two ticks are well past it.
+static bool     data_flags_clearing = false;
+static uint32_t data_flags_cleared_at;
+
 void cirque_pinnacle_clear_flags(void);
 void cirque_pinnacle_enable_feed(bool feedEnable);
 void RAP_ReadBytes(uint8_t address, uint8_t* data, uint8_t count);
@@ -92,9 +97,18 @@ void cirque_pinnacle_clear_flags() {
     wait_us(50);
 }
 
+// Waits for the flags cleared after reading data, if that was less than 50us ago
+static void cirque_pinnacle_wait_data_flags(void) {
+    if (data_flags_clearing && timer_elapsed32(data_flags_cleared_at) < 2) {
+        wait_us(50);
+    }
+    data_flags_clearing = false;
+}
+
 // Enables/Disables the feed
 void cirque_pinnacle_enable_feed(bool feedEnable) {
     uint8_t feedconfig1;
+    cirque_pinnacle_wait_data_flags();
     RAP_ReadBytes(HOSTREG__FEEDCONFIG1, &feedconfig1, 1);
 
     if (feedEnable) {
@@ -282,6 +296,7 @@ pinnacle_data_t cirque_pinnacle_read_data(void) {
     pinnacle_data_t result     = {0};
 
     // Check if there is valid data available
+    cirque_pinnacle_wait_data_flags();
     RAP_ReadBytes(HOSTREG__STATUS1, &data_ready, 1);
     if ((data_ready & HOSTREG__STATUS1__DATA_READY) == 0) {
         // no data available yet
@@ -292,8 +307,10 @@ pinnacle_data_t cirque_pinnacle_read_data(void) {
     // Read all data bytes
     RAP_ReadBytes(HOSTREG__PACKETBYTE_0, data, 6);
 
-    // Get ready for the next data sample
-    cirque_pinnacle_clear_flags();
+    // Get ready for the next data sample, the next read is usually a task or more away so it doesn't wait for the flags
+    RAP_Write(HOSTREG__STATUS1, HOSTREG__STATUS1_DEFVAL & ~(HOSTREG__STATUS1__COMMAND_COMPLETE | HOSTREG__STATUS1__DATA_READY));
+    data_flags_clearing   = true;
+    data_flags_cleared_at = timer_read32();
 
 #if CIRQUE_PINNACLE_POSITION_MODE
     // Decode data for absolute mode
@@ -13,12 +13,49 @@
 #include "wait.h"
 #include "spi_master.h"
 #include "progmem.h"
+#include "timer.h"
+#ifdef PROTOCOL_CHIBIOS
+#    include <ch.h>
+#endif
 
 extern const uint8_t pmw33xx_firmware_data[PMW33XX_FIRMWARE_LENGTH] PROGMEM;
 extern const uint8_t pmw33xx_firmware_signature[3] PROGMEM;
 
-static const pin_t cs_pins[]                     = PMW33XX_CS_PINS;
-static bool        in_burst[ARRAY_SIZE(cs_pins)] = {0};
+static const pin_t cs_pins[]                        = PMW33XX_CS_PINS;
+static bool        in_burst[ARRAY_SIZE(cs_pins)]    = {0};
+static bool        initialised[ARRAY_SIZE(cs_pins)] = {0};
+
+// tSRAD_MOTBR, from addressing the motion burst register until the burst can be read
+#define PMW33XX_TSRAD_MOTBR_US 35
+
+// The burst read is scheduled from the time it was addressed, using the finest clock the platform has. Only whole
+// ticks are counted as elapsed, as the first one may have just been about to end.
+#ifdef PROTOCOL_CHIBIOS
+typedef systime_t pmw33xx_time_t;
+#    define pmw33xx_time_read() chVTGetSystemTimeX()
+static uint32_t pmw33xx_time_elapsed_us(pmw33xx_time_t since) {
+    sysinterval_t elapsed = chVTTimeElapsedSinceX(since);
+    return elapsed > 0 ? (uint32_t)TIME_I2US(elapsed - 1) : 0;
+}
+#else
+typedef uint32_t pmw33xx_time_t;
+#    define pmw33xx_time_read() timer_read32()
+static uint32_t pmw33xx_time_elapsed_us(pmw33xx_time_t since) {
+    uint32_t elapsed = timer_elapsed32(since);
+    return elapsed > 0 ? (elapsed - 1) * 1000 : 0;
+}
+#endif
+
+// state of the non-blocking burst read, only one sensor can hold the bus at a time
+enum { PMW33XX_ASYNC_IDLE, PMW33XX_ASYNC_ADDRESSED, PMW33XX_ASYNC_RECEIVING };
+static uint8_t          async_state        = PMW33XX_ASYNC_IDLE;
+static uint8_t          async_sensor       = 0;
+static pmw33xx_time_t   async_addressed_at = 0;
+static pmw33xx_report_t async_report       = {0};
+static uint8_t          async_next_sensor  = 0;
+// finished burst reads, kept per sensor until they are picked up
+static pmw33xx_report_t kept_reports[ARRAY_SIZE(cs_pins)] = {0};
+static bool             kept[ARRAY_SIZE(cs_pins)]         = {0};
 
 const size_t pmw33xx_number_of_sensors = ARRAY_SIZE(cs_pins);
 
@@ -32,6 +69,9 @@ void pmw33xx_set_cpi_all_sensors(uint16_t cpi) {
 }
 
 bool pmw33xx_spi_start(uint8_t sensor) {
+    // the bus is held by a non-blocking burst read, finish it instead of failing
+    pmw33xx_read_burst_finish();
+
     if (!spi_start(cs_pins[sensor], false, 3, PMW33XX_SPI_DIVISOR)) {
         spi_stop();
         return false;
@@ -129,6 +169,7 @@ bool pmw33xx_init(uint8_t sensor) {
     if (sensor >= pmw33xx_number_of_sensors) {
         return false;
     }
+    initialised[sensor] = false;
     spi_init();
 
     // power up, need to first drive NCS high then low. the datasheet does not
@@ -173,44 +214,167 @@ bool pmw33xx_init(uint8_t sensor) {
         return false;
     }
 
+    initialised[sensor] = true;
     return true;
 }
 
-pmw33xx_report_t pmw33xx_read_burst(uint8_t sensor) {
-    pmw33xx_report_t report = {0};
-
+static bool pmw33xx_burst_begin(uint8_t sensor) {
     if (sensor >= pmw33xx_number_of_sensors) {
-        return report;
+        return false;
     }
 
     if (!in_burst[sensor]) {
         pd_dprintf("PMW33XX (%d): burst\n", sensor);
         if (!pmw33xx_write(sensor, REG_Motion_Burst, 0x00)) {
-            return report;
+            return false;
         }
         in_burst[sensor] = true;
     }
 
     if (!pmw33xx_spi_start(sensor)) {
-        return report;
+        return false;
     }
 
     spi_write(REG_Motion_Burst);
-    wait_us(35); // waits for tSRAD_MOTBR
 
-    spi_receive((uint8_t*)&report, sizeof(report));
+    return true;
+}
 
+static void pmw33xx_burst_end(uint8_t sensor, pmw33xx_report_t* report) {
     // panic recovery, sometimes burst mode works weird.
-    if (report.motion.w & 0b111) {
+    if (report->motion.w & 0b111) {
         in_burst[sensor] = false;
     }
 
     spi_stop();
 
-    pd_dprintf("PMW33XX (%d): motion: 0x%x dx: %i dy: %i\n", sensor, report.motion.w, report.delta_x, report.delta_y);
+    pd_dprintf("PMW33XX (%d): motion: 0x%x dx: %i dy: %i\n", sensor, report->motion.w, report->delta_x, report->delta_y);
 
-    report.delta_x *= -1;
-    report.delta_y *= -1;
+    report->delta_x *= -1;
+    report->delta_y *= -1;
+}
+
+pmw33xx_report_t pmw33xx_read_burst(uint8_t sensor) {
+    pmw33xx_report_t report = {0};
+
+    // motion already read in the background
+    if (pmw33xx_read_burst_wait(sensor, &report)) {
+        return report;
+    }
+
+    if (!pmw33xx_burst_begin(sensor)) {
+        return report;
+    }
+
+    wait_us(PMW33XX_TSRAD_MOTBR_US);
+    spi_receive((uint8_t*)&report, sizeof(report));
+    pmw33xx_burst_end(sensor, &report);
 
     return report;
 }
+
+static bool pmw33xx_read_burst_step(bool wait);
+
+bool pmw33xx_read_burst_start(uint8_t sensor) {
+    if (sensor >= pmw33xx_number_of_sensors || !pmw33xx_read_burst_step(false)) {
+        return false;
+    }
+
+    if (!pmw33xx_burst_begin(sensor)) {
+        return false;
+    }
+
+    // the burst is received once tSRAD_MOTBR has passed, by one of the polls that follow
+    async_sensor       = sensor;
+    async_addressed_at = pmw33xx_time_read();
+    async_state        = PMW33XX_ASYNC_ADDRESSED;
+    return true;
+}
+
+bool pmw33xx_read_burst_start_next(void) {
+    for (uint8_t i = 0; i < pmw33xx_number_of_sensors; i++) {
+        uint8_t sensor = (async_next_sensor + i) % pmw33xx_number_of_sensors;
+        if (initialised[sensor]) {
+            async_next_sensor = (sensor + 1) % pmw33xx_number_of_sensors;
+            return pmw33xx_read_burst_start(sensor);
+        }
+    }
+    return false;
+}
+
+// keeps the result of a burst read, adding it to one that hasn't been picked up yet
+static void pmw33xx_read_burst_keep(uint8_t sensor, pmw33xx_report_t* report) {
+    if (kept[sensor]) {
+        report->delta_x += kept_reports[sensor].delta_x;
+        report->delta_y += kept_reports[sensor].delta_y;
+        report->motion.b.is_motion |= kept_reports[sensor].motion.b.is_motion;
+    }
+    kept_reports[sensor] = *report;
+    kept[sensor]         = true;
+}
+
+// moves the burst read holding the bus on, optionally waiting for it, returns whether the bus is free
+static bool pmw33xx_read_burst_step(bool wait) {
+    if (async_state == PMW33XX_ASYNC_ADDRESSED) {
+        uint32_t elapsed = pmw33xx_time_elapsed_us(async_addressed_at);
+        if (elapsed < PMW33XX_TSRAD_MOTBR_US) {
+            if (!wait) {
+                return false;
+            }
+            wait_us(PMW33XX_TSRAD_MOTBR_US - elapsed);
+        }
+
+        memset(&async_report, 0, sizeof(async_report));
+        if (spi_receive_async((uint8_t*)&async_report, sizeof(async_report)) != SPI_STATUS_SUCCESS) {
+            spi_stop();
+            async_state = PMW33XX_ASYNC_IDLE;
+            return true;
+        }
+        async_state = PMW33XX_ASYNC_RECEIVING;
+    }
+
+    if (async_state == PMW33XX_ASYNC_RECEIVING) {
+        if (!wait && !spi_transfer_complete()) {
+            return false;
+        }
+        while (!spi_transfer_complete()) {
+        }
+        pmw33xx_burst_end(async_sensor, &async_report);
+        pmw33xx_read_burst_keep(async_sensor, &async_report);
+        async_state = PMW33XX_ASYNC_IDLE;
+    }
+
+    return true;
+}
+
+void pmw33xx_read_burst_finish(void) {
+    pmw33xx_read_burst_step(true);
+}
+
+bool pmw33xx_read_burst_poll(uint8_t sensor, pmw33xx_report_t* report) {
+    if (sensor >= pmw33xx_number_of_sensors) {
+        return false;
+    }
+
+    if (async_state != PMW33XX_ASYNC_IDLE && async_sensor == sensor) {
+        pmw33xx_read_burst_step(false);
+    }
+    if (!kept[sensor]) {
+        return false;
+    }
+
+    *report      = kept_reports[sensor];
+    kept[sensor] = false;
+    return true;
+}
+
+bool pmw33xx_read_burst_wait(uint8_t sensor, pmw33xx_report_t* report) {
+    if (sensor >= pmw33xx_number_of_sensors) {
+        return false;
+    }
+
+    if (async_state != PMW33XX_ASYNC_IDLE && async_sensor == sensor) {
+        pmw33xx_read_burst_step(true);
+    }
+    return pmw33xx_read_burst_poll(sensor, report);
+}
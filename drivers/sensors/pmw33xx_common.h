@@ -127,7 +127,8 @@ void pmw33xx_set_cpi_all_sensors(uint16_t cpi);
 
 /**
  * @brief Reads and clears the current delta, and motion register values on the
- * given sensor.
+ * given sensor. A burst read started in the background for this sensor is
+ * finished and handed out instead.
  *
  * @param sensor Index of the sensors chip select pin
  * @return pmw33xx_report_t Current values of the sensor, if errors occurred all
@@ -135,6 +136,64 @@ void pmw33xx_set_cpi_all_sensors(uint16_t cpi);
  */
 pmw33xx_report_t pmw33xx_read_burst(uint8_t sensor);
 
+/**
+ * @brief Starts a non-blocking burst read of the current delta, and motion
+ * register values on the given sensor. Only one burst read can be in flight at
+ * a time, as all sensors share the same SPI bus.
+ *
+ * The burst register is addressed straight away, and the values are received
+ * in the background by a later pmw33xx_read_burst_poll once tSRAD_MOTBR has
+ * passed. Chip select is held, and the SPI bus is busy, until the transfer is
+ * done. Register reads and writes on any sensor finish the transfer first.
+ * Results are kept per sensor until they are picked up, motion of several
+ * reads is added up.
+ *
+ * @param sensor Index of the sensors chip select pin
+ * @return true The transfer was started, poll for the result with
+ * pmw33xx_read_burst_poll
+ * @return false The transfer could not be started, e.g. because another one is
+ * still in flight
+ */
+bool pmw33xx_read_burst_start(uint8_t sensor);
+
+/**
+ * @brief Starts a non-blocking burst read on the next sensor that has been
+ * initialised, going through all of them in turn.
+ *
+ * @return true The transfer was started
+ * @return false No sensor has been initialised, or a transfer is still in
+ * flight
+ */
+bool pmw33xx_read_burst_start_next(void);
+
+/**
+ * @brief Finishes the burst read in flight, if any, and releases the bus. The
+ * result is kept for the sensor it was read from.
+ */
+void pmw33xx_read_burst_finish(void);
+
+/**
+ * @brief Moves the burst read of the given sensor on without waiting, and
+ * hands out its result once it is done.
+ *
+ * @param sensor Index of the sensors chip select pin
+ * @param report Receives the values of the sensor once the transfer is done
+ * @return true The transfer finished and report has been filled in
+ * @return false No transfer for this sensor has finished yet
+ */
+bool pmw33xx_read_burst_poll(uint8_t sensor, pmw33xx_report_t* report);
+
+/**
+ * @brief Waits for the burst read of the given sensor to finish, then releases
+ * the bus and hands out the result.
+ *
+ * @param sensor Index of the sensors chip select pin
+ * @param report Receives the values of the sensor
+ * @return true report has been filled in
+ * @return false No transfer was started for this sensor
+ */
+bool pmw33xx_read_burst_wait(uint8_t sensor, pmw33xx_report_t* report);
+
 /**
  * @brief Read one byte of data from the given register on the sensor
  *
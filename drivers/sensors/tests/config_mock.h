@@ -0,0 +1,7 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+/* Here, "pins" are just non-zero identifiers for the mocked SPI bus. */
+#define PMW33XX_CS_PINS \
+    { 1, 2 }
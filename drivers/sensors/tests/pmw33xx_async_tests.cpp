@@ -0,0 +1,275 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "gtest/gtest.h"
+#include "spi_mock.hpp"
+
+extern "C" {
+#define _Static_assert static_assert
+#include "pmw33xx_common.h"
+#undef _Static_assert
+void advance_time(uint32_t ms);
+}
+
+class Pmw33xxAsync : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        // Drain any burst left in flight by a previous test
+        MockSpi::Instance().reset_instance();
+        MockSpi::Instance().set_async_polls(1);
+        pmw33xx_report_t report;
+        for (uint8_t sensor = 0; sensor < 2; sensor++) {
+            pmw33xx_read_burst_wait(sensor, &report);
+        }
+        MockSpi::Instance().reset_instance();
+    }
+
+    // Lets tSRAD_MOTBR pass, the timer only counts whole milliseconds
+    static void pass_tsrad_motbr() {
+        advance_time(2);
+    }
+
+    // Lets tSRAD_MOTBR pass and the burst of the sensor be received
+    static void receive_burst(uint8_t sensor) {
+        pmw33xx_report_t report;
+        pass_tsrad_motbr();
+        EXPECT_FALSE(pmw33xx_read_burst_poll(sensor, &report));
+        MockSpi::Instance().complete_async();
+    }
+};
+
+// motion, observation, delta_x (LE), delta_y (LE)
+static const std::vector<uint8_t> burst_data = {0x80, 0x00, 0x05, 0x00, 0xFD, 0xFF};
+
+TEST_F(Pmw33xxAsync, BurstCompletesOnLaterPoll) {
+    auto&            spi    = MockSpi::Instance();
+    pmw33xx_report_t report = {0};
+
+    EXPECT_TRUE(pmw33xx_read_burst_start(0));
+    EXPECT_EQ(spi.selected_pin(), 1) << "Chip select must be held during the transfer";
+
+    // The burst is only addressed, nothing is received before tSRAD_MOTBR has passed
+    ASSERT_FALSE(spi.get_log().empty());
+    EXPECT_EQ(spi.get_log().back().op, MockSpiOp::write);
+    EXPECT_FALSE(pmw33xx_read_burst_poll(0, &report));
+    EXPECT_FALSE(spi.async_pending());
+
+    pass_tsrad_motbr();
+    EXPECT_FALSE(pmw33xx_read_burst_poll(0, &report));
+    EXPECT_TRUE(spi.async_pending());
+
+    // The last operation must be the asynchronous receive of a full report
+    EXPECT_EQ(spi.get_log().back().op, MockSpiOp::receive_async);
+    EXPECT_EQ(spi.get_log().back().data.size(), sizeof(pmw33xx_report_t));
+
+    // Still in flight: no result, and the bus is not released
+    EXPECT_FALSE(pmw33xx_read_burst_poll(0, &report));
+    EXPECT_EQ(spi.selected_pin(), 1);
+
+    spi.queue_rx(burst_data);
+    spi.complete_async();
+
+    EXPECT_TRUE(pmw33xx_read_burst_poll(0, &report));
+    EXPECT_EQ(spi.selected_pin(), 0) << "Chip select must be released once the result is picked up";
+    EXPECT_TRUE(report.motion.b.is_motion);
+    EXPECT_EQ(report.delta_x, -5);
+    EXPECT_EQ(report.delta_y, 3);
+
+    // Result is only handed out once
+    EXPECT_FALSE(pmw33xx_read_burst_poll(0, &report));
+}
+
+TEST_F(Pmw33xxAsync, EntersBurstModeOnlyOnce) {
+    auto&            spi    = MockSpi::Instance();
+    pmw33xx_report_t report = {0};
+
+    // An invalid motion register drops the sensor out of burst mode, whatever state earlier tests left it in
+    EXPECT_TRUE(pmw33xx_read_burst_start(0));
+    spi.queue_rx({0x81, 0x00, 0x00, 0x00, 0x00, 0x00});
+    receive_burst(0);
+    EXPECT_TRUE(pmw33xx_read_burst_poll(0, &report));
+
+    for (int i = 0; i < 3; i++) {
+        spi.clear_log();
+        EXPECT_TRUE(pmw33xx_read_burst_start(0));
+        spi.queue_rx(burst_data);
+        receive_burst(0);
+        EXPECT_TRUE(pmw33xx_read_burst_poll(0, &report));
+
+        int burst_writes = 0;
+        for (auto& entry : spi.get_log()) {
+            if (entry.op == MockSpiOp::transmit && entry.data[0] == (REG_Motion_Burst | 0x80)) {
+                burst_writes++;
+            }
+        }
+        EXPECT_EQ(burst_writes, i == 0 ? 1 : 0) << "Iteration " << i;
+    }
+}
+
+TEST_F(Pmw33xxAsync, SingleTransferInFlight) {
+    auto&            spi    = MockSpi::Instance();
+    pmw33xx_report_t report = {0};
+
+    EXPECT_TRUE(pmw33xx_read_burst_start(0));
+    EXPECT_FALSE(pmw33xx_read_burst_start(1)) << "Second sensor must wait for the bus";
+    EXPECT_FALSE(pmw33xx_read_burst_start(0));
+
+    spi.queue_rx(burst_data);
+    receive_burst(0);
+    EXPECT_FALSE(pmw33xx_read_burst_poll(1, &report)) << "Result belongs to sensor 0";
+    EXPECT_TRUE(pmw33xx_read_burst_poll(0, &report));
+
+    EXPECT_TRUE(pmw33xx_read_burst_start(1));
+    EXPECT_EQ(spi.selected_pin(), 2);
+}
+
+TEST_F(Pmw33xxAsync, BlockingReadWaitsForTransferInFlight) {
+    auto&            spi    = MockSpi::Instance();
+    pmw33xx_report_t report = {0};
+
+    spi.set_async_polls(3);
+    spi.queue_rx(burst_data);
+    EXPECT_TRUE(pmw33xx_read_burst_start(0));
+
+    // The blocking read of the other sensor goes ahead once the transfer is done
+    pmw33xx_read_burst(1);
+    EXPECT_FALSE(spi.async_pending());
+    EXPECT_EQ(spi.selected_pin(), 0);
+    EXPECT_EQ(spi.get_log().back().pin, 2);
+
+    // and the result of the transfer is kept
+    EXPECT_TRUE(pmw33xx_read_burst_poll(0, &report));
+    EXPECT_EQ(report.delta_x, -5);
+    EXPECT_EQ(report.delta_y, 3);
+}
+
+TEST_F(Pmw33xxAsync, SetCpiWaitsForTransferInFlight) {
+    auto&            spi    = MockSpi::Instance();
+    pmw33xx_report_t report = {0};
+
+    spi.set_async_polls(3);
+    spi.queue_rx(burst_data);
+    EXPECT_TRUE(pmw33xx_read_burst_start(0));
+
+    spi.clear_log();
+    pmw33xx_set_cpi(0, 1600);
+    EXPECT_FALSE(spi.async_pending());
+    EXPECT_EQ(spi.selected_pin(), 0) << "Chip select must be released after the write";
+
+    uint8_t cpival = 1600 / PMW33XX_CPI_STEP - 1;
+    bool    write  = false;
+    for (auto& entry : spi.get_log()) {
+        write |= entry.op == MockSpiOp::transmit && entry.data == std::vector<uint8_t>{REG_Config1 | 0x80, cpival};
+    }
+    EXPECT_TRUE(write) << "CPI must be written while a burst is in flight";
+
+    spi.queue_rx({cpival});
+    EXPECT_EQ(pmw33xx_get_cpi(0), 1600);
+
+    EXPECT_TRUE(pmw33xx_read_burst_poll(0, &report));
+    EXPECT_EQ(report.delta_x, -5);
+}
+
+TEST_F(Pmw33xxAsync, WaitReleasesTheBus) {
+    auto&            spi    = MockSpi::Instance();
+    pmw33xx_report_t report = {0};
+
+    EXPECT_FALSE(pmw33xx_read_burst_wait(0, &report)) << "No transfer to wait for";
+
+    spi.set_async_polls(2);
+    spi.queue_rx(burst_data);
+    EXPECT_TRUE(pmw33xx_read_burst_start(0));
+    EXPECT_TRUE(pmw33xx_read_burst_wait(0, &report));
+    EXPECT_EQ(spi.selected_pin(), 0);
+    EXPECT_EQ(report.delta_y, 3);
+    EXPECT_FALSE(pmw33xx_read_burst_poll(0, &report));
+}
+
+TEST_F(Pmw33xxAsync, PanicRecoveryRestartsBurstMode) {
+    auto&            spi    = MockSpi::Instance();
+    pmw33xx_report_t report = {0};
+
+    EXPECT_TRUE(pmw33xx_read_burst_start(0));
+    spi.queue_rx({0x81, 0x00, 0x00, 0x00, 0x00, 0x00});
+    receive_burst(0);
+    EXPECT_TRUE(pmw33xx_read_burst_poll(0, &report));
+
+    spi.clear_log();
+    EXPECT_TRUE(pmw33xx_read_burst_start(0));
+    ASSERT_FALSE(spi.get_log().empty());
+    EXPECT_EQ(spi.get_log().front().op, MockSpiOp::start);
+    bool burst_write = false;
+    for (auto& entry : spi.get_log()) {
+        burst_write |= entry.op == MockSpiOp::transmit && entry.data[0] == (REG_Motion_Burst | 0x80);
+    }
+    EXPECT_TRUE(burst_write) << "Burst mode must be re-entered after an invalid motion register";
+}
+
+TEST_F(Pmw33xxAsync, StartFailureLeavesBusIdle) {
+    auto&            spi    = MockSpi::Instance();
+    pmw33xx_report_t report = {0};
+
+    spi.set_start_fails(true);
+    EXPECT_FALSE(pmw33xx_read_burst_start(0));
+    EXPECT_FALSE(spi.async_pending());
+    EXPECT_FALSE(pmw33xx_read_burst_poll(0, &report));
+
+    spi.set_start_fails(false);
+    EXPECT_TRUE(pmw33xx_read_burst_start(0));
+}
+
+TEST_F(Pmw33xxAsync, ResultsAreKeptPerSensor) {
+    auto&            spi    = MockSpi::Instance();
+    pmw33xx_report_t report = {0};
+
+    spi.set_async_polls(1);
+    for (int i = 0; i < 2; i++) {
+        EXPECT_TRUE(pmw33xx_read_burst_start(0));
+        spi.queue_rx(burst_data);
+        pass_tsrad_motbr();
+        // Starting the other sensor finishes the transfer, without handing out its result
+        EXPECT_TRUE(pmw33xx_read_burst_start(1));
+        spi.queue_rx({0x80, 0x00, 0x01, 0x00, 0x00, 0x00});
+        pass_tsrad_motbr();
+        pmw33xx_read_burst_finish();
+    }
+
+    // Motion read twice before it was picked up is added up
+    EXPECT_TRUE(pmw33xx_read_burst_poll(1, &report));
+    EXPECT_EQ(report.delta_x, -2);
+    EXPECT_TRUE(pmw33xx_read_burst_poll(0, &report));
+    EXPECT_EQ(report.delta_x, -10);
+    EXPECT_EQ(report.delta_y, 6);
+    EXPECT_FALSE(pmw33xx_read_burst_poll(0, &report));
+
+    // The blocking read hands out a kept result without using the bus
+    EXPECT_TRUE(pmw33xx_read_burst_start(0));
+    spi.queue_rx(burst_data);
+    pmw33xx_read_burst_finish();
+    spi.clear_log();
+    report = pmw33xx_read_burst(0);
+    EXPECT_EQ(report.delta_x, -5);
+    EXPECT_TRUE(spi.get_log().empty());
+}
+
+TEST_F(Pmw33xxAsync, StartNextGoesThroughInitialisedSensors) {
+    extern const uint8_t pmw33xx_firmware_signature[3];
+    auto&                spi = MockSpi::Instance();
+
+    EXPECT_FALSE(pmw33xx_read_burst_start_next()) << "No sensor is initialised";
+
+    for (uint8_t sensor = 0; sensor < 2; sensor++) {
+        // discarded motion registers, then the signature
+        spi.queue_rx({0, 0, 0, 0, 0});
+        spi.queue_rx(std::vector<uint8_t>(pmw33xx_firmware_signature, pmw33xx_firmware_signature + 3));
+        ASSERT_TRUE(pmw33xx_init(sensor));
+    }
+
+    spi.set_async_polls(1);
+    std::vector<pin_t> selected;
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(pmw33xx_read_burst_start_next());
+        selected.push_back(spi.selected_pin());
+        pmw33xx_read_burst_finish();
+    }
+    EXPECT_EQ(selected, std::vector<pin_t>({1, 2, 1, 2}));
+}
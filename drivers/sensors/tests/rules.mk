@@ -0,0 +1,12 @@
+pmw33xx_async_DEFS := -DPOINTING_DEVICE_DRIVER_pmw3360
+pmw33xx_async_CONFIG := $(DRIVER_PATH)/sensors/tests/config_mock.h
+pmw33xx_async_INC := \
+	$(DRIVER_PATH)/sensors/tests \
+	$(DRIVER_PATH)/sensors
+
+pmw33xx_async_SRC := \
+	platforms/test/timer.c \
+	$(DRIVER_PATH)/sensors/tests/spi_mock.cpp \
+	$(DRIVER_PATH)/sensors/tests/pmw33xx_async_tests.cpp \
+	$(DRIVER_PATH)/sensors/pmw33xx_common.c \
+	$(DRIVER_PATH)/sensors/pmw3360.c
@@ -0,0 +1,71 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "gtest/gtest.h"
+#include "spi_mock.hpp"
+
+extern "C" {
+
+void spi_init(void) {}
+
+bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    return MockSpi::Instance().start(slavePin);
+}
+
+spi_status_t spi_write(uint8_t data) {
+    auto& inst = MockSpi::Instance();
+    EXPECT_FALSE(inst.async_pending()) << "Bus access while an asynchronous transfer is in flight";
+    inst.record(MockSpiOp::write, &data, 1);
+    return SPI_STATUS_SUCCESS;
+}
+
+spi_status_t spi_read(void) {
+    auto&   inst = MockSpi::Instance();
+    uint8_t data = inst.next_rx();
+    EXPECT_FALSE(inst.async_pending()) << "Bus access while an asynchronous transfer is in flight";
+    inst.record(MockSpiOp::read, &data, 1);
+    return data;
+}
+
+spi_status_t spi_transmit(const uint8_t *data, uint16_t length) {
+    auto& inst = MockSpi::Instance();
+    EXPECT_FALSE(inst.async_pending()) << "Bus access while an asynchronous transfer is in flight";
+    inst.record(MockSpiOp::transmit, data, length);
+    return SPI_STATUS_SUCCESS;
+}
+
+spi_status_t spi_receive(uint8_t *data, uint16_t length) {
+    auto& inst = MockSpi::Instance();
+    EXPECT_FALSE(inst.async_pending()) << "Bus access while an asynchronous transfer is in flight";
+    for (uint16_t i = 0; i < length; i++) {
+        data[i] = inst.next_rx();
+    }
+    inst.record(MockSpiOp::receive, data, length);
+    return SPI_STATUS_SUCCESS;
+}
+
+spi_status_t spi_transmit_async(const uint8_t *data, uint16_t length) {
+    auto& inst = MockSpi::Instance();
+    EXPECT_FALSE(inst.async_pending()) << "Asynchronous transfer started while another is in flight";
+    inst.begin_async_tx(data, length);
+    return SPI_STATUS_SUCCESS;
+}
+
+spi_status_t spi_receive_async(uint8_t *data, uint16_t length) {
+    auto& inst = MockSpi::Instance();
+    EXPECT_FALSE(inst.async_pending()) << "Asynchronous transfer started while another is in flight";
+    inst.begin_async(data, length);
+    return SPI_STATUS_SUCCESS;
+}
+
+bool spi_transfer_complete(void) {
+    auto& inst = MockSpi::Instance();
+    inst.poll_async();
+    return !inst.async_pending();
+}
+
+void spi_stop(void) {
+    auto& inst = MockSpi::Instance();
+    EXPECT_FALSE(inst.async_pending()) << "Device deselected while an asynchronous transfer is in flight";
+    inst.stop();
+}
+}
@@ -0,0 +1,141 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "spi_master.h"
+};
+
+enum class MockSpiOp { start, write, read, transmit, receive, transmit_async, receive_async, stop };
+
+struct MockSpiLogEntry {
+    MockSpiOp            op;
+    pin_t                pin;
+    std::vector<uint8_t> data;
+};
+
+class MockSpi {
+   private:
+    MockSpi() {
+        reset_instance();
+    }
+
+    // Currently selected device, 0 if none
+    pin_t selected;
+    // Buffer and contents of the asynchronous transfer in flight
+    uint8_t*             async_buffer;
+    const uint8_t*       async_tx_buffer;
+    std::vector<uint8_t> async_data;
+    // Number of spi_transfer_complete() polls before an asynchronous transfer finishes by itself, 0 to only finish in complete_async()
+    uint32_t async_polls;
+    uint32_t async_polls_remaining;
+    // Bytes handed out to subsequent reads
+    std::deque<uint8_t> rx_queue;
+    // Whether spi_start should fail
+    bool start_fails;
+    // Log of all operations
+    std::vector<MockSpiLogEntry> log;
+
+   public:
+    static MockSpi& Instance() {
+        static MockSpi instance;
+        return instance;
+    }
+
+    void reset_instance() {
+        selected     = 0;
+        async_buffer          = nullptr;
+        async_tx_buffer       = nullptr;
+        async_polls           = 0;
+        async_polls_remaining = 0;
+        start_fails           = false;
+        async_data.clear();
+        rx_queue.clear();
+        log.clear();
+    }
+
+    void queue_rx(const std::vector<uint8_t>& bytes) {
+        rx_queue.insert(rx_queue.end(), bytes.begin(), bytes.end());
+    }
+    void set_start_fails(bool fails) {
+        start_fails = fails;
+    }
+    pin_t selected_pin() const {
+        return selected;
+    }
+    void set_async_polls(uint32_t polls) {
+        async_polls = polls;
+    }
+    bool async_pending() const {
+        return async_buffer != nullptr || async_tx_buffer != nullptr;
+    }
+    // Finishes the asynchronous transfer in flight, filling the buffer from the rx queue
+    void complete_async() {
+        if (async_tx_buffer) {
+            EXPECT_TRUE(std::equal(async_data.begin(), async_data.end(), async_tx_buffer)) << "Transmit buffer modified while the transfer was in flight";
+            async_tx_buffer = nullptr;
+            return;
+        }
+        for (auto& b : async_data) {
+            b = next_rx();
+        }
+        std::copy(async_data.begin(), async_data.end(), async_buffer);
+        async_buffer = nullptr;
+    }
+    const std::vector<MockSpiLogEntry>& get_log() const {
+        return log;
+    }
+    void clear_log() {
+        log.clear();
+    }
+
+    // Internal helpers for the mocked API
+    uint8_t next_rx() {
+        if (rx_queue.empty()) {
+            return 0;
+        }
+        uint8_t b = rx_queue.front();
+        rx_queue.pop_front();
+        return b;
+    }
+    bool start(pin_t pin) {
+        log.push_back({MockSpiOp::start, pin, {}});
+        if (start_fails || selected != 0) {
+            return false;
+        }
+        selected = pin;
+        return true;
+    }
+    void stop() {
+        log.push_back({MockSpiOp::stop, selected, {}});
+        selected = 0;
+    }
+    void record(MockSpiOp op, const uint8_t* data, uint16_t length) {
+        log.push_back({op, selected, std::vector<uint8_t>(data, data + length)});
+    }
+    void begin_async(uint8_t* data, uint16_t length) {
+        log.push_back({MockSpiOp::receive_async, selected, std::vector<uint8_t>(length, 0)});
+        async_buffer = data;
+        async_data.assign(length, 0);
+        async_polls_remaining = async_polls;
+    }
+    void begin_async_tx(const uint8_t* data, uint16_t length) {
+        log.push_back({MockSpiOp::transmit_async, selected, std::vector<uint8_t>(data, data + length)});
+        async_tx_buffer = data;
+        async_data.assign(data, data + length);
+        async_polls_remaining = async_polls;
+    }
+    // Counts down the polls of a self-completing transfer
+    void poll_async() {
+        if (async_pending() && async_polls_remaining > 0 && --async_polls_remaining == 0) {
+            complete_async();
+        }
+    }
+};
@@ -0,0 +1 @@
+TEST_LIST += pmw33xx_async
@@ -37,6 +37,7 @@ subcommands = [
     'qmk.cli.cformat',
     'qmk.cli.chibios.confmigrate',
     'qmk.cli.clean',
+    'qmk.cli.console_decode',
     'qmk.cli.compile',
     'qmk.cli.docs',
     'qmk.cli.doctor',
@@ -49,6 +50,7 @@ subcommands = [
     'qmk.cli.generate.api',
     'qmk.cli.generate.autocorrect_data',
     'qmk.cli.generate.compilation_database',
+    'qmk.cli.generate.compressed_keymap',
     'qmk.cli.generate.config_h',
     'qmk.cli.generate.develop_pr_list',
     'qmk.cli.generate.dfu_header',
@@ -78,7 +80,9 @@ subcommands = [
     'qmk.cli.painter',
     'qmk.cli.pyformat',
     'qmk.cli.pytest',
+    'qmk.cli.unicode_helper',
     'qmk.cli.via2json',
+    'qmk.cli.via_keymap',
 ]
 
 
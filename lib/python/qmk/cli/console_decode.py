@@ -0,0 +1,79 @@
+"""Decode the binary console log of a keyboard.
+"""
+import sys
+
+from milc import cli
+
+from qmk.path import normpath
+from qmk.console_log import ConsoleDecoder, ElfStrings
+
+CONSOLE_USAGE_PAGE = 0xFF31
+CONSOLE_USAGE = 0x0074
+
+
+def _file_packets(stream, size):
+    while True:
+        packet = stream.read(size)
+        if len(packet) < size:
+            return
+        yield packet
+
+
+def _hid_packets(size):
+    import hid
+
+    devices = [d for d in hid.enumerate() if d['usage_page'] == CONSOLE_USAGE_PAGE and d['usage'] == CONSOLE_USAGE]
+    if not devices:
+        cli.log.error('No console device found.')
+        return
+
+    device = hid.Device(path=devices[0]['path'])
+    cli.log.info('Listening to %s %s', devices[0]['manufacturer_string'], devices[0]['product_string'])
+    try:
+        while True:
+            packet = device.read(size, 1000)
+            if packet:
+                yield packet
+    finally:
+        device.close()
+
+
+@cli.argument('-s', '--packet-size', arg_only=True, type=int, default=32, help='The console endpoint size of the keyboard, CONSOLE_EPSIZE. Defaults to 32.')
+@cli.argument('-i', '--input', help='Read raw console packets from a file, or - for stdin. Defaults to the first connected console device.')
+@cli.argument('elf', arg_only=True, type=normpath, help='The firmware ELF the keyboard is running.')
+@cli.subcommand('Decodes the binary console log of a keyboard built with CONSOLE_BINARY_ENABLE.')
+def console_decode(cli):
+    """Prints the messages logged by a keyboard built with `CONSOLE_BINARY_ENABLE = yes`.
+
+    The format strings are read from the firmware ELF, so it has to match the firmware running on the keyboard.
+    """
+    if not cli.args.elf.exists():
+        cli.log.error('ELF file %s does not exist!', cli.args.elf)
+        return False
+
+    try:
+        strings = ElfStrings(cli.args.elf.read_bytes())
+    except ValueError as e:
+        cli.log.error('Could not read %s: %s', cli.args.elf, e)
+        return False
+
+    size = cli.args.packet_size
+    if size < 2:
+        cli.log.error('Packet size must be at least 2, was %d.', size)
+        return False
+
+    decoder = ConsoleDecoder(strings)
+
+    if cli.args.input == '-':
+        packets = _file_packets(sys.stdin.buffer, size)
+    elif cli.args.input:
+        packets = _file_packets(open(normpath(cli.args.input), 'rb'), size)
+    else:
+        packets = _hid_packets(size)
+
+    try:
+        for packet in packets:
+            for line in decoder.packet(packet):
+                print(line, end='' if line.endswith('\n') else '\n', flush=True)
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,138 @@
+"""Used by the make system to generate compressed_keymap.h from a keymap.
+"""
+from argcomplete.completers import FilesCompleter
+from milc import cli
+
+from qmk.commands import dump_lines, parse_configurator_json
+from qmk.constants import GPL2_HEADER_C_LIKE, GENERATED_HEADER_C_LIKE
+from qmk.info import info_json
+from qmk.keyboard import keyboard_completer, keyboard_folder
+from qmk.keymap import parse_keymap_c
+from qmk.path import normpath
+
+# Only keycodes spelt like this are left out of a layer, anything else is stored as-is and evaluated by the C compiler
+TRANSPARENT_KEYCODES = ('KC_TRNS', 'KC_TRANSPARENT', '_______')
+NO_KEYCODES = ('KC_NO', 'XXXXXXX')
+
+
+def _strip_any(keycode):
+    """Remove ANY() from a keycode.
+    """
+    if keycode.startswith('ANY(') and keycode.endswith(')'):
+        keycode = keycode[4:-1]
+
+    return keycode
+
+
+def _load_layers(keymap_file):
+    """Returns `(layout, [(layer index, keycodes)])` for a keymap.json or keymap.c.
+
+    Layers in a keymap.c are indexed by their designator if it is a name, as it is resolved by the C compiler. The parser
+    reports numbered or undesignated layers as '0', those are indexed by their position instead.
+    """
+    if keymap_file.suffix == '.json':
+        keymap_json = parse_configurator_json(keymap_file)
+        return keymap_json['layout'], [(str(index), layer) for index, layer in enumerate(keymap_json['layers'])]
+
+    layers = parse_keymap_c(keymap_file, use_cpp=False)['layers']
+    if not layers:
+        cli.log.error(f'Could not find the keymaps array in {keymap_file}')
+        exit(1)
+
+    return layers[0]['layout'], [(layer['name'] if layer['name'] != '0' else str(index), layer['keycodes']) for index, layer in enumerate(layers)]
+
+
+def _bitmap_words(bits):
+    """Packs a list of bools into 32 bit words, as C literals.
+    """
+    words = []
+    for start in range(0, len(bits), 32):
+        word = sum(1 << bit for bit, set_ in enumerate(bits[start:start + 32]) if set_)
+        words.append(f'0x{word:08X}')
+
+    return words
+
+
+def compress_layer(keycodes):
+    """Compresses a layer, given as a list with a keycode or None for every matrix position.
+
+    Returns `(filler, bitmap, rank, stored)`, where `stored` is the list of keycodes differing from `filler`, in matrix order.
+    """
+    present = [keycode for keycode in keycodes if keycode is not None]
+    transparent = sum(keycode in TRANSPARENT_KEYCODES for keycode in present)
+    no = sum(keycode in NO_KEYCODES for keycode in present)
+    filler, filler_names = ('KC_TRNS', TRANSPARENT_KEYCODES) if transparent >= no else ('KC_NO', NO_KEYCODES)
+
+    bitmap = [keycode is not None and keycode not in filler_names for keycode in keycodes]
+    stored = [keycode for keycode, set_ in zip(keycodes, bitmap) if set_]
+    rank = [sum(bitmap[:start]) for start in range(0, len(bitmap), 32)]
+
+    return filler, bitmap, rank, stored
+
+
+def compressed_keymap_lines(info_data, layout_name, layers):
+    """Returns the lines of compressed_keymap.h.
+    """
+    rows = info_data['matrix_size']['rows']
+    cols = info_data['matrix_size']['cols']
+    layout_name = info_data.get('layout_aliases', {}).get(layout_name, layout_name)
+
+    if layout_name not in info_data['layouts']:
+        cli.log.error(f'Unknown layout {layout_name}')
+        exit(1)
+
+    layout = info_data['layouts'][layout_name]['layout']
+
+    lines = [GPL2_HEADER_C_LIKE, GENERATED_HEADER_C_LIKE, '#pragma once', '']
+    lines.append(f'_Static_assert(MATRIX_ROWS == {rows} && MATRIX_COLS == {cols}, "compressed_keymap.h was generated for a different matrix");')
+    lines.append('')
+
+    present = [False] * (rows * cols)
+    for key in layout:
+        row, col = key['matrix']
+        present[row * cols + col] = True
+
+    lines.append(f'static const uint32_t PROGMEM compressed_keymap_present[COMPRESSED_KEYMAP_WORDS] = {{{", ".join(_bitmap_words(present))}}};')
+    lines.append('')
+
+    compressed = []
+    for layer_num, (index, keycodes) in enumerate(layers):
+        if len(keycodes) != len(layout):
+            cli.log.error(f'Layer {index} has {len(keycodes)} keycodes, but {layout_name} has {len(layout)} keys')
+            exit(1)
+
+        matrix = [None] * (rows * cols)
+        for key, keycode in zip(layout, keycodes):
+            row, col = key['matrix']
+            matrix[row * cols + col] = _strip_any(keycode)
+
+        filler, bitmap, rank, stored = compress_layer(matrix)
+        keycodes_name = 'NULL'
+        if stored:
+            keycodes_name = f'compressed_keymap_keycodes_{layer_num}'
+            lines.append(f'static const uint16_t PROGMEM {keycodes_name}[] = {{{", ".join(stored)}}};')
+
+        compressed.append(f'    [{index}] = {{.bitmap = {{{", ".join(_bitmap_words(bitmap))}}}, .rank = {{{", ".join(map(str, rank))}}}, .filler = {filler}, .keycodes = {keycodes_name}}},')
+
+    lines.append('')
+    lines.append('static const compressed_keymap_layer_t PROGMEM compressed_keymap[] = {')
+    lines.extend(compressed)
+    lines.append('};')
+
+    return lines
+
+
+@cli.argument('-o', '--output', arg_only=True, type=normpath, help='File to write to')
+@cli.argument('-q', '--quiet', arg_only=True, action='store_true', help="Quiet mode, only output error messages")
+@cli.argument('-kb', '--keyboard', arg_only=True, type=keyboard_folder, completer=keyboard_completer, required=True, help='Keyboard to generate compressed_keymap.h for.')
+@cli.argument('filename', arg_only=True, type=normpath, completer=FilesCompleter(('.json', '.c')), help='The keymap.json or keymap.c to compress')
+@cli.subcommand('Used by the make system to generate compressed_keymap.h from a keymap', hidden=True)
+def generate_compressed_keymap(cli):
+    """Generates the compressed_keymap.h file.
+    """
+    layout_name, layers = _load_layers(cli.args.filename)
+
+    lines = compressed_keymap_lines(info_json(cli.args.keyboard), layout_name, layers)
+
+    # Show the results
+    dump_lines(cli.args.output, lines, cli.args.quiet)
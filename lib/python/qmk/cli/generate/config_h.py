@@ -1,5 +1,6 @@
 """Used by the make system to generate info_config.h from info.json.
 """
+import re
 from pathlib import Path
 from dotty_dict import dotty
 
@@ -42,6 +43,59 @@ def pin_array(define, pins, postfix):
     return generate_define(f'{define}_PINS{postfix}', f'{{ {pin_array} }}')
 
 
+def pin_port_bit(pin):
+    """Return the GPIO port and bit of a pin name, or None if it does not follow a known naming scheme.
+    """
+    match = re.fullmatch(r'([A-Z])([0-9]{1,2})', pin)
+    if match:
+        return match[1], int(match[2])
+
+    match = re.fullmatch(r'GP([0-9]{1,2})', pin)
+    if match:
+        return 'GP', int(match[1])
+
+    return None
+
+
+def pin_array_ports(define, pins, postfix):
+    """Return the config.h lines that describe reading a pin array a GPIO port at a time.
+
+    Each port is read once, and pins whose bit in the port is the same distance from their index in the array are
+    moved into place with a single mask and shift. Terms are sorted by port, so that each port is read once.
+    """
+    if len(pins) > 32:
+        return None
+
+    ports = []
+    terms = {}
+    for index, pin in enumerate(pins):
+        if not pin:
+            continue
+
+        port_bit = pin_port_bit(pin)
+        if not port_bit or port_bit[1] > 31:
+            return None
+
+        port, bit = port_bit
+        if port not in [p for p, _ in ports]:
+            ports.append((port, pin))
+        key = ([p for p, _ in ports].index(port), index - bit)
+        terms[key] = terms.get(key, 0) | (1 << bit)
+
+    if not ports:
+        return None
+
+    port_pins = ', '.join(pin for _, pin in ports)
+    port_terms = ', '.join(f'{{{port}, 0x{mask:X}, {shift}}}' for (port, shift), mask in sorted(terms.items()))
+    all_pins = ', '.join(map(str, [pin or 'NO_PIN' for pin in pins]))
+
+    return '\n'.join([
+        generate_define(f'{define}_PORTS{postfix}', f'{{ {port_pins} }}'),
+        generate_define(f'{define}_PORT_TERMS{postfix}', f'{{ {port_terms} }}'),
+        generate_define(f'{define}_PORT_PINS{postfix}', f'{{ {all_pins} }}'),
+    ])
+
+
 def matrix_pins(matrix_pins, postfix=''):
     """Add the matrix config to the config.h.
     """
@@ -50,11 +104,13 @@ def matrix_pins(matrix_pins, postfix=''):
     if 'direct' in matrix_pins:
         pins.append(direct_pins(matrix_pins['direct'], postfix))
 
-    if 'cols' in matrix_pins:
-        pins.append(pin_array('MATRIX_COL', matrix_pins['cols'], postfix))
+    for key, define in (('cols', 'MATRIX_COL'), ('rows', 'MATRIX_ROW')):
+        if key in matrix_pins:
+            pins.append(pin_array(define, matrix_pins[key], postfix))
 
-    if 'rows' in matrix_pins:
-        pins.append(pin_array('MATRIX_ROW', matrix_pins['rows'], postfix))
+            ports = pin_array_ports(define, matrix_pins[key], postfix)
+            if ports:
+                pins.append(ports)
 
     return '\n'.join(pins)
 
@@ -0,0 +1,30 @@
+"""This script packs Quantum Painter images and fonts into a single file for writing to external flash.
+"""
+
+from qmk.path import normpath
+from qmk.painter_qap import build_asset_pack
+from milc import cli
+
+
+@cli.argument('-o', '--output', required=True, help='Specify output asset pack path.')
+@cli.argument('-a', '--align', default=4, type=int, help='Align each asset to the specified number of bytes. Default 4.')
+@cli.argument('inputs', nargs='+', arg_only=True, help='QGF/QFF files to pack. Assets are named after the input files, without the extension.')
+@cli.subcommand('Packs QGF images and QFF fonts into an asset pack for external flash')
+def painter_make_asset_pack(cli):
+    assets = {}
+    for input_file in cli.args.inputs:
+        input_file = normpath(input_file)
+        if input_file.stem in assets:
+            cli.log.error(f'Duplicate asset name "{input_file.stem}"')
+            return False
+        assets[input_file.stem] = input_file.read_bytes()
+
+    try:
+        pack = build_asset_pack(assets, cli.args.align)
+    except ValueError as e:
+        cli.log.error(str(e))
+        return False
+
+    output = normpath(cli.args.output)
+    output.write_bytes(pack)
+    cli.log.info(f'Wrote {len(assets)} assets to {output} ({len(pack)} bytes)')
@@ -0,0 +1,63 @@
+"""Type the Unicode text sent by a keyboard built with UNICODE_HOST_HELPER.
+"""
+import time
+
+from milc import cli
+
+from qmk.unicode_helper import HELLO, HELPER_ID, TextAssembler, hello_report, type_text
+
+RAW_USAGE_PAGE = 0xFF60
+RAW_USAGE_ID = 0x61
+
+# The keyboard forgets about the helper after 2s without a hello
+HELLO_INTERVAL = 0.5
+
+
+@cli.argument('-s', '--report-size', arg_only=True, type=int, default=32, help='The raw HID report size of the keyboard, 64 on ATSAM.')
+@cli.argument('-p', '--print', arg_only=True, action='store_true', help='Print the text received rather than typing it.')
+@cli.subcommand('Types the Unicode text sent by a keyboard over raw HID.')
+def unicode_helper(cli):
+    """Keeps telling the keyboard the helper is running, and types the text it sends.
+    """
+    import hid
+
+    devices = [d for d in hid.enumerate() if d['usage_page'] == RAW_USAGE_PAGE and d['usage'] == RAW_USAGE_ID]
+    if not devices:
+        cli.log.error('No raw HID device found.')
+        return False
+
+    size = cli.args.report_size
+    device = hid.Device(path=devices[0]['path'])
+    assembler = TextAssembler()
+    answered = False
+    last_hello = 0
+    cli.log.info('Connected to %s %s', devices[0]['manufacturer_string'], devices[0]['product_string'])
+
+    try:
+        while True:
+            if time.monotonic() - last_hello >= HELLO_INTERVAL:
+                # hidapi expects the report ID first
+                device.write(b'\0' + hello_report(size))
+                last_hello = time.monotonic()
+
+            report = device.read(size, 100)
+            if not report:
+                continue
+
+            if not answered and report[0] == HELPER_ID and report[1] == HELLO:
+                cli.log.info('The keyboard answered, waiting for text.')
+                answered = True
+
+            text = assembler.feed(bytes(report))
+            if text is None:
+                continue
+            if cli.args.print:
+                print(text)
+            else:
+                type_text(text)
+
+    except KeyboardInterrupt:
+        pass
+
+    finally:
+        device.close()
@@ -0,0 +1,80 @@
+"""Read or write the dynamic keymap of a VIA enabled keyboard.
+"""
+import time
+
+from milc import cli
+
+from qmk.info import info_json
+from qmk.keyboard import keyboard_completer, keyboard_folder
+from qmk.path import normpath
+from qmk.via_keymap import ViaError, ViaKeymapClient
+
+RAW_USAGE_PAGE = 0xFF60
+RAW_USAGE_ID = 0x61
+
+
+class _HidDevice:
+    """Adds the report ID hidapi expects to the reports written.
+    """
+    def __init__(self, device):
+        self.device = device
+
+    def write(self, report):
+        self.device.write(b'\0' + report)
+
+    def read(self, size, timeout):
+        return self.device.read(size, timeout)
+
+
+@cli.argument('-kb', '--keyboard', type=keyboard_folder, completer=keyboard_completer, required=True, help='The keyboard connected, for the size of its matrix.')
+@cli.argument('-o', '--output', arg_only=True, type=normpath, help='Save the keymap read from the keyboard to a file.')
+@cli.argument('-i', '--input', arg_only=True, type=normpath, help='Write the keymap from a file to the keyboard, only the layers which differ are sent.')
+@cli.argument('--verify', arg_only=True, action='store_true', help='Compare the streamed keymap to one read a chunk at a time, as the VIA configurator does.')
+@cli.subcommand('Transfers the dynamic keymap of a VIA enabled keyboard.')
+def via_keymap(cli):
+    """Reads the keymap of a VIA enabled keyboard with the streaming commands, reporting how many round trips it took.
+    """
+    import hid
+
+    devices = [d for d in hid.enumerate() if d['usage_page'] == RAW_USAGE_PAGE and d['usage'] == RAW_USAGE_ID]
+    if not devices:
+        cli.log.error('No raw HID device found.')
+        return False
+
+    matrix = info_json(cli.config.via_keymap.keyboard)['matrix_size']
+    device = hid.Device(path=devices[0]['path'])
+    cli.log.info('Connected to %s %s', devices[0]['manufacturer_string'], devices[0]['product_string'])
+
+    try:
+        client = ViaKeymapClient(_HidDevice(device), matrix['rows'], matrix['cols'])
+
+        if cli.args.input:
+            keymap = cli.args.input.read_bytes()
+            start = time.monotonic()
+            client.write_keymap(keymap)
+            cli.log.info('Wrote %d bytes in %d requests, %.3fs', len(keymap), client.requests, time.monotonic() - start)
+
+        client.requests = 0
+        start = time.monotonic()
+        keymap = client.read_keymap()
+        cli.log.info('Read %d bytes in %d requests, %.3fs', len(keymap), client.requests, time.monotonic() - start)
+
+        if cli.args.verify:
+            client.requests = 0
+            start = time.monotonic()
+            legacy = client.read_buffer_legacy(0, len(keymap))
+            cli.log.info('Read %d bytes a chunk at a time in %d requests, %.3fs', len(legacy), client.requests, time.monotonic() - start)
+            if legacy != keymap:
+                cli.log.error('The keymaps differ!')
+                return False
+
+        if cli.args.output:
+            cli.args.output.write_bytes(keymap)
+            cli.log.info('Saved the keymap to %s', cli.args.output)
+
+    except ViaError as e:
+        cli.log.error('%s', e)
+        return False
+
+    finally:
+        device.close()
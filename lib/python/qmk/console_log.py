@@ -0,0 +1,219 @@
+"""Decoder for the binary console log (`CONSOLE_BINARY_ENABLE`).
+
+The keyboard sends the address of each format string together with its raw arguments. The format strings are looked up in the firmware ELF and formatted on the host. See `quantum/logging/binary_log.h` for the wire format.
+"""
+import re
+import struct
+
+DROPPED_ID = 0
+LITERAL_ID = 1
+TEXT_ID = 2
+NO_RECORD = 0xFF
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 0x2
+
+# %[flags][width][.precision][length]conversion
+format_re = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z|j|t|L)?([a-zA-Z%])')
+
+
+class ElfStrings:
+    """Resolves addresses to NUL terminated strings in the loadable sections of a 32 bit ELF file.
+    """
+    def __init__(self, data):
+        if data[:4] != b'\x7fELF':
+            raise ValueError('Not an ELF file')
+        if data[4] != 1:
+            raise ValueError('Only 32 bit ELF files are supported')
+        endian = '<' if data[5] == 1 else '>'
+
+        shoff, = struct.unpack_from(endian + 'I', data, 0x20)
+        shentsize, shnum = struct.unpack_from(endian + 'HH', data, 0x2E)
+
+        self.sections = []
+        for i in range(shnum):
+            _, sh_type, sh_flags, sh_addr, sh_offset, sh_size = struct.unpack_from(endian + 'IIIIII', data, shoff + i * shentsize)
+            if sh_type == SHT_PROGBITS and sh_flags & SHF_ALLOC:
+                self.sections.append((sh_addr, data[sh_offset:sh_offset + sh_size]))
+
+    def string(self, address):
+        for base, contents in self.sections:
+            if base <= address < base + len(contents):
+                end = contents.find(b'\0', address - base)
+                if end < 0:
+                    end = len(contents)
+                return contents[address - base:end].decode('utf-8', errors='replace')
+        return None
+
+
+class _Arguments:
+    """Walks the packed arguments of a record.
+    """
+    def __init__(self, data):
+        self.data = data
+        self.offset = 0
+
+    def u32(self):
+        if self.offset + 4 > len(self.data):
+            raise IndexError('record truncated')
+        value, = struct.unpack_from('<I', self.data, self.offset)
+        self.offset += 4
+        return value
+
+    def i32(self):
+        value = self.u32()
+        return value - (1 << 32) if value & 0x80000000 else value
+
+    def u64(self):
+        low = self.u32()
+        return low | self.u32() << 32
+
+    def i64(self):
+        value = self.u64()
+        return value - (1 << 64) if value & (1 << 63) else value
+
+    def double(self):
+        value, = struct.unpack('<d', struct.pack('<Q', self.u64()))
+        return value
+
+    def string(self):
+        end = self.data.find(b'\0', self.offset)
+        if end < 0:
+            end = len(self.data)
+        value = self.data[self.offset:end].decode('utf-8', errors='replace')
+        self.offset = end + 1
+        return value
+
+
+def format_record(fmt, data):
+    """Formats the packed arguments of a record with its printf style format string.
+
+    Arguments missing from a truncated record are shown as `?`. The keyboard stops storing arguments at a conversion it doesn't support, so that conversion is left as is and the ones after it are shown as `?`.
+    """
+    args = _Arguments(data)
+    unsupported = False
+
+    def convert(match):
+        nonlocal unsupported
+        flags, width, precision, length, conversion = match.groups()
+        if conversion == '%':
+            return '%'
+        if unsupported:
+            return '?'
+        wide = length in ('ll', 'j')
+        try:
+            if width == '*':
+                width = str(args.i32())
+            if precision == '*':
+                precision = str(args.i32())
+            spec = '%' + flags + (width or '') + ('.' + precision if precision is not None else '')
+
+            if conversion == 's':
+                return (spec + 's') % args.string()
+            if conversion in 'di':
+                return (spec + 'd') % (args.i64() if wide else args.i32())
+            if conversion in 'uxXo':
+                return (spec + conversion.replace('u', 'd')) % (args.u64() if wide else args.u32())
+            if conversion in 'fFeEgGaA':
+                value = args.double()
+                if conversion in 'aA':
+                    text = value.hex()
+                    return (spec + 's') % (text.upper() if conversion == 'A' else text)
+                return (spec + conversion) % value
+            if conversion == 'c':
+                return (spec + 'c') % chr((args.u64() if wide else args.u32()) & 0xFF)
+            if conversion == 'b':
+                return (spec + 's') % format(args.u64() if wide else args.u32(), 'b').rjust(int(width or 0), '0' if '0' in flags else ' ')
+            if conversion == 'p':
+                return '0x%08x' % args.u32()
+        except IndexError:
+            return '?'
+        unsupported = True
+        return match.group(0)
+
+    return format_re.sub(convert, fmt)
+
+
+class ConsoleDecoder:
+    """Turns console packets back into log lines.
+
+    Feed packets in the order they were received. Partial records carry over to the next packet, and the decoder resynchronises on the first record offset of a packet after lost or garbled data.
+    """
+    def __init__(self, strings):
+        self.strings = strings
+        self.record = None
+        self.text = b''
+
+    def _add(self, record, lines):
+        """Decodes a complete record. Raw text is joined up into whole lines, an unfinished one is shown ahead of the next message.
+        """
+        if len(record) >= 4 and struct.unpack_from('<I', record, 0)[0] == TEXT_ID:
+            self.text += record[4:]
+            while b'\n' in self.text:
+                line, self.text = self.text.split(b'\n', 1)
+                lines.append(line.decode('utf-8', errors='replace') + '\n')
+            return
+        if self.text:
+            lines.append(self.text.decode('utf-8', errors='replace'))
+            self.text = b''
+        lines.append(self._decode(record))
+
+    def _decode(self, record):
+        if len(record) < 4:
+            return '<truncated record>'
+        address, = struct.unpack_from('<I', record, 0)
+        if address == DROPPED_ID:
+            count = _Arguments(record[4:]).u32() if len(record) >= 8 else 0
+            return f'<{count} messages dropped>'
+        if address == LITERAL_ID:
+            address = _Arguments(record[4:]).u32() if len(record) >= 8 else None
+            text = self.strings.string(address) if address is not None else None
+            return text if text is not None else '<unknown string>'
+
+        fmt = self.strings.string(address)
+        if fmt is None:
+            return f'<unknown format string 0x{address:08x}>'
+        return format_record(fmt, record[4:])
+
+    def packet(self, packet):
+        """Decodes one packet, returning the text of every record completed by it.
+        """
+        if not packet:
+            return []
+        first, payload = packet[0], bytes(packet[1:])
+        offset = 0
+        text = []
+
+        if self.record is not None:
+            length, data = self.record
+            missing = length - len(data)
+            if first != NO_RECORD and first != min(missing, len(payload)):
+                # lost part of the record, start again at the next one
+                self.record = None
+            else:
+                data += payload[:missing]
+                offset = min(missing, len(payload))
+                if len(data) < length:
+                    self.record = (length, data)
+                    return text
+                self.record = None
+                self._add(data, text)
+
+        if self.record is None and offset == 0 and first != 0:
+            if first == NO_RECORD or first >= len(payload):
+                return text
+            offset = first
+
+        while offset < len(payload):
+            length = payload[offset]
+            if length == 0:
+                # padding
+                break
+            data = payload[offset + 1:offset + 1 + length]
+            offset += 1 + length
+            if len(data) < length:
+                self.record = (length, data)
+                break
+            self._add(data, text)
+
+        return text
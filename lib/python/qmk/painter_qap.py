@@ -0,0 +1,91 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# Quantum Asset Pack "QAP" File Format.
+# See https://docs.qmk.fm/#/quantum_painter?id=quantum-painter-asset-packs for more information.
+
+import struct
+
+QAP_MAGIC = 0x504151
+QAP_VERSION = 1
+QAP_NAME_LENGTH = 24
+
+# Magic numbers of the asset formats which can be packed
+QGF_MAGIC = 0x464751
+QFF_MAGIC = 0x464651
+
+_block_header_size = 5
+_pack_descriptor_length = 14
+_asset_entry_size = 32
+
+
+def _block_header(type_id, length):
+    return struct.pack('<BB', type_id, (~type_id) & 0xFF) + struct.pack('<I', length)[:3]
+
+
+def asset_magic(data):
+    """Returns the magic number of a QGF/QFF file, or None if it's not one.
+    """
+    if len(data) < _block_header_size + 4 or data[0] != 0x00 or data[1] != 0xFF:
+        return None
+    magic = int.from_bytes(data[_block_header_size:_block_header_size + 3], 'little')
+    return magic if magic in (QGF_MAGIC, QFF_MAGIC) else None
+
+
+def build_asset_pack(assets, align=4):
+    """Builds an asset pack from a dict of names to QGF/QFF file contents.
+
+    Each asset starts on a multiple of `align` bytes from the start of the pack. Names are stored sorted so that the
+    firmware can binary search the directory.
+    """
+    names = sorted(assets.keys(), key=lambda n: n.encode('utf-8'))
+    for name in names:
+        encoded = name.encode('utf-8')
+        if len(encoded) == 0 or len(encoded) > QAP_NAME_LENGTH:
+            raise ValueError(f'Asset name "{name}" must be between 1 and {QAP_NAME_LENGTH} bytes long')
+        if asset_magic(assets[name]) is None:
+            raise ValueError(f'Asset "{name}" is not a QGF image or QFF font')
+    if len(names) > 0xFFFF:
+        raise ValueError('Too many assets')
+    if align < 1:
+        raise ValueError('Alignment must be at least 1')
+
+    directory_length = len(names) * _asset_entry_size
+    offset = _block_header_size + _pack_descriptor_length + _block_header_size + directory_length
+
+    directory = b''
+    data = b''
+    for name in names:
+        padding = (-offset) % align
+        data += bytes(padding)
+        offset += padding
+        directory += struct.pack('<24sII', name.encode('utf-8'), offset, len(assets[name]))
+        data += assets[name]
+        offset += len(assets[name])
+
+    total_size = offset
+    pack = _block_header(0x00, _pack_descriptor_length)
+    pack += struct.pack('<I', QAP_MAGIC)[:3] + struct.pack('<B', QAP_VERSION)
+    pack += struct.pack('<IIH', total_size, (~total_size) & 0xFFFFFFFF, len(names))
+    pack += _block_header(0x01, directory_length) + directory
+    pack += data
+    return pack
+
+
+def read_asset_pack(pack):
+    """Returns a dict of names to asset contents from an asset pack.
+    """
+    if len(pack) < _block_header_size + _pack_descriptor_length + _block_header_size:
+        raise ValueError('Asset pack is truncated')
+    if pack[0:2] != b'\x00\xFF' or int.from_bytes(pack[5:8], 'little') != QAP_MAGIC or pack[8] != QAP_VERSION:
+        raise ValueError('Not an asset pack')
+    total_size, neg_total_size, count = struct.unpack_from('<IIH', pack, 9)
+    if neg_total_size != (~total_size) & 0xFFFFFFFF or total_size != len(pack):
+        raise ValueError('Asset pack size mismatch')
+
+    assets = {}
+    entries = _block_header_size + _pack_descriptor_length + _block_header_size
+    for i in range(count):
+        name, offset, size = struct.unpack_from('<24sII', pack, entries + i * _asset_entry_size)
+        assets[name.rstrip(b'\0').decode('utf-8')] = pack[offset:offset + size]
+    return assets
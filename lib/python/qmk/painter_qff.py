@@ -136,6 +136,7 @@ class QFFUnicodeGlyphTableV1:
         self.header.length = len(self.glyphs.keys()) * 6
         self.header.write(fp)
 
+        # Ascending code point order lets the firmware binary search the table
         for n in sorted(self.glyphs.keys()):
             self.glyphs[n].write(fp, True)
 
@@ -273,6 +273,9 @@ def test_generate_config_h():
     assert '#    define MATRIX_COL_PINS { F4 }' in result.stdout
     assert '#    define MATRIX_ROWS 1' in result.stdout
     assert '#    define MATRIX_ROW_PINS { F5 }' in result.stdout
+    assert '#    define MATRIX_COL_PORTS { F4 }' in result.stdout
+    assert '#    define MATRIX_COL_PORT_TERMS { {0, 0x10, -4} }' in result.stdout
+    assert '#    define MATRIX_COL_PORT_PINS { F4 }' in result.stdout
 
 
 def test_generate_rules_mk():
@@ -282,6 +285,14 @@ def test_generate_rules_mk():
     assert 'MCU ?= atmega32u4' in result.stdout
 
 
+def test_generate_compressed_keymap():
+    result = check_subcommand('generate-compressed-keymap', '-kb', 'handwired/pytest/basic', 'keyboards/handwired/pytest/basic/keymaps/default_json/keymap.json')
+    check_returncode(result)
+    assert 'compressed_keymap_present[COMPRESSED_KEYMAP_WORDS] = {0x00000001};' in result.stdout
+    assert 'compressed_keymap_keycodes_0[] = {KC_A};' in result.stdout
+    assert '[0] = {.bitmap = {0x00000001}, .rank = {0}, .filler = KC_TRNS, .keycodes = compressed_keymap_keycodes_0},' in result.stdout
+
+
 def test_generate_version_h():
     result = check_subcommand('generate-version-h')
     check_returncode(result)
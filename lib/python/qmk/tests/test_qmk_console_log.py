@@ -0,0 +1,105 @@
+import struct
+
+from qmk.console_log import ConsoleDecoder, ElfStrings, format_record
+
+RODATA_ADDR = 0x08001000
+
+
+def make_elf(rodata):
+    """Builds a little endian ELF32 file with a null section and a single .rodata section.
+    """
+    header_size, section_size = 52, 40
+    shoff = header_size + len(rodata)
+    header = b'\x7fELF\x01\x01\x01' + bytes(9)
+    header += struct.pack('<HHIIIIIHHHHHH', 2, 40, 1, 0, 0, shoff, 0, header_size, 0, 0, section_size, 2, 0)
+    sections = bytes(section_size)
+    sections += struct.pack('<IIIIIIIIII', 0, 1, 0x2, RODATA_ADDR, header_size, len(rodata), 0, 0, 4, 0)
+    return header + rodata + sections
+
+
+def record(address, args=b''):
+    body = struct.pack('<I', address) + args
+    return bytes([len(body)]) + body
+
+
+def packets(stream, size=8):
+    """Splits a record stream into packets the way the keyboard does.
+    """
+    out = []
+    starts = set()
+    offset = 0
+    while offset < len(stream):
+        starts.add(offset)
+        offset += stream[offset] + 1
+    for base in range(0, len(stream), size - 1):
+        chunk = stream[base:base + size - 1]
+        first = next((i - base for i in range(base, base + len(chunk)) if i in starts), 0xFF)
+        out.append(bytes([first]) + chunk + bytes(size - 1 - len(chunk)))
+    return out
+
+
+def test_elf_strings():
+    strings = ElfStrings(make_elf(b'hello\0world\0'))
+    assert strings.string(RODATA_ADDR) == 'hello'
+    assert strings.string(RODATA_ADDR + 6) == 'world'
+    assert strings.string(RODATA_ADDR + 8) == 'rld'
+    assert strings.string(0x20000000) is None
+
+
+def test_format_record():
+    args = struct.pack('<iI', -5, 0xBEEF) + b'hi\0' + struct.pack('<II', 4, 5)
+    assert format_record('%d %04X %s %0*b %%', args) == '-5 BEEF hi 0101 %'
+
+
+def test_format_truncated_record():
+    assert format_record('%u %u', struct.pack('<I', 7)) == '7 ?'
+
+
+def test_decoder_split_records():
+    decoder = ConsoleDecoder(ElfStrings(make_elf(b'a=%u\0b=%s\0')))
+    stream = record(RODATA_ADDR, struct.pack('<I', 1)) + record(RODATA_ADDR + 5, b'text\0') + record(0, struct.pack('<I', 3))
+
+    lines = []
+    for packet in packets(stream):
+        lines += decoder.packet(packet)
+    assert lines == ['a=1', 'b=text', '<3 messages dropped>']
+
+
+def test_decoder_resyncs_after_lost_packet():
+    decoder = ConsoleDecoder(ElfStrings(make_elf(b'a=%u\0')))
+    stream = b''.join(record(RODATA_ADDR, struct.pack('<I', i)) for i in range(4))
+
+    lines = []
+    for i, packet in enumerate(packets(stream)):
+        if i != 1:
+            lines += decoder.packet(packet)
+    assert lines == ['a=2', 'a=3']
+
+
+def test_format_wide_and_float_arguments():
+    args = struct.pack('<qQd', -(1 << 40), 1 << 33, 1.5)
+    assert format_record('%lld %llx %.2f', args) == '-1099511627776 200000000 1.50'
+
+
+def test_format_stops_at_unsupported_conversion():
+    assert format_record('%u %n %u %%', struct.pack('<I', 7)) == '7 %n ? %'
+
+
+def test_decoder_literal_string():
+    decoder = ConsoleDecoder(ElfStrings(make_elf(b'100%d\0')))
+    stream = record(1, struct.pack('<I', RODATA_ADDR))
+
+    lines = []
+    for packet in packets(stream, size=16):
+        lines += decoder.packet(packet)
+    assert lines == ['100%d']
+
+
+def test_decoder_joins_raw_text():
+    decoder = ConsoleDecoder(ElfStrings(make_elf(b'a=%u\0')))
+    stream = record(2, b'he') + record(2, b'llo\nwor') + record(2, b'ld') + record(RODATA_ADDR, struct.pack('<I', 1))
+
+    lines = []
+    for packet in packets(stream):
+        lines += decoder.packet(packet)
+    assert lines == ['hello\n', 'world', 'a=1']
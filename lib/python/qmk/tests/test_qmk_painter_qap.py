@@ -0,0 +1,38 @@
+import struct
+
+import pytest
+
+from qmk.painter_qap import build_asset_pack, read_asset_pack, QGF_MAGIC, QFF_MAGIC
+
+
+def fake_asset(magic, size):
+    """Just enough of a QGF/QFF file to be recognised.
+    """
+    header = b'\x00\xFF' + struct.pack('<I', 18)[:3] + struct.pack('<I', magic)[:3]
+    return header + bytes(range(size - len(header)))
+
+
+def test_roundtrip():
+    assets = {'logo': fake_asset(QGF_MAGIC, 40), 'font': fake_asset(QFF_MAGIC, 21), 'icon': fake_asset(QGF_MAGIC, 9)}
+    pack = build_asset_pack(assets)
+    assert read_asset_pack(pack) == assets
+
+
+def test_directory_sorted_and_aligned():
+    pack = build_asset_pack({'b': fake_asset(QGF_MAGIC, 10), 'a': fake_asset(QFF_MAGIC, 11), 'c': fake_asset(QGF_MAGIC, 12)}, align=16)
+    names = []
+    for i in range(3):
+        name, offset, size = struct.unpack_from('<24sII', pack, 24 + i * 32)
+        names.append(name.rstrip(b'\0'))
+        assert offset % 16 == 0
+    assert names == [b'a', b'b', b'c']
+    total_size, neg_total_size = struct.unpack_from('<II', pack, 9)
+    assert total_size == len(pack)
+    assert neg_total_size == (~total_size) & 0xFFFFFFFF
+
+
+def test_rejects_bad_assets():
+    with pytest.raises(ValueError):
+        build_asset_pack({'x' * 25: fake_asset(QGF_MAGIC, 10)})
+    with pytest.raises(ValueError):
+        build_asset_pack({'png': b'\x89PNG\r\n\x1a\n'})
@@ -0,0 +1,50 @@
+from qmk.unicode_helper import HEADER_SIZE, HELLO, HELPER_ID, MORE, TEXT, TextAssembler, hello_report
+
+REPORT_SIZE = 32
+
+
+def text_reports(text):
+    """Splits text over reports the way quantum/unicode/unicode.c does.
+    """
+    data = text.encode('utf-8')
+    chunk = REPORT_SIZE - HEADER_SIZE
+    reports = []
+    for start in range(0, len(data), chunk):
+        part = data[start:start + chunk]
+        more = MORE if start + chunk < len(data) else 0
+        reports.append((bytes([HELPER_ID, TEXT, len(part) | more]) + part).ljust(REPORT_SIZE, b'\0'))
+    return reports
+
+
+def test_hello_report():
+    report = hello_report(REPORT_SIZE)
+    assert len(report) == REPORT_SIZE
+    assert report[:2] == bytes([HELPER_ID, HELLO])
+
+
+def test_single_report():
+    assembler = TextAssembler()
+    assert assembler.feed(text_reports('ab€')[0]) == 'ab€'
+
+
+def test_text_split_within_code_points():
+    assembler = TextAssembler()
+    text = '😀' * 20
+    reports = text_reports(text)
+    assert len(reports) == 3
+
+    for report in reports[:-1]:
+        assert assembler.feed(report) is None
+    assert assembler.feed(reports[-1]) == text
+    # Ready for the next text
+    assert assembler.feed(text_reports('x')[0]) == 'x'
+
+
+def test_other_reports_are_ignored():
+    assembler = TextAssembler()
+    reports = text_reports('é' * 20)
+
+    assert assembler.feed(reports[0]) is None
+    assert assembler.feed(hello_report(REPORT_SIZE)) is None
+    assert assembler.feed(bytes([0xFF, TEXT, 1, ord('x')])) is None
+    assert assembler.feed(reports[1]) == 'é' * 20
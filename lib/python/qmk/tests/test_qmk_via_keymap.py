@@ -0,0 +1,128 @@
+import pytest
+
+from qmk.via_keymap import ID_GET_LAYER_COUNT, ID_GET_BUFFER, ID_GET_LAYER_CRCS, ID_STREAM_GET_BUFFER, ID_STREAM_SET_BUFFER, ID_UNHANDLED, REPORT_SIZE, STREAM_CHUNK_SIZE, STREAM_HEADER_SIZE, STREAM_LAST_REPORT, STREAM_OK, STREAM_OUT_OF_SEQUENCE, ViaError, ViaKeymapClient, layer_crc
+
+ROWS = 5
+COLS = 15
+LAYERS = 4
+LAYER_SIZE = ROWS * COLS * 2
+
+
+class FakeKeyboard:
+    """Replies to the keymap commands the way quantum/via.c does.
+    """
+    def __init__(self, keymap, streaming=True):
+        self.keymap = bytearray(keymap)
+        self.streaming = streaming
+        self.replies = []
+        self.next_seq = 0
+        self.drop = set()  # indexes of written reports to lose
+        self.written = 0
+
+    def write(self, report):
+        assert len(report) == REPORT_SIZE
+        index = self.written
+        self.written += 1
+        if index in self.drop:
+            return
+
+        report = bytearray(report)
+        command = report[0]
+        if command == ID_GET_LAYER_COUNT:
+            report[1] = LAYERS
+        elif command == ID_GET_BUFFER:
+            offset, size = int.from_bytes(report[1:3], 'big'), report[3]
+            report[4:4 + size] = self.keymap[offset:offset + size].ljust(size, b'\0')
+        elif command == ID_GET_LAYER_CRCS and self.streaming:
+            first = report[1]
+            layers = range(first, min(LAYERS, first + (REPORT_SIZE - 3) // 2))
+            report[2] = len(layers)
+            for i, layer in enumerate(layers):
+                report[3 + i * 2:5 + i * 2] = layer_crc(self.keymap[layer * LAYER_SIZE:(layer + 1) * LAYER_SIZE]).to_bytes(2, 'big')
+        elif command == ID_STREAM_GET_BUFFER and self.streaming:
+            offset = int.from_bytes(report[2:4], 'big')
+            for seq in range(report[1]):
+                chunk = self.keymap[offset:offset + STREAM_CHUNK_SIZE]
+                header = bytes([command, seq, offset >> 8, offset & 0xFF, len(chunk)])
+                self.replies.append(header + chunk.ljust(STREAM_CHUNK_SIZE, b'\0'))
+                offset += STREAM_CHUNK_SIZE
+            return
+        elif command == ID_STREAM_SET_BUFFER and self.streaming:
+            seq = report[1] & ~STREAM_LAST_REPORT
+            if seq == 0:
+                self.next_seq = 0
+            if seq != self.next_seq:
+                if self.next_seq != 0xFF:
+                    self.replies.append(bytes([command, STREAM_OUT_OF_SEQUENCE, self.next_seq]).ljust(REPORT_SIZE, b'\0'))
+                self.next_seq = 0xFF
+                return
+            offset, size = int.from_bytes(report[2:4], 'big'), report[4]
+            self.keymap[offset:offset + size] = report[STREAM_HEADER_SIZE:STREAM_HEADER_SIZE + size]
+            self.next_seq += 1
+            if report[1] & STREAM_LAST_REPORT:
+                self.replies.append(bytes([command, STREAM_OK, self.next_seq]).ljust(REPORT_SIZE, b'\0'))
+            return
+        else:
+            report[0] = ID_UNHANDLED
+        self.replies.append(bytes(report))
+
+    def read(self, size, timeout):
+        return self.replies.pop(0) if self.replies else b''
+
+
+def make_keymap():
+    return bytes((i * 7) & 0xFF for i in range(LAYERS * LAYER_SIZE))
+
+
+def test_read_keymap():
+    keyboard = FakeKeyboard(make_keymap())
+    client = ViaKeymapClient(keyboard, ROWS, COLS)
+
+    assert client.read_keymap() == keyboard.keymap
+    streamed = client.requests
+
+    client.requests = 0
+    assert client.read_buffer_legacy(0, LAYERS * LAYER_SIZE) == keyboard.keymap
+    assert streamed * 5 < client.requests
+
+
+def test_read_keymap_only_changed_layers():
+    keyboard = FakeKeyboard(make_keymap())
+    client = ViaKeymapClient(keyboard, ROWS, COLS)
+    cached = client.read_keymap()
+
+    keyboard.keymap[2 * LAYER_SIZE + 10] ^= 0xFF
+    client.requests = 0
+    assert client.read_keymap(cached) == keyboard.keymap
+    # Layer count, CRCs and a single layer
+    assert client.requests == 4
+
+
+def test_write_keymap():
+    keyboard = FakeKeyboard(bytes(LAYERS * LAYER_SIZE))
+    client = ViaKeymapClient(keyboard, ROWS, COLS)
+    keymap = make_keymap()
+
+    client.write_keymap(keymap)
+    assert keyboard.keymap == keymap
+    assert not keyboard.replies
+
+
+def test_write_resends_windows_with_lost_reports():
+    keyboard = FakeKeyboard(bytes(LAYERS * LAYER_SIZE))
+    client = ViaKeymapClient(keyboard, ROWS, COLS, window=4)
+    keymap = make_keymap()[:LAYER_SIZE]
+
+    # Lose a report in the middle of the first window, and the last report of the second
+    keyboard.drop = {1, 4 + 4 + 3}
+    client.write_buffer(0, keymap)
+    assert keyboard.keymap[:LAYER_SIZE] == keymap
+    assert not keyboard.replies
+
+
+def test_unsupported_keyboard():
+    keyboard = FakeKeyboard(make_keymap(), streaming=False)
+    client = ViaKeymapClient(keyboard, ROWS, COLS)
+
+    with pytest.raises(ViaError, match='not supported'):
+        client.read_keymap(make_keymap())
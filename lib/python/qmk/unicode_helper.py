@@ -0,0 +1,78 @@
+"""Host side of the Unicode host helper, typing the text a keyboard sends over raw HID.
+
+Keyboards built with `UNICODE_HOST_HELPER` send Unicode as UTF-8 while the helper keeps saying hello, instead of typing hex sequences. See `quantum/unicode/unicode.h` for the report format.
+"""
+import platform
+import subprocess
+
+HELPER_ID = 0x55
+HELLO = 0x01
+TEXT = 0x02
+HEADER_SIZE = 3
+MORE = 0x80
+
+
+def hello_report(size=32):
+    """The report telling the keyboard the helper is running, `size` being the keyboard's raw HID report size.
+    """
+    return bytes([HELPER_ID, HELLO]).ljust(size, b'\0')
+
+
+class TextAssembler:
+    """Puts text split over several reports back together.
+    """
+    def __init__(self):
+        self.pending = bytearray()
+
+    def feed(self, report):
+        """Returns the text once its last report is fed, None until then. Reports other than text are ignored.
+        """
+        if len(report) < HEADER_SIZE or report[0] != HELPER_ID or report[1] != TEXT:
+            return None
+
+        size = report[2] & ~MORE
+        self.pending += report[HEADER_SIZE:HEADER_SIZE + size]
+        if report[2] & MORE:
+            return None
+
+        text = self.pending.decode('utf-8', errors='replace')
+        self.pending = bytearray()
+        return text
+
+
+def _type_windows(text):
+    import ctypes
+    from ctypes import wintypes
+
+    KEYEVENTF_KEYUP = 0x0002
+    KEYEVENTF_UNICODE = 0x0004
+
+    class KEYBDINPUT(ctypes.Structure):
+        _fields_ = [('wVk', wintypes.WORD), ('wScan', wintypes.WORD), ('dwFlags', wintypes.DWORD), ('time', wintypes.DWORD), ('dwExtraInfo', ctypes.c_size_t)]
+
+    class INPUT(ctypes.Structure):
+        # Only keyboard input is sent, padded to the size of the union with mouse input
+        _fields_ = [('type', wintypes.DWORD), ('ki', KEYBDINPUT), ('padding', ctypes.c_ubyte * 8)]
+
+    units = text.encode('utf-16-le')
+    inputs = []
+    for i in range(0, len(units), 2):
+        unit = int.from_bytes(units[i:i + 2], 'little')
+        for flags in (KEYEVENTF_UNICODE, KEYEVENTF_UNICODE | KEYEVENTF_KEYUP):
+            inputs.append(INPUT(type=1, ki=KEYBDINPUT(wVk=0, wScan=unit, dwFlags=flags)))
+
+    array = (INPUT * len(inputs))(*inputs)
+    ctypes.windll.user32.SendInput(len(inputs), array, ctypes.sizeof(INPUT))
+
+
+def type_text(text):
+    """Types text with the facilities of the host OS.
+    """
+    system = platform.system()
+    if system == 'Windows':
+        _type_windows(text)
+    elif system == 'Darwin':
+        script = ['-e', 'on run argv', '-e', 'tell application "System Events" to keystroke (item 1 of argv)', '-e', 'end run']
+        subprocess.run(['osascript', *script, text], check=True)
+    else:
+        subprocess.run(['xdotool', 'type', '--clearmodifiers', '--', text], check=True)
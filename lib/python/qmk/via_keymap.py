@@ -0,0 +1,155 @@
+"""Client for the VIA dynamic keymap commands, including the streaming and CRC extensions.
+
+The keymap is a buffer of big endian keycodes by layer, row and column. See `quantum/via.c` for the wire format of the streaming commands.
+"""
+from binascii import crc_hqx
+
+REPORT_SIZE = 32
+STREAM_HEADER_SIZE = 5
+STREAM_CHUNK_SIZE = REPORT_SIZE - STREAM_HEADER_SIZE
+STREAM_LAST_REPORT = 0x80
+STREAM_WINDOW_SIZE = 16
+LEGACY_CHUNK_SIZE = 28
+
+ID_GET_LAYER_COUNT = 0x11
+ID_GET_BUFFER = 0x12
+ID_GET_LAYER_CRCS = 0x16
+ID_STREAM_GET_BUFFER = 0x17
+ID_STREAM_SET_BUFFER = 0x18
+ID_UNHANDLED = 0xFF
+
+STREAM_OK = 0x00
+STREAM_OUT_OF_SEQUENCE = 0x01
+
+
+class ViaError(Exception):
+    """Raised when the keyboard doesn't reply as expected.
+    """
+
+
+def layer_crc(data):
+    """The CRC the keyboard reports for a layer, CRC-16/CCITT-FALSE.
+    """
+    return crc_hqx(bytes(data), 0xFFFF)
+
+
+class ViaKeymapClient:
+    """Transfers the dynamic keymap of a keyboard.
+
+    `device` needs `write(report)` and `read(size, timeout)` methods taking and returning raw HID reports of `REPORT_SIZE` bytes, like `hid.Device` apart from the report ID. `rows` and `cols` are the size of the keyboard's matrix.
+    """
+    def __init__(self, device, rows, cols, window=STREAM_WINDOW_SIZE, timeout=500, retries=3):
+        self.device = device
+        self.layer_size = rows * cols * 2
+        self.window = window
+        self.timeout = timeout
+        self.retries = retries
+        self.requests = 0
+
+    def _send(self, *data):
+        report = bytes(data)
+        self.device.write(report + bytes(REPORT_SIZE - len(report)))
+
+    def _receive(self, command_id):
+        report = self.device.read(REPORT_SIZE, self.timeout)
+        if not report:
+            return None
+        if report[0] == ID_UNHANDLED:
+            raise ViaError(f'Command 0x{command_id:02X} is not supported by the keyboard')
+        if report[0] != command_id:
+            raise ViaError(f'Expected a reply to 0x{command_id:02X}, got 0x{report[0]:02X}')
+        return bytes(report)
+
+    def _request(self, *data):
+        self.requests += 1
+        self._send(*data)
+        reply = self._receive(data[0])
+        if reply is None:
+            raise ViaError(f'No reply to 0x{data[0]:02X}')
+        return reply
+
+    def layer_count(self):
+        return self._request(ID_GET_LAYER_COUNT)[1]
+
+    def layer_crcs(self):
+        """Returns the CRC of every layer, as computed by `layer_crc()`.
+        """
+        crcs = []
+        count = self.layer_count()
+        while len(crcs) < count:
+            reply = self._request(ID_GET_LAYER_CRCS, len(crcs))
+            if not reply[2]:
+                raise ViaError(f'No CRC for layer {len(crcs)}')
+            crcs.extend(int.from_bytes(reply[3 + i * 2:5 + i * 2], 'big') for i in range(reply[2]))
+        return crcs
+
+    def read_buffer(self, offset, size):
+        """Reads part of the keymap, a window of reports for each request.
+        """
+        data = bytearray()
+        while len(data) < size:
+            reports = min(self.window, -(-(size - len(data)) // STREAM_CHUNK_SIZE))
+            start = offset + len(data)
+            self.requests += 1
+            self._send(ID_STREAM_GET_BUFFER, reports, start >> 8, start & 0xFF)
+            end = False
+            for seq in range(reports):
+                report = self._receive(ID_STREAM_GET_BUFFER)
+                if report is None or report[1] != seq or int.from_bytes(report[2:4], 'big') != start + seq * STREAM_CHUNK_SIZE:
+                    raise ViaError(f'Lost report {seq} of the window at offset {start}')
+                data += report[STREAM_HEADER_SIZE:STREAM_HEADER_SIZE + report[4]]
+                end = end or report[4] < STREAM_CHUNK_SIZE
+            if end:
+                break
+        return bytes(data[:size])
+
+    def read_buffer_legacy(self, offset, size):
+        """Reads part of the keymap with a request for every 28 bytes, as the VIA configurator does.
+        """
+        data = bytearray()
+        while len(data) < size:
+            start = offset + len(data)
+            length = min(LEGACY_CHUNK_SIZE, size - len(data))
+            reply = self._request(ID_GET_BUFFER, start >> 8, start & 0xFF, length)
+            data += reply[4:4 + length]
+        return bytes(data)
+
+    def read_keymap(self, cached=None):
+        """Reads the whole keymap. Layers of `cached`, a keymap read before, are only read again if their CRC changed.
+        """
+        count = self.layer_count()
+        if cached is None or len(cached) != count * self.layer_size:
+            return self.read_buffer(0, count * self.layer_size)
+
+        keymap = bytearray(cached)
+        for layer, crc in enumerate(self.layer_crcs()):
+            start = layer * self.layer_size
+            if layer_crc(keymap[start:start + self.layer_size]) != crc:
+                keymap[start:start + self.layer_size] = self.read_buffer(start, self.layer_size)
+        return bytes(keymap)
+
+    def write_buffer(self, offset, data):
+        """Writes part of the keymap, only waiting for the keyboard at the end of each window. Windows the keyboard missed a report of are sent again.
+        """
+        chunks = [data[i:i + STREAM_CHUNK_SIZE] for i in range(0, len(data), STREAM_CHUNK_SIZE)]
+        for first in range(0, len(chunks), self.window):
+            window = chunks[first:first + self.window]
+            for _ in range(self.retries + 1):
+                self.requests += 1
+                for seq, chunk in enumerate(window):
+                    start = offset + (first + seq) * STREAM_CHUNK_SIZE
+                    flags = STREAM_LAST_REPORT if seq == len(window) - 1 else 0
+                    self._send(ID_STREAM_SET_BUFFER, seq | flags, start >> 8, start & 0xFF, len(chunk), *chunk)
+                reply = self._receive(ID_STREAM_SET_BUFFER)
+                if reply is not None and reply[1] == STREAM_OK and reply[2] == len(window):
+                    break
+            else:
+                raise ViaError(f'Could not write the window at offset {offset + first * STREAM_CHUNK_SIZE}')
+
+    def write_keymap(self, keymap):
+        """Writes the layers of `keymap` which differ from the keyboard's.
+        """
+        for layer, crc in enumerate(self.layer_crcs()):
+            start = layer * self.layer_size
+            if layer_crc(keymap[start:start + self.layer_size]) != crc:
+                self.write_buffer(start, keymap[start:start + self.layer_size])
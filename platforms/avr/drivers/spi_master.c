@@ -167,6 +167,19 @@ spi_status_t spi_receive(uint8_t *data, uint16_t length) {
     return SPI_STATUS_SUCCESS;
 }
 
+// There is no DMA on AVR, so the transfers have completed by the time these return
+spi_status_t spi_transmit_async(const uint8_t *data, uint16_t length) {
+    return spi_transmit(data, length);
+}
+
+spi_status_t spi_receive_async(uint8_t *data, uint16_t length) {
+    return spi_receive(data, length);
+}
+
+bool spi_transfer_complete(void) {
+    return true;
+}
+
 void spi_stop(void) {
     if (currentSlavePin != NO_PIN) {
         setPinOutput(currentSlavePin);
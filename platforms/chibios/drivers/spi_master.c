@@ -282,6 +282,20 @@ spi_status_t spi_receive(uint8_t *data, uint16_t length) {
     return SPI_STATUS_SUCCESS;
 }
 
+spi_status_t spi_transmit_async(const uint8_t *data, uint16_t length) {
+    spiStartSend(&SPI_DRIVER, length, data);
+    return SPI_STATUS_SUCCESS;
+}
+
+spi_status_t spi_receive_async(uint8_t *data, uint16_t length) {
+    spiStartReceive(&SPI_DRIVER, length, data);
+    return SPI_STATUS_SUCCESS;
+}
+
+bool spi_transfer_complete(void) {
+    return SPI_DRIVER.state != SPI_ACTIVE;
+}
+
 void spi_stop(void) {
     if (currentSlavePin != NO_PIN) {
         spiUnselect(&SPI_DRIVER);
@@ -87,6 +87,12 @@ spi_status_t spi_transmit(const uint8_t *data, uint16_t length);
 
 spi_status_t spi_receive(uint8_t *data, uint16_t length);
 
+spi_status_t spi_transmit_async(const uint8_t *data, uint16_t length);
+
+spi_status_t spi_receive_async(uint8_t *data, uint16_t length);
+
+bool spi_transfer_complete(void);
+
 void spi_stop(void);
 #ifdef __cplusplus
 }
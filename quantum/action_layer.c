@@ -335,6 +335,12 @@ uint8_t layer_switch_get_layer(keypos_t key) {
     /* check top layer first */
     for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
         if (layers & ((layer_state_t)1 << i)) {
+#    if defined(KEYMAP_COMPRESSED) && !defined(DYNAMIC_KEYMAP_ENABLE)
+            // The compressed keymap knows which keys are transparent without looking up their action
+            if (keymap_location_is_transparent_raw(i, key.row, key.col)) {
+                continue;
+            }
+#    endif
             action = action_for_key(i, key);
             if (action.code != ACTION_TRANSPARENT) {
                 return i;
@@ -157,7 +157,7 @@ void audio_toggle(void) {
         stop_all_notes();
     }
     audio_config.enable ^= 1;
-    eeconfig_update_audio(audio_config.raw);
+    eeconfig_defer_flush(eeconfig_update_audio_current);
     if (audio_config.enable) {
         audio_on_user();
     } else {
@@ -167,7 +167,7 @@ void audio_toggle(void) {
 
 void audio_on(void) {
     audio_config.enable = 1;
-    eeconfig_update_audio(audio_config.raw);
+    eeconfig_defer_flush(eeconfig_update_audio_current);
     audio_on_user();
     PLAY_SONG(audio_on_song);
 }
@@ -178,13 +178,17 @@ void audio_off(void) {
     wait_ms(100);
     audio_stop_all();
     audio_config.enable = 0;
-    eeconfig_update_audio(audio_config.raw);
+    eeconfig_defer_flush(eeconfig_update_audio_current);
 }
 
 bool audio_is_on(void) {
     return (audio_config.enable != 0);
 }
 
+void eeconfig_update_audio_current(void) {
+    eeconfig_update_audio(audio_config.raw);
+}
+
 void audio_stop_all() {
     if (audio_driver_stopped) {
         return;
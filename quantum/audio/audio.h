@@ -88,6 +88,10 @@ void audio_off(void);
  * @brief query the if audio output is enabled
  */
 bool audio_is_on(void);
+/**
+ * @brief write the current audio config to the eeprom
+ */
+void eeconfig_update_audio_current(void);
 
 /**
  * @brief start playback of a tone with the given frequency and duration
@@ -23,6 +23,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 backlight_config_t backlight_config;
 
+// The config as of the last request to write it
+static uint8_t backlight_eeconfig_pending;
+
+static void backlight_eeconfig_flush(void) {
+    eeconfig_update_backlight(backlight_eeconfig_pending);
+}
+
+/* Schedules the current config to be written, without any later _noeeprom changes */
+static void backlight_eeconfig_defer(void) {
+    backlight_eeconfig_pending = backlight_config.raw;
+    eeconfig_defer_flush(backlight_eeconfig_flush);
+}
+
 #ifndef BACKLIGHT_DEFAULT_LEVEL
 #    define BACKLIGHT_DEFAULT_LEVEL BACKLIGHT_LEVELS
 #endif
@@ -58,7 +71,7 @@ void backlight_increase(void) {
         backlight_config.level++;
     }
     backlight_config.enable = 1;
-    eeconfig_update_backlight(backlight_config.raw);
+    backlight_eeconfig_defer();
     dprintf("backlight increase: %u\n", backlight_config.level);
     backlight_set(backlight_config.level);
 }
@@ -71,7 +84,7 @@ void backlight_decrease(void) {
     if (backlight_config.level > 0) {
         backlight_config.level--;
         backlight_config.enable = !!backlight_config.level;
-        eeconfig_update_backlight(backlight_config.raw);
+        backlight_eeconfig_defer();
     }
     dprintf("backlight decrease: %u\n", backlight_config.level);
     backlight_set(backlight_config.level);
@@ -100,7 +113,7 @@ void backlight_enable(void) {
     backlight_config.enable = true;
     if (backlight_config.raw == 1) // enabled but level == 0
         backlight_config.level = 1;
-    eeconfig_update_backlight(backlight_config.raw);
+    backlight_eeconfig_defer();
     dprintf("backlight enable\n");
     backlight_set(backlight_config.level);
 }
@@ -113,7 +126,7 @@ void backlight_disable(void) {
     if (!backlight_config.enable) return; // do nothing if backlight is already off
 
     backlight_config.enable = false;
-    eeconfig_update_backlight(backlight_config.raw);
+    backlight_eeconfig_defer();
     dprintf("backlight disable\n");
     backlight_set(0);
 }
@@ -136,7 +149,7 @@ void backlight_step(void) {
         backlight_config.level = 0;
     }
     backlight_config.enable = !!backlight_config.level;
-    eeconfig_update_backlight(backlight_config.raw);
+    backlight_eeconfig_defer();
     dprintf("backlight step: %u\n", backlight_config.level);
     backlight_set(backlight_config.level);
 }
@@ -157,7 +170,7 @@ void backlight_level_noeeprom(uint8_t level) {
  */
 void backlight_level(uint8_t level) {
     backlight_level_noeeprom(level);
-    eeconfig_update_backlight(backlight_config.raw);
+    backlight_eeconfig_defer();
 }
 
 uint8_t eeconfig_read_backlight(void) {
@@ -165,6 +178,7 @@ uint8_t eeconfig_read_backlight(void) {
 }
 
 void eeconfig_update_backlight(uint8_t val) {
+    backlight_eeconfig_pending = val;
     eeprom_update_byte(EECONFIG_BACKLIGHT, val);
 }
 
@@ -213,7 +227,7 @@ void backlight_enable_breathing(void) {
     if (backlight_config.breathing) return; // do nothing if breathing is already on
 
     backlight_config.breathing = true;
-    eeconfig_update_backlight(backlight_config.raw);
+    backlight_eeconfig_defer();
     dprintf("backlight breathing enable\n");
     breathing_enable();
 }
@@ -226,7 +240,7 @@ void backlight_disable_breathing(void) {
     if (!backlight_config.breathing) return; // do nothing if breathing is already off
 
     backlight_config.breathing = false;
-    eeconfig_update_backlight(backlight_config.raw);
+    backlight_eeconfig_defer();
     dprintf("backlight breathing disable\n");
     breathing_disable();
 }
@@ -579,7 +579,15 @@ static bool command_console(uint8_t code) {
 static void mousekey_param_print(void) {
     xprintf(/* clang-format off */
 
-#ifndef MK_3_SPEED
+#if defined(MK_INTEGRATED_SPEED)
+        "1:	delay(*10ms): %u\n"
+        "2:	interval(ms): %u\n"
+        "3:	curve_step(ms): %u\n"
+
+        , mk_delay
+        , mk_interval
+        , mk_curve_step
+#elif !defined(MK_3_SPEED)
         "1:	delay(*10ms): %u\n"
         "2:	interval(ms): %u\n"
         "3:	max_speed: %u\n"
@@ -613,7 +621,7 @@ static void mousekey_console_help(void) {
         "rt:	-10\n"
         "ESC/q:	quit\n"
 
-#ifndef MK_3_SPEED
+#if !defined(MK_3_SPEED) && !defined(MK_INTEGRATED_SPEED)
         "\n"
         "speed = delta * max_speed * (repeat / time_to_max)\n"
         "where delta: cursor=%d, wheel=%d\n"
@@ -669,7 +677,11 @@ bool mousekey_console(uint8_t code) {
             switch (param) { /* clang-format off */
 #               define PARAM(n, v) case n: pp = &(v); desc = #v; break
 
-#ifndef MK_3_SPEED
+#if defined(MK_INTEGRATED_SPEED)
+                PARAM(1, mk_delay);
+                PARAM(2, mk_interval);
+                PARAM(3, mk_curve_step);
+#elif !defined(MK_3_SPEED)
                 PARAM(1, mk_delay);
                 PARAM(2, mk_interval);
                 PARAM(3, mk_max_speed);
@@ -696,7 +708,11 @@ bool mousekey_console(uint8_t code) {
 
         case KC_D:
 
-#    ifndef MK_3_SPEED
+#    if defined(MK_INTEGRATED_SPEED)
+            mk_delay      = MOUSEKEY_DELAY / 10;
+            mk_interval   = MOUSEKEY_INTERVAL;
+            mk_curve_step = MK_CURVE_STEP;
+#    elif !defined(MK_3_SPEED)
             mk_delay             = MOUSEKEY_DELAY / 10;
             mk_interval          = MOUSEKEY_INTERVAL;
             mk_max_speed         = MOUSEKEY_MAX_SPEED;
@@ -14,6 +14,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include "keymap.h" // to get keymaps[][][]
 #include "eeprom.h"
 #include "progmem.h" // to read default from flash
@@ -98,6 +99,36 @@ _Static_assert((DYNAMIC_KEYMAP_EEPROM_MAX_ADDR) - (DYNAMIC_KEYMAP_MACRO_EEPROM_A
 #    define DYNAMIC_KEYMAP_MACRO_DELAY TAP_CODE_DELAY
 #endif
 
+#define DYNAMIC_KEYMAP_BUFFER_SIZE (DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2)
+
+// Keep a copy of the keymaps in RAM, so that key lookups and transfers to the host don't read
+// EEPROM. AVR doesn't have the RAM to spare.
+#if !defined(DYNAMIC_KEYMAP_NO_RAM_MIRROR) && !defined(__AVR__)
+#    define DYNAMIC_KEYMAP_RAM_MIRROR
+#endif
+
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+// Same layout as the EEPROM, big endian keycodes by layer/row/column
+static uint8_t  dynamic_keymap_mirror[DYNAMIC_KEYMAP_BUFFER_SIZE];
+static uint16_t dynamic_keymap_dirty_start = DYNAMIC_KEYMAP_BUFFER_SIZE;
+static uint16_t dynamic_keymap_dirty_end   = 0;
+
+// Writes the part of the mirror changed by dynamic_keymap_set_buffer()
+static void dynamic_keymap_flush(void) {
+    if (dynamic_keymap_dirty_start < dynamic_keymap_dirty_end) {
+        eeprom_update_block(&dynamic_keymap_mirror[dynamic_keymap_dirty_start], ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + dynamic_keymap_dirty_start, dynamic_keymap_dirty_end - dynamic_keymap_dirty_start);
+    }
+    dynamic_keymap_dirty_start = DYNAMIC_KEYMAP_BUFFER_SIZE;
+    dynamic_keymap_dirty_end   = 0;
+}
+#endif // DYNAMIC_KEYMAP_RAM_MIRROR
+
+void dynamic_keymap_init(void) {
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+    eeprom_read_block(dynamic_keymap_mirror, (void *)DYNAMIC_KEYMAP_EEPROM_ADDR, DYNAMIC_KEYMAP_BUFFER_SIZE);
+#endif
+}
+
 uint8_t dynamic_keymap_get_layer_count(void) {
     return DYNAMIC_KEYMAP_LAYER_COUNT;
 }
@@ -110,15 +141,25 @@ void *dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t c
 uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return KC_NO;
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+    uint16_t offset = address - (void *)DYNAMIC_KEYMAP_EEPROM_ADDR;
+    return (dynamic_keymap_mirror[offset] << 8) | dynamic_keymap_mirror[offset + 1];
+#else
     // Big endian, so we can read/write EEPROM directly from host if we want
     uint16_t keycode = eeprom_read_byte(address) << 8;
     keycode |= eeprom_read_byte(address + 1);
     return keycode;
+#endif
 }
 
 void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return;
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+    uint16_t offset                   = address - (void *)DYNAMIC_KEYMAP_EEPROM_ADDR;
+    dynamic_keymap_mirror[offset]     = keycode >> 8;
+    dynamic_keymap_mirror[offset + 1] = keycode & 0xFF;
+#endif
     // Big endian, so we can read/write EEPROM directly from host if we want
     eeprom_update_byte(address, (uint8_t)(keycode >> 8));
     eeprom_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
@@ -147,58 +188,90 @@ void dynamic_keymap_set_encoder(uint8_t layer, uint8_t encoder_id, bool clockwis
 }
 #endif // ENCODER_MAP_ENABLE
 
-void dynamic_keymap_reset(void) {
-    // Reset the keymaps in EEPROM to what is in flash.
-    for (int layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
-        for (int row = 0; row < MATRIX_ROWS; row++) {
-            for (int column = 0; column < MATRIX_COLS; column++) {
-                if (layer < keymap_layer_count()) {
-                    dynamic_keymap_set_keycode(layer, row, column, keycode_at_keymap_location_raw(layer, row, column));
-                } else {
-                    dynamic_keymap_set_keycode(layer, row, column, KC_TRANSPARENT);
-                }
+void dynamic_keymap_reset_layer(uint8_t layer) {
+    if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT) return;
+    // Reset the keymap in EEPROM to what is in flash.
+    for (int row = 0; row < MATRIX_ROWS; row++) {
+        for (int column = 0; column < MATRIX_COLS; column++) {
+            if (layer < keymap_layer_count()) {
+                dynamic_keymap_set_keycode(layer, row, column, keycode_at_keymap_location_raw(layer, row, column));
+            } else {
+                dynamic_keymap_set_keycode(layer, row, column, KC_TRANSPARENT);
             }
         }
+    }
 #ifdef ENCODER_MAP_ENABLE
-        for (int encoder = 0; encoder < NUM_ENCODERS; encoder++) {
-            if (layer < encodermap_layer_count()) {
-                dynamic_keymap_set_encoder(layer, encoder, true, keycode_at_encodermap_location_raw(layer, encoder, true));
-                dynamic_keymap_set_encoder(layer, encoder, false, keycode_at_encodermap_location_raw(layer, encoder, false));
-            } else {
-                dynamic_keymap_set_encoder(layer, encoder, true, KC_TRANSPARENT);
-                dynamic_keymap_set_encoder(layer, encoder, false, KC_TRANSPARENT);
-            }
+    for (int encoder = 0; encoder < NUM_ENCODERS; encoder++) {
+        if (layer < encodermap_layer_count()) {
+            dynamic_keymap_set_encoder(layer, encoder, true, keycode_at_encodermap_location_raw(layer, encoder, true));
+            dynamic_keymap_set_encoder(layer, encoder, false, keycode_at_encodermap_location_raw(layer, encoder, false));
+        } else {
+            dynamic_keymap_set_encoder(layer, encoder, true, KC_TRANSPARENT);
+            dynamic_keymap_set_encoder(layer, encoder, false, KC_TRANSPARENT);
         }
+    }
 #endif // ENCODER_MAP_ENABLE
+}
+
+void dynamic_keymap_reset(void) {
+    for (int layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        dynamic_keymap_reset_layer(layer);
     }
 }
 
+uint16_t dynamic_keymap_get_buffer_size(void) {
+    return DYNAMIC_KEYMAP_BUFFER_SIZE;
+}
+
 void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   source                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
-    uint8_t *target                     = data;
-    for (uint16_t i = 0; i < size; i++) {
-        if (offset + i < dynamic_keymap_eeprom_size) {
-            *target = eeprom_read_byte(source);
-        } else {
-            *target = 0x00;
-        }
-        source++;
-        target++;
+    uint16_t length = 0;
+    if (offset < DYNAMIC_KEYMAP_BUFFER_SIZE) {
+        length = MIN(size, DYNAMIC_KEYMAP_BUFFER_SIZE - offset);
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+        memcpy(data, &dynamic_keymap_mirror[offset], length);
+#else
+        eeprom_read_block(data, ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + offset, length);
+#endif
     }
+    memset(data + length, 0x00, size - length);
 }
 
 void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   target                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
-    uint8_t *source                     = data;
-    for (uint16_t i = 0; i < size; i++) {
-        if (offset + i < dynamic_keymap_eeprom_size) {
-            eeprom_update_byte(target, *source);
+    if (offset < DYNAMIC_KEYMAP_BUFFER_SIZE) {
+        uint16_t length = MIN(size, DYNAMIC_KEYMAP_BUFFER_SIZE - offset);
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+        // Writes of consecutive chunks end up in a single EEPROM update
+        memcpy(&dynamic_keymap_mirror[offset], data, length);
+        dynamic_keymap_dirty_start = MIN(dynamic_keymap_dirty_start, offset);
+        dynamic_keymap_dirty_end   = MAX(dynamic_keymap_dirty_end, offset + length);
+        eeconfig_defer_flush(dynamic_keymap_flush);
+#else
+        eeprom_update_block(data, ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + offset, length);
+#endif
+    }
+}
+
+// CRC-16/CCITT-FALSE, as computed by binascii.crc_hqx(data, 0xFFFF) on the host
+static uint16_t dynamic_keymap_crc16_update(uint16_t crc, uint8_t data) {
+    crc ^= (uint16_t)data << 8;
+    for (uint8_t i = 0; i < 8; i++) {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+uint16_t dynamic_keymap_get_layer_crc(uint8_t layer) {
+    uint16_t crc = 0xFFFF;
+    if (layer < DYNAMIC_KEYMAP_LAYER_COUNT) {
+        uint8_t row_data[MATRIX_COLS * 2];
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            dynamic_keymap_get_buffer((layer * MATRIX_ROWS + row) * sizeof(row_data), sizeof(row_data), row_data);
+            for (uint8_t i = 0; i < sizeof(row_data); i++) {
+                crc = dynamic_keymap_crc16_update(crc, row_data[i]);
+            }
         }
-        source++;
-        target++;
     }
+    return crc;
 }
 
 uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
@@ -226,28 +299,17 @@ uint16_t dynamic_keymap_macro_get_buffer_size(void) {
 }
 
 void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   source = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
-    uint8_t *target = data;
-    for (uint16_t i = 0; i < size; i++) {
-        if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
-            *target = eeprom_read_byte(source);
-        } else {
-            *target = 0x00;
-        }
-        source++;
-        target++;
+    uint16_t length = 0;
+    if (offset < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
+        length = MIN(size, DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE - offset);
+        eeprom_read_block(data, ((void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR) + offset, length);
     }
+    memset(data + length, 0x00, size - length);
 }
 
 void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   target = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
-    uint8_t *source = data;
-    for (uint16_t i = 0; i < size; i++) {
-        if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
-            eeprom_update_byte(target, *source);
-        }
-        source++;
-        target++;
+    if (offset < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
+        eeprom_update_block(data, ((void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR) + offset, MIN(size, DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE - offset));
     }
 }
 
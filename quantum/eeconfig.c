@@ -4,6 +4,8 @@
 #include "eeprom.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "timer.h"
+#include "debug.h"
 
 #if defined(EEPROM_DRIVER)
 #    include "eeprom_driver.h"
@@ -39,10 +41,17 @@ __attribute__((weak)) void eeconfig_init_kb(void) {
     eeconfig_init_user();
 }
 
+static eeconfig_flush_func_t deferred_flushes[EECONFIG_DEFERRED_MAX_PENDING];
+static uint8_t               deferred_count;
+static uint16_t              deferred_last_change;
+static uint32_t              deferred_writes_avoided;
+
 /*
  * FIXME: needs doc
  */
 void eeconfig_init_quantum(void) {
+    // Anything still pending would overwrite the defaults
+    deferred_count = 0;
 #if defined(EEPROM_DRIVER)
     eeprom_driver_erase();
 #endif
@@ -341,3 +350,58 @@ __attribute__((weak)) void eeconfig_init_user_datablock(void) {
     eeconfig_update_user_datablock(dummy_user);
 }
 #endif // (EECONFIG_USER_DATA_SIZE) > 0
+
+/** \brief Schedules a feature's config to be written once changes have settled
+ *
+ * Scheduling a flush which is already pending counts as a write avoided.
+ */
+void eeconfig_defer_flush(eeconfig_flush_func_t flush) {
+    deferred_last_change = timer_read();
+    for (uint8_t i = 0; i < deferred_count; i++) {
+        if (deferred_flushes[i] == flush) {
+            deferred_writes_avoided++;
+            return;
+        }
+    }
+
+    if (deferred_count == EECONFIG_DEFERRED_MAX_PENDING) {
+        // No room to defer it, so write it now
+        flush();
+        return;
+    }
+    deferred_flushes[deferred_count++] = flush;
+}
+
+/** \brief Writes all pending feature configs
+ *
+ * Call before anything that relies on the EEPROM contents being up to date, such as a reset or power down.
+ */
+void eeconfig_deferred_flush(void) {
+    if (deferred_count == 0) {
+        return;
+    }
+    dprintf("eeconfig: flushing %u deferred writes, %lu writes avoided\n", deferred_count, (unsigned long)deferred_writes_avoided);
+
+    // Flushes may defer further writes, so take the pending list first
+    uint8_t               count = deferred_count;
+    eeconfig_flush_func_t flushes[EECONFIG_DEFERRED_MAX_PENDING];
+    memcpy(flushes, deferred_flushes, sizeof(eeconfig_flush_func_t) * count);
+    deferred_count = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        flushes[i]();
+    }
+}
+
+/** \brief Writes pending feature configs once no change was made for EECONFIG_DEFERRED_FLUSH_MS
+ */
+void eeconfig_deferred_task(void) {
+    if (deferred_count && timer_elapsed(deferred_last_change) >= EECONFIG_DEFERRED_FLUSH_MS) {
+        eeconfig_deferred_flush();
+    }
+}
+
+/** \brief The number of config writes which were merged into an already pending write
+ */
+uint32_t eeconfig_deferred_writes_avoided(void) {
+    return deferred_writes_avoided;
+}
@@ -147,6 +147,27 @@ void eeconfig_update_user_datablock(const void *data);
 void eeconfig_init_user_datablock(void);
 #endif // (EECONFIG_USER_DATA_SIZE) > 0
 
+/*
+    Deferred writes of feature configuration. Features hand over a function
+    that writes their config, and the writes for all pending features happen
+    together once no change was made for EECONFIG_DEFERRED_FLUSH_MS, when the
+    keyboard suspends, or on eeconfig_deferred_flush(). Repeated changes in the
+    meantime only result in a single write.
+*/
+#ifndef EECONFIG_DEFERRED_FLUSH_MS
+#    define EECONFIG_DEFERRED_FLUSH_MS 1000
+#endif
+#ifndef EECONFIG_DEFERRED_MAX_PENDING
+#    define EECONFIG_DEFERRED_MAX_PENDING 8
+#endif
+
+typedef void (*eeconfig_flush_func_t)(void);
+
+void     eeconfig_defer_flush(eeconfig_flush_func_t flush);
+void     eeconfig_deferred_flush(void);
+void     eeconfig_deferred_task(void);
+uint32_t eeconfig_deferred_writes_avoided(void);
+
 // Any "checked" debounce variant used requires implementation of:
 //    -- bool eeconfig_check_valid_##name(void)
 //    -- void eeconfig_post_flush_##name(void)
@@ -156,13 +177,6 @@ void eeconfig_init_user_datablock(void);
     bool eeconfig_check_valid_##name(void);                             \
     void eeconfig_post_flush_##name(void);                              \
                                                                         \
-    static inline void eeconfig_init_##name(void) {                     \
-        dirty_##name = true;                                            \
-        if (eeconfig_check_valid_##name()) {                            \
-            eeprom_read_block(&config, offset, sizeof(config));         \
-            dirty_##name = false;                                       \
-        }                                                               \
-    }                                                                   \
     static inline void eeconfig_flush_##name(bool force) {              \
         if (force || dirty_##name) {                                    \
             eeprom_update_block(&config, offset, sizeof(config));       \
@@ -170,6 +184,23 @@ void eeconfig_init_user_datablock(void);
             dirty_##name = false;                                       \
         }                                                               \
     }                                                                   \
+    static inline void eeconfig_deferred_flush_##name(void) {           \
+        eeconfig_flush_##name(false);                                   \
+    }                                                                   \
+    static inline void eeconfig_flag_##name(bool v) {                   \
+        if (v) {                                                        \
+            dirty_##name = true;                                        \
+            eeconfig_defer_flush(eeconfig_deferred_flush_##name);       \
+        }                                                               \
+    }                                                                   \
+    static inline void eeconfig_init_##name(void) {                     \
+        if (eeconfig_check_valid_##name()) {                            \
+            eeprom_read_block(&config, offset, sizeof(config));         \
+            dirty_##name = false;                                       \
+        } else {                                                        \
+            eeconfig_flag_##name(true);                                 \
+        }                                                               \
+    }                                                                   \
     static inline void eeconfig_flush_##name##_task(uint16_t timeout) { \
         static uint16_t flush_timer = 0;                                \
         if (timer_elapsed(flush_timer) > timeout) {                     \
@@ -177,9 +208,6 @@ void eeconfig_init_user_datablock(void);
             flush_timer = timer_read();                                 \
         }                                                               \
     }                                                                   \
-    static inline void eeconfig_flag_##name(bool v) {                   \
-        dirty_##name |= v;                                              \
-    }                                                                   \
     static inline void eeconfig_write_##name(typeof(config) *conf) {    \
         if (memcmp(&config, conf, sizeof(config)) != 0) {               \
             memcpy(&config, conf, sizeof(config));                      \
@@ -23,6 +23,10 @@
 // for memcpy
 #include <string.h>
 
+#ifdef ENCODER_QEI_DRIVERS
+#    include <hal.h>
+#endif
+
 #ifndef ENCODER_MAP_KEY_DELAY
 #    include "action.h"
 #    define ENCODER_MAP_KEY_DELAY TAP_CODE_DELAY
@@ -36,6 +40,26 @@
 #    error "No encoder pads defined by ENCODERS_PAD_A and ENCODERS_PAD_B"
 #endif
 
+#ifndef ENCODER_QUEUE_SIZE
+#    define ENCODER_QUEUE_SIZE 16
+#endif
+
+#ifndef ENCODER_MAP_QUEUE_SIZE
+#    define ENCODER_MAP_QUEUE_SIZE 8
+#endif
+
+#if defined(ENCODER_INTERRUPTS) && defined(ENCODER_QEI_DRIVERS)
+#    error "ENCODER_INTERRUPTS and ENCODER_QEI_DRIVERS cannot be used together"
+#endif
+
+#if defined(ENCODER_QEI_DRIVERS) && defined(ENCODER_DEFAULT_POS)
+#    error "ENCODER_DEFAULT_POS is not supported with ENCODER_QEI_DRIVERS"
+#endif
+
+#if defined(ENCODER_QEI_DRIVERS) && !defined(ENCODER_QEI_PAL_MODE)
+#    error "ENCODER_QEI_PAL_MODE must be set to the alternate function of the encoder timers' inputs"
+#endif
+
 extern volatile bool isLeftHand;
 
 static pin_t encoders_pad_a[NUM_ENCODERS_MAX_PER_SIDE] = ENCODERS_PAD_A;
@@ -52,10 +76,12 @@ static uint8_t encoder_resolutions[NUM_ENCODERS] = ENCODER_RESOLUTIONS;
 #    define ENCODER_CLOCKWISE false
 #    define ENCODER_COUNTER_CLOCKWISE true
 #endif
+#ifndef ENCODER_QEI_DRIVERS
 static int8_t encoder_LUT[] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
 
-static uint8_t encoder_state[NUM_ENCODERS]  = {0};
-static int8_t  encoder_pulses[NUM_ENCODERS] = {0};
+static uint8_t encoder_state[NUM_ENCODERS] = {0};
+#endif
+static int8_t encoder_pulses[NUM_ENCODERS] = {0};
 
 // encoder counts
 static uint8_t thisCount;
@@ -68,6 +94,37 @@ static uint8_t thatCount;
 
 static uint8_t encoder_value[NUM_ENCODERS] = {0};
 
+// Detents waiting to be processed, each stored as (index << 1 | clockwise) -- written by the decoder, which may run in
+// an interrupt, and read from the scan loop
+static volatile uint8_t encoder_queue[ENCODER_QUEUE_SIZE];
+static volatile uint8_t encoder_queue_head = 0;
+static volatile uint8_t encoder_queue_tail = 0;
+
+#ifdef ENCODER_QEI_DRIVERS
+static QEIDriver *const encoder_qei_drivers[] = ENCODER_QEI_DRIVERS;
+static uint16_t         encoder_qei_count[ARRAY_SIZE(encoder_qei_drivers)];
+
+static const QEIConfig encoder_qei_config = {
+    .mode       = QEI_MODE_QUADRATURE,
+    .resolution = QEI_BOTH_EDGES,
+    .dirinv     = QEI_DIRINV_FALSE,
+};
+#endif // ENCODER_QEI_DRIVERS
+
+#ifdef ENCODER_MAP_ENABLE
+// Taps waiting to be sent, each stored as (index << 1 | clockwise)
+static uint8_t  encoder_map_queue[ENCODER_MAP_QUEUE_SIZE];
+static uint8_t  encoder_map_queue_head = 0;
+static uint8_t  encoder_map_queue_tail = 0;
+static bool     encoder_map_tap_pressed = false;
+static bool     encoder_map_tap_waiting = false;
+static uint16_t encoder_map_tap_timer;
+#endif // ENCODER_MAP_ENABLE
+
+#if defined(ENCODER_INTERRUPTS) && defined(PROTOCOL_CHIBIOS)
+static void encoder_pal_callback(void *arg);
+#endif
+
 __attribute__((weak)) void encoder_wait_pullup_charge(void) {
     wait_us(100);
 }
@@ -100,8 +157,15 @@ void encoder_init(void) {
     // executable doesn't reset any of these. Kinda crappy having test-only code
     // here, but it's the simplest solution.
     memset(encoder_value, 0, sizeof(encoder_value));
+#    ifndef ENCODER_QEI_DRIVERS
     memset(encoder_state, 0, sizeof(encoder_state));
+#    endif
     memset(encoder_pulses, 0, sizeof(encoder_pulses));
+    encoder_queue_head = encoder_queue_tail = 0;
+#    ifdef ENCODER_MAP_ENABLE
+    encoder_map_queue_head = encoder_map_queue_tail = 0;
+    encoder_map_tap_pressed = encoder_map_tap_waiting = false;
+#    endif
     static const pin_t encoders_pad_a_left[] = ENCODERS_PAD_A;
     static const pin_t encoders_pad_b_left[] = ENCODERS_PAD_B;
     for (uint8_t i = 0; i < thisCount; i++) {
@@ -134,6 +198,16 @@ void encoder_init(void) {
     }
 #endif // defined(SPLIT_KEYBOARD) && defined(ENCODER_RESOLUTIONS)
 
+#ifdef ENCODER_QEI_DRIVERS
+    // The pads are the timer's channel 1 and 2 inputs, counted in hardware
+    for (uint8_t i = 0; i < thisCount; i++) {
+        palSetLineMode(encoders_pad_a[i], PAL_MODE_ALTERNATE(ENCODER_QEI_PAL_MODE) | PAL_STM32_PUPDR_PULLUP);
+        palSetLineMode(encoders_pad_b[i], PAL_MODE_ALTERNATE(ENCODER_QEI_PAL_MODE) | PAL_STM32_PUPDR_PULLUP);
+        qeiStart(encoder_qei_drivers[i], &encoder_qei_config);
+        qeiEnable(encoder_qei_drivers[i]);
+        encoder_qei_count[i] = qeiGetCount(encoder_qei_drivers[i]);
+    }
+#else // ENCODER_QEI_DRIVERS
     for (uint8_t i = 0; i < thisCount; i++) {
         setPinInputHigh(encoders_pad_a[i]);
         setPinInputHigh(encoders_pad_b[i]);
@@ -142,26 +216,107 @@ void encoder_init(void) {
     for (uint8_t i = 0; i < thisCount; i++) {
         encoder_state[i] = (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
     }
+#endif // ENCODER_QEI_DRIVERS
+
+#if defined(ENCODER_INTERRUPTS) && defined(PROTOCOL_CHIBIOS)
+    // Pads may be shared between encoders, so every edge decodes all of them
+    for (uint8_t i = 0; i < thisCount; i++) {
+        palEnableLineEvent(encoders_pad_a[i], PAL_EVENT_MODE_BOTH_EDGES);
+        palSetLineCallback(encoders_pad_a[i], encoder_pal_callback, NULL);
+        palEnableLineEvent(encoders_pad_b[i], PAL_EVENT_MODE_BOTH_EDGES);
+        palSetLineCallback(encoders_pad_b[i], encoder_pal_callback, NULL);
+    }
+#endif // defined(ENCODER_INTERRUPTS) && defined(PROTOCOL_CHIBIOS)
+}
+
+static void encoder_queue_event(uint8_t index, bool clockwise) {
+    uint8_t next = (encoder_queue_head + 1) % ENCODER_QUEUE_SIZE;
+    if (next == encoder_queue_tail) {
+        // The scan loop has fallen too far behind, drop the detent
+        return;
+    }
+    encoder_queue[encoder_queue_head] = (index << 1) | clockwise;
+    encoder_queue_head                = next;
 }
 
 #ifdef ENCODER_MAP_ENABLE
 static void encoder_exec_mapping(uint8_t index, bool clockwise) {
-    // The delays below cater for Windows and its wonderful requirements.
-    action_exec(clockwise ? ENCODER_CW_EVENT(index, true) : ENCODER_CCW_EVENT(index, true));
+    uint8_t next = (encoder_map_queue_head + 1) % ENCODER_MAP_QUEUE_SIZE;
+    if (next == encoder_map_queue_tail) {
+        // Too many taps are already waiting, drop this one
+        return;
+    }
+    encoder_map_queue[encoder_map_queue_head] = (index << 1) | clockwise;
+    encoder_map_queue_head                    = next;
+}
+
+// Sends the queued taps one key event at a time. The delays between them cater for Windows and its wonderful
+// requirements, and are timed rather than waited for so that the scan loop keeps running.
+static void encoder_map_task(void) {
 #    if ENCODER_MAP_KEY_DELAY > 0
-    wait_ms(ENCODER_MAP_KEY_DELAY);
+    if (encoder_map_tap_waiting && timer_elapsed(encoder_map_tap_timer) < ENCODER_MAP_KEY_DELAY) {
+        return;
+    }
+    encoder_map_tap_waiting = false;
 #    endif // ENCODER_MAP_KEY_DELAY > 0
 
-    action_exec(clockwise ? ENCODER_CW_EVENT(index, false) : ENCODER_CCW_EVENT(index, false));
+    if (encoder_map_queue_tail == encoder_map_queue_head) {
+        return;
+    }
+
+    uint8_t event   = encoder_map_queue[encoder_map_queue_tail];
+    bool    pressed = !encoder_map_tap_pressed;
+    action_exec((event & 1) ? ENCODER_CW_EVENT(event >> 1, pressed) : ENCODER_CCW_EVENT(event >> 1, pressed));
+    encoder_map_tap_pressed = pressed;
+    if (!pressed) {
+        encoder_map_queue_tail = (encoder_map_queue_tail + 1) % ENCODER_MAP_QUEUE_SIZE;
+    }
+
 #    if ENCODER_MAP_KEY_DELAY > 0
-    wait_ms(ENCODER_MAP_KEY_DELAY);
+    encoder_map_tap_waiting = true;
+    encoder_map_tap_timer   = timer_read();
 #    endif // ENCODER_MAP_KEY_DELAY > 0
 }
 #endif // ENCODER_MAP_ENABLE
 
-static bool encoder_update(uint8_t index, uint8_t state) {
-    bool    changed = false;
-    uint8_t i       = index;
+static void encoder_exec(uint8_t index, bool clockwise) {
+#ifdef ENCODER_MAP_ENABLE
+    encoder_exec_mapping(index, clockwise);
+#else  // ENCODER_MAP_ENABLE
+    encoder_update_kb(index, clockwise);
+#endif // ENCODER_MAP_ENABLE
+}
+
+#ifdef ENCODER_QEI_DRIVERS
+static void encoder_qei_read(void) {
+    for (uint8_t i = 0; i < thisCount; i++) {
+#    ifdef ENCODER_RESOLUTIONS
+        const int8_t resolution = encoder_resolutions[i];
+#    else
+        const int8_t resolution = ENCODER_RESOLUTION;
+#    endif
+#    ifdef SPLIT_KEYBOARD
+        const uint8_t index = i + thisHand;
+#    else
+        const uint8_t index = i;
+#    endif
+        // Each count is one quadrature edge, the same as a step of the lookup table -- a fast spin may have
+        // covered several detents since the last scan
+        uint16_t count       = qeiGetCount(encoder_qei_drivers[i]);
+        int16_t  pulses      = encoder_pulses[i] + (int16_t)(count - encoder_qei_count[i]);
+        encoder_qei_count[i] = count;
+        for (; pulses >= resolution; pulses -= resolution) {
+            encoder_queue_event(index, ENCODER_COUNTER_CLOCKWISE);
+        }
+        for (; pulses <= -resolution; pulses += resolution) {
+            encoder_queue_event(index, ENCODER_CLOCKWISE);
+        }
+        encoder_pulses[i] = pulses;
+    }
+}
+#else // ENCODER_QEI_DRIVERS
+static void encoder_update(uint8_t index, uint8_t state) {
+    uint8_t i = index;
 
 #ifdef ENCODER_RESOLUTIONS
     const uint8_t resolution = encoder_resolutions[i];
@@ -181,16 +336,7 @@ static bool encoder_update(uint8_t index, uint8_t state) {
     if (encoder_pulses[i] >= resolution) {
 #endif
 
-            encoder_value[index]++;
-            changed = true;
-#ifdef SPLIT_KEYBOARD
-            if (should_process_encoder())
-#endif // SPLIT_KEYBOARD
-#ifdef ENCODER_MAP_ENABLE
-                encoder_exec_mapping(index, ENCODER_COUNTER_CLOCKWISE);
-#else  // ENCODER_MAP_ENABLE
-        encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
-#endif // ENCODER_MAP_ENABLE
+            encoder_queue_event(index, ENCODER_COUNTER_CLOCKWISE);
         }
 
 #ifdef ENCODER_DEFAULT_POS
@@ -198,35 +344,68 @@ static bool encoder_update(uint8_t index, uint8_t state) {
 #else
     if (encoder_pulses[i] <= -resolution) { // direction is arbitrary here, but this clockwise
 #endif
-            encoder_value[index]--;
-            changed = true;
-#ifdef SPLIT_KEYBOARD
-            if (should_process_encoder())
-#endif // SPLIT_KEYBOARD
-#ifdef ENCODER_MAP_ENABLE
-                encoder_exec_mapping(index, ENCODER_CLOCKWISE);
-#else  // ENCODER_MAP_ENABLE
-        encoder_update_kb(index, ENCODER_CLOCKWISE);
-#endif // ENCODER_MAP_ENABLE
+            encoder_queue_event(index, ENCODER_CLOCKWISE);
         }
         encoder_pulses[i] %= resolution;
 #ifdef ENCODER_DEFAULT_POS
         encoder_pulses[i] = 0;
     }
 #endif
-    return changed;
 }
 
-bool encoder_read(void) {
-    bool changed = false;
+static void encoder_decode(void) {
     for (uint8_t i = 0; i < thisCount; i++) {
         uint8_t new_status = (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
         if ((encoder_state[i] & 0x3) != new_status) {
             encoder_state[i] <<= 2;
             encoder_state[i] |= new_status;
-            changed |= encoder_update(i, encoder_state[i]);
+            encoder_update(i, encoder_state[i]);
         }
     }
+}
+#endif // ENCODER_QEI_DRIVERS
+
+#ifdef ENCODER_INTERRUPTS
+void encoder_handle_pin_change(void) {
+    encoder_decode();
+}
+
+#    ifdef PROTOCOL_CHIBIOS
+static void encoder_pal_callback(void *arg) {
+    encoder_handle_pin_change();
+}
+#    endif // PROTOCOL_CHIBIOS
+#endif     // ENCODER_INTERRUPTS
+
+bool encoder_read(void) {
+#if defined(ENCODER_QEI_DRIVERS)
+    encoder_qei_read();
+#elif !defined(ENCODER_INTERRUPTS)
+    encoder_decode();
+#endif
+
+    bool changed = false;
+    while (encoder_queue_tail != encoder_queue_head) {
+        uint8_t event      = encoder_queue[encoder_queue_tail];
+        encoder_queue_tail = (encoder_queue_tail + 1) % ENCODER_QUEUE_SIZE;
+
+        uint8_t index     = event >> 1;
+        bool    clockwise = event & 1;
+        if (clockwise == ENCODER_CLOCKWISE) {
+            encoder_value[index]--;
+        } else {
+            encoder_value[index]++;
+        }
+        changed = true;
+#ifdef SPLIT_KEYBOARD
+        if (should_process_encoder())
+#endif // SPLIT_KEYBOARD
+            encoder_exec(index, clockwise);
+    }
+
+#ifdef ENCODER_MAP_ENABLE
+    encoder_map_task();
+#endif // ENCODER_MAP_ENABLE
     return changed;
 }
 
@@ -246,21 +425,13 @@ void encoder_update_raw(uint8_t *slave_state) {
             delta--;
             encoder_value[index]++;
             changed = true;
-#    ifdef ENCODER_MAP_ENABLE
-            encoder_exec_mapping(index, ENCODER_COUNTER_CLOCKWISE);
-#    else  // ENCODER_MAP_ENABLE
-            encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
-#    endif // ENCODER_MAP_ENABLE
+            encoder_exec(index, ENCODER_COUNTER_CLOCKWISE);
         }
         while (delta < 0) {
             delta++;
             encoder_value[index]--;
             changed = true;
-#    ifdef ENCODER_MAP_ENABLE
-            encoder_exec_mapping(index, ENCODER_CLOCKWISE);
-#    else  // ENCODER_MAP_ENABLE
-            encoder_update_kb(index, ENCODER_CLOCKWISE);
-#    endif // ENCODER_MAP_ENABLE
+            encoder_exec(index, ENCODER_CLOCKWISE);
         }
     }
 
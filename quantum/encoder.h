@@ -23,6 +23,10 @@
 void encoder_init(void);
 bool encoder_read(void);
 
+#ifdef ENCODER_INTERRUPTS
+void encoder_handle_pin_change(void);
+#endif // ENCODER_INTERRUPTS
+
 bool encoder_update_kb(uint8_t index, bool clockwise);
 bool encoder_update_user(uint8_t index, bool clockwise);
 
@@ -0,0 +1,128 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+
+extern "C" {
+#include "encoder.h"
+#include "encoder/tests/mock.h"
+}
+
+struct update {
+    int8_t index;
+    bool   clockwise;
+};
+
+uint8_t updates_array_idx = 0;
+update  updates[32];
+
+bool encoder_update_kb(uint8_t index, bool clockwise) {
+    updates[updates_array_idx % 32] = {index, clockwise};
+    updates_array_idx++;
+    return true;
+}
+
+// Changes a pin as the hardware would, decoding the edge in the "interrupt"
+void setAndInterrupt(pin_t pin, bool val) {
+    setPin(pin, val);
+    encoder_handle_pin_change();
+}
+
+void clockwiseDetent(pin_t pin_a, pin_t pin_b) {
+    setAndInterrupt(pin_a, false);
+    setAndInterrupt(pin_b, false);
+    setAndInterrupt(pin_a, true);
+    setAndInterrupt(pin_b, true);
+}
+
+void counterClockwiseDetent(pin_t pin_a, pin_t pin_b) {
+    setAndInterrupt(pin_b, false);
+    setAndInterrupt(pin_a, false);
+    setAndInterrupt(pin_b, true);
+    setAndInterrupt(pin_a, true);
+}
+
+class EncoderInterruptTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        updates_array_idx = 0;
+        encoder_init();
+    }
+};
+
+TEST_F(EncoderInterruptTest, TestCallbacksWaitForScan) {
+    clockwiseDetent(0, 1);
+    EXPECT_EQ(updates_array_idx, 0);
+
+    EXPECT_TRUE(encoder_read());
+    EXPECT_EQ(updates_array_idx, 1);
+    EXPECT_EQ(updates[0].index, 0);
+    EXPECT_EQ(updates[0].clockwise, true);
+
+    EXPECT_FALSE(encoder_read());
+    EXPECT_EQ(updates_array_idx, 1);
+}
+
+TEST_F(EncoderInterruptTest, TestScanDoesNotPoll) {
+    // Pin changes without an interrupt aren't seen
+    setPin(0, false);
+    setPin(1, false);
+    setPin(0, true);
+    setPin(1, true);
+    EXPECT_FALSE(encoder_read());
+    EXPECT_EQ(updates_array_idx, 0);
+}
+
+TEST_F(EncoderInterruptTest, TestFastSpinBetweenScans) {
+    // A fast spin covers several detents, in both directions and on both encoders, between two scans
+    clockwiseDetent(0, 1);
+    clockwiseDetent(2, 3);
+    clockwiseDetent(0, 1);
+    counterClockwiseDetent(0, 1);
+    counterClockwiseDetent(2, 3);
+    EXPECT_EQ(updates_array_idx, 0);
+
+    EXPECT_TRUE(encoder_read());
+    EXPECT_EQ(updates_array_idx, 5);
+    EXPECT_EQ(updates[0].index, 0);
+    EXPECT_EQ(updates[0].clockwise, true);
+    EXPECT_EQ(updates[1].index, 1);
+    EXPECT_EQ(updates[1].clockwise, true);
+    EXPECT_EQ(updates[2].index, 0);
+    EXPECT_EQ(updates[2].clockwise, true);
+    EXPECT_EQ(updates[3].index, 0);
+    EXPECT_EQ(updates[3].clockwise, false);
+    EXPECT_EQ(updates[4].index, 1);
+    EXPECT_EQ(updates[4].clockwise, false);
+}
+
+TEST_F(EncoderInterruptTest, TestQueueOverflow) {
+    // The queue holds ENCODER_QUEUE_SIZE - 1 detents, later ones are dropped until the next scan
+    for (int i = 0; i < 10; i++) {
+        clockwiseDetent(0, 1);
+    }
+    EXPECT_TRUE(encoder_read());
+    EXPECT_EQ(updates_array_idx, 7);
+
+    counterClockwiseDetent(0, 1);
+    EXPECT_TRUE(encoder_read());
+    EXPECT_EQ(updates_array_idx, 8);
+    EXPECT_EQ(updates[7].clockwise, false);
+}
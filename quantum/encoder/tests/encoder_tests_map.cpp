@@ -0,0 +1,108 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+
+extern "C" {
+// encoder.h declares encoder_map with a size that can't be evaluated in C++
+#include "keyboard.h"
+#include "timer.h"
+#include "encoder/tests/mock.h"
+
+void encoder_init(void);
+bool encoder_read(void);
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+std::vector<keyevent_t> events;
+
+extern "C" void action_exec(keyevent_t event) {
+    events.push_back(event);
+}
+
+bool setAndRead(pin_t pin, bool val) {
+    setPin(pin, val);
+    return encoder_read();
+}
+
+void expectEvent(size_t idx, bool clockwise, bool pressed) {
+    ASSERT_LT(idx, events.size());
+    EXPECT_EQ(events[idx].key.row, clockwise ? KEYLOC_ENCODER_CW : KEYLOC_ENCODER_CCW);
+    EXPECT_EQ(events[idx].key.col, 0);
+    EXPECT_EQ(events[idx].pressed, pressed);
+}
+
+class EncoderMapTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        events.clear();
+        set_time(1000);
+        encoder_init();
+    }
+};
+
+TEST_F(EncoderMapTest, TestTapIsNotBlocking) {
+    setAndRead(0, false);
+    setAndRead(1, false);
+    setAndRead(0, true);
+    EXPECT_TRUE(setAndRead(1, true));
+
+    // The press is sent straight away, without waiting for the release
+    EXPECT_EQ(timer_read(), 1000);
+    ASSERT_EQ(events.size(), 1);
+    expectEvent(0, true, true);
+
+    advance_time(ENCODER_MAP_KEY_DELAY - 1);
+    encoder_read();
+    EXPECT_EQ(events.size(), 1);
+
+    advance_time(1);
+    encoder_read();
+    ASSERT_EQ(events.size(), 2);
+    expectEvent(1, true, false);
+}
+
+TEST_F(EncoderMapTest, TestQueuedTaps) {
+    // Two detents in quick succession, the second waits for the first tap to finish
+    setAndRead(0, false);
+    setAndRead(1, false);
+    setAndRead(0, true);
+    setAndRead(1, true);
+    setAndRead(1, false);
+    setAndRead(0, false);
+    setAndRead(1, true);
+    setAndRead(0, true);
+    ASSERT_EQ(events.size(), 1);
+    expectEvent(0, true, true);
+
+    for (int i = 0; i < 4; i++) {
+        advance_time(ENCODER_MAP_KEY_DELAY);
+        encoder_read();
+    }
+    ASSERT_EQ(events.size(), 4);
+    expectEvent(1, true, false);
+    expectEvent(2, false, true);
+    expectEvent(3, false, false);
+
+    advance_time(ENCODER_MAP_KEY_DELAY);
+    encoder_read();
+    EXPECT_EQ(events.size(), 4);
+}
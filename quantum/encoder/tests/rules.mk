@@ -66,3 +66,21 @@ encoder_split_role_SRC := \
 	$(QUANTUM_PATH)/encoder/tests/mock_split.c \
 	$(QUANTUM_PATH)/encoder/tests/encoder_tests_split_role.cpp \
 	$(QUANTUM_PATH)/encoder.c
+
+encoder_interrupts_DEFS := -DENCODER_TESTS -DENCODER_ENABLE -DENCODER_MOCK_SINGLE -DENCODER_INTERRUPTS
+encoder_interrupts_CONFIG := $(QUANTUM_PATH)/encoder/tests/config_mock_interrupts.h
+
+encoder_interrupts_SRC := \
+	platforms/test/timer.c \
+	$(QUANTUM_PATH)/encoder/tests/mock.c \
+	$(QUANTUM_PATH)/encoder/tests/encoder_tests_interrupts.cpp \
+	$(QUANTUM_PATH)/encoder.c
+
+encoder_map_DEFS := -DENCODER_TESTS -DENCODER_ENABLE -DENCODER_MOCK_SINGLE -DENCODER_MAP_ENABLE
+encoder_map_CONFIG := $(QUANTUM_PATH)/encoder/tests/config_mock_map.h
+
+encoder_map_SRC := \
+	platforms/test/timer.c \
+	$(QUANTUM_PATH)/encoder/tests/mock.c \
+	$(QUANTUM_PATH)/encoder/tests/encoder_tests_map.cpp \
+	$(QUANTUM_PATH)/encoder.c
@@ -19,6 +19,7 @@
 #include "debug.h"
 #include "usb_device_state.h"
 #include "gpio.h"
+#include "timer.h"
 #ifdef DRV2605L
 #    include "DRV2605L.h"
 #endif
@@ -26,8 +27,23 @@
 #    include "solenoid.h"
 #endif
 
+// The most effects played at once, the length of the DRV2605L waveform sequencer
+#ifndef HAPTIC_QUEUE_SIZE
+#    define HAPTIC_QUEUE_SIZE 8
+#endif
+
+// Effects queued within this many ms of the last ones played are played together
+#ifndef HAPTIC_QUEUE_INTERVAL
+#    define HAPTIC_QUEUE_INTERVAL 20
+#endif
+
 haptic_config_t haptic_config;
 
+// Effects are played from haptic_task() rather than as keys are processed
+static uint8_t  haptic_queue[HAPTIC_QUEUE_SIZE];
+static uint8_t  haptic_queue_length = 0;
+static uint16_t haptic_queue_played = 0;
+
 static void update_haptic_enable_gpios(void) {
     if (haptic_config.enable && ((!HAPTIC_OFF_IN_LOW_POWER) || (usb_device_state == USB_DEVICE_STATE_CONFIGURED))) {
 #if defined(HAPTIC_ENABLE_PIN)
@@ -91,7 +107,21 @@ void haptic_init(void) {
 #endif
 }
 
+static void haptic_queue_play(void) {
+#ifdef DRV2605L
+    DRV_sequence(haptic_queue, haptic_queue_length);
+#endif
+#ifdef SOLENOID_ENABLE
+    solenoid_fire_handler();
+#endif
+    haptic_queue_length = 0;
+    haptic_queue_played = timer_read();
+}
+
 void haptic_task(void) {
+    if (haptic_queue_length > 0 && timer_elapsed(haptic_queue_played) >= HAPTIC_QUEUE_INTERVAL) {
+        haptic_queue_play();
+    }
 #ifdef SOLENOID_ENABLE
     solenoid_check();
 #endif
@@ -315,14 +345,17 @@ void haptic_cont_decrease(void) {
 }
 
 void haptic_play(void) {
-#ifdef DRV2605L
-    uint8_t play_eff = 0;
-    play_eff         = haptic_config.mode;
-    DRV_pulse(play_eff);
-#endif
-#ifdef SOLENOID_ENABLE
-    solenoid_fire_handler();
-#endif
+    // Rapid fire events are felt as one
+    if (haptic_queue_length > 0 && haptic_queue[haptic_queue_length - 1] == haptic_config.mode) {
+        return;
+    }
+    haptic_play_sequence((uint8_t[]){haptic_config.mode}, 1);
+}
+
+void haptic_play_sequence(const uint8_t *effects, uint8_t length) {
+    while (length-- > 0 && haptic_queue_length < HAPTIC_QUEUE_SIZE) {
+        haptic_queue[haptic_queue_length++] = *effects++;
+    }
 }
 
 void haptic_shutdown(void) {
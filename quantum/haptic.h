@@ -73,7 +73,9 @@ void    haptic_toggle_continuous(void);
 void    haptic_cont_increase(void);
 void    haptic_cont_decrease(void);
 
+// Effects are queued, and played together from haptic_task()
 void haptic_play(void);
+void haptic_play_sequence(const uint8_t *effects, uint8_t length);
 void haptic_shutdown(void);
 void haptic_notify_usb_device_state_change(void);
 
@@ -87,6 +87,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef EEPROM_DRIVER
 #    include "eeprom_driver.h"
 #endif
+#ifdef EEPROM_WRITE_CACHE_ENABLE
+#    include "eeprom_write_cache.h"
+#endif
+#ifdef EEPROM_WEAR_LEVELING
+#    include "eeprom_wear_leveling.h"
+#endif
 #if defined(CRC_ENABLE)
 #    include "crc.h"
 #endif
@@ -348,6 +354,9 @@ void quantum_init(void) {
 void keyboard_init(void) {
     timer_init();
     sync_timer_init();
+#ifdef DYNAMIC_KEYMAP_ENABLE
+    dynamic_keymap_init();
+#endif
 #ifdef VIA_ENABLE
     via_init();
 #endif
@@ -546,6 +555,10 @@ void quantum_task(void) {
     combo_task();
 #endif
 
+#ifdef STENO_ENABLE
+    steno_task();
+#endif
+
 #ifdef WPM_ENABLE
     decay_wpm();
 #endif
@@ -573,6 +586,10 @@ void quantum_task(void) {
 
 /** \brief Main task that is repeatedly called as fast as possible. */
 void keyboard_task(void) {
+#ifdef POINTING_DEVICE_ENABLE
+    pointing_device_read_start();
+#endif
+
     const bool matrix_changed = matrix_task();
     if (matrix_changed) {
         last_matrix_activity_trigger();
@@ -643,6 +660,7 @@ void keyboard_task(void) {
 
 #ifdef POINTING_DEVICE_ENABLE
     pointing_device_task();
+    pointing_device_read_end();
 #endif
 
 #ifdef MIDI_ENABLE
@@ -663,5 +681,15 @@ void keyboard_task(void) {
     bluetooth_task();
 #endif
 
+    eeconfig_deferred_task();
+
+#ifdef EEPROM_WRITE_CACHE_ENABLE
+    eeprom_write_cache_task();
+#endif
+
+#ifdef EEPROM_WEAR_LEVELING
+    eeprom_wear_leveling_task();
+#endif
+
     led_task();
 }
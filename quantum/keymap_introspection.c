@@ -19,6 +19,62 @@ uint8_t keymap_layer_count(void) {
 
 _Static_assert(NUM_KEYMAP_LAYERS <= MAX_LAYER, "Number of keymap layers exceeds maximum set by LAYER_STATE_(8|16|32)BIT");
 
+#ifdef KEYMAP_COMPRESSED
+
+#    define COMPRESSED_KEYMAP_KEYS (MATRIX_ROWS * MATRIX_COLS)
+#    define COMPRESSED_KEYMAP_WORDS ((COMPRESSED_KEYMAP_KEYS + 31) / 32)
+
+// Each layer only stores the keycodes which differ from its filler, KC_TRNS or KC_NO, with a bit set
+// for each of those keys (by row * MATRIX_COLS + column) so that they can be found without a search.
+typedef struct compressed_keymap_layer_t {
+    uint32_t        bitmap[COMPRESSED_KEYMAP_WORDS];
+    uint16_t        rank[COMPRESSED_KEYMAP_WORDS]; // number of keycodes stored for the words of the bitmap before this one
+    uint16_t        filler;
+    const uint16_t *keycodes;
+} compressed_keymap_layer_t;
+
+// Generated from the keymap by `qmk generate-compressed-keymap`, declaring:
+//  compressed_keymap_present, the keys in the keymap's layout, the rest of the matrix is KC_NO on every layer
+//  compressed_keymap, the layers
+#    include "compressed_keymap.h"
+
+_Static_assert(sizeof(compressed_keymap) / sizeof(compressed_keymap[0]) == NUM_KEYMAP_LAYERS, "compressed_keymap.h doesn't match the keymap, it needs to be regenerated");
+
+static inline bool compressed_keymap_bit(const uint32_t *bitmap, uint16_t key) {
+    return pgm_read_dword(&bitmap[key / 32]) & ((uint32_t)1 << (key % 32));
+}
+
+uint16_t keycode_at_keymap_location_raw(uint8_t layer_num, uint8_t row, uint8_t column) {
+    if (layer_num < NUM_KEYMAP_LAYERS && row < MATRIX_ROWS && column < MATRIX_COLS) {
+        uint16_t key = row * MATRIX_COLS + column;
+        if (!compressed_keymap_bit(compressed_keymap_present, key)) {
+            return KC_NO;
+        }
+
+        const compressed_keymap_layer_t *layer = &compressed_keymap[layer_num];
+        uint32_t                         word  = pgm_read_dword(&layer->bitmap[key / 32]);
+        uint32_t                         bit   = (uint32_t)1 << (key % 32);
+        if (!(word & bit)) {
+            return pgm_read_word(&layer->filler);
+        }
+
+        // The keycode's index is the number of keycodes stored before it
+        const uint16_t *keycodes = pgm_read_ptr(&layer->keycodes);
+        return pgm_read_word(&keycodes[pgm_read_word(&layer->rank[key / 32]) + __builtin_popcountl(word & (bit - 1))]);
+    }
+    return KC_NO;
+}
+
+bool keymap_location_is_transparent_raw(uint8_t layer_num, uint8_t row, uint8_t column) {
+    if (layer_num < NUM_KEYMAP_LAYERS && row < MATRIX_ROWS && column < MATRIX_COLS) {
+        uint16_t key = row * MATRIX_COLS + column;
+        return compressed_keymap_bit(compressed_keymap_present, key) && !compressed_keymap_bit(compressed_keymap[layer_num].bitmap, key) && pgm_read_word(&compressed_keymap[layer_num].filler) == KC_TRNS;
+    }
+    return false;
+}
+
+#else
+
 uint16_t keycode_at_keymap_location_raw(uint8_t layer_num, uint8_t row, uint8_t column) {
     if (layer_num < NUM_KEYMAP_LAYERS && row < MATRIX_ROWS && column < MATRIX_COLS) {
         return pgm_read_word(&keymaps[layer_num][row][column]);
@@ -26,6 +82,8 @@ uint16_t keycode_at_keymap_location_raw(uint8_t layer_num, uint8_t row, uint8_t
     return KC_NO;
 }
 
+#endif // KEYMAP_COMPRESSED
+
 __attribute__((weak)) uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
     return keycode_at_keymap_location_raw(layer_num, row, column);
 }
@@ -12,6 +12,13 @@ uint16_t keycode_at_keymap_location_raw(uint8_t layer_num, uint8_t row, uint8_t
 // Get the keycode for the keymap location, potentially stored dynamically
 uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column);
 
+#ifdef KEYMAP_COMPRESSED
+#    include <stdbool.h>
+
+// Check whether the keymap location is KC_TRNS, stored in firmware, without reading its keycode
+bool keymap_location_is_transparent_raw(uint8_t layer_num, uint8_t row, uint8_t column);
+#endif // KEYMAP_COMPRESSED
+
 #if defined(ENCODER_ENABLE) && defined(ENCODER_MAP_ENABLE)
 
 // Get the number of layers defined in the encoder map
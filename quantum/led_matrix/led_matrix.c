@@ -263,7 +263,6 @@ static void led_task_timers(void) {
 }
 
 static void led_task_sync(void) {
-    eeconfig_flush_led_matrix(false);
     // next task
     if (sync_timer_elapsed32(g_led_timer) >= LED_MATRIX_LED_FLUSH_LIMIT) led_task_state = STARTING;
 }
@@ -0,0 +1,292 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdarg.h>
+#include <string.h>
+#include "binary_log.h"
+#include "timer.h"
+
+static uint8_t  buffer[CONSOLE_BINARY_BUFFER_SIZE];
+static uint16_t buffer_head;
+static uint16_t buffer_count;
+static uint8_t  record_remaining; /* bytes of the record being drained that are still in the buffer */
+static uint16_t dropped;
+static uint16_t last_write;
+static uint8_t  text[1 + 4 + BINARY_LOG_TEXT_MAX]; /* record of the raw characters gathered so far */
+static uint8_t  text_length;
+static uint16_t last_char;
+
+static uint8_t put_u32(uint8_t *record, uint8_t length, uint32_t value) {
+    if (length + 4 > BINARY_LOG_RECORD_MAX) {
+        return length;
+    }
+    for (uint8_t i = 0; i < 4; i++) {
+        record[length++] = value >> (8 * i);
+    }
+    return length;
+}
+
+static uint8_t put_u64(uint8_t *record, uint8_t length, uint64_t value) {
+    if (length + 8 > BINARY_LOG_RECORD_MAX) {
+        return length;
+    }
+    length = put_u32(record, length, (uint32_t)value);
+    return put_u32(record, length, (uint32_t)(value >> 32));
+}
+
+static bool buffer_write(const uint8_t *record, uint8_t length) {
+    if (length > CONSOLE_BINARY_BUFFER_SIZE - buffer_count) {
+        return false;
+    }
+    for (uint8_t i = 0; i < length; i++) {
+        buffer[(buffer_head + buffer_count++) % CONSOLE_BINARY_BUFFER_SIZE] = record[i];
+    }
+    last_write = timer_read();
+    return true;
+}
+
+/* Reports lost messages once there is room again, ahead of the next message */
+static bool write_dropped(void) {
+    uint8_t record[1 + 4 + 4];
+    uint8_t length = 1;
+
+    if (!dropped) {
+        return true;
+    }
+    length    = put_u32(record, length, BINARY_LOG_DROPPED_ID);
+    length    = put_u32(record, length, dropped);
+    record[0] = length - 1;
+    if (!buffer_write(record, length)) {
+        return false;
+    }
+    dropped = 0;
+    return true;
+}
+
+/* Queues a complete record, counting it as lost if there is no room */
+static void queue_record(const uint8_t *record, uint8_t length) {
+    if (!write_dropped() || !buffer_write(record, length)) {
+        if (dropped < UINT16_MAX) {
+            dropped++;
+        }
+    }
+}
+
+/* Queues the raw characters gathered so far */
+static void text_flush(void) {
+    if (!text_length) {
+        return;
+    }
+    uint8_t length = put_u32(text, 1, BINARY_LOG_TEXT_ID) + text_length;
+    text[0]        = length - 1;
+    text_length    = 0;
+    queue_record(text, length);
+}
+
+/* Queues a record behind any raw characters logged before it */
+static void binary_log_write(const uint8_t *record, uint8_t length) {
+    text_flush();
+    queue_record(record, length);
+}
+
+/** \brief Log a message
+ *
+ * Takes the same arguments as printf, but only walks the format string to find out how to store the arguments. The
+ * arguments following a conversion that isn't supported are not stored, as their size is unknown.
+ */
+void binary_log(const char *fmt, ...) {
+    uint8_t record[BINARY_LOG_RECORD_MAX];
+    uint8_t length      = 1;
+    bool    unsupported = false;
+    va_list args;
+
+    length = put_u32(record, length, (uint32_t)(uintptr_t)fmt);
+
+    va_start(args, fmt);
+    for (const char *p = fmt; *p && !unsupported; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        p++;
+        // flags, width and precision
+        while (*p && strchr("-+ #0123456789.*", *p)) {
+            if (*p == '*') {
+                length = put_u32(record, length, va_arg(args, int));
+            }
+            p++;
+        }
+        bool is_long        = false;
+        bool is_long_long   = false;
+        bool is_long_double = false;
+        while (*p && strchr("hlzjtL", *p)) {
+            if (*p == 'l') {
+                is_long_long = is_long;
+                is_long      = true;
+            } else if (*p == 'j') {
+                is_long_long = true;
+            } else if (*p == 'z' || *p == 't') {
+                is_long = true;
+            } else if (*p == 'L') {
+                is_long_double = true;
+            }
+            p++;
+        }
+        switch (*p) {
+            case '\0':
+                p--;
+                break;
+            case '%':
+                break;
+            case 's': {
+                const char *s = va_arg(args, const char *);
+                // truncated to fit, terminated unless the record is full
+                while (*s && length < BINARY_LOG_RECORD_MAX - 1) {
+                    record[length++] = *s++;
+                }
+                if (length < BINARY_LOG_RECORD_MAX) {
+                    record[length++] = '\0';
+                }
+                break;
+            }
+            case 'p':
+                length = put_u32(record, length, (uint32_t)(uintptr_t)va_arg(args, void *));
+                break;
+            case 'c':
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+            case 'b':
+                if (is_long_long) {
+                    length = put_u64(record, length, (uint64_t)va_arg(args, long long));
+                } else {
+                    length = put_u32(record, length, is_long ? (uint32_t)va_arg(args, long) : (uint32_t)va_arg(args, int));
+                }
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A': {
+                // stored as an IEEE 754 double
+                double   value = is_long_double ? (double)va_arg(args, long double) : va_arg(args, double);
+                uint64_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                length = put_u64(record, length, bits);
+                break;
+            }
+            default:
+                unsupported = true;
+                break;
+        }
+    }
+    va_end(args);
+
+    record[0] = length - 1;
+    binary_log_write(record, length);
+}
+
+/** \brief Log a string as is
+ *
+ * Used for print(), where the string is text rather than a format string.
+ */
+void binary_log_literal(const char *s) {
+    uint8_t record[1 + 4 + 4];
+    uint8_t length = 1;
+
+    length    = put_u32(record, length, BINARY_LOG_LITERAL_ID);
+    length    = put_u32(record, length, (uint32_t)(uintptr_t)s);
+    record[0] = length - 1;
+    binary_log_write(record, length);
+}
+
+/** \brief Log a raw character
+ *
+ * Used by sendchar(), so that output that doesn't go through the print functions, such as printf(), still reaches the
+ * host. Characters are sent once a line is complete, the record is full, or nothing was logged for
+ * CONSOLE_BINARY_FLUSH_MS.
+ */
+void binary_log_char(uint8_t c) {
+    text[1 + 4 + text_length++] = c;
+    last_char                   = timer_read();
+    if (c == '\n' || text_length == BINARY_LOG_TEXT_MAX) {
+        text_flush();
+    }
+}
+
+/** \brief Check whether a packet is due
+ *
+ * Full packets go out right away, a partly filled one once nothing was logged for CONSOLE_BINARY_FLUSH_MS.
+ */
+bool binary_log_packet_ready(uint8_t size) {
+    // an unfinished line has waited long enough as well
+    if (text_length && timer_elapsed(last_char) >= CONSOLE_BINARY_FLUSH_MS) {
+        text_flush();
+        return true;
+    }
+    if (buffer_count >= size - 1) {
+        return true;
+    }
+    return (buffer_count || dropped) && timer_elapsed(last_write) >= CONSOLE_BINARY_FLUSH_MS;
+}
+
+/** \brief Move logged bytes into a console packet
+ *
+ * \return number of logged bytes in the packet
+ */
+uint8_t binary_log_packet(uint8_t *packet, uint8_t size) {
+    uint8_t length = 1;
+
+    write_dropped();
+
+    packet[0] = BINARY_LOG_NO_RECORD;
+    while (length < size && buffer_count) {
+        uint8_t byte = buffer[buffer_head];
+        if (record_remaining == 0) {
+            // length byte, a new record starts here
+            if (packet[0] == BINARY_LOG_NO_RECORD) {
+                packet[0] = length - 1;
+            }
+            record_remaining = byte + 1;
+        }
+        record_remaining--;
+        packet[length++] = byte;
+        buffer_head      = (buffer_head + 1) % CONSOLE_BINARY_BUFFER_SIZE;
+        buffer_count--;
+    }
+    memset(&packet[length], 0, size - length);
+
+    // queue the lost message count as soon as there is room, so that it goes out with the next packet
+    write_dropped();
+    return length - 1;
+}
+
+uint16_t binary_log_pending(void) {
+    return buffer_count;
+}
+
+void binary_log_clear(void) {
+    buffer_head      = 0;
+    buffer_count     = 0;
+    record_remaining = 0;
+    dropped          = 0;
+    text_length      = 0;
+}
@@ -0,0 +1,75 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Binary console logging
+ *
+ * Instead of formatting text on the keyboard, each message is stored as the address of its format string followed by
+ * the raw arguments. The format strings stay in the firmware image, where `qmk console-decode` looks them up to
+ * rebuild the text on the host.
+ *
+ * Record:  [length] [format string address, 4 bytes LE] [arguments]
+ *          length counts the bytes after itself. Integer arguments (including `*` widths) take 4 bytes LE, `ll` and
+ *          `j` integers and floating point arguments (as doubles) 8 bytes LE, `%s` arguments are copied up to their NUL
+ *          terminator. Arguments following an unsupported conversion are not stored.
+ *          Strings logged by print() are not format strings: their records have the address BINARY_LOG_LITERAL_ID,
+ *          followed by the address of the string.
+ *          Raw characters sent through sendchar(), e.g. by printf(), are gathered into records with the address
+ *          BINARY_LOG_TEXT_ID followed by the characters themselves, up to the end of a line or BINARY_LOG_TEXT_MAX.
+ * Packet:  [offset of the first record starting in this packet, or 0xFF] [records...] [zero padding]
+ *          Records may continue into the next packet, padding only follows a complete record.
+ */
+
+#ifndef CONSOLE_BINARY_BUFFER_SIZE
+#    define CONSOLE_BINARY_BUFFER_SIZE 256
+#endif
+#ifndef CONSOLE_BINARY_FLUSH_MS
+#    define CONSOLE_BINARY_FLUSH_MS 10
+#endif
+
+#if CONSOLE_BINARY_BUFFER_SIZE < 255
+#    define BINARY_LOG_RECORD_MAX CONSOLE_BINARY_BUFFER_SIZE
+#else
+#    define BINARY_LOG_RECORD_MAX 255
+#endif
+/* Format string address of the record counting messages lost to a full buffer */
+#define BINARY_LOG_DROPPED_ID 0
+/* Format string address of the records of print() strings */
+#define BINARY_LOG_LITERAL_ID 1
+/* Format string address of the records of raw characters */
+#define BINARY_LOG_TEXT_ID 2
+#define BINARY_LOG_NO_RECORD 0xFF
+
+/* Raw characters gathered before they are logged, even without the end of a line */
+#if BINARY_LOG_RECORD_MAX < 1 + 4 + 32
+#    define BINARY_LOG_TEXT_MAX (BINARY_LOG_RECORD_MAX - 1 - 4)
+#else
+#    define BINARY_LOG_TEXT_MAX 32
+#endif
+
+void binary_log(const char *fmt, ...);
+void binary_log_literal(const char *s);
+void binary_log_char(uint8_t c);
+
+bool    binary_log_packet_ready(uint8_t size);
+uint8_t binary_log_packet(uint8_t *packet, uint8_t size);
+
+uint16_t binary_log_pending(void);
+void     binary_log_clear(void);
@@ -49,7 +49,18 @@ void print_set_sendchar(sendchar_func_t func);
     } while (0)
 
 #ifndef NO_PRINT
-#    if __has_include_next("_print.h")
+#    if defined(CONSOLE_BINARY_ENABLE)
+// Log format string addresses and raw arguments, decoded by `qmk console-decode`
+#        include "binary_log.h"
+
+#        define print(s) binary_log_literal(s)
+#        define println(s) binary_log_literal(s "\r\n")
+#        define xprintf binary_log
+#        define uprint(s) binary_log_literal(s)
+#        define uprintln(s) binary_log_literal(s "\r\n")
+#        define uprintf binary_log
+
+#    elif __has_include_next("_print.h")
 #        include_next "_print.h" /* Include the platforms print.h */
 #    else
 // Fall back to lib/printf
@@ -0,0 +1,206 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "gtest/gtest.h"
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "binary_log.h"
+void advance_time(uint32_t ms);
+}
+
+class BinaryLog : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        binary_log_clear();
+    }
+};
+
+static std::vector<uint8_t> u32(uint32_t value) {
+    return {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+}
+
+static std::vector<uint8_t> record(const char* fmt, std::vector<uint8_t> args) {
+    std::vector<uint8_t> out = u32((uint32_t)(uintptr_t)fmt);
+    out.insert(out.end(), args.begin(), args.end());
+    out.insert(out.begin(), (uint8_t)out.size());
+    return out;
+}
+
+static std::vector<uint8_t> drain(uint8_t size) {
+    std::vector<uint8_t> out;
+    uint8_t              packet[64];
+    while (binary_log_pending()) {
+        uint8_t length = binary_log_packet(packet, size);
+        out.insert(out.end(), &packet[1], &packet[1 + length]);
+    }
+    return out;
+}
+
+TEST_F(BinaryLog, RecordEncoding) {
+    static const char fmt[] = "%d %-4s %lx %c";
+    binary_log(fmt, -2, "hi", 0x12345678L, 'q');
+
+    std::vector<uint8_t> args = u32(-2);
+    args.insert(args.end(), {'h', 'i', '\0'});
+    for (auto v : {u32(0x12345678), u32('q')}) {
+        args.insert(args.end(), v.begin(), v.end());
+    }
+    EXPECT_EQ(drain(64), record(fmt, args));
+}
+
+TEST_F(BinaryLog, StarWidthIsStored) {
+    static const char fmt[] = "%*u";
+    binary_log(fmt, 5, 42);
+
+    std::vector<uint8_t> args = u32(5);
+    auto                 value = u32(42);
+    args.insert(args.end(), value.begin(), value.end());
+    EXPECT_EQ(drain(64), record(fmt, args));
+}
+
+static std::vector<uint8_t> u64(uint64_t value) {
+    std::vector<uint8_t> out = u32((uint32_t)value);
+    auto                 high = u32((uint32_t)(value >> 32));
+    out.insert(out.end(), high.begin(), high.end());
+    return out;
+}
+
+TEST_F(BinaryLog, WideAndFloatArgumentsAreStored) {
+    static const char fmt[] = "%lld %.2f %u";
+    binary_log(fmt, -2LL, 1.5, 7);
+
+    double   value = 1.5;
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    std::vector<uint8_t> args = u64((uint64_t)-2LL);
+    for (auto v : {u64(bits), u32(7)}) {
+        args.insert(args.end(), v.begin(), v.end());
+    }
+    EXPECT_EQ(drain(64), record(fmt, args));
+}
+
+TEST_F(BinaryLog, UnsupportedConversionStopsArguments) {
+    static const char fmt[] = "%u %n %u";
+    int               count;
+    binary_log(fmt, 1, &count, 2);
+
+    EXPECT_EQ(drain(64), record(fmt, u32(1)));
+}
+
+TEST_F(BinaryLog, PrintIsNotAFormatString) {
+    static const char text[] = "100%s done";
+    binary_log_literal(text);
+
+    std::vector<uint8_t> expected = u32(BINARY_LOG_LITERAL_ID);
+    auto                 address  = u32((uint32_t)(uintptr_t)text);
+    expected.insert(expected.end(), address.begin(), address.end());
+    expected.insert(expected.begin(), (uint8_t)expected.size());
+    EXPECT_EQ(drain(64), expected);
+}
+
+TEST_F(BinaryLog, RawCharactersAreLoggedAsText) {
+    static const char fmt[] = "%u";
+    for (char c : std::string("ab\ncd")) {
+        binary_log_char(c);
+    }
+    // the unfinished line goes out ahead of the next message
+    binary_log(fmt, 1);
+
+    std::vector<uint8_t> expected;
+    for (std::string line : {"ab\n", "cd"}) {
+        std::vector<uint8_t> text = u32(BINARY_LOG_TEXT_ID);
+        text.insert(text.end(), line.begin(), line.end());
+        text.insert(text.begin(), (uint8_t)text.size());
+        expected.insert(expected.end(), text.begin(), text.end());
+    }
+    auto message = record(fmt, u32(1));
+    expected.insert(expected.end(), message.begin(), message.end());
+    EXPECT_EQ(drain(64), expected);
+}
+
+TEST_F(BinaryLog, UnfinishedLineWaitsForFlushTime) {
+    binary_log_char('x');
+    EXPECT_FALSE(binary_log_packet_ready(64));
+    EXPECT_EQ(binary_log_pending(), 0);
+    advance_time(CONSOLE_BINARY_FLUSH_MS);
+    EXPECT_TRUE(binary_log_packet_ready(64));
+    EXPECT_EQ(binary_log_pending(), 1 + 4 + 1);
+}
+
+TEST_F(BinaryLog, PacketsMarkFirstRecord) {
+    static const char fmt[] = "%u";
+    uint8_t           packet[8];
+
+    // 9 byte records in 7 byte payloads
+    binary_log(fmt, 1);
+    binary_log(fmt, 2);
+
+    EXPECT_EQ(binary_log_packet(packet, sizeof(packet)), 7);
+    EXPECT_EQ(packet[0], 0);
+    EXPECT_EQ(packet[1], 8);
+
+    EXPECT_EQ(binary_log_packet(packet, sizeof(packet)), 7);
+    EXPECT_EQ(packet[0], 2);
+    EXPECT_EQ(packet[3], 8);
+
+    EXPECT_EQ(binary_log_packet(packet, sizeof(packet)), 4);
+    EXPECT_EQ(packet[0], BINARY_LOG_NO_RECORD);
+    for (uint8_t i = 5; i < sizeof(packet); i++) {
+        EXPECT_EQ(packet[i], 0);
+    }
+    EXPECT_EQ(binary_log_pending(), 0);
+}
+
+TEST_F(BinaryLog, LongStringIsTruncated) {
+    static const char fmt[] = "%s";
+    std::string       text(300, 'a');
+    binary_log(fmt, text.c_str());
+
+    std::vector<uint8_t> out = drain(64);
+    ASSERT_EQ(out.size(), BINARY_LOG_RECORD_MAX);
+    EXPECT_EQ(out[0], BINARY_LOG_RECORD_MAX - 1);
+    EXPECT_EQ(out[BINARY_LOG_RECORD_MAX - 2], 'a');
+    EXPECT_EQ(out.back(), '\0');
+}
+
+TEST_F(BinaryLog, DroppedRecordsAreCounted) {
+    static const char fmt[] = "%u";
+
+    // 64 byte buffer holds 7 records of 9 bytes
+    for (uint32_t i = 0; i < 10; i++) {
+        binary_log(fmt, i);
+    }
+    EXPECT_EQ(binary_log_pending(), 63);
+
+    std::vector<uint8_t> out = drain(64);
+    ASSERT_EQ(out.size(), 8 * 9);
+    std::vector<uint8_t> dropped(out.end() - 9, out.end());
+    std::vector<uint8_t> expected = u32(BINARY_LOG_DROPPED_ID);
+    auto                 count    = u32(3);
+    expected.insert(expected.end(), count.begin(), count.end());
+    expected.insert(expected.begin(), 8);
+    EXPECT_EQ(dropped, expected);
+
+    // the count is only reported once
+    EXPECT_EQ(binary_log_pending(), 0);
+    EXPECT_FALSE(binary_log_packet_ready(64));
+}
+
+TEST_F(BinaryLog, PartialPacketWaitsForFlushTime) {
+    static const char fmt[] = "%u";
+    binary_log(fmt, 1);
+    EXPECT_FALSE(binary_log_packet_ready(64));
+    advance_time(CONSOLE_BINARY_FLUSH_MS - 1);
+    EXPECT_FALSE(binary_log_packet_ready(64));
+    advance_time(1);
+    EXPECT_TRUE(binary_log_packet_ready(64));
+}
+
+TEST_F(BinaryLog, FullPacketIsReadyAtOnce) {
+    static const char fmt[] = "%u";
+    binary_log(fmt, 1);
+    binary_log(fmt, 2);
+    EXPECT_TRUE(binary_log_packet_ready(16));
+    EXPECT_FALSE(binary_log_packet_ready(32));
+}
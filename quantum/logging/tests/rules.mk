@@ -0,0 +1,8 @@
+binary_log_DEFS := -DCONSOLE_BINARY_BUFFER_SIZE=64 -DCONSOLE_BINARY_FLUSH_MS=10
+binary_log_INC := \
+	$(QUANTUM_PATH)/logging
+
+binary_log_SRC := \
+	platforms/test/timer.c \
+	$(QUANTUM_PATH)/logging/tests/binary_log_tests.cpp \
+	$(QUANTUM_PATH)/logging/binary_log.c
@@ -55,8 +55,61 @@ static SPLIT_MUTABLE_ROW pin_t row_pins[ROWS_PER_HAND] = MATRIX_ROW_PINS;
 #    ifdef MATRIX_COL_PINS
 static SPLIT_MUTABLE_COL pin_t col_pins[MATRIX_COLS]   = MATRIX_COL_PINS;
 #    endif // MATRIX_COL_PINS
+#    if defined(readPort) && defined(MATRIX_COL_PINS) && defined(MATRIX_COL_PORT_TERMS) && (DIODE_DIRECTION == COL2ROW)
+#        define MATRIX_COL_PORT_READS
+#    endif
+#    if defined(readPort) && defined(MATRIX_ROW_PINS) && defined(MATRIX_ROW_PORT_TERMS) && (DIODE_DIRECTION == ROW2COL)
+#        define MATRIX_ROW_PORT_READS
+#    endif
+#endif
+
+#if defined(MATRIX_COL_PORT_READS) || defined(MATRIX_ROW_PORT_READS)
+/* Pins on one GPIO port whose bit in the port is the same distance from their index in the pin array */
+typedef struct {
+    uint8_t     port;
+    port_data_t mask;
+    int8_t      shift;
+} matrix_port_term_t;
+
+/* How to read a pin array a GPIO port at a time, generated from info.json -- terms are sorted by port */
+typedef struct {
+    const pin_t *             ports;
+    const matrix_port_term_t *terms;
+    uint8_t                   term_count;
+} matrix_port_group_t;
+
+#    define MATRIX_PORT_GROUP(ports, terms) \
+        { ports, terms, ARRAY_SIZE(terms) }
 #endif
 
+#ifdef MATRIX_COL_PORT_READS
+static const pin_t               col_port_ports[] = MATRIX_COL_PORTS;
+static const matrix_port_term_t  col_port_terms[] = MATRIX_COL_PORT_TERMS;
+static const pin_t               col_port_pins[]  = MATRIX_COL_PORT_PINS;
+static const matrix_port_group_t col_port_group   = MATRIX_PORT_GROUP(col_port_ports, col_port_terms);
+#    ifdef MATRIX_COL_PORT_TERMS_RIGHT
+static const pin_t               col_port_ports_right[] = MATRIX_COL_PORTS_RIGHT;
+static const matrix_port_term_t  col_port_terms_right[] = MATRIX_COL_PORT_TERMS_RIGHT;
+static const pin_t               col_port_pins_right[]  = MATRIX_COL_PORT_PINS_RIGHT;
+static const matrix_port_group_t col_port_group_right   = MATRIX_PORT_GROUP(col_port_ports_right, col_port_terms_right);
+#    endif
+static const matrix_port_group_t *col_ports;
+#endif // MATRIX_COL_PORT_READS
+
+#ifdef MATRIX_ROW_PORT_READS
+static const pin_t               row_port_ports[] = MATRIX_ROW_PORTS;
+static const matrix_port_term_t  row_port_terms[] = MATRIX_ROW_PORT_TERMS;
+static const pin_t               row_port_pins[]  = MATRIX_ROW_PORT_PINS;
+static const matrix_port_group_t row_port_group   = MATRIX_PORT_GROUP(row_port_ports, row_port_terms);
+#    ifdef MATRIX_ROW_PORT_TERMS_RIGHT
+static const pin_t               row_port_ports_right[] = MATRIX_ROW_PORTS_RIGHT;
+static const matrix_port_term_t  row_port_terms_right[] = MATRIX_ROW_PORT_TERMS_RIGHT;
+static const pin_t               row_port_pins_right[]  = MATRIX_ROW_PORT_PINS_RIGHT;
+static const matrix_port_group_t row_port_group_right   = MATRIX_PORT_GROUP(row_port_ports_right, row_port_terms_right);
+#    endif
+static const matrix_port_group_t *row_ports;
+#endif // MATRIX_ROW_PORT_READS
+
 /* matrix state(1:on, 0:off) */
 extern matrix_row_t raw_matrix[MATRIX_ROWS]; // raw values
 extern matrix_row_t matrix[MATRIX_ROWS];     // debounced values
@@ -99,6 +152,31 @@ static inline uint8_t readMatrixPin(pin_t pin) {
     }
 }
 
+#if defined(MATRIX_COL_PORT_READS) || defined(MATRIX_ROW_PORT_READS)
+/* Returns the port group if it was generated for the pins in use, which may have been overridden or swapped for the right hand */
+static const matrix_port_group_t *matrix_port_group_for_pins(const pin_t *pins, size_t size, const pin_t *group_pins, const matrix_port_group_t *group) {
+    return memcmp(pins, group_pins, size) == 0 ? group : NULL;
+}
+
+/* Reads a pin array with one read per GPIO port, setting a bit for each pin that is low
+ * -- up to 32 pins, which may be more than a matrix_row_t holds when reading rows */
+static inline uint32_t read_port_group(const matrix_port_group_t *group) {
+    uint32_t    value = 0;
+    port_data_t data  = 0;
+    uint8_t     port  = UINT8_MAX;
+    for (uint8_t i = 0; i < group->term_count; i++) {
+        const matrix_port_term_t *term = &group->terms[i];
+        if (term->port != port) {
+            port = term->port;
+            data = ~readPort(group->ports[port]);
+        }
+        port_data_t bits = data & term->mask;
+        value |= term->shift >= 0 ? (uint32_t)bits << term->shift : (uint32_t)(bits >> -term->shift);
+    }
+    return value;
+}
+#endif
+
 // matrix code
 
 #ifdef DIRECT_PINS
@@ -178,13 +256,21 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
     }
     matrix_output_select_delay();
 
-    // For each col...
-    matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
-    for (uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++, row_shifter <<= 1) {
-        uint8_t pin_state = readMatrixPin(col_pins[col_index]);
-
-        // Populate the matrix row with the state of the col pin
-        current_row_value |= pin_state ? 0 : row_shifter;
+#            ifdef MATRIX_COL_PORT_READS
+    if (col_ports) {
+        // Read all cols a port at a time
+        current_row_value = (matrix_row_t)read_port_group(col_ports);
+    } else
+#            endif
+    {
+        // For each col...
+        matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
+        for (uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++, row_shifter <<= 1) {
+            uint8_t pin_state = readMatrixPin(col_pins[col_index]);
+
+            // Populate the matrix row with the state of the col pin
+            current_row_value |= pin_state ? 0 : row_shifter;
+        }
     }
 
     // Unselect row
@@ -241,10 +327,20 @@ __attribute__((weak)) void matrix_read_rows_on_col(matrix_row_t current_matrix[]
     }
     matrix_output_select_delay();
 
+#            ifdef MATRIX_ROW_PORT_READS
+    // Read all rows a port at a time
+    uint32_t row_states = row_ports ? read_port_group(row_ports) : 0;
+#            endif
+
     // For each row...
     for (uint8_t row_index = 0; row_index < ROWS_PER_HAND; row_index++) {
         // Check row pin state
-        if (readMatrixPin(row_pins[row_index]) == 0) {
+#            ifdef MATRIX_ROW_PORT_READS
+        bool pin_low = row_ports ? (row_states >> row_index) & 1 : readMatrixPin(row_pins[row_index]) == 0;
+#            else
+        bool pin_low = readMatrixPin(row_pins[row_index]) == 0;
+#            endif
+        if (pin_low) {
             // Pin LO, set col bit
             current_matrix[row_index] |= row_shifter;
             key_pressed = true;
@@ -297,6 +393,23 @@ void matrix_init(void) {
     thatHand = ROWS_PER_HAND - thisHand;
 #endif
 
+#ifdef MATRIX_COL_PORT_READS
+    col_ports = matrix_port_group_for_pins(col_pins, sizeof(col_pins), col_port_pins, &col_port_group);
+#    ifdef MATRIX_COL_PORT_TERMS_RIGHT
+    if (!col_ports) {
+        col_ports = matrix_port_group_for_pins(col_pins, sizeof(col_pins), col_port_pins_right, &col_port_group_right);
+    }
+#    endif
+#endif
+#ifdef MATRIX_ROW_PORT_READS
+    row_ports = matrix_port_group_for_pins(row_pins, sizeof(row_pins), row_port_pins, &row_port_group);
+#    ifdef MATRIX_ROW_PORT_TERMS_RIGHT
+    if (!row_ports) {
+        row_ports = matrix_port_group_for_pins(row_pins, sizeof(row_pins), row_port_pins_right, &row_port_group_right);
+    }
+#    endif
+#endif
+
     // initialize key pins
     matrix_init_pins();
 
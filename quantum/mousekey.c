@@ -48,7 +48,297 @@ static int8_t  mousekey_y_inertia = 0; // ...
 static uint16_t mouse_timer = 0;
 #endif
 
-#ifndef MK_3_SPEED
+#if defined(MK_INTEGRATED_SPEED)
+
+static uint16_t last_timer_c = 0;
+static uint16_t last_timer_w = 0;
+
+/*
+ * Integrated acceleration mode
+ *
+ *  Speed (counts per second) follows a piecewise linear curve over the time the keys have been held, with
+ *  points mk_curve_step milliseconds apart. The distance sent is the exact integral of that curve, so the
+ *  position is a function of time only and does not depend on how often mousekey_task() runs. Reports are
+ *  sent at most every mk_interval milliseconds.
+ */
+/* milliseconds between the initial key press and the start of the curve (0-2550) */
+uint8_t mk_delay = MOUSEKEY_DELAY / 10;
+/* minimum milliseconds between motion reports (0-255) */
+uint8_t mk_interval = MOUSEKEY_INTERVAL;
+/* milliseconds between two points of the speed curves (1-255) */
+uint8_t mk_curve_step = MK_CURVE_STEP;
+/* cursor speed curve, in counts per second */
+uint16_t mk_curve[MK_CURVE_POINTS] = MK_CURVE;
+/* wheel speed curve, in wheel units per second */
+uint16_t mk_wheel_curve[MK_WHEEL_CURVE_POINTS] = MK_WHEEL_CURVE;
+
+#    ifdef MOUSE_EXTENDED_REPORT
+#        define MK_MOVE_REPORT_MAX INT16_MAX
+#    else
+#        define MK_MOVE_REPORT_MAX MOUSEKEY_MOVE_MAX
+#    endif
+
+/* time after which the constant tail of the curve is rebased, to keep the distance within 32 bits */
+#    define MK_REBASE_MS 30000
+
+typedef struct {
+    int8_t   dir_a;  // -1 / 0 / 1 along x (cursor) or h (wheel)
+    int8_t   dir_b;  // -1 / 0 / 1 along y (cursor) or v (wheel)
+    bool     moving; // whether a motion is in progress
+    uint32_t start;  // time at which the curve starts
+    uint32_t sent;   // whole counts sent along the curve so far
+} mk_motion_t;
+
+static mk_motion_t mk_cursor    = {0};
+static mk_motion_t mk_wheel     = {0};
+static uint32_t    mk_last_step = 0;
+
+/* distance travelled at constant speed over dt milliseconds, in 1/256th counts */
+static uint32_t mk_constant_distance(uint16_t speed, uint32_t dt) {
+    // speed * dt * 256 / 1000, split on whole 125ms periods to stay within 32 bits
+    return (dt / 125) * speed * 32 + (uint32_t)speed * (dt % 125) * 32 / 125;
+}
+
+/* distance travelled between two curve points over dt <= step milliseconds, in 1/256th counts */
+static uint32_t mk_segment_distance(uint16_t v0, uint16_t v1, uint8_t step, uint8_t dt) {
+    // (v0 * dt + (v1 - v0) * dt^2 / (2 * step)) * 256 / 1000
+    int32_t dv = ((int32_t)v1 - v0) * dt / step;
+    return ((int32_t)v0 * dt * 32 + dv * dt * 16) / 125;
+}
+
+static uint32_t mk_curve_distance(const uint16_t *curve, uint8_t points, uint16_t speed_cap, uint32_t t) {
+    uint32_t distance = 0;
+    uint8_t  step     = mk_curve_step ? mk_curve_step : 1;
+
+    // accelerator keys move at a constant fraction of the top speed
+    if (mousekey_accel & ((1 << 0) | (1 << 1) | (1 << 2))) {
+        return mk_constant_distance(speed_cap, t);
+    }
+
+    for (uint8_t i = 0; i + 1 < points && t; i++) {
+        uint8_t dt = t < step ? t : step;
+        distance += mk_segment_distance(curve[i], curve[i + 1], step, dt);
+        t -= dt;
+    }
+
+    // hold the last speed past the end of the curve
+    return distance + mk_constant_distance(curve[points - 1], t);
+}
+
+static uint16_t mk_accel_speed(const uint16_t *curve, uint8_t points) {
+    uint16_t top = curve[points - 1];
+    if (mousekey_accel & (1 << 0)) {
+        return top / 4;
+    } else if (mousekey_accel & (1 << 1)) {
+        return top / 2;
+    }
+    return top;
+}
+
+/* whole counts along the direction of travel after t milliseconds on the curve */
+static uint32_t mk_motion_counts(mk_motion_t *motion, const uint16_t *curve, uint8_t points, uint32_t t) {
+    uint32_t counts = mk_curve_distance(curve, points, mk_accel_speed(curve, points), t) >> 8;
+    if (motion->dir_a && motion->dir_b) {
+        // diagonal move [1/sqrt(2)]
+        counts = (counts * 181) >> 8;
+    }
+    return counts;
+}
+
+/* whole counts along the direction of travel that should have been sent by now */
+static uint32_t mk_motion_target(mk_motion_t *motion, const uint16_t *curve, uint8_t points, uint32_t now) {
+    if ((int32_t)(now - motion->start) <= 0) {
+        return 0;
+    }
+
+    uint32_t t = now - motion->start;
+    // the tail of the curve is linear, so moving the origin forward removes the counts of one rebase period
+    if (!(mousekey_accel & ((1 << 0) | (1 << 1) | (1 << 2))) && t > (uint32_t)mk_curve_step * points + MK_REBASE_MS) {
+        uint32_t rebased = mk_motion_counts(motion, curve, points, t) - mk_motion_counts(motion, curve, points, t - MK_REBASE_MS);
+        motion->start += MK_REBASE_MS;
+        motion->sent = motion->sent > rebased ? motion->sent - rebased : 0;
+        t -= MK_REBASE_MS;
+    }
+
+    return mk_motion_counts(motion, curve, points, t);
+}
+
+static int16_t mk_motion_step(mk_motion_t *motion, const uint16_t *curve, uint8_t points, uint32_t now, int16_t max) {
+    if (!motion->moving) {
+        return 0;
+    }
+
+    uint32_t target = mk_motion_target(motion, curve, points, now);
+    if (target <= motion->sent) {
+        return 0;
+    }
+
+    // anything above the report range is carried over to the next report
+    uint32_t counts = target - motion->sent;
+    if (counts > (uint32_t)max) {
+        counts = max;
+    }
+    motion->sent += counts;
+    return counts;
+}
+
+/* continue the current motion from where it is now, e.g. after its direction or speed changed */
+static void mk_motion_sync(mk_motion_t *motion, const uint16_t *curve, uint8_t points, uint32_t now) {
+    if (motion->moving) {
+        motion->sent = mk_motion_target(motion, curve, points, now);
+    }
+}
+
+static void mk_motion_report(uint32_t now) {
+    int16_t move  = mk_motion_step(&mk_cursor, mk_curve, MK_CURVE_POINTS, now, MK_MOVE_REPORT_MAX);
+    int16_t wheel = mk_motion_step(&mk_wheel, mk_wheel_curve, MK_WHEEL_CURVE_POINTS, now, MOUSEKEY_WHEEL_MAX);
+
+    mouse_report.x += mk_cursor.dir_a * move;
+    mouse_report.y += mk_cursor.dir_b * move;
+    mouse_report.h += mk_wheel.dir_a * wheel;
+    mouse_report.v += mk_wheel.dir_b * wheel;
+}
+
+/* apply a new direction to a motion, starting it with a single count if it wasn't moving yet */
+static void mk_motion_update(mk_motion_t *motion, const uint16_t *curve, uint8_t points, int8_t dir_a, int8_t dir_b, uint32_t now) {
+    bool was_moving = motion->moving;
+
+    motion->dir_a  = dir_a;
+    motion->dir_b  = dir_b;
+    motion->moving = dir_a || dir_b;
+
+    if (motion->moving && !was_moving) {
+        motion->start = now + mk_delay * 10;
+        motion->sent  = 0;
+    } else {
+        mk_motion_sync(motion, curve, points, now);
+    }
+}
+
+void mousekey_task(void) {
+    uint32_t now = timer_read32();
+
+    if (TIMER_DIFF_32(now, mk_last_step) < mk_interval) {
+        return;
+    }
+    mk_last_step = now;
+
+    mouse_report.x = 0;
+    mouse_report.y = 0;
+    mouse_report.v = 0;
+    mouse_report.h = 0;
+
+    mk_motion_report(now);
+
+    if (should_mousekey_report_send(&mouse_report)) {
+        mousekey_send();
+    }
+}
+
+static void mousekey_integrated_change(uint8_t code, bool pressed) {
+    uint32_t     now    = timer_read32();
+    mk_motion_t *motion = NULL;
+    int8_t       dir_a, dir_b;
+    int8_t       sign = 0;
+
+    mouse_report.x = 0;
+    mouse_report.y = 0;
+    mouse_report.v = 0;
+    mouse_report.h = 0;
+
+    // bring every motion up to date, so no distance is lost or gained by the change
+    mk_motion_report(now);
+
+    switch (code) {
+        case KC_MS_UP ... KC_MS_RIGHT:
+            motion = &mk_cursor;
+            break;
+        case KC_MS_WH_UP ... KC_MS_WH_RIGHT:
+            motion = &mk_wheel;
+            break;
+        case KC_MS_ACCEL0 ... KC_MS_ACCEL2:
+            if (pressed) {
+                mousekey_accel |= (1 << (code - KC_MS_ACCEL0));
+            } else {
+                mousekey_accel &= ~(1 << (code - KC_MS_ACCEL0));
+            }
+            mk_motion_sync(&mk_cursor, mk_curve, MK_CURVE_POINTS, now);
+            mk_motion_sync(&mk_wheel, mk_wheel_curve, MK_WHEEL_CURVE_POINTS, now);
+            return;
+        default:
+            return;
+    }
+
+    dir_a = motion->dir_a;
+    dir_b = motion->dir_b;
+    switch (code) {
+        case KC_MS_UP:
+        case KC_MS_WH_DOWN:
+            sign = -1;
+            break;
+        case KC_MS_DOWN:
+        case KC_MS_WH_UP:
+            sign = 1;
+            break;
+        case KC_MS_LEFT:
+        case KC_MS_WH_LEFT:
+            sign = -2;
+            break;
+        case KC_MS_RIGHT:
+        case KC_MS_WH_RIGHT:
+            sign = 2;
+            break;
+    }
+
+    // key release clears the direction unless the opposite key took over
+    if (sign == 1 || sign == -1) {
+        if (pressed) {
+            dir_b = sign;
+        } else if (dir_b == sign) {
+            dir_b = 0;
+        }
+    } else {
+        if (pressed) {
+            dir_a = sign / 2;
+        } else if (dir_a == sign / 2) {
+            dir_a = 0;
+        }
+    }
+
+    bool start = pressed && !motion->moving;
+    if (motion == &mk_cursor) {
+        mk_motion_update(motion, mk_curve, MK_CURVE_POINTS, dir_a, dir_b, now);
+    } else {
+        mk_motion_update(motion, mk_wheel_curve, MK_WHEEL_CURVE_POINTS, dir_a, dir_b, now);
+    }
+
+    // initial keypress moves a single count
+    if (start && motion == &mk_cursor) {
+        mouse_report.x = dir_a;
+        mouse_report.y = dir_b;
+    } else if (start) {
+        mouse_report.h = dir_a;
+        mouse_report.v = dir_b;
+    }
+}
+
+void mousekey_on(uint8_t code) {
+    if (IS_MOUSEKEY_BUTTON(code)) {
+        mouse_report.buttons |= 1 << (code - KC_MS_BTN1);
+    } else {
+        mousekey_integrated_change(code, true);
+    }
+}
+
+void mousekey_off(uint8_t code) {
+    if (IS_MOUSEKEY_BUTTON(code)) {
+        mouse_report.buttons &= ~(1 << (code - KC_MS_BTN1));
+    } else {
+        mousekey_integrated_change(code, false);
+    }
+}
+
+#elif !defined(MK_3_SPEED)
 
 static uint16_t last_timer_c = 0;
 static uint16_t last_timer_w = 0;
@@ -470,7 +760,7 @@ void mousekey_off(uint8_t code) {
     if (mouse_report.v == 0 && mouse_report.h == 0) mousekey_wheel_repeat = 0;
 }
 
-#else /* #ifndef MK_3_SPEED */
+#else /* #if defined(MK_INTEGRATED_SPEED) / #elif !defined(MK_3_SPEED) */
 
 enum { mkspd_unmod, mkspd_0, mkspd_1, mkspd_2, mkspd_COUNT };
 #    ifndef MK_MOMENTARY_ACCEL
@@ -601,7 +891,7 @@ void mousekey_off(uint8_t code) {
 #    endif
 }
 
-#endif /* #ifndef MK_3_SPEED */
+#endif /* #if defined(MK_INTEGRATED_SPEED) / #elif !defined(MK_3_SPEED) */
 
 void mousekey_send(void) {
     mousekey_debug();
@@ -609,6 +899,13 @@ void mousekey_send(void) {
     if (mouse_report.x || mouse_report.y) last_timer_c = time;
     if (mouse_report.v || mouse_report.h) last_timer_w = time;
     host_mouse_send(&mouse_report);
+#ifdef MK_INTEGRATED_SPEED
+    // motion is sent as deltas, held keys are tracked separately
+    mouse_report.x = 0;
+    mouse_report.y = 0;
+    mouse_report.v = 0;
+    mouse_report.h = 0;
+#endif
 }
 
 void mousekey_clear(void) {
@@ -616,6 +913,10 @@ void mousekey_clear(void) {
     mousekey_repeat       = 0;
     mousekey_wheel_repeat = 0;
     mousekey_accel        = 0;
+#ifdef MK_INTEGRATED_SPEED
+    mk_cursor = (mk_motion_t){0};
+    mk_wheel  = (mk_motion_t){0};
+#endif
 #ifdef MOUSEKEY_INERTIA
     mousekey_frame     = 0;
     mousekey_x_inertia = 0;
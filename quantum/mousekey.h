@@ -61,6 +61,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #            define MOUSEKEY_INTERVAL 10
 #        elif defined(MOUSEKEY_INERTIA)
 #            define MOUSEKEY_INTERVAL 16 // 60 fps
+#        elif defined(MK_INTEGRATED_SPEED)
+#            define MOUSEKEY_INTERVAL 8
 #        else
 #            define MOUSEKEY_INTERVAL 20
 #        endif
@@ -120,6 +122,30 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #        define MOUSEKEY_WHEEL_DECELERATED_MOVEMENTS 8
 #    endif
 
+#    ifdef MK_INTEGRATED_SPEED
+#        ifndef MK_CURVE_STEP
+#            define MK_CURVE_STEP 100
+#        elif MK_CURVE_STEP < 1 || MK_CURVE_STEP > 255
+#            error MK_CURVE_STEP needs to be between 1 and 255
+#        endif
+/* quadratic ramp over 8 points, from the initial to the base speed */
+#        define MK_CURVE_RAMP(from, to, i) ((from) + (((uint32_t)(to) - (from)) * (i) * (i)) / 49)
+#        define MK_CURVE_RAMP_8(from, to) \
+            { MK_CURVE_RAMP(from, to, 0), MK_CURVE_RAMP(from, to, 1), MK_CURVE_RAMP(from, to, 2), MK_CURVE_RAMP(from, to, 3), MK_CURVE_RAMP(from, to, 4), MK_CURVE_RAMP(from, to, 5), MK_CURVE_RAMP(from, to, 6), MK_CURVE_RAMP(from, to, 7) }
+#        ifndef MK_CURVE
+#            define MK_CURVE_POINTS 8
+#            define MK_CURVE MK_CURVE_RAMP_8(MOUSEKEY_INITIAL_SPEED, MOUSEKEY_BASE_SPEED)
+#        elif !defined(MK_CURVE_POINTS)
+#            error MK_CURVE_POINTS needs to be defined along with MK_CURVE
+#        endif
+#        ifndef MK_WHEEL_CURVE
+#            define MK_WHEEL_CURVE_POINTS 8
+#            define MK_WHEEL_CURVE MK_CURVE_RAMP_8(MOUSEKEY_WHEEL_INITIAL_MOVEMENTS, MOUSEKEY_WHEEL_BASE_MOVEMENTS)
+#        elif !defined(MK_WHEEL_CURVE_POINTS)
+#            error MK_WHEEL_CURVE_POINTS needs to be defined along with MK_WHEEL_CURVE
+#        endif
+#    endif
+
 #else /* #ifndef MK_3_SPEED */
 
 #    ifndef MK_C_OFFSET_UNMOD
@@ -180,10 +206,16 @@ extern "C" {
 
 extern uint8_t mk_delay;
 extern uint8_t mk_interval;
+#ifdef MK_INTEGRATED_SPEED
+extern uint8_t  mk_curve_step;
+extern uint16_t mk_curve[MK_CURVE_POINTS];
+extern uint16_t mk_wheel_curve[MK_WHEEL_CURVE_POINTS];
+#else
 extern uint8_t mk_max_speed;
 extern uint8_t mk_time_to_max;
 extern uint8_t mk_wheel_max_speed;
 extern uint8_t mk_wheel_time_to_max;
+#endif
 
 void           mousekey_task(void);
 void           mousekey_on(uint8_t code);
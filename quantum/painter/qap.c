@@ -0,0 +1,121 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Quantum Asset Pack "QAP" File Format.
+// See https://docs.qmk.fm/#/quantum_painter?id=quantum-painter-asset-packs for more information.
+
+#include <string.h>
+
+#include "qap.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// QAP API
+
+static bool qap_read_pack_descriptor(qp_stream_t *stream, uint16_t *asset_count, uint32_t *total_file_size) {
+    // Seek to the start
+    qp_stream_setpos(stream, 0);
+
+    // Read and validate the pack descriptor
+    qap_pack_descriptor_v1_t pack_descriptor;
+    if (qp_stream_read(&pack_descriptor, sizeof(qap_pack_descriptor_v1_t), 1, stream) != 1) {
+        qp_dprintf("Failed to read pack_descriptor, expected length was not %d\n", (int)sizeof(qap_pack_descriptor_v1_t));
+        return false;
+    }
+
+    // Make sure this block is valid
+    if (!qgf_validate_block_header(&pack_descriptor.header, QAP_PACK_DESCRIPTOR_TYPEID, (sizeof(qap_pack_descriptor_v1_t) - sizeof(qgf_block_header_v1_t)))) {
+        return false;
+    }
+
+    // Make sure the magic and version are correct
+    if (pack_descriptor.magic != QAP_MAGIC || pack_descriptor.qap_version != 0x01) {
+        qp_dprintf("Failed to validate pack_descriptor, expected magic 0x%06X was 0x%06X, expected version = 0x%02X was 0x%02X\n", (int)QAP_MAGIC, (int)pack_descriptor.magic, (int)0x01, (int)pack_descriptor.qap_version);
+        return false;
+    }
+
+    // Make sure the file length is valid
+    if (pack_descriptor.neg_total_file_size != ~pack_descriptor.total_file_size) {
+        qp_dprintf("Failed to validate pack_descriptor, expected negated length 0x%08X was 0x%08X\n", (int)(~pack_descriptor.total_file_size), (int)pack_descriptor.neg_total_file_size);
+        return false;
+    }
+
+    // Read and validate the directory header
+    qap_directory_v1_t directory;
+    if (qp_stream_read(&directory, sizeof(qap_directory_v1_t), 1, stream) != 1) {
+        qp_dprintf("Failed to read directory, expected length was not %d\n", (int)sizeof(qap_directory_v1_t));
+        return false;
+    }
+
+    if (!qgf_validate_block_header(&directory.header, QAP_DIRECTORY_DESCRIPTOR_TYPEID, pack_descriptor.asset_count * sizeof(qap_asset_v1_t))) {
+        return false;
+    }
+
+    *asset_count     = pack_descriptor.asset_count;
+    *total_file_size = pack_descriptor.total_file_size;
+    return true;
+}
+
+// Finds the named asset in the pack, returning its location relative to the start of the pack
+bool qap_find_asset(qp_stream_t *stream, const char *name, uint32_t *offset, uint32_t *size) {
+    if (strlen(name) > QAP_ASSET_NAME_LENGTH) {
+        qp_dprintf("Asset name '%s' is longer than %d characters\n", name, (int)QAP_ASSET_NAME_LENGTH);
+        return false;
+    }
+
+    uint16_t asset_count;
+    uint32_t total_file_size;
+    if (!qap_read_pack_descriptor(stream, &asset_count, &total_file_size)) {
+        return false;
+    }
+
+    // The directory is sorted by name, so binary search it
+    const uint32_t directory_offset = sizeof(qap_pack_descriptor_v1_t) + sizeof(qap_directory_v1_t);
+    int32_t        lo               = 0;
+    int32_t        hi               = (int32_t)asset_count - 1;
+    while (lo <= hi) {
+        int32_t        mid = lo + (hi - lo) / 2;
+        qap_asset_v1_t asset;
+        if (qp_stream_setpos(stream, directory_offset + mid * sizeof(qap_asset_v1_t)) < 0 || qp_stream_read(&asset, sizeof(qap_asset_v1_t), 1, stream) != 1) {
+            qp_dprintf("Failed to read asset %d from the directory\n", (int)mid);
+            return false;
+        }
+
+        int cmp = strncmp(name, asset.name, QAP_ASSET_NAME_LENGTH);
+        if (cmp == 0) {
+            // Don't hand out an asset that would be read from past the end of the pack
+            if (asset.offset > total_file_size || asset.size > total_file_size - asset.offset) {
+                qp_dprintf("Asset '%s' at offset %u with size %u is outside the pack of size %u\n", name, (unsigned)asset.offset, (unsigned)asset.size, (unsigned)total_file_size);
+                return false;
+            }
+            *offset = asset.offset;
+            *size   = asset.size;
+            return true;
+        }
+        if (cmp < 0) {
+            hi = mid - 1;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    qp_dprintf("Asset '%s' not found\n", name);
+    return false;
+}
+
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
+// Finds the named asset in the asset pack in external flash, returning its flash address
+bool qap_find_flash_asset(const char *name, uint32_t *address) {
+    // The pack descriptor is validated while searching, so the stream doesn't need to know the pack size up front
+    qp_flash_stream_t pack = qp_make_flash_stream(QUANTUM_PAINTER_ASSET_PACK_ADDRESS, INT32_MAX);
+    uint32_t          offset;
+    uint32_t          size;
+    if (!qap_find_asset((qp_stream_t *)&pack, name, &offset, &size)) {
+        return false;
+    }
+
+    *address = QUANTUM_PAINTER_ASSET_PACK_ADDRESS + offset;
+    return true;
+}
+
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
@@ -0,0 +1,66 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+// Quantum Asset Pack "QAP" File Format.
+// See https://docs.qmk.fm/#/quantum_painter?id=quantum-painter-asset-packs for more information.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "qp_stream.h"
+#include "qp_internal.h"
+#include "qgf.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// QAP structures
+
+/////////////////////////////////////////
+// Pack descriptor
+
+#define QAP_PACK_DESCRIPTOR_TYPEID 0x00
+
+typedef struct QP_PACKED qap_pack_descriptor_v1_t {
+    qgf_block_header_v1_t header;              // = { .type_id = 0x00, .neg_type_id = (~0x00), .length = 14 }
+    uint32_t              magic : 24;          // constant, equal to 0x504151 ("QAP")
+    uint8_t               qap_version;         // constant, equal to 0x01
+    uint32_t              total_file_size;     // total size of the entire file, starting at offset zero
+    uint32_t              neg_total_file_size; // negated value of total_file_size, used for detecting parsing errors
+    uint16_t              asset_count;         // number of entries in the asset directory
+} qap_pack_descriptor_v1_t;
+
+_Static_assert(sizeof(qap_pack_descriptor_v1_t) == (sizeof(qgf_block_header_v1_t) + 14), "qap_pack_descriptor_v1_t must be 19 bytes in v1 of QAP");
+
+#define QAP_MAGIC 0x504151
+
+/////////////////////////////////////////
+// Asset directory
+
+#define QAP_DIRECTORY_DESCRIPTOR_TYPEID 0x01
+
+#define QAP_ASSET_NAME_LENGTH 24
+
+typedef struct QP_PACKED qap_asset_v1_t {
+    char     name[QAP_ASSET_NAME_LENGTH]; // asset name, NUL-padded if shorter -- entries are sorted by name
+    uint32_t offset;                      // location of the QGF/QFF data, relative to the start of the pack
+    uint32_t size;                        // size of the QGF/QFF data
+} qap_asset_v1_t;
+
+_Static_assert(sizeof(qap_asset_v1_t) == 32, "qap_asset_v1_t must be 32 bytes in v1 of QAP");
+
+typedef struct QP_PACKED qap_directory_v1_t {
+    qgf_block_header_v1_t header;   // = { .type_id = 0x01, .neg_type_id = (~0x01), .length = (N * 32) }
+    qap_asset_v1_t        asset[0]; // Extent of '0' signifies that this struct is immediately followed by the directory entries
+} qap_directory_v1_t;
+
+_Static_assert(sizeof(qap_directory_v1_t) == sizeof(qgf_block_header_v1_t), "qap_directory_v1_t must only contain qgf_block_header_v1_t in v1 of QAP");
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// QAP API
+
+bool qap_find_asset(qp_stream_t *stream, const char *name, uint32_t *offset, uint32_t *size);
+
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+bool qap_find_flash_asset(const char *name, uint32_t *address);
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
@@ -49,6 +49,9 @@ bool qp_init(painter_device_t device, painter_rotation_t rotation) {
         return false;
     }
 
+    // Re-initialising may change the native pixel format, so don't reuse any palettes converted beforehand
+    qp_internal_evict_palettes(device);
+
     // Set the rotation before init
     driver->rotation = rotation;
 
@@ -125,6 +128,24 @@ bool qp_flush(painter_device_t device) {
     return ret;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_flush_complete
+
+bool qp_flush_complete(painter_device_t device) {
+    return qp_comms_complete(device);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter Core API: qp_internal_task
+
+void qp_internal_task(void) {
+    // Release the bus once background transfers have finished, so that other peripherals can use it
+    qp_comms_task();
+
+    void qp_internal_animation_tick(void);
+    qp_internal_animation_tick();
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter External API: qp_get_geometry
 
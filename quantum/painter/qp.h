@@ -40,6 +40,15 @@
 #    define QUANTUM_PAINTER_LOAD_FONTS_TO_RAM FALSE
 #endif
 
+#ifndef QUANTUM_PAINTER_GLYPH_CACHE_SIZE
+/**
+ * @def This controls the number of recently drawn Unicode glyphs whose location is remembered for each loaded font, so
+ *      that they don't need to be looked up in the font's glyph table again. Each entry requires 6 bytes of RAM per
+ *      font. Set to 0 to disable.
+ */
+#    define QUANTUM_PAINTER_GLYPH_CACHE_SIZE 8
+#endif // QUANTUM_PAINTER_GLYPH_CACHE_SIZE
+
 #ifndef QUANTUM_PAINTER_CONCURRENT_ANIMATIONS
 /**
  * @def This controls the maximum number of animations that Quantum Painter can play simultaneously. Increasing this
@@ -56,6 +65,49 @@
 #    define QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE 32
 #endif
 
+#ifndef QUANTUM_PAINTER_SPI_ASYNC
+/**
+ * @def This controls whether SPI displays are sent data in the background, so that drawing can carry on while the
+ *      previous block of pixel data is transmitted. Data is gathered in two buffers of
+ *      \ref QUANTUM_PAINTER_SPI_ASYNC_BUFFER_SIZE bytes. The SPI bus is released once the last transfer has completed,
+ *      which can be checked using \ref qp_flush_complete.
+ */
+#    define QUANTUM_PAINTER_SPI_ASYNC FALSE
+#endif // QUANTUM_PAINTER_SPI_ASYNC
+
+#ifndef QUANTUM_PAINTER_SPI_ASYNC_BUFFER_SIZE
+/**
+ * @def This controls the size of each of the two buffers used by \ref QUANTUM_PAINTER_SPI_ASYNC. Drawing only waits
+ *      for the bus once a whole buffer has been gathered while the other one is still being transmitted.
+ */
+#    define QUANTUM_PAINTER_SPI_ASYNC_BUFFER_SIZE 512
+#endif // QUANTUM_PAINTER_SPI_ASYNC_BUFFER_SIZE
+
+#ifndef QUANTUM_PAINTER_SPI_ASYNC_TIMEOUT_MS
+/**
+ * @def This controls how long \ref QUANTUM_PAINTER_SPI_ASYNC waits for a background transfer before giving up on it.
+ */
+#    define QUANTUM_PAINTER_SPI_ASYNC_TIMEOUT_MS 100
+#endif // QUANTUM_PAINTER_SPI_ASYNC_TIMEOUT_MS
+
+#ifndef QUANTUM_PAINTER_PALETTE_CACHE_SIZE
+/**
+ * @def This controls the number of palettes kept after conversion to the display's native pixel format, so that
+ *      redrawing an image, or text, with the same colors on the same display doesn't need to convert them again. Each
+ *      entry requires roughly 90 bytes of RAM. Palettes with more than 16 colors are not cached. Set to 0 to disable.
+ */
+#    define QUANTUM_PAINTER_PALETTE_CACHE_SIZE 4
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE
+
+#ifndef QUANTUM_PAINTER_DECODE_SPAN_SIZE
+/**
+ * @def This controls how many pixels of image and font data are decoded at a time, using a stack buffer of the same
+ *      number of bytes. Whole RLE runs and packed bytes are then expanded in one go and handed to the display driver as
+ *      a single span. Must be a multiple of 8. Set to 0 to decode one pixel at a time, which uses the least RAM.
+ */
+#    define QUANTUM_PAINTER_DECODE_SPAN_SIZE 64
+#endif // QUANTUM_PAINTER_DECODE_SPAN_SIZE
+
 #ifndef QUANTUM_PAINTER_SUPPORTS_256_PALETTE
 /**
  * @def This controls whether 256-color palettes are supported. This has relatively hefty requirements on RAM -- at
@@ -64,6 +116,30 @@
 #    define QUANTUM_PAINTER_SUPPORTS_256_PALETTE FALSE
 #endif
 
+#ifndef QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE
+/**
+ * @def This controls the size of each block read ahead from external flash when loading images and fonts from it. Reads
+ *      of external flash are done a block at a time, and kept in RAM while the asset is being drawn.
+ */
+#    define QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE 256
+#endif // QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE
+
+#ifndef QUANTUM_PAINTER_FLASH_CACHE_BLOCKS
+/**
+ * @def This controls the number of external flash blocks kept in RAM, shared between all images and fonts loaded from
+ *      external flash.
+ */
+#    define QUANTUM_PAINTER_FLASH_CACHE_BLOCKS 2
+#endif // QUANTUM_PAINTER_FLASH_CACHE_BLOCKS
+
+#ifndef QUANTUM_PAINTER_ASSET_PACK_ADDRESS
+/**
+ * @def This controls the location in external flash of the asset pack used by \ref qp_load_image_asset and
+ *      \ref qp_load_font_asset.
+ */
+#    define QUANTUM_PAINTER_ASSET_PACK_ADDRESS 0
+#endif // QUANTUM_PAINTER_ASSET_PACK_ADDRESS
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter types
 
@@ -151,6 +227,18 @@ bool qp_clear(painter_device_t device);
  */
 bool qp_flush(painter_device_t device);
 
+/**
+ * Checks whether everything sent to the display has finished transmitting.
+ *
+ * @note Only displays sending data in the background (see \ref QUANTUM_PAINTER_SPI_ASYNC) can return false. Drawing
+ *       to the same display again doesn't need to wait for this, but other users of the bus may.
+ *
+ * @param device[in] the handle of the device to check
+ * @return true if all transfers to the display have completed, and the bus has been released
+ * @return false if data is still being transmitted
+ */
+bool qp_flush_complete(painter_device_t device);
+
 /**
  * Retrieves the size, rotation, and offsets for the display.
  *
@@ -294,6 +382,34 @@ bool qp_pixdata(painter_device_t device, const void *pixel_data, uint32_t native
  */
 painter_image_handle_t qp_load_image_mem(const void *buffer);
 
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
+/**
+ * Loads an image stored in external flash.
+ *
+ * @note Images can be unloaded by calling \ref qp_close_image. Image data is read from flash as it's drawn.
+ *
+ * @param address[in] the location of the image data in external flash
+ * @return an image handle usable with \ref qp_drawimage, \ref qp_drawimage_recolor, \ref qp_animate, and
+ *         \ref qp_animate_recolor.
+ * @return NULL if loading the image failed
+ */
+painter_image_handle_t qp_load_image_flash(uint32_t address);
+
+/**
+ * Loads an image from the asset pack in external flash, by name.
+ *
+ * @note Images can be unloaded by calling \ref qp_close_image.
+ *
+ * @param name[in] the name of the image in the asset pack
+ * @return an image handle usable with \ref qp_drawimage, \ref qp_drawimage_recolor, \ref qp_animate, and
+ *         \ref qp_animate_recolor.
+ * @return NULL if the image could not be found, or loading the image failed
+ */
+painter_image_handle_t qp_load_image_asset(const char *name);
+
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
 /**
  * Closes an image handle when no longer in use.
  *
@@ -381,6 +497,33 @@ void qp_stop_animation(deferred_token anim_token);
  */
 painter_font_handle_t qp_load_font_mem(const void *buffer);
 
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
+/**
+ * Loads a font stored in external flash.
+ *
+ * @note Fonts can be unloaded by calling \ref qp_close_font. Font data is read from flash as it's drawn, unless
+ *       \ref QUANTUM_PAINTER_LOAD_FONTS_TO_RAM is set to TRUE.
+ *
+ * @param address[in] the location of the font data in external flash
+ * @return an image handle usable with \ref qp_textwidth, \ref qp_drawtext, and \ref qp_drawtext_recolor.
+ * @return NULL if loading the font failed
+ */
+painter_font_handle_t qp_load_font_flash(uint32_t address);
+
+/**
+ * Loads a font from the asset pack in external flash, by name.
+ *
+ * @note Fonts can be unloaded by calling \ref qp_close_font.
+ *
+ * @param name[in] the name of the font in the asset pack
+ * @return an image handle usable with \ref qp_textwidth, \ref qp_drawtext, and \ref qp_drawtext_recolor.
+ * @return NULL if the font could not be found, or loading the font failed
+ */
+painter_font_handle_t qp_load_font_asset(const char *name);
+
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
 /**
  * Closes a font handle when no longer in use.
  *
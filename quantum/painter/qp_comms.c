@@ -6,6 +6,35 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Base comms APIs
 
+// The device whose comms are currently started, if any
+static painter_device_t active_device = NULL;
+
+// The device whose comms were stopped while still transmitting in the background, if any
+static painter_device_t pending_stop_device = NULL;
+
+static bool qp_comms_busy(painter_device_t device) {
+    struct painter_driver_t *driver = (struct painter_driver_t *)device;
+    return driver->comms_vtable->comms_busy && driver->comms_vtable->comms_busy(device);
+}
+
+// Completes a deferred stop once the background transfer has finished, optionally waiting for it
+static bool qp_comms_release(bool wait) {
+    if (!pending_stop_device) {
+        return true;
+    }
+
+    while (qp_comms_busy(pending_stop_device)) {
+        if (!wait) {
+            return false;
+        }
+    }
+
+    struct painter_driver_t *driver = (struct painter_driver_t *)pending_stop_device;
+    driver->comms_vtable->comms_stop(pending_stop_device);
+    pending_stop_device = NULL;
+    return true;
+}
+
 bool qp_comms_init(painter_device_t device) {
     struct painter_driver_t *driver = (struct painter_driver_t *)device;
     if (!driver->validate_ok) {
@@ -13,6 +42,8 @@ bool qp_comms_init(painter_device_t device) {
         return false;
     }
 
+    // Pins may be shared with a display that's still transmitting
+    qp_comms_release(true);
     return driver->comms_vtable->comms_init(device);
 }
 
@@ -23,7 +54,18 @@ bool qp_comms_start(painter_device_t device) {
         return false;
     }
 
-    return driver->comms_vtable->comms_start(device);
+    if (pending_stop_device == device) {
+        // Still selected from last time, carry on without waiting for the transfer to finish
+        pending_stop_device = NULL;
+    } else {
+        qp_comms_release(true);
+        if (!driver->comms_vtable->comms_start(device)) {
+            return false;
+        }
+    }
+
+    active_device = device;
+    return true;
 }
 
 void qp_comms_stop(painter_device_t device) {
@@ -33,9 +75,49 @@ void qp_comms_stop(painter_device_t device) {
         return;
     }
 
+    active_device = NULL;
+    if (qp_comms_busy(device)) {
+        // Let the transfer finish in the background, the stop completes in qp_comms_task() or the next qp_comms_start()
+        pending_stop_device = device;
+        return;
+    }
+
     driver->comms_vtable->comms_stop(device);
 }
 
+bool qp_comms_complete(painter_device_t device) {
+    return qp_comms_release(false) || pending_stop_device != device;
+}
+
+void qp_comms_task(void) {
+    qp_comms_release(false);
+}
+
+painter_device_t qp_comms_suspend(void) {
+    qp_comms_release(true);
+    painter_device_t device = active_device;
+    if (device) {
+        while (qp_comms_busy(device)) {
+        }
+        qp_comms_stop(device);
+    }
+    return device;
+}
+
+void qp_comms_resume(painter_device_t device) {
+    if (device && qp_comms_start(device)) {
+        // Deselecting may have ended the pixel write, so the driver picks it up again where it stopped
+        struct painter_driver_t *driver = (struct painter_driver_t *)device;
+        if (driver->driver_vtable->resume_pixdata) {
+            driver->driver_vtable->resume_pixdata(device);
+        }
+    }
+}
+
+bool qp_comms_idle(void) {
+    return !active_device && !pending_stop_device;
+}
+
 uint32_t qp_comms_send(painter_device_t device, const void *data, uint32_t byte_count) {
     struct painter_driver_t *driver = (struct painter_driver_t *)device;
     if (!driver->validate_ok) {
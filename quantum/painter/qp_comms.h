@@ -16,6 +16,23 @@ bool     qp_comms_start(painter_device_t device);
 void     qp_comms_stop(painter_device_t device);
 uint32_t qp_comms_send(painter_device_t device, const void* data, uint32_t byte_count);
 
+// Polls for the end of background transfers, releasing the bus once they're done. qp_comms_complete() returns false
+// while the supplied device is still transmitting.
+bool qp_comms_complete(painter_device_t device);
+void qp_comms_task(void);
+
+// Temporarily releases the comms of whichever device is mid-operation, so that other peripherals on the same bus
+// (such as external flash) can be accessed. Returns the device to hand back to qp_comms_resume().
+//
+// A display in the middle of receiving pixel data is deselected once everything queued for it has been sent. Not
+// every panel carries on with a memory write after its chip select has been released, so on resume the driver sends
+// the viewport again for the pixels that are still to come (see resume_pixdata in painter_driver_vtable_t).
+painter_device_t qp_comms_suspend(void);
+void             qp_comms_resume(painter_device_t device);
+
+// Returns whether no device's comms are started, including stops still waiting for a background transfer to finish.
+bool qp_comms_idle(void);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Comms APIs that use a D/C pin
 
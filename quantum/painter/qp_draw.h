@@ -52,6 +52,17 @@ void qp_internal_invalidate_palette(void);
 // Helper shared between image and font rendering -- sets up the global palette to match the palette block specified in the asset. Expects the stream to be positioned at the start of the block header.
 bool qp_internal_load_qgf_palette(qp_stream_t* stream, uint8_t bpp);
 
+// Sets up the global palette with native pixels, reusing a recent conversion for the same device where possible. If source is an image or font handle,
+// the palette block is read from its stream, which is expected to be positioned at the start of the block header and is left positioned after the block.
+// Otherwise, source and stream are NULL and the palette is interpolated from fg/bg.
+bool qp_internal_prepare_palette(painter_device_t device, const void* source, qp_stream_t* stream, uint8_t bpp, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888);
+
+// Forgets any converted palettes for a device or an image/font handle. Needed whenever a handle is closed, as it may be reused for a different asset.
+void qp_internal_evict_palettes(const void* owner);
+
+// Converts palette entries from HSV888 to RGB888 in place, only converting each run of identical colors once. Used by drivers to implement palette_convert.
+void qp_internal_palette_hsv888_to_rgb888(int16_t palette_size, qp_pixel_t* palette);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter codec functions
 
@@ -62,9 +73,10 @@ enum qp_internal_rle_mode_t {
 };
 
 struct qp_internal_byte_input_state {
-    painter_device_t device;
-    qp_stream_t*     src_stream;
-    int16_t          curr;
+    painter_device_t      device;
+    qp_stream_t*          src_stream;
+    painter_compression_t compression;
+    int16_t               curr;
     union {
         // RLE-specific
         struct {
@@ -83,3 +95,7 @@ struct qp_internal_pixel_output_state {
 bool qp_internal_pixel_appender(qp_pixel_t* palette, uint8_t index, void* cb_arg);
 
 qp_internal_byte_input_callback qp_internal_prepare_input_state(struct qp_internal_byte_input_state* input_state, painter_compression_t compression);
+
+// Decodes pixel data from the input state into the pixdata buffer, transmitting each time it fills up. Leftover pixels are left in the buffer for the caller to send.
+// Decodes a span of pixels at a time, or a pixel at a time through the byte input and pixel output callbacks if QUANTUM_PAINTER_DECODE_SPAN_SIZE is 0. An input state must only be used with one of the two.
+bool qp_internal_decode_pixdata(painter_device_t device, uint32_t pixel_count, uint8_t bits_per_pixel, struct qp_internal_byte_input_state* input_state, qp_pixel_t* palette, struct qp_internal_pixel_output_state* output_state);
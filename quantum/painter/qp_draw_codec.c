@@ -1,10 +1,16 @@
 // Copyright 2021 Nick Brassel (@tzarc)
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <string.h>
+
 #include "qp_internal.h"
 #include "qp_draw.h"
 #include "qp_comms.h"
 
+#if (QUANTUM_PAINTER_DECODE_SPAN_SIZE % 8) != 0
+#    error QUANTUM_PAINTER_DECODE_SPAN_SIZE must be a multiple of 8
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Palette / Monochrome-format decoder
 
@@ -53,12 +59,8 @@ bool qp_internal_decode_grayscale(painter_device_t device, uint32_t pixel_count,
 }
 
 bool qp_internal_decode_recolor(painter_device_t device, uint32_t pixel_count, uint8_t bits_per_pixel, qp_internal_byte_input_callback input_callback, void* input_arg, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, qp_internal_pixel_output_callback output_callback, void* output_arg) {
-    struct painter_driver_t* driver = (struct painter_driver_t*)device;
-    int16_t                  steps  = 1 << bits_per_pixel; // number of items we need to interpolate
-    if (qp_internal_interpolate_palette(fg_hsv888, bg_hsv888, steps)) {
-        if (!driver->driver_vtable->palette_convert(device, steps, qp_internal_global_pixel_lookup_table)) {
-            return false;
-        }
+    if (!qp_internal_prepare_palette(device, NULL, NULL, bits_per_pixel, fg_hsv888, bg_hsv888)) {
+        return false;
     }
 
     return qp_internal_decode_palette(device, pixel_count, bits_per_pixel, input_callback, input_arg, qp_internal_global_pixel_lookup_table, output_callback, output_arg);
@@ -128,15 +130,138 @@ bool qp_internal_pixel_appender(qp_pixel_t* palette, uint8_t index, void* cb_arg
     return true;
 }
 
-qp_internal_byte_input_callback qp_internal_prepare_input_state(struct qp_internal_byte_input_state* input_state, painter_compression_t compression) {
+static qp_internal_byte_input_callback qp_internal_byte_input_decoder(painter_compression_t compression) {
     switch (compression) {
         case IMAGE_UNCOMPRESSED:
             return qp_drawimage_byte_uncompressed_decoder;
         case IMAGE_COMPRESSED_RLE:
-            input_state->rle.mode   = MARKER_BYTE;
-            input_state->rle.remain = 0;
             return qp_drawimage_byte_rle_decoder;
         default:
             return NULL;
     }
 }
+
+qp_internal_byte_input_callback qp_internal_prepare_input_state(struct qp_internal_byte_input_state* input_state, painter_compression_t compression) {
+    input_state->compression = compression;
+    input_state->rle.mode    = MARKER_BYTE;
+    input_state->rle.remain  = 0;
+    return qp_internal_byte_input_decoder(compression);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Span decoding, pulling runs of bytes and pushing runs of pixels
+
+#if QUANTUM_PAINTER_DECODE_SPAN_SIZE > 0
+
+// Reads the next `length` bytes of decompressed data, expanding RLE runs with a single memset or stream read each
+static bool qp_internal_read_span(struct qp_internal_byte_input_state* state, uint8_t* buffer, uint32_t length) {
+    if (state->compression == IMAGE_UNCOMPRESSED) {
+        return qp_stream_read(buffer, 1, length, state->src_stream) == length;
+    }
+
+    while (length > 0) {
+        if (state->rle.mode == MARKER_BYTE) {
+            int16_t c = qp_stream_get(state->src_stream);
+            if (c < 0) {
+                return false;
+            }
+            if (c >= 128) {
+                state->rle.mode   = NON_REPEATING_RUN;
+                state->rle.remain = c - 127;
+            } else {
+                state->rle.mode   = REPEATING_RUN;
+                state->rle.remain = c;
+                state->curr       = qp_stream_get(state->src_stream);
+                if (state->curr < 0) {
+                    return false;
+                }
+            }
+        }
+
+        uint8_t run = QP_MIN(state->rle.remain, length);
+        if (state->rle.mode == REPEATING_RUN) {
+            memset(buffer, state->curr, run);
+        } else if (qp_stream_read(buffer, 1, run, state->src_stream) != run) {
+            return false;
+        }
+
+        buffer += run;
+        length -= run;
+        state->rle.remain -= run;
+        if (state->rle.remain == 0) {
+            state->rle.mode = MARKER_BYTE;
+        }
+    }
+
+    return true;
+}
+
+static bool qp_internal_decode_span(painter_device_t device, uint32_t pixel_count, uint8_t bits_per_pixel, struct qp_internal_byte_input_state* input_state, qp_pixel_t* palette, struct qp_internal_pixel_output_state* output_state) {
+    struct painter_driver_t* driver          = (struct painter_driver_t*)device;
+    const uint8_t            pixel_bitmask   = (1 << bits_per_pixel) - 1;
+    const uint8_t            pixels_per_byte = 8 / bits_per_pixel;
+    uint8_t                  indices[QUANTUM_PAINTER_DECODE_SPAN_SIZE];
+
+    uint32_t remaining_pixels = pixel_count;
+    while (remaining_pixels > 0) {
+        // Only the last span of the image may end partway through a byte, as the span size is a multiple of 8
+        uint32_t span_pixels = QP_MIN(remaining_pixels, QUANTUM_PAINTER_DECODE_SPAN_SIZE);
+        uint32_t span_bytes  = (span_pixels + pixels_per_byte - 1) / pixels_per_byte;
+
+        // Packed bytes are read into the end of the buffer, so that they can be expanded into indices front to back in place
+        uint8_t* packed = &indices[QUANTUM_PAINTER_DECODE_SPAN_SIZE - span_bytes];
+        if (!qp_internal_read_span(input_state, packed, span_bytes)) {
+            return false;
+        }
+
+        uint8_t* span = packed;
+        if (pixels_per_byte > 1) {
+            span = indices;
+            for (uint32_t i = 0, pos = 0; i < span_bytes; ++i) {
+                uint8_t byteval     = packed[i];
+                uint8_t loop_pixels = QP_MIN(span_pixels - pos, pixels_per_byte);
+                if (byteval == 0x00 || byteval == 0xFF) {
+                    // All pixels in the byte share the same index, e.g. background or solid foreground
+                    memset(&indices[pos], byteval & pixel_bitmask, loop_pixels);
+                    pos += loop_pixels;
+                } else {
+                    for (uint8_t q = 0; q < loop_pixels; ++q) {
+                        indices[pos++] = byteval & pixel_bitmask;
+                        byteval >>= bits_per_pixel;
+                    }
+                }
+            }
+        }
+
+        // Convert the span into native pixels, transmitting each time the pixdata buffer fills up
+        uint32_t done = 0;
+        while (done < span_pixels) {
+            uint32_t count = QP_MIN(span_pixels - done, output_state->max_pixels - output_state->pixel_write_pos);
+            if (!driver->driver_vtable->append_pixels(device, qp_internal_global_pixdata_buffer, palette, output_state->pixel_write_pos, count, &span[done])) {
+                return false;
+            }
+            done += count;
+            output_state->pixel_write_pos += count;
+            if (output_state->pixel_write_pos == output_state->max_pixels) {
+                if (!driver->driver_vtable->pixdata(device, qp_internal_global_pixdata_buffer, output_state->pixel_write_pos)) {
+                    return false;
+                }
+                output_state->pixel_write_pos = 0;
+            }
+        }
+
+        remaining_pixels -= span_pixels;
+    }
+
+    return true;
+}
+
+#endif // QUANTUM_PAINTER_DECODE_SPAN_SIZE > 0
+
+bool qp_internal_decode_pixdata(painter_device_t device, uint32_t pixel_count, uint8_t bits_per_pixel, struct qp_internal_byte_input_state* input_state, qp_pixel_t* palette, struct qp_internal_pixel_output_state* output_state) {
+#if QUANTUM_PAINTER_DECODE_SPAN_SIZE > 0
+    return qp_internal_decode_span(device, pixel_count, bits_per_pixel, input_state, palette, output_state);
+#else
+    return qp_internal_decode_palette(device, pixel_count, bits_per_pixel, qp_internal_byte_input_decoder(input_state->compression), input_state, palette, qp_internal_pixel_appender, output_state);
+#endif
+}
@@ -2,6 +2,7 @@
 // Copyright 2021 Paul Cotter (@gr1mr3aver)
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "color.h"
 #include "qp_internal.h"
 #include "qp_comms.h"
 #include "qp_draw.h"
@@ -33,6 +34,34 @@ __attribute__((__aligned__(4))) qp_pixel_t qp_internal_global_pixel_lookup_table
 __attribute__((__aligned__(4))) qp_pixel_t qp_internal_global_pixel_lookup_table[16];
 #endif
 
+// Identifies a palette after conversion to native pixels -- either a palette block embedded in an image or font, or a
+// palette interpolated from foreground and background colors.
+typedef struct qp_palette_key_t {
+    painter_device_t device;
+    const void *     source; // image or font handle containing the palette block, NULL if interpolated
+    int32_t          offset; // location of the palette block within the source's stream
+    qp_pixel_t       fg_hsv888;
+    qp_pixel_t       bg_hsv888;
+    uint16_t         entries;
+} qp_palette_key_t;
+
+// Palette currently held in the lookup table as native pixels, if any
+static bool             lookup_table_native = false;
+static qp_palette_key_t lookup_table_key;
+
+#if QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+// Recently converted palettes, restored into the lookup table instead of being converted again
+typedef struct qp_palette_cache_entry_t {
+    bool             valid;
+    uint32_t         last_used;
+    qp_palette_key_t key;
+    qp_pixel_t       native[16];
+} qp_palette_cache_entry_t;
+
+static qp_palette_cache_entry_t palette_cache[QUANTUM_PAINTER_PALETTE_CACHE_SIZE];
+static uint32_t                 palette_cache_counter = 0;
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Helpers
 
@@ -66,8 +95,9 @@ void qp_internal_fill_pixdata(painter_device_t device, uint32_t num_pixels, uint
 
 // Resets the global palette so that it can be regenerated. Only needed if the colors are identical, but a different display is used with a different internal pixel format.
 void qp_internal_invalidate_palette(void) {
-    generated_palette = false;
-    generated_steps   = -1;
+    generated_palette   = false;
+    generated_steps     = -1;
+    lookup_table_native = false;
 }
 
 // Interpolates between two colors to generate a palette
@@ -80,6 +110,7 @@ bool qp_internal_interpolate_palette(qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888,
     }
 
     // Save the parameters so we know whether we can skip generation
+    lookup_table_native    = false;
     generated_palette      = true;
     generated_steps        = steps;
     interpolated_fg_hsv888 = fg_hsv888;
@@ -140,6 +171,137 @@ bool qp_internal_load_qgf_palette(qp_stream_t *stream, uint8_t bpp) {
     return true;
 }
 
+// Converts palette entries from HSV888 to RGB888 in place, for use by drivers when converting to their native format.
+// Palettes often contain runs of the same color, such as the unused entries at the end of a QGF palette, or steps
+// between similar colors, so each run is only converted once.
+void qp_internal_palette_hsv888_to_rgb888(int16_t palette_size, qp_pixel_t *palette) {
+    RGB rgb = {0};
+    HSV hsv = {0};
+    for (int16_t i = 0; i < palette_size; ++i) {
+        if (i == 0 || palette[i].hsv888.h != hsv.h || palette[i].hsv888.s != hsv.s || palette[i].hsv888.v != hsv.v) {
+            hsv = (HSV){palette[i].hsv888.h, palette[i].hsv888.s, palette[i].hsv888.v};
+            rgb = hsv_to_rgb_nocie(hsv);
+        }
+        palette[i].rgb888.r = rgb.r;
+        palette[i].rgb888.g = rgb.g;
+        palette[i].rgb888.b = rgb.b;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Native palette cache
+
+static bool qp_palette_key_equal(const qp_palette_key_t *a, const qp_palette_key_t *b) {
+    return a->device == b->device && a->source == b->source && a->offset == b->offset && a->entries == b->entries && memcmp(&a->fg_hsv888.hsv888, &b->fg_hsv888.hsv888, sizeof(a->fg_hsv888.hsv888)) == 0 && memcmp(&a->bg_hsv888.hsv888, &b->bg_hsv888.hsv888, sizeof(a->bg_hsv888.hsv888)) == 0;
+}
+
+// Moves the stream past a palette block that didn't need to be read
+static bool qp_palette_skip_block(qp_stream_t *stream, uint16_t palette_entries) {
+    return qp_stream_seek(stream, sizeof(qgf_palette_v1_t) + palette_entries * sizeof(qgf_palette_entry_v1_t), SEEK_CUR) == 0;
+}
+
+#if QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+static qp_palette_cache_entry_t *qp_palette_cache_find(const qp_palette_key_t *key) {
+    for (uint8_t i = 0; i < QUANTUM_PAINTER_PALETTE_CACHE_SIZE; ++i) {
+        if (palette_cache[i].valid && qp_palette_key_equal(&palette_cache[i].key, key)) {
+            palette_cache[i].last_used = ++palette_cache_counter;
+            return &palette_cache[i];
+        }
+    }
+    return NULL;
+}
+
+// Saves the lookup table into the least recently used cache entry
+static void qp_palette_cache_store(const qp_palette_key_t *key) {
+    qp_palette_cache_entry_t *entry = &palette_cache[0];
+    for (uint8_t i = 1; i < QUANTUM_PAINTER_PALETTE_CACHE_SIZE && entry->valid; ++i) {
+        if (!palette_cache[i].valid || palette_cache[i].last_used < entry->last_used) {
+            entry = &palette_cache[i];
+        }
+    }
+
+    entry->valid     = true;
+    entry->last_used = ++palette_cache_counter;
+    entry->key       = *key;
+    memcpy(entry->native, qp_internal_global_pixel_lookup_table, key->entries * sizeof(qp_pixel_t));
+}
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+
+// Sets up the lookup table with the native pixels for a palette, reusing an earlier conversion if the same palette was
+// recently used on the same device.
+bool qp_internal_prepare_palette(painter_device_t device, const void *source, qp_stream_t *stream, uint8_t bpp, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888) {
+    struct painter_driver_t *driver          = (struct painter_driver_t *)device;
+    const uint16_t           palette_entries = 1u << bpp;
+
+    qp_palette_key_t key;
+    memset(&key, 0, sizeof(key));
+    key.device  = device;
+    key.source  = source;
+    key.entries = palette_entries;
+    if (source) {
+        key.offset = qp_stream_tell(stream);
+    } else {
+        key.fg_hsv888 = fg_hsv888;
+        key.bg_hsv888 = bg_hsv888;
+    }
+
+    // Nothing to do if the lookup table already holds this palette
+    if (lookup_table_native && qp_palette_key_equal(&lookup_table_key, &key)) {
+        return source ? qp_palette_skip_block(stream, palette_entries) : true;
+    }
+
+#if QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+    qp_palette_cache_entry_t *entry = qp_palette_cache_find(&key);
+    if (entry) {
+        qp_internal_invalidate_palette();
+        memcpy(qp_internal_global_pixel_lookup_table, entry->native, palette_entries * sizeof(qp_pixel_t));
+        lookup_table_native = true;
+        lookup_table_key    = key;
+        return source ? qp_palette_skip_block(stream, palette_entries) : true;
+    }
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+
+    if (source) {
+        // Load the palette from the stream
+        if (!qp_internal_load_qgf_palette(stream, bpp)) {
+            return false;
+        }
+    } else {
+        // Interpolate from fg/bg -- the lookup table may hold the same colors converted for a different device
+        qp_internal_invalidate_palette();
+        qp_internal_interpolate_palette(fg_hsv888, bg_hsv888, palette_entries);
+    }
+
+    // Convert the palette to native format
+    if (!driver->driver_vtable->palette_convert(device, palette_entries, qp_internal_global_pixel_lookup_table)) {
+        qp_internal_invalidate_palette();
+        return false;
+    }
+
+    lookup_table_native = true;
+    lookup_table_key    = key;
+#if QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+    if (palette_entries <= (sizeof(entry->native) / sizeof(entry->native[0]))) {
+        qp_palette_cache_store(&key);
+    }
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+    return true;
+}
+
+// Forgets any converted palettes for a device, or from an image/font handle, as the handle may be reused for a different asset.
+void qp_internal_evict_palettes(const void *owner) {
+    if (lookup_table_native && (lookup_table_key.device == owner || lookup_table_key.source == owner)) {
+        lookup_table_native = false;
+    }
+#if QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+    for (uint8_t i = 0; i < QUANTUM_PAINTER_PALETTE_CACHE_SIZE; ++i) {
+        if (palette_cache[i].key.device == owner || palette_cache[i].key.source == owner) {
+            palette_cache[i].valid = false;
+        }
+    }
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter External API: qp_setpixel
 
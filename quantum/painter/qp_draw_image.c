@@ -5,6 +5,7 @@
 #include "qp_draw.h"
 #include "qp_comms.h"
 #include "qgf.h"
+#include "qap.h"
 #include "deferred_exec.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -19,6 +20,9 @@ typedef struct qgf_image_handle_t {
 #ifdef QP_STREAM_HAS_FILE_IO
         qp_file_stream_t file_stream;
 #endif // QP_STREAM_HAS_FILE_IO
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+        qp_flash_stream_t flash_stream;
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
     };
 } qgf_image_handle_t;
 
@@ -85,6 +89,42 @@ painter_image_handle_t qp_load_image_mem(const void *buffer) {
     return qp_load_image_internal(image_mem_stream_factory, (void *)buffer);
 }
 
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_load_image_flash
+
+static inline bool image_flash_stream_factory(qgf_image_handle_t *image, void *arg) {
+    uint32_t address = *(uint32_t *)arg;
+
+    // Assume we can read the graphics descriptor
+    image->flash_stream = qp_make_flash_stream(address, sizeof(qgf_graphics_descriptor_v1_t));
+
+    // Update the length of the stream to match, and rewind to the start
+    image->flash_stream.length   = qgf_get_total_size(&image->stream);
+    image->flash_stream.position = 0;
+
+    return true;
+}
+
+painter_image_handle_t qp_load_image_flash(uint32_t address) {
+    return qp_load_image_internal(image_flash_stream_factory, &address);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_load_image_asset
+
+painter_image_handle_t qp_load_image_asset(const char *name) {
+    uint32_t address;
+    if (!qap_find_flash_asset(name, &address)) {
+        qp_dprintf("qp_load_image_asset: fail (could not find '%s' in the asset pack)\n", name);
+        return NULL;
+    }
+    return qp_load_image_flash(address);
+}
+
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter External API: qp_close_image
 
@@ -96,6 +136,7 @@ bool qp_close_image(painter_image_handle_t image) {
     }
 
     // Free up this image for use elsewhere.
+    qp_internal_evict_palettes(qgf_image);
     qgf_image->validate_ok = false;
     qp_stream_close(&qgf_image->stream);
     return true;
@@ -124,8 +165,6 @@ typedef struct qgf_frame_info_t {
 } qgf_frame_info_t;
 
 static bool qp_drawimage_prepare_frame_for_stream_read(painter_device_t device, qgf_image_handle_t *qgf_image, uint16_t frame_number, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, qgf_frame_info_t *info) {
-    struct painter_driver_t *driver = (struct painter_driver_t *)device;
-
     // Drop out if we can't actually place the data we read out anywhere
     if (!info) {
         qp_dprintf("Failed to prepare stream for read, output info buffer unavailable\n");
@@ -147,37 +186,17 @@ static bool qp_drawimage_prepare_frame_for_stream_read(painter_device_t device,
         return false;
     }
 
-    // Ensure we aren't reusing any palette
-    qp_internal_invalidate_palette();
-
     if (!qp_internal_bpp_capable(info->bpp)) {
         qp_dprintf("qp_drawimage_recolor: fail (image bpp too high (%d), check QUANTUM_PAINTER_SUPPORTS_256_PALETTE)\n", (int)info->bpp);
         qp_comms_stop(device);
         return false;
     }
 
-    // Handle palette if needed
-    const uint16_t palette_entries  = 1u << info->bpp;
-    bool           needs_pixconvert = false;
-    if (info->has_palette) {
-        // Load the palette from the stream
-        if (!qp_internal_load_qgf_palette((qp_stream_t *)&qgf_image->stream, info->bpp)) {
-            return false;
-        }
-
-        needs_pixconvert = true;
-    } else {
-        // Interpolate from fg/bg
-        needs_pixconvert = qp_internal_interpolate_palette(fg_hsv888, bg_hsv888, palette_entries);
-    }
-
-    if (needs_pixconvert) {
-        // Convert the palette to native format
-        if (!driver->driver_vtable->palette_convert(device, palette_entries, qp_internal_global_pixel_lookup_table)) {
-            qp_dprintf("qp_drawimage_recolor: fail (could not convert pixels to native)\n");
-            qp_comms_stop(device);
-            return false;
-        }
+    // Set up the native palette, either from the frame or interpolated from fg/bg
+    if (!qp_internal_prepare_palette(device, info->has_palette ? qgf_image : NULL, info->has_palette ? (qp_stream_t *)&qgf_image->stream : NULL, info->bpp, fg_hsv888, bg_hsv888)) {
+        qp_dprintf("qp_drawimage_recolor: fail (could not convert pixels to native)\n");
+        qp_comms_stop(device);
+        return false;
     }
 
     // Handle delta if needed
@@ -264,7 +283,7 @@ static bool qp_drawimage_recolor_impl(painter_device_t device, uint16_t x, uint1
     struct qp_internal_pixel_output_state output_state = {.device = device, .pixel_write_pos = 0, .max_pixels = qp_internal_num_pixels_in_buffer(device)};
 
     // Decode the pixel data and stream to the display
-    bool ret = qp_internal_decode_palette(device, pixel_count, frame_info->bpp, input_callback, &input_state, qp_internal_global_pixel_lookup_table, qp_internal_pixel_appender, &output_state);
+    bool ret = qp_internal_decode_pixdata(device, pixel_count, frame_info->bpp, &input_state, qp_internal_global_pixel_lookup_table, &output_state);
 
     // Any leftovers need transmission as well.
     if (ret && output_state.pixel_write_pos > 0) {
@@ -8,6 +8,7 @@
 #include "qp_draw.h"
 #include "qp_comms.h"
 #include "qff.h"
+#include "qap.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // QFF font handles
@@ -20,12 +21,22 @@ typedef struct qff_font_handle_t {
     uint8_t               bpp;
     bool                  has_palette;
     painter_compression_t compression_scheme;
+    uint32_t              unicode_table_offset; // location of the first unicode glyph entry
+    uint32_t              glyph_data_offset;    // location of the first byte of glyph data
+    bool                  unicode_table_sorted; // whether the unicode table can be binary searched
+#if QUANTUM_PAINTER_GLYPH_CACHE_SIZE > 0
+    qff_unicode_glyph_v1_t glyph_cache[QUANTUM_PAINTER_GLYPH_CACHE_SIZE]; // most recently used first
+    uint8_t                glyph_cache_count;
+#endif // QUANTUM_PAINTER_GLYPH_CACHE_SIZE > 0
     union {
         qp_stream_t        stream;
         qp_memory_stream_t mem_stream;
 #ifdef QP_STREAM_HAS_FILE_IO
         qp_file_stream_t file_stream;
 #endif // QP_STREAM_HAS_FILE_IO
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+        qp_flash_stream_t flash_stream;
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
     };
 #if QUANTUM_PAINTER_LOAD_FONTS_TO_RAM
     bool  owns_buffer;
@@ -35,6 +46,50 @@ typedef struct qff_font_handle_t {
 
 static qff_font_handle_t font_descriptors[QUANTUM_PAINTER_NUM_FONTS] = {0};
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Helper: unicode glyph table access
+
+static inline bool qff_read_unicode_glyph(qff_font_handle_t *font, uint16_t index, qff_unicode_glyph_v1_t *glyph_info) {
+    if (qp_stream_setpos(&font->stream, font->unicode_table_offset + (uint32_t)index * sizeof(qff_unicode_glyph_v1_t)) < 0) {
+        return false;
+    }
+    return qp_stream_read(glyph_info, sizeof(qff_unicode_glyph_v1_t), 1, &font->stream) == 1;
+}
+
+// Works out the location of the tables, and whether the unicode table is in ascending code point order
+static void qff_prepare_glyph_lookup(qff_font_handle_t *font) {
+    uint32_t offset = sizeof(qff_font_descriptor_v1_t);
+    if (font->has_ascii_table) {
+        offset += sizeof(qff_ascii_glyph_table_v1_t);
+    }
+    font->unicode_table_offset = offset + sizeof(qgf_block_header_v1_t);
+    if (font->num_unicode_glyphs > 0) {
+        offset += sizeof(qff_unicode_glyph_table_v1_t) + (font->num_unicode_glyphs * sizeof(qff_unicode_glyph_v1_t));
+    }
+    if (font->has_palette) {
+        offset += sizeof(qgf_palette_v1_t) + ((1 << font->bpp) * sizeof(qgf_palette_entry_v1_t));
+    }
+    font->glyph_data_offset = offset + sizeof(qgf_block_header_v1_t);
+
+    // Fonts converted by `qmk painter-convert-font-image` are sorted, but don't rely on it for hand-crafted files
+    font->unicode_table_sorted = true;
+    if (font->num_unicode_glyphs > 0 && qp_stream_setpos(&font->stream, font->unicode_table_offset) >= 0) {
+        qff_unicode_glyph_v1_t glyph_info;
+        uint32_t               previous = 0;
+        for (uint16_t i = 0; i < font->num_unicode_glyphs; ++i) {
+            if (qp_stream_read(&glyph_info, sizeof(qff_unicode_glyph_v1_t), 1, &font->stream) != 1 || (i > 0 && glyph_info.code_point <= previous)) {
+                font->unicode_table_sorted = false;
+                break;
+            }
+            previous = glyph_info.code_point;
+        }
+    }
+
+#if QUANTUM_PAINTER_GLYPH_CACHE_SIZE > 0
+    font->glyph_cache_count = 0;
+#endif // QUANTUM_PAINTER_GLYPH_CACHE_SIZE > 0
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Helper: load font from stream
 
@@ -72,13 +127,16 @@ static painter_font_handle_t qp_load_font_internal(bool (*stream_factory)(qff_fo
     font->owns_buffer = false;
     font->buffer      = NULL;
 
-    void *ram_buffer = malloc(font->mem_stream.length);
+    // Works for any kind of stream, including external flash
+    uint32_t length     = qff_get_total_size(&font->stream);
+    void *   ram_buffer = malloc(length);
     if (ram_buffer == NULL) {
         qp_dprintf("qp_load_font: could not allocate enough RAM for font, falling back to original\n");
     } else {
         do {
             // Copy the data into RAM
-            if (qp_stream_read(ram_buffer, 1, font->mem_stream.length, &font->mem_stream) != font->mem_stream.length) {
+            qp_stream_setpos(&font->stream, 0);
+            if (qp_stream_read(ram_buffer, 1, length, &font->stream) != length) {
                 qp_dprintf("qp_load_font: could not copy from flash to RAM, falling back to original\n");
                 break;
             }
@@ -86,7 +144,7 @@ static painter_font_handle_t qp_load_font_internal(bool (*stream_factory)(qff_fo
             // Create the new stream with the new buffer
             font->buffer      = ram_buffer;
             font->owns_buffer = true;
-            font->mem_stream  = qp_make_memory_stream(font->buffer, font->mem_stream.length);
+            font->mem_stream  = qp_make_memory_stream(font->buffer, length);
         } while (0);
     }
 
@@ -105,6 +163,9 @@ static painter_font_handle_t qp_load_font_internal(bool (*stream_factory)(qff_fo
         return NULL;
     }
 
+    qff_prepare_glyph_lookup(font);
+    qp_dprintf("qp_load_font: unicode glyph table %s\n", font->unicode_table_sorted ? "sorted" : "unsorted, using linear search");
+
     // Validation success, we can return the handle
     font->validate_ok = true;
     qp_dprintf("qp_load_font: ok\n");
@@ -131,6 +192,42 @@ painter_font_handle_t qp_load_font_mem(const void *buffer) {
     return qp_load_font_internal(font_mem_stream_factory, (void *)buffer);
 }
 
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_load_font_flash
+
+static inline bool font_flash_stream_factory(qff_font_handle_t *font, void *arg) {
+    uint32_t address = *(uint32_t *)arg;
+
+    // Assume we can read the font descriptor
+    font->flash_stream = qp_make_flash_stream(address, sizeof(qff_font_descriptor_v1_t));
+
+    // Update the length of the stream to match, and rewind to the start
+    font->flash_stream.length   = qff_get_total_size(&font->stream);
+    font->flash_stream.position = 0;
+
+    return true;
+}
+
+painter_font_handle_t qp_load_font_flash(uint32_t address) {
+    return qp_load_font_internal(font_flash_stream_factory, &address);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_load_font_asset
+
+painter_font_handle_t qp_load_font_asset(const char *name) {
+    uint32_t address;
+    if (!qap_find_flash_asset(name, &address)) {
+        qp_dprintf("qp_load_font_asset: fail (could not find '%s' in the asset pack)\n", name);
+        return NULL;
+    }
+    return qp_load_font_flash(address);
+}
+
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter External API: qp_close_font
 
@@ -151,6 +248,7 @@ bool qp_close_font(painter_font_handle_t font) {
 #endif // QUANTUM_PAINTER_LOAD_FONTS_TO_RAM
 
     // Free up this font for use elsewhere.
+    qp_internal_evict_palettes(qff_font);
     qp_stream_close(&qff_font->stream);
     qff_font->validate_ok = false;
     return true;
@@ -164,8 +262,6 @@ typedef bool (*code_point_handler)(qff_font_handle_t *qff_font, uint32_t code_po
 
 // Helper that sets up the palette (if required) and returns the offset in the stream that the data starts
 static inline bool qp_drawtext_prepare_font_for_render(painter_device_t device, qff_font_handle_t *qff_font, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, uint32_t *data_offset) {
-    struct painter_driver_t *driver = (struct painter_driver_t *)device;
-
     // Drop out if we can't actually place the data we read out anywhere
     if (!data_offset) {
         qp_dprintf("Failed to prepare stream for read, output info buffer unavailable\n");
@@ -181,39 +277,92 @@ static inline bool qp_drawtext_prepare_font_for_render(painter_device_t device,
         offset += sizeof(qff_unicode_glyph_table_v1_t) + (qff_font->num_unicode_glyphs * 6);
     }
 
-    // Handle palette if needed
-    const uint16_t palette_entries  = 1u << qff_font->bpp;
-    bool           needs_pixconvert = false;
+    // Set up the native palette, either from the font or interpolated from fg/bg
     if (qff_font->has_palette) {
-        // If this font has a palette, we need to read it out and set up the pixel lookup table
         qp_stream_setpos(&qff_font->stream, offset);
-        if (!qp_internal_load_qgf_palette(&qff_font->stream, qff_font->bpp)) {
-            return false;
-        }
-
+    }
+    if (!qp_internal_prepare_palette(device, qff_font->has_palette ? qff_font : NULL, qff_font->has_palette ? &qff_font->stream : NULL, qff_font->bpp, fg_hsv888, bg_hsv888)) {
+        qp_dprintf("qp_drawtext_recolor: fail (could not convert pixels to native)\n");
+        qp_comms_stop(device);
+        return false;
+    }
+    if (qff_font->has_palette) {
         // Skip this block, as far as offset calculations go
-        offset += sizeof(qgf_palette_v1_t) + (palette_entries * 3);
-        needs_pixconvert = true;
-    } else {
-        // Interpolate from fg/bg
-        int16_t palette_entries = 1 << qff_font->bpp;
-        needs_pixconvert        = qp_internal_interpolate_palette(fg_hsv888, bg_hsv888, palette_entries);
+        offset += sizeof(qgf_palette_v1_t) + ((1u << qff_font->bpp) * 3);
     }
 
-    if (needs_pixconvert) {
-        // Convert the palette to native format
-        if (!driver->driver_vtable->palette_convert(device, palette_entries, qp_internal_global_pixel_lookup_table)) {
-            qp_dprintf("qp_drawtext_recolor: fail (could not convert pixels to native)\n");
-            qp_comms_stop(device);
+    *data_offset = offset;
+    return true;
+}
+
+#if QUANTUM_PAINTER_GLYPH_CACHE_SIZE > 0
+// Moves the entry at the given index to the front of the glyph cache, inserting it if the index is past the end
+static inline void qp_glyph_cache_promote(qff_font_handle_t *qff_font, uint8_t index, const qff_unicode_glyph_v1_t *glyph_info) {
+    if (index >= qff_font->glyph_cache_count) {
+        index = qff_font->glyph_cache_count < QUANTUM_PAINTER_GLYPH_CACHE_SIZE ? qff_font->glyph_cache_count++ : QUANTUM_PAINTER_GLYPH_CACHE_SIZE - 1;
+    }
+    memmove(&qff_font->glyph_cache[1], &qff_font->glyph_cache[0], index * sizeof(qff_unicode_glyph_v1_t));
+    qff_font->glyph_cache[0] = *glyph_info;
+}
+#endif // QUANTUM_PAINTER_GLYPH_CACHE_SIZE > 0
+
+// Finds the glyph info of a code point in the unicode table
+static inline bool qp_drawtext_find_unicode_glyph(qff_font_handle_t *qff_font, uint32_t code_point, qff_unicode_glyph_v1_t *glyph_info) {
+#if QUANTUM_PAINTER_GLYPH_CACHE_SIZE > 0
+    for (uint8_t i = 0; i < qff_font->glyph_cache_count; ++i) {
+        if (qff_font->glyph_cache[i].code_point == code_point) {
+            *glyph_info = qff_font->glyph_cache[i];
+            qp_glyph_cache_promote(qff_font, i, glyph_info);
+            return true;
+        }
+    }
+#endif // QUANTUM_PAINTER_GLYPH_CACHE_SIZE > 0
+
+    bool found = false;
+    if (qff_font->unicode_table_sorted) {
+        // Binary search the table
+        uint16_t low  = 0;
+        uint16_t high = qff_font->num_unicode_glyphs;
+        while (low < high) {
+            uint16_t mid = low + (high - low) / 2;
+            if (!qff_read_unicode_glyph(qff_font, mid, glyph_info)) {
+                qp_dprintf("Failed to read unicode glyph info\n");
+                return false;
+            }
+            if (glyph_info->code_point == code_point) {
+                found = true;
+                break;
+            } else if (glyph_info->code_point < code_point) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+    } else {
+        // Scan the whole table
+        if (qp_stream_setpos(&qff_font->stream, qff_font->unicode_table_offset) < 0) {
+            qp_dprintf("Failed to set stream position while preparing glyph data\n");
             return false;
         }
+        for (uint16_t i = 0; i < qff_font->num_unicode_glyphs && !found; ++i) {
+            if (qp_stream_read(glyph_info, sizeof(qff_unicode_glyph_v1_t), 1, &qff_font->stream) != 1) {
+                qp_dprintf("Failed to read unicode glyph info\n");
+                return false;
+            }
+            found = (glyph_info->code_point == code_point);
+        }
     }
 
-    *data_offset = offset;
-    return true;
+#if QUANTUM_PAINTER_GLYPH_CACHE_SIZE > 0
+    if (found) {
+        qp_glyph_cache_promote(qff_font, QUANTUM_PAINTER_GLYPH_CACHE_SIZE, glyph_info);
+    }
+#endif // QUANTUM_PAINTER_GLYPH_CACHE_SIZE > 0
+    return found;
 }
 
 static inline bool qp_drawtext_prepare_glyph_for_render(qff_font_handle_t *qff_font, uint32_t code_point, uint8_t *width) {
+    uint32_t glyph_value;
     if (code_point >= 0x20 && code_point < 0x7F && qff_font->has_ascii_table) {
         // Do ascii table
         qff_ascii_glyph_v1_t glyph_info;
@@ -229,66 +378,26 @@ static inline bool qp_drawtext_prepare_glyph_for_render(qff_font_handle_t *qff_f
             qp_dprintf("Failed to read glyph info\n");
             return false;
         }
-
-        uint8_t  glyph_width  = (uint8_t)(glyph_info.value & QFF_GLYPH_WIDTH_MASK);
-        uint32_t glyph_offset = ((glyph_info.value & QFF_GLYPH_OFFSET_MASK) >> QFF_GLYPH_WIDTH_BITS);
-        uint32_t data_offset  = sizeof(qff_font_descriptor_v1_t)                                                                                                                   // Skip the font descriptor
-                               + sizeof(qff_ascii_glyph_table_v1_t)                                                                                                                // Skip the ascii table
-                               + (qff_font->num_unicode_glyphs > 0 ? (sizeof(qff_unicode_glyph_table_v1_t) + (qff_font->num_unicode_glyphs * sizeof(qff_unicode_glyph_v1_t))) : 0) // Skip the unicode table
-                               + (qff_font->has_palette ? (sizeof(qgf_palette_v1_t) + ((1 << qff_font->bpp) * sizeof(qgf_palette_entry_v1_t))) : 0)                                // Skip the palette
-                               + sizeof(qgf_block_header_v1_t)                                                                                                                     // Skip the data block header
-                               + glyph_offset;                                                                                                                                     // Jump to the specified glyph offset
-
-        if (qp_stream_setpos(&qff_font->stream, data_offset) < 0) {
-            qp_dprintf("Failed to set stream position while preparing ascii glyph data\n");
-            return false;
-        }
-
-        *width = glyph_width;
-        return true;
+        glyph_value = glyph_info.value;
     } else {
         // Do unicode table, which may include singular ascii glyphs if full ascii table isn't specified
-        uint32_t glyph_info_offset = sizeof(qff_font_descriptor_v1_t)                                       // Skip the font descriptor
-                                     + (qff_font->has_ascii_table ? sizeof(qff_ascii_glyph_table_v1_t) : 0) // Skip the ascii table
-                                     + sizeof(qgf_block_header_v1_t);                                       // Skip the unicode block header
-
-        if (qp_stream_setpos(&qff_font->stream, glyph_info_offset) < 0) {
-            qp_dprintf("Failed to set stream position while preparing glyph data\n");
-            return false;
-        }
-
         qff_unicode_glyph_v1_t glyph_info;
-        for (uint16_t i = 0; i < qff_font->num_unicode_glyphs; ++i) {
-            if (qp_stream_read(&glyph_info, sizeof(qff_unicode_glyph_v1_t), 1, &qff_font->stream) != 1) {
-                qp_dprintf("Failed to set stream position while reading unicode glyph info\n");
-                return false;
-            }
-
-            if (glyph_info.code_point == code_point) {
-                uint8_t  glyph_width  = (uint8_t)(glyph_info.value & QFF_GLYPH_WIDTH_MASK);
-                uint32_t glyph_offset = ((glyph_info.value & QFF_GLYPH_OFFSET_MASK) >> QFF_GLYPH_WIDTH_BITS);
-                uint32_t data_offset  = sizeof(qff_font_descriptor_v1_t)                                                                                                                   // Skip the font descriptor
-                                       + sizeof(qff_ascii_glyph_table_v1_t)                                                                                                                // Skip the ascii table
-                                       + (qff_font->num_unicode_glyphs > 0 ? (sizeof(qff_unicode_glyph_table_v1_t) + (qff_font->num_unicode_glyphs * sizeof(qff_unicode_glyph_v1_t))) : 0) // Skip the unicode table
-                                       + (qff_font->has_palette ? (sizeof(qgf_palette_v1_t) + ((1 << qff_font->bpp) * sizeof(qgf_palette_entry_v1_t))) : 0)                                // Skip the palette
-                                       + sizeof(qgf_block_header_v1_t)                                                                                                                     // Skip the data block header
-                                       + glyph_offset;                                                                                                                                     // Jump to the specified glyph offset
-
-                if (qp_stream_setpos(&qff_font->stream, data_offset) < 0) {
-                    qp_dprintf("Failed to set stream position while preparing unicode glyph data\n");
-                    return false;
-                }
-
-                *width = glyph_width;
-                return true;
-            }
+        if (!qp_drawtext_find_unicode_glyph(qff_font, code_point, &glyph_info)) {
+            qp_dprintf("Failed to find unicode glyph info\n");
+            return false;
         }
+        glyph_value = glyph_info.value;
+    }
 
-        // Not found
-        qp_dprintf("Failed to find unicode glyph info\n");
+    uint8_t  glyph_width  = (uint8_t)(glyph_value & QFF_GLYPH_WIDTH_MASK);
+    uint32_t glyph_offset = ((glyph_value & QFF_GLYPH_OFFSET_MASK) >> QFF_GLYPH_WIDTH_BITS);
+    if (qp_stream_setpos(&qff_font->stream, qff_font->glyph_data_offset + glyph_offset) < 0) {
+        qp_dprintf("Failed to set stream position while preparing glyph data\n");
         return false;
     }
-    return false;
+
+    *width = glyph_width;
+    return true;
 }
 
 // Function to iterate over each UTF8 codepoint, invoking the callback for each decoded glyph
@@ -341,7 +450,6 @@ struct code_point_iter_drawglyph_state {
     painter_device_t                       device;
     int16_t                                xpos;
     int16_t                                ypos;
-    qp_internal_byte_input_callback        input_callback;
     struct qp_internal_byte_input_state *  input_state;
     struct qp_internal_pixel_output_state *output_state;
 };
@@ -365,7 +473,7 @@ static inline bool qp_font_code_point_handler_drawglyph(qff_font_handle_t *qff_f
 
     // Decode the pixel data for the glyph
     uint32_t pixel_count = ((uint32_t)width) * height;
-    bool     ret         = qp_internal_decode_palette(state->device, pixel_count, qff_font->bpp, state->input_callback, state->input_state, qp_internal_global_pixel_lookup_table, qp_internal_pixel_appender, state->output_state);
+    bool     ret         = qp_internal_decode_pixdata(state->device, pixel_count, qff_font->bpp, state->input_state, qp_internal_global_pixel_lookup_table, state->output_state);
 
     // Any leftovers need transmission as well.
     if (ret && state->output_state->pixel_write_pos > 0) {
@@ -440,8 +548,7 @@ int16_t qp_drawtext_recolor(painter_device_t device, uint16_t x, uint16_t y, pai
                                                     .xpos   = x,
                                                     .ypos   = y,
                                                     // Input
-                                                    .input_callback = input_callback,
-                                                    .input_state    = &input_state,
+                                                    .input_state = &input_state,
                                                     // Output
                                                     .output_state = &output_state};
 
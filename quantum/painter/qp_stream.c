@@ -1,12 +1,18 @@
 // Copyright 2021 Nick Brassel (@tzarc)
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <string.h>
+
 #include "qp_stream.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Stream API
 
 uint32_t qp_stream_read_impl(void *output_buf, uint32_t member_size, uint32_t num_members, qp_stream_t *stream) {
+    if (stream->read) {
+        return stream->read(stream, output_buf, num_members * member_size) / member_size;
+    }
+
     uint8_t *output_ptr = (uint8_t *)output_buf;
 
     uint32_t i;
@@ -47,6 +53,21 @@ static inline int16_t mem_get(qp_stream_t *stream) {
     return s->buffer[s->position++];
 }
 
+static inline uint32_t mem_read(qp_stream_t *stream, void *output_buf, uint32_t length) {
+    qp_memory_stream_t *s = (qp_memory_stream_t *)stream;
+    if (s->position >= s->length) {
+        s->is_eof = true;
+        return 0;
+    }
+    if (length > (uint32_t)(s->length - s->position)) {
+        length    = s->length - s->position;
+        s->is_eof = true;
+    }
+    memcpy(output_buf, &s->buffer[s->position], length);
+    s->position += length;
+    return length;
+}
+
 static inline bool mem_put(qp_stream_t *stream, uint8_t c) {
     qp_memory_stream_t *s = (qp_memory_stream_t *)stream;
     if (s->position >= s->length) {
@@ -111,7 +132,7 @@ static inline void mem_close(qp_stream_t *stream) {
 
 qp_memory_stream_t qp_make_memory_stream(void *buffer, int32_t length) {
     qp_memory_stream_t stream = {
-        .base     = {.get = mem_get, .put = mem_put, .seek = mem_seek, .tell = mem_tell, .is_eof = mem_is_eof, .close = mem_close},
+        .base     = {.get = mem_get, .read = mem_read, .put = mem_put, .seek = mem_seek, .tell = mem_tell, .is_eof = mem_is_eof, .close = mem_close},
         .buffer   = (uint8_t *)buffer,
         .length   = length,
         .position = 0,
@@ -131,6 +152,11 @@ static inline int16_t file_get(qp_stream_t *stream) {
     return (uint16_t)c;
 }
 
+static inline uint32_t file_read(qp_stream_t *stream, void *output_buf, uint32_t length) {
+    qp_file_stream_t *s = (qp_file_stream_t *)stream;
+    return (uint32_t)fread(output_buf, 1, length, s->file);
+}
+
 static inline bool file_put(qp_stream_t *stream, uint8_t c) {
     qp_file_stream_t *s = (qp_file_stream_t *)stream;
     return fputc(c, s->file) == c;
@@ -158,9 +184,181 @@ static inline void file_close(qp_stream_t *stream) {
 
 qp_file_stream_t qp_make_file_stream(FILE *f) {
     qp_file_stream_t stream = {
-        .base = {.get = file_get, .put = file_put, .seek = file_seek, .tell = file_tell, .is_eof = file_is_eof, .close = file_close},
+        .base = {.get = file_get, .read = file_read, .put = file_put, .seek = file_seek, .tell = file_tell, .is_eof = file_is_eof, .close = file_close},
         .file = f,
     };
     return stream;
 }
 #endif // QP_STREAM_HAS_FILE_IO
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// External flash streams
+
+#ifdef QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
+
+#    include "flash_spi.h"
+#    include "qp_comms.h"
+
+// Blocks of external flash, shared between all flash streams
+typedef struct qp_flash_cache_block_t {
+    bool     valid;
+    uint32_t address;
+    uint8_t  data[QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE];
+} qp_flash_cache_block_t;
+
+static qp_flash_cache_block_t flash_cache[QUANTUM_PAINTER_FLASH_CACHE_BLOCKS];
+static uint8_t                flash_cache_last; // most recently used block
+static bool                   flash_initialised = false;
+
+// The display is usually on the same SPI bus as the flash, and is held while drawing -- release it for each read
+static bool flash_read_shared(uint32_t address, void *buf, size_t len) {
+    painter_device_t device = qp_comms_suspend();
+    bool             ok     = flash_read_block(address, buf, len) == FLASH_STATUS_SUCCESS;
+    qp_comms_resume(device);
+    return ok;
+}
+
+// Returns the cached block containing the supplied address, reading the whole block from flash if it's not cached
+static qp_flash_cache_block_t *flash_cache_block(uint32_t address) {
+    uint32_t block_address = address - (address % QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE);
+
+    // Sequential reads nearly always hit the same block as last time
+    if (flash_cache[flash_cache_last].valid && flash_cache[flash_cache_last].address == block_address) {
+        return &flash_cache[flash_cache_last];
+    }
+    for (uint8_t i = 0; i < QUANTUM_PAINTER_FLASH_CACHE_BLOCKS; ++i) {
+        if (flash_cache[i].valid && flash_cache[i].address == block_address) {
+            flash_cache_last = i;
+            return &flash_cache[i];
+        }
+    }
+
+    // Replace the blocks in turn, the one after the last used is the least likely to be needed again
+    flash_cache_last               = (flash_cache_last + 1) % QUANTUM_PAINTER_FLASH_CACHE_BLOCKS;
+    qp_flash_cache_block_t *block = &flash_cache[flash_cache_last];
+    block->valid                  = flash_read_shared(block_address, block->data, QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE);
+    block->address                = block_address;
+    return block->valid ? block : NULL;
+}
+
+static inline int16_t flash_get(qp_stream_t *stream) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    if (s->position >= s->length) {
+        s->is_eof = true;
+        return STREAM_EOF;
+    }
+
+    uint32_t                address = s->address + s->position;
+    qp_flash_cache_block_t *block   = flash_cache_block(address);
+    if (!block) {
+        return STREAM_EOF;
+    }
+
+    s->position++;
+    return block->data[address - block->address];
+}
+
+static inline uint32_t flash_read(qp_stream_t *stream, void *output_buf, uint32_t length) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    if (s->position >= s->length) {
+        s->is_eof = true;
+        return 0;
+    }
+    if (length > (uint32_t)(s->length - s->position)) {
+        length    = s->length - s->position;
+        s->is_eof = true;
+    }
+
+    uint8_t *output_ptr = (uint8_t *)output_buf;
+    uint32_t remaining  = length;
+    while (remaining > 0) {
+        uint32_t address = s->address + s->position;
+        uint32_t offset  = address % QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE;
+        uint32_t count   = QP_MIN(remaining, QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE - offset);
+
+        if (offset == 0 && remaining >= QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE) {
+            // Whole blocks go straight to the caller as one transfer, without displacing cached blocks
+            count = remaining - (remaining % QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE);
+            if (!flash_read_shared(address, output_ptr, count)) {
+                break;
+            }
+        } else {
+            qp_flash_cache_block_t *block = flash_cache_block(address);
+            if (!block) {
+                break;
+            }
+            memcpy(output_ptr, &block->data[offset], count);
+        }
+
+        output_ptr += count;
+        remaining -= count;
+        s->position += count;
+    }
+
+    return length - remaining;
+}
+
+static inline bool flash_put(qp_stream_t *stream, uint8_t c) {
+    // Assets are written to flash ahead of time, streams are read-only
+    return false;
+}
+
+static inline int flash_seek(qp_stream_t *stream, int32_t offset, int origin) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+
+    // Handle as per fseek
+    int32_t position = s->position;
+    switch (origin) {
+        case SEEK_SET:
+            position = offset;
+            break;
+        case SEEK_CUR:
+            position += offset;
+            break;
+        case SEEK_END:
+            position = s->length + offset;
+            break;
+        default:
+            return -1;
+    }
+
+    // Same bounds as memory streams, seeking to the end is allowed
+    if (position < 0 || position > s->length) {
+        return -1;
+    }
+
+    s->position = position;
+    s->is_eof   = false;
+    return 0;
+}
+
+static inline int32_t flash_tell(qp_stream_t *stream) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    return s->position;
+}
+
+static inline bool flash_is_eof(qp_stream_t *stream) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    return s->is_eof;
+}
+
+static inline void flash_close(qp_stream_t *stream) {
+    // No-op.
+}
+
+qp_flash_stream_t qp_make_flash_stream(uint32_t address, int32_t length) {
+    if (!flash_initialised) {
+        flash_init();
+        flash_initialised = true;
+    }
+
+    qp_flash_stream_t stream = {
+        .base     = {.get = flash_get, .read = flash_read, .put = flash_put, .seek = flash_seek, .tell = flash_tell, .is_eof = flash_is_eof, .close = flash_close},
+        .address  = address,
+        .length   = length,
+        .position = 0,
+    };
+    return stream;
+}
+
+#endif // QUANTUM_PAINTER_FLASH_ASSETS_ENABLE
@@ -157,6 +157,20 @@ __attribute__((weak)) void pointing_device_init(void) {
     pointing_device_init_user();
 }
 
+/**
+ * @brief Starts reading the sensor in the background, at the beginning of the keyboard task
+ *
+ * Drivers which can read their sensor without blocking override this, so the transfer overlaps the matrix scan.
+ */
+__attribute__((weak)) void pointing_device_read_start(void) {}
+
+/**
+ * @brief Finishes the read started by pointing_device_read_start
+ *
+ * Called at the end of the keyboard task, so that the sensor does not hold the bus in between tasks.
+ */
+__attribute__((weak)) void pointing_device_read_end(void) {}
+
 /**
  * @brief Sends processed mouse report to host
  *
@@ -263,6 +277,15 @@ __attribute__((weak)) void pointing_device_task(void) {
     local_mouse_report = pointing_device_driver.get_report(local_mouse_report);
 #endif // defined(SPLIT_POINTING_ENABLE)
 
+#ifdef POINTING_DEVICE_MOTION_ACCUMULATE_ENABLE
+    // Sensor reads are accumulated with their fractional remainders, and flushed once per report interval.
+    // Only the motion waits for the flush, buttons still go through on every cycle.
+    local_mouse_report = pointing_device_motion_accumulate(local_mouse_report);
+    if (pointing_device_motion_flush_ready()) {
+        local_mouse_report = pointing_device_motion_flush(local_mouse_report);
+    }
+#endif
+
     // allow kb to intercept and modify report
 #if defined(SPLIT_POINTING_ENABLE) && defined(POINTING_DEVICE_COMBINED)
     if (is_keyboard_left()) {
@@ -330,6 +353,10 @@ uint16_t pointing_device_get_cpi(void) {
  * @param[in] cpi uint16_t value.
  */
 void pointing_device_set_cpi(uint16_t cpi) {
+#ifdef POINTING_DEVICE_MOTION_ACCUMULATE_ENABLE
+    // counts accumulated at the old resolution would move the pointer by the wrong distance
+    pointing_device_motion_reset();
+#endif
 #if defined(SPLIT_POINTING_ENABLE)
     if (POINTING_DEVICE_THIS_SIDE) {
         pointing_device_driver.set_cpi(cpi);
@@ -24,6 +24,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef POINTING_DEVICE_AUTO_MOUSE_ENABLE
 #    include "pointing_device_auto_mouse.h"
 #endif
+#ifdef POINTING_DEVICE_MOTION_ACCUMULATE_ENABLE
+#    include "pointing_device_motion.h"
+#endif
 
 #if defined(POINTING_DEVICE_DRIVER_adns5050)
 #    include "drivers/sensors/adns5050.h"
@@ -98,6 +101,8 @@ typedef int16_t clamp_range_t;
 
 void           pointing_device_init(void);
 void           pointing_device_task(void);
+void           pointing_device_read_start(void);
+void           pointing_device_read_end(void);
 void           pointing_device_send(void);
 report_mouse_t pointing_device_get_report(void);
 void           pointing_device_set_report(report_mouse_t mouse_report);
@@ -55,8 +55,13 @@ const pointing_device_driver_t pointing_device_driver = {
 report_mouse_t adns9800_get_report_driver(report_mouse_t mouse_report) {
     report_adns9800_t sensor_report = adns9800_get_report();
 
+#    ifdef POINTING_DEVICE_MOTION_ACCUMULATE_ENABLE
+    // hand the full resolution deltas to the motion pipeline instead of clamping them
+    pointing_device_motion_add(sensor_report.x, sensor_report.y, 0, 0);
+#    else
     mouse_report.x = CONSTRAIN_HID_XY(sensor_report.x);
     mouse_report.y = CONSTRAIN_HID_XY(sensor_report.y);
+#    endif
 
     return mouse_report;
 }
@@ -313,6 +318,17 @@ const pointing_device_driver_t pointing_device_driver = {
 // clang-format on
 
 #elif defined(POINTING_DEVICE_DRIVER_pmw3360) || defined(POINTING_DEVICE_DRIVER_pmw3389)
+#    ifdef PMW33XX_ASYNC_BURST
+void pointing_device_read_start(void) {
+    // every initialised sensor in turn, the motion is kept until it is read
+    pmw33xx_read_burst_start_next();
+}
+
+void pointing_device_read_end(void) {
+    pmw33xx_read_burst_finish();
+}
+#    endif
+
 static void pmw33xx_init_wrapper(void) {
     pmw33xx_init(0);
 }
@@ -326,8 +342,18 @@ static uint16_t pmw33xx_get_cpi_wrapper(void) {
 }
 
 report_mouse_t pmw33xx_get_report(report_mouse_t mouse_report) {
+#    ifdef PMW33XX_ASYNC_BURST
+    // pick up the burst read started at the beginning of the keyboard task, sensors are read in turn so there may be
+    // none this time
+    pmw33xx_report_t report    = {0};
+    static bool      in_motion = false;
+    if (!pmw33xx_read_burst_wait(0, &report)) {
+        return mouse_report;
+    }
+#    else
     pmw33xx_report_t report    = pmw33xx_read_burst(0);
     static bool      in_motion = false;
+#    endif
 
     if (report.motion.b.is_lifted) {
         return mouse_report;
@@ -343,8 +369,13 @@ report_mouse_t pmw33xx_get_report(report_mouse_t mouse_report) {
         pd_dprintf("PWM3360 (0): starting motion\n");
     }
 
+#    ifdef POINTING_DEVICE_MOTION_ACCUMULATE_ENABLE
+    // hand the full resolution deltas to the motion pipeline instead of clamping them
+    pointing_device_motion_add(report.delta_x, report.delta_y, 0, 0);
+#    else
     mouse_report.x = CONSTRAIN_HID_XY(report.delta_x);
     mouse_report.y = CONSTRAIN_HID_XY(report.delta_y);
+#    endif
     return mouse_report;
 }
 
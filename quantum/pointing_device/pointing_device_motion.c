@@ -0,0 +1,165 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef POINTING_DEVICE_MOTION_ACCUMULATE_ENABLE
+
+#    include <stdlib.h>
+#    include "pointing_device.h"
+#    include "timer.h"
+
+/* local data structure for tracking accumulated motion, in Q8 fixed point */
+static pointing_device_motion_t motion_accumulator = {0};
+static uint16_t                 motion_last_flush  = 0;
+static uint32_t                 motion_last_read   = 0;
+
+/**
+ * @brief Weak function allowing for user level gain curve modification
+ *
+ * Takes the speed of the pointer (|x| + |y| in counts per second) and returns the gain to apply in Q8 fixed point.
+ *
+ * @param[in] speed uint16_t
+ * @return uint16_t gain, 256 == 1.0
+ */
+__attribute__((weak)) uint16_t pointing_device_motion_gain_user(uint16_t speed) {
+    uint32_t gain = POINTING_DEVICE_MOTION_SCALE + (((uint32_t)POINTING_DEVICE_MOTION_ACCEL * speed) >> POINTING_DEVICE_MOTION_FRAC_BITS);
+    return gain > POINTING_DEVICE_MOTION_ACCEL_LIMIT ? POINTING_DEVICE_MOTION_ACCEL_LIMIT : gain;
+}
+
+/**
+ * @brief Weak function allowing for keyboard level gain curve modification
+ *
+ * @param[in] speed uint16_t
+ * @return uint16_t gain, 256 == 1.0
+ */
+__attribute__((weak)) uint16_t pointing_device_motion_gain_kb(uint16_t speed) {
+    return pointing_device_motion_gain_user(speed);
+}
+
+/**
+ * @brief Adds counts to an accumulator, keeping it within POINTING_DEVICE_MOTION_CARRY_MAX counts
+ *
+ * @param[in] accumulator int32_t pointer
+ * @param[in] value int32_t in Q8
+ */
+static void pointing_device_motion_carry(int32_t* accumulator, int32_t value) {
+    const int32_t limit = (int32_t)POINTING_DEVICE_MOTION_CARRY_MAX * POINTING_DEVICE_MOTION_ONE;
+
+    *accumulator += value;
+    if (*accumulator > limit) {
+        *accumulator = limit;
+    } else if (*accumulator < -limit) {
+        *accumulator = -limit;
+    }
+}
+
+/**
+ * @brief Adds raw sensor deltas to the motion accumulators
+ *
+ * Deltas are scaled by the gain curve and stored with their fractional part, so that no counts are lost
+ * to integer truncation or clamping. Motion beyond POINTING_DEVICE_MOTION_CARRY_MAX counts is dropped. Drivers that can report more than a single HID report can carry may
+ * call this directly with their unclamped deltas.
+ *
+ * @param[in] x int16_t
+ * @param[in] y int16_t
+ * @param[in] h int16_t
+ * @param[in] v int16_t
+ */
+void pointing_device_motion_add(int16_t x, int16_t y, int16_t h, int16_t v) {
+    if (x || y) {
+        // divide by the time since the previous motion, so that the curve does not depend on how often the sensor is read
+        uint32_t elapsed = timer_elapsed32(motion_last_read);
+        motion_last_read = timer_read32();
+        uint32_t speed   = ((uint32_t)abs(x) + (uint32_t)abs(y)) * 1000 / (elapsed ? elapsed : 1);
+        int32_t  gain    = pointing_device_motion_gain_kb(speed > UINT16_MAX ? UINT16_MAX : speed);
+        pointing_device_motion_carry(&motion_accumulator.x, (int32_t)x * gain);
+        pointing_device_motion_carry(&motion_accumulator.y, (int32_t)y * gain);
+    }
+    pointing_device_motion_carry(&motion_accumulator.h, (int32_t)h * POINTING_DEVICE_MOTION_ONE);
+    pointing_device_motion_carry(&motion_accumulator.v, (int32_t)v * POINTING_DEVICE_MOTION_ONE);
+}
+
+/**
+ * @brief Moves the motion of a mouse report into the accumulators
+ *
+ * @param[in] mouse_report report_mouse_t
+ * @return report_mouse_t with motion cleared, buttons untouched
+ */
+report_mouse_t pointing_device_motion_accumulate(report_mouse_t mouse_report) {
+    pointing_device_motion_add(mouse_report.x, mouse_report.y, mouse_report.h, mouse_report.v);
+    mouse_report.x = 0;
+    mouse_report.y = 0;
+    mouse_report.h = 0;
+    mouse_report.v = 0;
+    return mouse_report;
+}
+
+/**
+ * @brief Checks whether the accumulated motion is due to be sent
+ *
+ * @return true once POINTING_DEVICE_MOTION_REPORT_MS has elapsed since the last flush
+ */
+bool pointing_device_motion_flush_ready(void) {
+    return timer_elapsed(motion_last_flush) >= POINTING_DEVICE_MOTION_REPORT_MS;
+}
+
+/**
+ * @brief Takes the whole counts out of an accumulator
+ *
+ * The value is clamped to the report range; anything that does not fit, plus the fractional remainder, stays
+ * in the accumulator for the next flush.
+ *
+ * @param[in] accumulator int32_t pointer
+ * @param[in] min int32_t
+ * @param[in] max int32_t
+ * @return int32_t whole counts
+ */
+static int32_t pointing_device_motion_take(int32_t* accumulator, int32_t min, int32_t max) {
+    // truncate towards zero so the remainder keeps the sign of the motion
+    int32_t counts = *accumulator / POINTING_DEVICE_MOTION_ONE;
+    if (counts < min) {
+        counts = min;
+    } else if (counts > max) {
+        counts = max;
+    }
+    *accumulator -= counts * POINTING_DEVICE_MOTION_ONE;
+    return counts;
+}
+
+/**
+ * @brief Writes the accumulated motion into a mouse report
+ *
+ * @param[in] mouse_report report_mouse_t
+ * @return report_mouse_t with accumulated motion applied
+ */
+report_mouse_t pointing_device_motion_flush(report_mouse_t mouse_report) {
+    motion_last_flush = timer_read();
+    mouse_report.x    = pointing_device_motion_take(&motion_accumulator.x, XY_REPORT_MIN, XY_REPORT_MAX);
+    mouse_report.y    = pointing_device_motion_take(&motion_accumulator.y, XY_REPORT_MIN, XY_REPORT_MAX);
+    mouse_report.h    = pointing_device_motion_take(&motion_accumulator.h, INT8_MIN, INT8_MAX);
+    mouse_report.v    = pointing_device_motion_take(&motion_accumulator.v, INT8_MIN, INT8_MAX);
+    return mouse_report;
+}
+
+/**
+ * @brief Discards any accumulated motion, including fractional remainders
+ *
+ * Called when the meaning of the counts changes (CPI) and on wakeup, so that stale motion is not sent.
+ */
+void pointing_device_motion_reset(void) {
+    motion_accumulator = (pointing_device_motion_t){0};
+}
+
+#endif // POINTING_DEVICE_MOTION_ACCUMULATE_ENABLE
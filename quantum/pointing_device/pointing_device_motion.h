@@ -0,0 +1,78 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "report.h"
+
+/* check settings and set defaults */
+#ifndef POINTING_DEVICE_MOTION_ACCUMULATE_ENABLE
+#    error "POINTING_DEVICE_MOTION_ACCUMULATE_ENABLE not defined! check config settings"
+#endif
+
+#if defined(SPLIT_POINTING_ENABLE) && defined(POINTING_DEVICE_COMBINED)
+#    error "POINTING_DEVICE_MOTION_ACCUMULATE_ENABLE is not supported with POINTING_DEVICE_COMBINED"
+#endif
+
+/* Number of fractional bits used by the motion accumulators (Q8) */
+#define POINTING_DEVICE_MOTION_FRAC_BITS 8
+#define POINTING_DEVICE_MOTION_ONE (1 << POINTING_DEVICE_MOTION_FRAC_BITS)
+
+/* Base gain applied to every count, in Q8 (256 == 1.0) */
+#ifndef POINTING_DEVICE_MOTION_SCALE
+#    define POINTING_DEVICE_MOTION_SCALE POINTING_DEVICE_MOTION_ONE
+#endif
+/* Additional gain per count per second of speed (|x| + |y|), in Q8 */
+#ifndef POINTING_DEVICE_MOTION_ACCEL
+#    define POINTING_DEVICE_MOTION_ACCEL 0
+#endif
+/* Upper bound of the total gain, in Q8 */
+#ifndef POINTING_DEVICE_MOTION_ACCEL_LIMIT
+#    define POINTING_DEVICE_MOTION_ACCEL_LIMIT (4 * POINTING_DEVICE_MOTION_ONE)
+#endif
+/* Most counts an accumulator carries over to later flushes, per axis */
+#ifndef POINTING_DEVICE_MOTION_CARRY_MAX
+#    define POINTING_DEVICE_MOTION_CARRY_MAX (4 * XY_REPORT_MAX)
+#endif
+/* Minimum time between two flushes of the accumulated motion to the host */
+#ifndef POINTING_DEVICE_MOTION_REPORT_MS
+#    ifdef USB_POLLING_INTERVAL_MS
+#        define POINTING_DEVICE_MOTION_REPORT_MS USB_POLLING_INTERVAL_MS
+#    else
+#        define POINTING_DEVICE_MOTION_REPORT_MS 1
+#    endif
+#endif
+
+/* data structure */
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t h;
+    int32_t v;
+} pointing_device_motion_t;
+
+/* ----------Motion pipeline--------------------------------------------------------------------------------- */
+void           pointing_device_motion_add(int16_t x, int16_t y, int16_t h, int16_t v);
+report_mouse_t pointing_device_motion_accumulate(report_mouse_t mouse_report);
+bool           pointing_device_motion_flush_ready(void);
+report_mouse_t pointing_device_motion_flush(report_mouse_t mouse_report);
+void           pointing_device_motion_reset(void);
+
+/* ----------Callbacks for modifying the gain curve---------------------------------------------------------- */
+uint16_t pointing_device_motion_gain_kb(uint16_t speed);
+uint16_t pointing_device_motion_gain_user(uint16_t speed);
@@ -64,17 +64,17 @@ void clicky_freq_reset(void) {
 
 void clicky_toggle(void) {
     audio_config.clicky_enable ^= 1;
-    eeconfig_update_audio(audio_config.raw);
+    eeconfig_defer_flush(eeconfig_update_audio_current);
 }
 
 void clicky_on(void) {
     audio_config.clicky_enable = 1;
-    eeconfig_update_audio(audio_config.raw);
+    eeconfig_defer_flush(eeconfig_update_audio_current);
 }
 
 void clicky_off(void) {
     audio_config.clicky_enable = 0;
-    eeconfig_update_audio(audio_config.raw);
+    eeconfig_defer_flush(eeconfig_update_audio_current);
 }
 
 bool is_clicky_on(void) {
@@ -17,6 +17,7 @@
 #include "quantum_keycodes.h"
 #include "keymap_steno.h"
 #include <string.h>
+#include "debug.h"
 #ifdef VIRTSER_ENABLE
 #    include "virtser.h"
 #endif
@@ -34,6 +35,17 @@ static uint8_t chord[MAX_STROKE_SIZE] = {0};
 // At the end of this scenario given as an example, `chord` would have five bits set to 1 but
 // `n_pressed_keys` would be set to 2 because there are only two keys currently being pressed down.
 static int8_t n_pressed_keys = 0;
+// Whether any keys have been added to `chord` since the last chord was sent.
+static bool chord_pending = false;
+// Times of the key events which started and ended the last chord.
+static uint16_t chord_start_time = 0;
+static uint16_t chord_end_time   = 0;
+
+#ifdef STENO_FIRST_UP
+// The steno keys being held down. When the first key of a chord is released the chord is sent,
+// and the keys which are still held down carry over into the next chord.
+static uint8_t held_keys[(STN__MAX - STN__MIN + 8) / 8] = {0};
+#endif
 
 #ifdef STENO_ENABLE_ALL
 static steno_mode_t mode;
@@ -47,15 +59,74 @@ static inline void steno_clear_chord(void) {
     memset(chord, 0, sizeof(chord));
 }
 
+#ifdef VIRTSER_ENABLE
+#    ifndef STENO_QUEUE_SIZE
+#        define STENO_QUEUE_SIZE 64
+#    endif
+
+_Static_assert(STENO_QUEUE_SIZE >= GEMINI_STROKE_SIZE && STENO_QUEUE_SIZE <= 255, "STENO_QUEUE_SIZE must be between 6 and 255 bytes");
+
+// Packets of the chords which have been written but not yet taken by the virtual serial port.
+// Chords written while the previous one is still being transmitted wait here, and are then
+// handed to the port together so that they fill up whole USB packets.
+static uint8_t steno_queue[STENO_QUEUE_SIZE];
+static uint8_t steno_queue_head  = 0;
+static uint8_t steno_queue_count = 0;
+
+void steno_task(void) {
+    while (steno_queue_count > 0) {
+        // The queued bytes up to the end of the buffer, the rest are sent on the next pass
+        uint8_t length = MIN(steno_queue_count, STENO_QUEUE_SIZE - steno_queue_head);
+        uint8_t sent   = virtser_send_buffer(&steno_queue[steno_queue_head], length);
+
+        steno_queue_head = (steno_queue_head + sent) % STENO_QUEUE_SIZE;
+        steno_queue_count -= sent;
+        if (sent < length) {
+            // The port is busy, try again on the next scan
+            break;
+        }
+    }
+}
+
+/**
+ * Queues a whole packet, or nothing at all if there isn't room for it.
+ */
+static void steno_queue_packet(const uint8_t *packet, uint8_t length) {
+    if (STENO_QUEUE_SIZE - steno_queue_count < length) {
+        steno_task();
+        if (STENO_QUEUE_SIZE - steno_queue_count < length) {
+            dprintln("steno: queue full, dropping chord");
+            return;
+        }
+    }
+    for (uint8_t i = 0; i < length; ++i) {
+        steno_queue[(steno_queue_head + steno_queue_count) % STENO_QUEUE_SIZE] = packet[i];
+        steno_queue_count++;
+    }
+    // Start transmitting straight away if the port is free
+    steno_task();
+}
+#else
+void steno_task(void) {}
+#endif // VIRTSER_ENABLE
+
+uint16_t steno_chord_start_time(void) {
+    return chord_start_time;
+}
+
+uint16_t steno_chord_end_time(void) {
+    return chord_end_time;
+}
+
 #ifdef STENO_ENABLE_GEMINI
 
 #    ifdef VIRTSER_ENABLE
 void send_steno_chord_gemini(void) {
+    uint8_t packet[GEMINI_STROKE_SIZE];
+    memcpy(packet, chord, GEMINI_STROKE_SIZE);
     // Set MSB to 1 to indicate the start of packet
-    chord[0] |= 0x80;
-    for (uint8_t i = 0; i < GEMINI_STROKE_SIZE; ++i) {
-        virtser_send(chord[i]);
-    }
+    packet[0] |= 0x80;
+    steno_queue_packet(packet, GEMINI_STROKE_SIZE);
 }
 #    else
 #        pragma message "VIRTSER_ENABLE = yes is required for Gemini PR to work properly out of the box!"
@@ -93,18 +164,21 @@ static const uint8_t boltmap[64] PROGMEM = {TXB_NUL, TXB_NUM, TXB_NUM, TXB_NUM,
 
 #    ifdef VIRTSER_ENABLE
 static void send_steno_chord_bolt(void) {
+    uint8_t packet[BOLT_STROKE_SIZE + 1];
+    uint8_t length = 0;
     for (uint8_t i = 0; i < BOLT_STROKE_SIZE; ++i) {
         // TX Bolt uses variable length packets where each byte corresponds to a bit array of certain keys.
         // If a user chorded the keys of the first group with keys of the last group, for example, there
         // would be bytes of 0x00 in `chord` for the middle groups which we mustn't send.
         if (chord[i]) {
-            virtser_send(chord[i]);
+            packet[length++] = chord[i];
         }
     }
     // Sending a null packet is not always necessary, but it is simpler and more reliable
     // to unconditionally send it every time instead of keeping track of more states and
     // creating more branches in the execution of the program.
-    virtser_send(0);
+    packet[length++] = 0;
+    steno_queue_packet(packet, length);
 }
 #    else
 #        pragma message "VIRTSER_ENABLE = yes is required for TX Bolt to work properly out of the box!"
@@ -136,11 +210,44 @@ void steno_init() {
 
 void steno_set_mode(steno_mode_t new_mode) {
     steno_clear_chord();
-    mode = new_mode;
+    chord_pending = false;
+    mode          = new_mode;
     eeprom_update_byte(EECONFIG_STENOMODE, mode);
 }
 #endif // STENO_ENABLE_ALL
 
+/**
+ * Adds the key to the chord in the format of the current mode.
+ * @return false if the current mode isn't supported
+ */
+static bool add_key_to_chord(uint8_t key) {
+    switch (mode) {
+#ifdef STENO_ENABLE_BOLT
+        case STENO_MODE_BOLT:
+            add_bolt_key_to_chord(key);
+            return true;
+#endif // STENO_ENABLE_BOLT
+#ifdef STENO_ENABLE_GEMINI
+        case STENO_MODE_GEMINI:
+            add_gemini_key_to_chord(key);
+            return true;
+#endif // STENO_ENABLE_GEMINI
+        default:
+            return false;
+    }
+}
+
+#ifdef STENO_FIRST_UP
+static void steno_chord_from_held_keys(void) {
+    steno_clear_chord();
+    for (uint8_t key = 0; key <= STN__MAX - STN__MIN; ++key) {
+        if (held_keys[key / 8] & (1 << (key % 8))) {
+            add_key_to_chord(key + STN__MIN - QK_STENO);
+        }
+    }
+}
+#endif
+
 /* override to intercept chords right before they get sent.
  * return zero to suppress normal sending behavior.
  */
@@ -195,53 +302,68 @@ bool process_steno(uint16_t keycode, keyrecord_t *record) {
         case STN__MIN ... STN__MAX:
             if (IS_PRESSED(record->event)) {
                 n_pressed_keys++;
-                switch (mode) {
-#ifdef STENO_ENABLE_BOLT
-                    case STENO_MODE_BOLT:
-                        add_bolt_key_to_chord(keycode - QK_STENO);
-                        break;
-#endif // STENO_ENABLE_BOLT
-#ifdef STENO_ENABLE_GEMINI
-                    case STENO_MODE_GEMINI:
-                        add_gemini_key_to_chord(keycode - QK_STENO);
-                        break;
-#endif // STENO_ENABLE_GEMINI
-                    default:
-                        return false;
+                if (!add_key_to_chord(keycode - QK_STENO)) {
+                    return false;
+                }
+#ifdef STENO_FIRST_UP
+                held_keys[(keycode - STN__MIN) / 8] |= 1 << ((keycode - STN__MIN) % 8);
+#endif
+                if (!chord_pending) {
+                    chord_pending    = true;
+                    chord_start_time = record->event.time;
                 }
                 if (!post_process_steno_user(keycode, record, mode, chord, n_pressed_keys)) {
                     return false;
                 }
             } else { // is released
                 n_pressed_keys--;
+#ifdef STENO_FIRST_UP
+                held_keys[(keycode - STN__MIN) / 8] &= ~(1 << ((keycode - STN__MIN) % 8));
+#endif
                 if (!post_process_steno_user(keycode, record, mode, chord, n_pressed_keys)) {
                     return false;
                 }
+#ifdef STENO_FIRST_UP
+                if (!chord_pending) {
+                    // The chord was already sent when the first of its keys was released,
+                    // and no keys have been pressed since. The released key is not part of the next one.
+                    steno_chord_from_held_keys();
+                    return false;
+                }
+#else
                 if (n_pressed_keys > 0) {
                     // User hasn't released all keys yet,
                     // so the chord cannot be sent
                     return false;
                 }
-                n_pressed_keys = 0;
-                if (!send_steno_chord_user(mode, chord)) {
-                    steno_clear_chord();
-                    return false;
+#endif
+                if (n_pressed_keys < 0) {
+                    n_pressed_keys = 0;
                 }
-                switch (mode) {
+                chord_pending  = false;
+                chord_end_time = record->event.time;
+                if (send_steno_chord_user(mode, chord)) {
+                    switch (mode) {
 #if defined(STENO_ENABLE_BOLT) && defined(VIRTSER_ENABLE)
-                    case STENO_MODE_BOLT:
-                        send_steno_chord_bolt();
-                        break;
+                        case STENO_MODE_BOLT:
+                            send_steno_chord_bolt();
+                            break;
 #endif // STENO_ENABLE_BOLT && VIRTSER_ENABLE
 #if defined(STENO_ENABLE_GEMINI) && defined(VIRTSER_ENABLE)
-                    case STENO_MODE_GEMINI:
-                        send_steno_chord_gemini();
-                        break;
+                        case STENO_MODE_GEMINI:
+                            send_steno_chord_gemini();
+                            break;
 #endif // STENO_ENABLE_GEMINI && VIRTSER_ENABLE
-                    default:
-                        break;
+                        default:
+                            break;
+                    }
                 }
+#ifdef STENO_FIRST_UP
+                // The keys which are still held down start off the next chord
+                steno_chord_from_held_keys();
+#else
                 steno_clear_chord();
+#endif
             }
             break;
     }
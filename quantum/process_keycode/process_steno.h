@@ -32,7 +32,10 @@ typedef enum {
     STENO_MODE_BOLT,
 } steno_mode_t;
 
-bool process_steno(uint16_t keycode, keyrecord_t *record);
+bool     process_steno(uint16_t keycode, keyrecord_t *record);
+void     steno_task(void);
+uint16_t steno_chord_start_time(void);
+uint16_t steno_chord_end_time(void);
 #ifdef STENO_ENABLE_ALL
 void steno_init(void);
 void steno_set_mode(steno_mode_t mode);
@@ -15,8 +15,46 @@
  */
 #include "quantum.h"
 
-static uint16_t active_td;
-static uint16_t last_tap_time;
+/* Dances that are waiting for more taps, in the order they were started */
+typedef struct {
+    uint8_t  index;
+    uint16_t start_time;
+    uint16_t last_tap_time;
+} tap_dance_slot_t;
+
+static tap_dance_slot_t    active_slots[TAP_DANCE_MAX_SIMULTANEOUS];
+static uint8_t             active_count;
+static tap_dance_latency_t latency;
+
+static int8_t tap_dance_slot_find(uint8_t index) {
+    for (uint8_t i = 0; i < active_count; i++) {
+        if (active_slots[i].index == index) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void tap_dance_slot_remove(uint8_t index, bool resolved) {
+    int8_t slot = tap_dance_slot_find(index);
+
+    if (slot < 0) return;
+
+    if (resolved) {
+        uint16_t elapsed = timer_elapsed(active_slots[slot].start_time);
+        latency.last     = elapsed;
+        latency.max      = MAX(latency.max, elapsed);
+        if (latency.count < UINT16_MAX) {
+            latency.count++;
+        }
+        dprintf("tap dance %u resolved after %ums\n", index, elapsed);
+    }
+
+    active_count--;
+    for (uint8_t i = slot; i < active_count; i++) {
+        active_slots[i] = active_slots[i + 1];
+    }
+}
 
 void qk_tap_dance_pair_on_each_tap(qk_tap_dance_state_t *state, void *user_data) {
     qk_tap_dance_pair_t *pair = (qk_tap_dance_pair_t *)user_data;
@@ -108,24 +146,47 @@ static inline void process_tap_dance_action_on_dance_finished(qk_tap_dance_actio
         send_keyboard_report();
         _process_tap_dance_action_fn(&action->state, action->user_data, action->fn.on_dance_finished);
     }
-    active_td = 0;
+    tap_dance_slot_remove(action - tap_dance_actions, true);
     if (!action->state.pressed) {
         // There will not be a key release event, so reset now.
         process_tap_dance_action_on_reset(action);
     }
 }
 
-bool preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
-    qk_tap_dance_action_t *action;
-
-    if (!record->event.pressed) return false;
-
-    if (!active_td || keycode == active_td) return false;
+static void tap_dance_interrupt_oldest(uint16_t keycode) {
+    qk_tap_dance_action_t *action = &tap_dance_actions[active_slots[0].index];
 
-    action                             = &tap_dance_actions[TD_INDEX(active_td)];
     action->state.interrupted          = true;
     action->state.interrupting_keycode = keycode;
     process_tap_dance_action_on_dance_finished(action);
+}
+
+bool preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
+    int8_t slot;
+
+    if (!active_count || !record->event.pressed) return false;
+
+    switch (keycode) {
+        case QK_TAP_DANCE ... QK_TAP_DANCE_MAX:
+            slot = tap_dance_slot_find(TD_INDEX(keycode));
+            if (slot == 0 || (slot < 0 && active_count < TAP_DANCE_MAX_SIMULTANEOUS)) return false;
+
+            if (slot < 0) {
+                // No room for a new dance
+                tap_dance_interrupt_oldest(keycode);
+            } else {
+                // Another tap may finish this dance right away, so the dances started before it are decided first
+                while (active_slots[0].index != TD_INDEX(keycode)) {
+                    tap_dance_interrupt_oldest(keycode);
+                }
+            }
+            break;
+        default:
+            while (active_count) {
+                tap_dance_interrupt_oldest(keycode);
+            }
+            break;
+    }
 
     // Tap dance actions can leave some weak mods active (e.g., if the tap dance is mapped to a keycode with
     // modifiers), but these weak mods should not affect the keypress which interrupted the tap dance.
@@ -147,9 +208,21 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
 
             action->state.pressed = record->event.pressed;
             if (record->event.pressed) {
-                last_tap_time = timer_read();
+                uint16_t now  = timer_read();
+                int8_t   slot = tap_dance_slot_find(TD_INDEX(keycode));
+
+                if (slot < 0 && active_count < TAP_DANCE_MAX_SIMULTANEOUS) {
+                    slot                          = active_count++;
+                    active_slots[slot].index      = TD_INDEX(keycode);
+                    active_slots[slot].start_time = now;
+                }
+                if (slot >= 0) {
+                    active_slots[slot].last_tap_time = now;
+                }
                 process_tap_dance_action_on_each_tap(action);
-                active_td = action->state.finished ? 0 : keycode;
+                if (action->state.finished) {
+                    tap_dance_slot_remove(TD_INDEX(keycode), true);
+                }
             } else {
                 if (action->state.finished) {
                     process_tap_dance_action_on_reset(action);
@@ -163,17 +236,31 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
 }
 
 void tap_dance_task() {
-    qk_tap_dance_action_t *action;
+    int8_t expired = -1;
+
+    if (!active_count) return;
 
-    if (!active_td || timer_elapsed(last_tap_time) <= GET_TAPPING_TERM(active_td, &(keyrecord_t){})) return;
+    for (uint8_t i = 0; i < active_count; i++) {
+        if (timer_elapsed(active_slots[i].last_tap_time) > GET_TAPPING_TERM(TD(active_slots[i].index), &(keyrecord_t){})) {
+            expired = i;
+        }
+    }
 
-    action = &tap_dance_actions[TD_INDEX(active_td)];
-    if (!action->state.interrupted) {
-        process_tap_dance_action_on_dance_finished(action);
+    // Dances started earlier than an expired one finish first, so their output stays in order
+    for (; expired >= 0 && active_count; expired--) {
+        process_tap_dance_action_on_dance_finished(&tap_dance_actions[active_slots[0].index]);
     }
 }
 
 void reset_tap_dance(qk_tap_dance_state_t *state) {
-    active_td = 0;
+    tap_dance_slot_remove((qk_tap_dance_action_t *)state - tap_dance_actions, false);
     process_tap_dance_action_on_reset((qk_tap_dance_action_t *)state);
 }
+
+tap_dance_latency_t tap_dance_get_latency(void) {
+    return latency;
+}
+
+void tap_dance_clear_latency(void) {
+    latency = (tap_dance_latency_t){0};
+}
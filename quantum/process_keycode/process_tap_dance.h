@@ -21,6 +21,13 @@
 #    include <stdbool.h>
 #    include <inttypes.h>
 
+/* Number of dances that can wait for more taps at the same time */
+#    ifndef TAP_DANCE_MAX_SIMULTANEOUS
+#        define TAP_DANCE_MAX_SIMULTANEOUS 1
+#    elif TAP_DANCE_MAX_SIMULTANEOUS < 1 || TAP_DANCE_MAX_SIMULTANEOUS > 8
+#        error TAP_DANCE_MAX_SIMULTANEOUS needs to be between 1 and 8
+#    endif
+
 typedef struct {
     uint16_t interrupting_keycode;
     uint8_t  count;
@@ -75,10 +82,20 @@ typedef struct {
 #    define TD_INDEX(code) ((code)&0xFF)
 #    define TAP_DANCE_KEYCODE(state) TD(((qk_tap_dance_action_t *)state) - tap_dance_actions)
 
+/* Time from the first tap of a dance until it finished, in milliseconds */
+typedef struct {
+    uint16_t last;
+    uint16_t max;
+    uint16_t count;
+} tap_dance_latency_t;
+
 extern qk_tap_dance_action_t tap_dance_actions[];
 
 void reset_tap_dance(qk_tap_dance_state_t *state);
 
+tap_dance_latency_t tap_dance_get_latency(void);
+void                tap_dance_clear_latency(void);
+
 /* To be used internally */
 
 bool preprocess_tap_dance(uint16_t keycode, keyrecord_t *record);
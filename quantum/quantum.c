@@ -36,6 +36,13 @@
 #    include "haptic.h"
 #endif
 
+#ifdef EEPROM_WRITE_CACHE_ENABLE
+#    include "eeprom_write_cache.h"
+#endif
+#ifdef EEPROM_WEAR_LEVELING
+#    include "eeprom_wear_leveling.h"
+#endif
+
 #ifdef AUDIO_ENABLE
 #    ifndef GOODBYE_SONG
 #        define GOODBYE_SONG SONG(GOODBYE_SOUND)
@@ -153,6 +160,13 @@ void shutdown_quantum(void) {
 #endif
 #ifdef HAPTIC_ENABLE
     haptic_shutdown();
+#endif
+    eeconfig_deferred_flush();
+#ifdef EEPROM_WRITE_CACHE_ENABLE
+    eeprom_write_cache_flush();
+#endif
+#ifdef EEPROM_WEAR_LEVELING
+    eeprom_wear_leveling_flush();
 #endif
 }
 
@@ -471,6 +485,11 @@ __attribute__((weak)) void shutdown_user() {}
 
 void suspend_power_down_quantum(void) {
     suspend_power_down_kb();
+    eeconfig_deferred_flush();
+#ifdef EEPROM_WEAR_LEVELING
+    // Don't leave batched writes or a partial consolidation in RAM if power is about to be removed
+    eeprom_wear_leveling_flush();
+#endif
 #ifndef NO_SUSPEND_POWER_DOWN
 // Turn off backlight
 #    ifdef BACKLIGHT_ENABLE
@@ -536,6 +555,10 @@ __attribute__((weak)) void suspend_wakeup_init_quantum(void) {
 #endif
 #if defined(RGB_MATRIX_ENABLE)
     rgb_matrix_set_suspend_state(false);
+#endif
+#if defined(POINTING_DEVICE_ENABLE) && defined(POINTING_DEVICE_MOTION_ACCUMULATE_ENABLE)
+    // don't send motion that piled up while suspended
+    pointing_device_motion_reset();
 #endif
     suspend_wakeup_init_kb();
 }
@@ -0,0 +1,65 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <stddef.h>
+
+#include "raw_hid.h"
+
+#ifndef RAW_HID_COMMAND_COUNT
+#    define RAW_HID_COMMAND_COUNT 4
+#endif
+
+typedef struct {
+    uint8_t                   id;
+    raw_hid_command_handler_t handler;
+} raw_hid_command_t;
+
+static raw_hid_command_t raw_hid_commands[RAW_HID_COMMAND_COUNT];
+static uint8_t           raw_hid_command_count = 0;
+
+// The report being handled, the response is written to it
+static uint8_t                  *raw_hid_report        = NULL;
+static uint8_t                   raw_hid_report_length = 0;
+static raw_hid_command_handler_t raw_hid_deferred      = NULL;
+
+bool raw_hid_register_command(uint8_t id, raw_hid_command_handler_t handler) {
+    for (uint8_t i = 0; i < raw_hid_command_count; i++) {
+        if (raw_hid_commands[i].id == id) {
+            raw_hid_commands[i].handler = handler;
+            return true;
+        }
+    }
+    if (raw_hid_command_count == RAW_HID_COMMAND_COUNT) {
+        return false;
+    }
+    raw_hid_commands[raw_hid_command_count++] = (raw_hid_command_t){.id = id, .handler = handler};
+    return true;
+}
+
+void raw_hid_defer(raw_hid_command_handler_t function) {
+    raw_hid_deferred = function;
+}
+
+void raw_hid_dispatch(uint8_t *data, uint8_t length) {
+    raw_hid_report        = data;
+    raw_hid_report_length = length;
+
+    for (uint8_t i = 0; i < raw_hid_command_count; i++) {
+        if (raw_hid_commands[i].id == data[0]) {
+            if (raw_hid_commands[i].handler(data, length) && !raw_hid_deferred) {
+                raw_hid_send(data, length);
+            }
+            return;
+        }
+    }
+
+    raw_hid_receive(data, length);
+}
+
+bool raw_hid_ready(void) {
+    if (raw_hid_deferred && raw_hid_deferred(raw_hid_report, raw_hid_report_length)) {
+        raw_hid_deferred = NULL;
+        raw_hid_send(raw_hid_report, raw_hid_report_length);
+    }
+    return !raw_hid_deferred;
+}
@@ -1,5 +1,36 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
 void raw_hid_receive(uint8_t *data, uint8_t length);
 
 void raw_hid_send(uint8_t *data, uint8_t length);
+
+/**
+ * Handles a report from the host in place: the report is passed in data and changed into the
+ * response. Returns whether the report should be sent back to the host.
+ */
+typedef bool (*raw_hid_command_handler_t)(uint8_t *data, uint8_t length);
+
+/**
+ * Handles reports whose first byte is id with handler, before they reach raw_hid_receive().
+ * Registering an id again replaces its handler. Returns false if RAW_HID_COMMAND_COUNT handlers
+ * are registered already.
+ */
+bool raw_hid_register_command(uint8_t id, raw_hid_command_handler_t handler);
+
+/**
+ * Finishes the command being handled later, for commands which take too long to handle in a
+ * single task. function is called with the report once per task, until it returns true, and the
+ * report is then sent back to the host. No reports are read from the host in the meantime.
+ *
+ * Only to be called from a command handler or raw_hid_receive(), which should not send a response.
+ */
+void raw_hid_defer(raw_hid_command_handler_t function);
+
+// Called by the USB protocol for every report received, with a buffer which outlives the command.
+void raw_hid_dispatch(uint8_t *data, uint8_t length);
+
+// Called by the USB protocol before reading reports, returns whether another can be handled.
+bool raw_hid_ready(void);
@@ -318,7 +318,6 @@ static void rgb_task_timers(void) {
 }
 
 static void rgb_task_sync(void) {
-    eeconfig_flush_rgb_matrix(false);
     // next task
     if (sync_timer_elapsed32(g_rgb_timer) >= RGB_MATRIX_LED_FLUSH_LIMIT) rgb_task_state = STARTING;
 }
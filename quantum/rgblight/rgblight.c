@@ -133,9 +133,32 @@ static bool deferred_set_layer_state = false;
 
 rgblight_ranges_t rgblight_ranges = {0, RGBLED_NUM, 0, RGBLED_NUM, RGBLED_NUM};
 
+/* The effects only write the LEDs that change from one frame to the next, and
+ * the range of LEDs written since the last frame was sent is tracked so that
+ * unchanged frames aren't sent, and the driver is only given the strip up to
+ * the last changed LED.
+ */
+static uint8_t rgblight_dirty_start = 0;
+static uint8_t rgblight_dirty_end   = RGBLED_NUM;
+#ifdef RGBLIGHT_USE_TIMER
+// The LEDs may have been written outside of the effects, so the next frame must be drawn in full
+static bool rgblight_effect_redraw = true;
+#endif
+
+static void rgblight_mark_dirty(uint8_t start, uint8_t end) {
+    if (rgblight_dirty_start >= rgblight_dirty_end) {
+        rgblight_dirty_start = start;
+        rgblight_dirty_end   = end;
+    } else {
+        rgblight_dirty_start = MIN(rgblight_dirty_start, start);
+        rgblight_dirty_end   = MAX(rgblight_dirty_end, end);
+    }
+}
+
 void rgblight_set_clipping_range(uint8_t start_pos, uint8_t num_leds) {
     rgblight_ranges.clipping_start_pos = start_pos;
     rgblight_ranges.clipping_num_leds  = num_leds;
+    rgblight_mark_dirty(0, RGBLED_NUM);
 }
 
 void rgblight_set_effect_range(uint8_t start_pos, uint8_t num_leds) {
@@ -144,6 +167,9 @@ void rgblight_set_effect_range(uint8_t start_pos, uint8_t num_leds) {
     rgblight_ranges.effect_start_pos = start_pos;
     rgblight_ranges.effect_end_pos   = start_pos + num_leds;
     rgblight_ranges.effect_num_leds  = num_leds;
+#ifdef RGBLIGHT_USE_TIMER
+    rgblight_effect_redraw = true;
+#endif
 }
 
 __attribute__((weak)) RGB rgblight_hsv_to_rgb(HSV hsv) {
@@ -183,6 +209,11 @@ void rgblight_check_config(void) {
     }
 }
 
+#ifdef EEPROM_ENABLE
+// The config as of the last request to write it
+static uint32_t rgblight_eeconfig_pending;
+#endif
+
 uint32_t eeconfig_read_rgblight(void) {
 #ifdef EEPROM_ENABLE
     return eeprom_read_dword(EECONFIG_RGBLIGHT);
@@ -194,10 +225,25 @@ uint32_t eeconfig_read_rgblight(void) {
 void eeconfig_update_rgblight(uint32_t val) {
 #ifdef EEPROM_ENABLE
     rgblight_check_config();
+    rgblight_eeconfig_pending = val;
     eeprom_update_dword(EECONFIG_RGBLIGHT, val);
 #endif
 }
 
+#ifdef EEPROM_ENABLE
+static void rgblight_eeconfig_flush(void) {
+    eeconfig_update_rgblight(rgblight_eeconfig_pending);
+}
+#endif
+
+/* Schedules the current config to be written, without any later _noeeprom changes */
+static void rgblight_eeconfig_defer(void) {
+#ifdef EEPROM_ENABLE
+    rgblight_eeconfig_pending = rgblight_config.raw;
+    eeconfig_defer_flush(rgblight_eeconfig_flush);
+#endif
+}
+
 void eeconfig_update_rgblight_current(void) {
     eeconfig_update_rgblight(rgblight_config.raw);
 }
@@ -349,7 +395,7 @@ void rgblight_mode_eeprom_helper(uint8_t mode, bool write_to_eeprom) {
     }
     RGBLIGHT_SPLIT_SET_CHANGE_MODE;
     if (write_to_eeprom) {
-        eeconfig_update_rgblight(rgblight_config.raw);
+        rgblight_eeconfig_defer();
         dprintf("rgblight mode [EEPROM]: %u\n", rgblight_config.mode);
     } else {
         dprintf("rgblight mode [NOEEPROM]: %u\n", rgblight_config.mode);
@@ -407,7 +453,7 @@ void rgblight_enable_noeeprom(void) {
 
 void rgblight_disable(void) {
     rgblight_config.enable = 0;
-    eeconfig_update_rgblight(rgblight_config.raw);
+    rgblight_eeconfig_defer();
     dprintf("rgblight disable [EEPROM]: rgblight_config.enable = %u\n", rgblight_config.enable);
     rgblight_timer_disable();
     RGBLIGHT_SPLIT_SET_CHANGE_MODE;
@@ -491,7 +537,7 @@ void rgblight_increase_speed_helper(bool write_to_eeprom) {
     if (rgblight_config.speed < 3) rgblight_config.speed++;
     // RGBLIGHT_SPLIT_SET_CHANGE_HSVS; // NEED?
     if (write_to_eeprom) {
-        eeconfig_update_rgblight(rgblight_config.raw); // EECONFIG needs to be increased to support this
+        rgblight_eeconfig_defer(); // EECONFIG needs to be increased to support this
     }
 }
 void rgblight_increase_speed(void) {
@@ -505,7 +551,7 @@ void rgblight_decrease_speed_helper(bool write_to_eeprom) {
     if (rgblight_config.speed > 0) rgblight_config.speed--;
     // RGBLIGHT_SPLIT_SET_CHANGE_HSVS; // NEED??
     if (write_to_eeprom) {
-        eeconfig_update_rgblight(rgblight_config.raw); // EECONFIG needs to be increased to support this
+        rgblight_eeconfig_defer(); // EECONFIG needs to be increased to support this
     }
 }
 void rgblight_decrease_speed(void) {
@@ -591,7 +637,7 @@ void rgblight_sethsv_eeprom_helper(uint8_t hue, uint8_t sat, uint8_t val, bool w
         rgblight_config.sat = sat;
         rgblight_config.val = val;
         if (write_to_eeprom) {
-            eeconfig_update_rgblight(rgblight_config.raw);
+            rgblight_eeconfig_defer();
             dprintf("rgblight set hsv [EEPROM]: %u,%u,%u\n", rgblight_config.hue, rgblight_config.sat, rgblight_config.val);
         } else {
             dprintf("rgblight set hsv [NOEEPROM]: %u,%u,%u\n", rgblight_config.hue, rgblight_config.sat, rgblight_config.val);
@@ -614,7 +660,7 @@ uint8_t rgblight_get_speed(void) {
 void rgblight_set_speed_eeprom_helper(uint8_t speed, bool write_to_eeprom) {
     rgblight_config.speed = speed;
     if (write_to_eeprom) {
-        eeconfig_update_rgblight(rgblight_config.raw); // EECONFIG needs to be increased to support this
+        rgblight_eeconfig_defer(); // EECONFIG needs to be increased to support this
         dprintf("rgblight set speed [EEPROM]: %u\n", rgblight_config.speed);
     } else {
         dprintf("rgblight set speed [NOEEPROM]: %u\n", rgblight_config.speed);
@@ -904,7 +950,7 @@ __attribute__((weak)) void rgblight_call_driver(LED_TYPE *start_led, uint8_t num
 
 #ifndef RGBLIGHT_CUSTOM_DRIVER
 
-void rgblight_set(void) {
+static void rgblight_send_changes(void) {
     LED_TYPE *start_led;
     uint8_t   num_leds = rgblight_ranges.clipping_num_leds;
 
@@ -917,6 +963,7 @@ void rgblight_set(void) {
             led[i].w = 0;
 #    endif
         }
+        rgblight_mark_dirty(rgblight_ranges.effect_start_pos, rgblight_ranges.effect_end_pos);
     }
 
 #    ifdef RGBLIGHT_LAYERS
@@ -928,27 +975,71 @@ void rgblight_set(void) {
 #        endif
     ) {
         rgblight_layers_write();
+        if (rgblight_status.enabled_layer_mask) {
+            // The effects must draw over the layers again on their next frame
+            rgblight_mark_dirty(0, RGBLED_NUM);
+#        ifdef RGBLIGHT_USE_TIMER
+            rgblight_effect_redraw = true;
+#        endif
+        }
+    }
+#    endif
+
+#    if defined(RGBLIGHT_LED_MAP) || defined(RGBW)
+    // The whole strip is sent, as changed LEDs may be anywhere in it once mapped
+    if (rgblight_dirty_start < rgblight_dirty_end) {
+        rgblight_mark_dirty(0, RGBLED_NUM);
     }
 #    endif
 
-#    ifdef RGBLIGHT_LED_MAP
+    // LEDs after the last changed one keep their color if they aren't sent
+    uint8_t clipping_end = rgblight_ranges.clipping_start_pos + rgblight_ranges.clipping_num_leds;
+    if (rgblight_dirty_start >= rgblight_dirty_end || rgblight_dirty_start >= clipping_end || rgblight_dirty_end <= rgblight_ranges.clipping_start_pos) {
+        rgblight_dirty_start = rgblight_dirty_end = 0;
+        return;
+    }
+    if (rgblight_dirty_end < clipping_end) {
+        num_leds = rgblight_dirty_end - rgblight_ranges.clipping_start_pos;
+    }
+    rgblight_dirty_start = rgblight_dirty_end = 0;
+
+#    if defined(RGBLIGHT_LED_MAP) || defined(RGBW)
+    // Mapped or converted to RGBW in a copy, so that led[] still holds what the effects drew
     LED_TYPE led0[RGBLED_NUM];
     for (uint8_t i = 0; i < RGBLED_NUM; i++) {
+#        ifdef RGBLIGHT_LED_MAP
         led0[i] = led[pgm_read_byte(&led_map[i])];
+#        else
+        led0[i] = led[i];
+#        endif
+#        ifdef RGBW
+        convert_rgb_to_rgbw(&led0[i]);
+#        endif
     }
     start_led = led0 + rgblight_ranges.clipping_start_pos;
 #    else
     start_led = led + rgblight_ranges.clipping_start_pos;
 #    endif
 
-#    ifdef RGBW
-    for (uint8_t i = 0; i < num_leds; i++) {
-        convert_rgb_to_rgbw(&start_led[i]);
-    }
-#    endif
     rgblight_call_driver(start_led, num_leds);
 }
-#endif
+
+void rgblight_set(void) {
+    // led[] may have been written directly, so all of it is sent
+    rgblight_mark_dirty(0, RGBLED_NUM);
+#    ifdef RGBLIGHT_USE_TIMER
+    rgblight_effect_redraw = true;
+#    endif
+    rgblight_send_changes();
+}
+#elif defined(RGBLIGHT_USE_TIMER)
+static void rgblight_send_changes(void) {
+    if (rgblight_dirty_start < rgblight_dirty_end) {
+        rgblight_dirty_start = rgblight_dirty_end = 0;
+        rgblight_set();
+    }
+}
+#endif // RGBLIGHT_CUSTOM_DRIVER
 
 #ifdef RGBLIGHT_SPLIT
 /* for split keyboard master side */
@@ -1038,6 +1129,39 @@ void rgblight_show_solid_color(uint8_t r, uint8_t g, uint8_t b) {
     rgblight_setrgb(r, g, b);
 }
 
+// Number of intervals the effect should advance by for this frame
+static inline uint8_t rgblight_effect_steps(animation_status_t *anim) {
+    return anim->steps ? anim->steps : 1;
+}
+
+// Sets an LED drawn by an effect, tracking it for sending if it changed
+static inline void rgblight_set_led(uint8_t index, const LED_TYPE *color) {
+    LED_TYPE *ledp = &led[index];
+    if (ledp->r != color->r || ledp->g != color->g || ledp->b != color->b
+#    ifdef RGBW
+        || ledp->w != color->w
+#    endif
+    ) {
+        *ledp = *color;
+        rgblight_mark_dirty(index, index + 1);
+    }
+}
+
+static inline void rgblight_fill_effect_range(const LED_TYPE *color) {
+    for (uint8_t i = rgblight_ranges.effect_start_pos; i < rgblight_ranges.effect_end_pos; i++) {
+        rgblight_set_led(i, color);
+    }
+}
+
+// Clears the effect range when the whole frame has to be drawn, for the effects which only draw some of the LEDs
+static inline void rgblight_effect_begin_frame(void) {
+    if (rgblight_effect_redraw) {
+        rgblight_effect_redraw = false;
+        LED_TYPE off           = {0};
+        rgblight_fill_effect_range(&off);
+    }
+}
+
 static void rgblight_effect_dummy(animation_status_t *anim) {
     // do nothing
     /********
@@ -1125,9 +1249,16 @@ void rgblight_task(void) {
             animation_status.restart    = false;
             animation_status.last_timer = sync_timer_read();
             animation_status.pos16      = 0; // restart signal to local each effect
+            rgblight_effect_redraw      = true;
         }
         uint16_t now = sync_timer_read();
         if (timer_expired(now, animation_status.last_timer)) {
+            // Step the effect by every interval that has passed, so that its speed doesn't depend on how often this runs
+            uint16_t steps = TIMER_DIFF_16(now, animation_status.last_timer) / interval_time + 1;
+            if (steps > UINT8_MAX) {
+                steps = UINT8_MAX;
+            }
+            animation_status.steps = steps;
 #    if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
             static uint16_t report_last_timer = 0;
             static bool     tick_flag         = false;
@@ -1142,7 +1273,7 @@ void rgblight_task(void) {
             }
             oldpos16 = animation_status.pos16;
 #    endif
-            animation_status.last_timer += interval_time;
+            animation_status.last_timer += steps * interval_time;
             effect_func(&animation_status);
 #    if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
             if (animation_status.pos16 == 0 && oldpos16 != 0) {
@@ -1203,9 +1334,12 @@ static uint8_t breathe_calc(uint8_t pos) {
 __attribute__((weak)) const uint8_t RGBLED_BREATHING_INTERVALS[] PROGMEM = {30, 20, 10, 5};
 
 void rgblight_effect_breathing(animation_status_t *anim) {
-    uint8_t val = breathe_calc(anim->pos);
-    rgblight_sethsv_noeeprom_old(rgblight_config.hue, rgblight_config.sat, val);
-    anim->pos = (anim->pos + 1);
+    LED_TYPE color;
+    sethsv(rgblight_config.hue, rgblight_config.sat, breathe_calc(anim->pos), &color);
+    rgblight_effect_begin_frame();
+    rgblight_fill_effect_range(&color);
+    rgblight_send_changes();
+    anim->pos = (anim->pos + rgblight_effect_steps(anim));
 }
 #endif
 
@@ -1213,8 +1347,12 @@ void rgblight_effect_breathing(animation_status_t *anim) {
 __attribute__((weak)) const uint8_t RGBLED_RAINBOW_MOOD_INTERVALS[] PROGMEM = {120, 60, 30};
 
 void rgblight_effect_rainbow_mood(animation_status_t *anim) {
-    rgblight_sethsv_noeeprom_old(anim->current_hue, rgblight_config.sat, rgblight_config.val);
-    anim->current_hue++;
+    LED_TYPE color;
+    sethsv(anim->current_hue, rgblight_config.sat, rgblight_config.val, &color);
+    rgblight_effect_begin_frame();
+    rgblight_fill_effect_range(&color);
+    rgblight_send_changes();
+    anim->current_hue += rgblight_effect_steps(anim);
 }
 #endif
 
@@ -1226,19 +1364,21 @@ void rgblight_effect_rainbow_mood(animation_status_t *anim) {
 __attribute__((weak)) const uint8_t RGBLED_RAINBOW_SWIRL_INTERVALS[] PROGMEM = {100, 50, 20};
 
 void rgblight_effect_rainbow_swirl(animation_status_t *anim) {
-    uint8_t hue;
-    uint8_t i;
+    uint8_t  hue_step = RGBLIGHT_RAINBOW_SWIRL_RANGE / rgblight_ranges.effect_num_leds;
+    uint8_t  hue      = anim->current_hue;
+    LED_TYPE color;
 
-    for (i = 0; i < rgblight_ranges.effect_num_leds; i++) {
-        hue = (RGBLIGHT_RAINBOW_SWIRL_RANGE / rgblight_ranges.effect_num_leds * i + anim->current_hue);
-        sethsv(hue, rgblight_config.sat, rgblight_config.val, (LED_TYPE *)&led[i + rgblight_ranges.effect_start_pos]);
+    rgblight_effect_begin_frame();
+    for (uint8_t i = rgblight_ranges.effect_start_pos; i < rgblight_ranges.effect_end_pos; i++, hue += hue_step) {
+        sethsv(hue, rgblight_config.sat, rgblight_config.val, &color);
+        rgblight_set_led(i, &color);
     }
-    rgblight_set();
+    rgblight_send_changes();
 
     if (anim->delta % 2) {
-        anim->current_hue++;
+        anim->current_hue += rgblight_effect_steps(anim);
     } else {
-        anim->current_hue--;
+        anim->current_hue -= rgblight_effect_steps(anim);
     }
 }
 #endif
@@ -1246,11 +1386,27 @@ void rgblight_effect_rainbow_swirl(animation_status_t *anim) {
 #ifdef RGBLIGHT_EFFECT_SNAKE
 __attribute__((weak)) const uint8_t RGBLED_SNAKE_INTERVALS[] PROGMEM = {100, 50, 20};
 
+// Index within the effect range of a segment of the snake, or -1 if it is off the end
+static int8_t snake_segment(uint8_t pos, uint8_t segment, int8_t increment) {
+    int8_t k = pos + segment * increment;
+    if (k > RGBLED_NUM) {
+        k = k % RGBLED_NUM;
+    }
+    if (k < 0) {
+        k = k + rgblight_ranges.effect_num_leds;
+    }
+    return k < rgblight_ranges.effect_num_leds ? k : -1;
+}
+
 void rgblight_effect_snake(animation_status_t *anim) {
-    static uint8_t pos = 0;
-    uint8_t        i, j;
+    static uint8_t pos       = 0;
+    static uint8_t drawn_pos = 0;
+    static bool    drawn     = false;
+    uint8_t        j;
     int8_t         k;
     int8_t         increment = 1;
+    LED_TYPE       off       = {0};
+    LED_TYPE       color;
 
     if (anim->delta % 2) {
         increment = -1;
@@ -1267,45 +1423,49 @@ void rgblight_effect_snake(animation_status_t *anim) {
     }
 #    endif
 
-    for (i = 0; i < rgblight_ranges.effect_num_leds; i++) {
-        LED_TYPE *ledp = led + i + rgblight_ranges.effect_start_pos;
-        ledp->r        = 0;
-        ledp->g        = 0;
-        ledp->b        = 0;
-#    ifdef RGBW
-        ledp->w = 0;
-#    endif
+    // Only the LEDs of the previous and current snake change
+    if (rgblight_effect_redraw) {
+        drawn = false;
+    }
+    rgblight_effect_begin_frame();
+    if (drawn) {
         for (j = 0; j < RGBLIGHT_EFFECT_SNAKE_LENGTH; j++) {
-            k = pos + j * increment;
-            if (k > RGBLED_NUM) {
-                k = k % RGBLED_NUM;
-            }
-            if (k < 0) {
-                k = k + rgblight_ranges.effect_num_leds;
-            }
-            if (i == k) {
-                sethsv(rgblight_config.hue, rgblight_config.sat, (uint8_t)(rgblight_config.val * (RGBLIGHT_EFFECT_SNAKE_LENGTH - j) / RGBLIGHT_EFFECT_SNAKE_LENGTH), ledp);
+            k = snake_segment(drawn_pos, j, increment);
+            if (k >= 0) {
+                rgblight_set_led(k + rgblight_ranges.effect_start_pos, &off);
             }
         }
     }
-    rgblight_set();
-    if (increment == 1) {
-        if (pos - RGBLIGHT_EFFECT_SNAKE_INCREMENT < 0) {
-            pos = rgblight_ranges.effect_num_leds - 1;
+    for (j = 0; j < RGBLIGHT_EFFECT_SNAKE_LENGTH; j++) {
+        k = snake_segment(pos, j, increment);
+        if (k >= 0) {
+            sethsv(rgblight_config.hue, rgblight_config.sat, (uint8_t)(rgblight_config.val * (RGBLIGHT_EFFECT_SNAKE_LENGTH - j) / RGBLIGHT_EFFECT_SNAKE_LENGTH), &color);
+            rgblight_set_led(k + rgblight_ranges.effect_start_pos, &color);
+        }
+    }
+    drawn_pos = pos;
+    drawn     = true;
+    rgblight_send_changes();
+
+    for (uint8_t step = rgblight_effect_steps(anim); step > 0; step--) {
+        if (increment == 1) {
+            if (pos - RGBLIGHT_EFFECT_SNAKE_INCREMENT < 0) {
+                pos = rgblight_ranges.effect_num_leds - 1;
 #    if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
-            anim->pos = 0;
+                anim->pos = 0;
 #    endif
-        } else {
-            pos -= RGBLIGHT_EFFECT_SNAKE_INCREMENT;
+            } else {
+                pos -= RGBLIGHT_EFFECT_SNAKE_INCREMENT;
 #    if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
-            anim->pos = 1;
+                anim->pos = 1;
 #    endif
-        }
-    } else {
-        pos = (pos + RGBLIGHT_EFFECT_SNAKE_INCREMENT) % rgblight_ranges.effect_num_leds;
+            }
+        } else {
+            pos = (pos + RGBLIGHT_EFFECT_SNAKE_INCREMENT) % rgblight_ranges.effect_num_leds;
 #    if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
-        anim->pos = pos;
+            anim->pos = pos;
 #    endif
+        }
     }
 }
 #endif
@@ -1318,6 +1478,8 @@ void rgblight_effect_knight(animation_status_t *anim) {
     static int8_t high_bound = RGBLIGHT_EFFECT_KNIGHT_LENGTH - 1;
     static int8_t increment  = RGBLIGHT_EFFECT_KNIGHT_INCREMENT;
     uint8_t       i, cur;
+    LED_TYPE      off = {0};
+    LED_TYPE      color;
 
 #    if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
     if (anim->pos == 0) { // restart signal
@@ -1327,44 +1489,30 @@ void rgblight_effect_knight(animation_status_t *anim) {
         increment  = 1;
     }
 #    endif
-    // Set all the LEDs to 0
-    for (i = rgblight_ranges.effect_start_pos; i < rgblight_ranges.effect_end_pos; i++) {
-        led[i].r = 0;
-        led[i].g = 0;
-        led[i].b = 0;
-#    ifdef RGBW
-        led[i].w = 0;
-#    endif
-    }
+    // LEDs outside of the knight's range stay off
+    rgblight_effect_begin_frame();
     // Determine which LEDs should be lit up
+    sethsv(rgblight_config.hue, rgblight_config.sat, rgblight_config.val, &color);
     for (i = 0; i < RGBLIGHT_EFFECT_KNIGHT_LED_NUM; i++) {
         cur = (i + RGBLIGHT_EFFECT_KNIGHT_OFFSET) % rgblight_ranges.effect_num_leds + rgblight_ranges.effect_start_pos;
-
-        if (i >= low_bound && i <= high_bound) {
-            sethsv(rgblight_config.hue, rgblight_config.sat, rgblight_config.val, (LED_TYPE *)&led[cur]);
-        } else {
-            led[cur].r = 0;
-            led[cur].g = 0;
-            led[cur].b = 0;
-#    ifdef RGBW
-            led[cur].w = 0;
-#    endif
-        }
+        rgblight_set_led(cur, (i >= low_bound && i <= high_bound) ? &color : &off);
     }
-    rgblight_set();
+    rgblight_send_changes();
 
-    // Move from low_bound to high_bound changing the direction we increment each
-    // time a boundary is hit.
-    low_bound += increment;
-    high_bound += increment;
+    for (uint8_t step = rgblight_effect_steps(anim); step > 0; step--) {
+        // Move from low_bound to high_bound changing the direction we increment each
+        // time a boundary is hit.
+        low_bound += increment;
+        high_bound += increment;
 
-    if (high_bound <= 0 || low_bound >= RGBLIGHT_EFFECT_KNIGHT_LED_NUM - 1) {
-        increment = -increment;
+        if (high_bound <= 0 || low_bound >= RGBLIGHT_EFFECT_KNIGHT_LED_NUM - 1) {
+            increment = -increment;
 #    if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
-        if (increment == 1) {
-            anim->pos = 0;
-        }
+            if (increment == 1) {
+                anim->pos = 0;
+            }
 #    endif
+        }
     }
 }
 #endif
@@ -1383,6 +1531,7 @@ void rgblight_effect_christmas(animation_status_t *anim) {
     uint32_t xa;
     uint8_t  hue, val;
     uint8_t  i;
+    LED_TYPE colors[2];
 
     // The effect works by animating anim->pos from 0 to 32 and back to 0.
     // The pos is used in a cubic bezier formula to ease-in-out between red and green, leaving the interpolated colors visible as short as possible.
@@ -1391,18 +1540,23 @@ void rgblight_effect_christmas(animation_status_t *anim) {
     // Additionally, these interpolated colors get shown with a slightly darker value, to make them less prominent than the main colors.
     val = 255 - (3 * (hue < hue_green / 2 ? hue : hue_green - hue) / 2);
 
+    // Every LED is one of two colors
+    sethsv(hue_green - hue, rgblight_config.sat, val, &colors[0]);
+    sethsv(hue, rgblight_config.sat, val, &colors[1]);
+    rgblight_effect_begin_frame();
     for (i = 0; i < rgblight_ranges.effect_num_leds; i++) {
-        uint8_t local_hue = (i / RGBLIGHT_EFFECT_CHRISTMAS_STEP) % 2 ? hue : hue_green - hue;
-        sethsv(local_hue, rgblight_config.sat, val, (LED_TYPE *)&led[i + rgblight_ranges.effect_start_pos]);
+        rgblight_set_led(i + rgblight_ranges.effect_start_pos, &colors[(i / RGBLIGHT_EFFECT_CHRISTMAS_STEP) % 2]);
     }
-    rgblight_set();
+    rgblight_send_changes();
 
-    if (anim->pos == 0) {
-        increment = 1;
-    } else if (anim->pos == max_pos) {
-        increment = -1;
+    for (uint8_t step = rgblight_effect_steps(anim); step > 0; step--) {
+        if (anim->pos == 0) {
+            increment = 1;
+        } else if (anim->pos == max_pos) {
+            increment = -1;
+        }
+        anim->pos += increment;
     }
-    anim->pos += increment;
 }
 #endif
 
@@ -1433,24 +1587,23 @@ void rgblight_effect_rgbtest(animation_status_t *anim) {
             break;
     }
     rgblight_setrgb(r, g, b);
-    anim->pos = (anim->pos + 1) % 3;
+    anim->pos = (anim->pos + rgblight_effect_steps(anim)) % 3;
 }
 #endif
 
 #ifdef RGBLIGHT_EFFECT_ALTERNATING
 void rgblight_effect_alternating(animation_status_t *anim) {
+    LED_TYPE on, off;
+    sethsv(rgblight_config.hue, rgblight_config.sat, rgblight_config.val, &on);
+    sethsv(rgblight_config.hue, rgblight_config.sat, 0, &off);
+
+    rgblight_effect_begin_frame();
     for (int i = 0; i < rgblight_ranges.effect_num_leds; i++) {
-        LED_TYPE *ledp = led + i + rgblight_ranges.effect_start_pos;
-        if (i < rgblight_ranges.effect_num_leds / 2 && anim->pos) {
-            sethsv(rgblight_config.hue, rgblight_config.sat, rgblight_config.val, ledp);
-        } else if (i >= rgblight_ranges.effect_num_leds / 2 && !anim->pos) {
-            sethsv(rgblight_config.hue, rgblight_config.sat, rgblight_config.val, ledp);
-        } else {
-            sethsv(rgblight_config.hue, rgblight_config.sat, 0, ledp);
-        }
+        bool lit = (i < rgblight_ranges.effect_num_leds / 2) ? anim->pos : !anim->pos;
+        rgblight_set_led(i + rgblight_ranges.effect_start_pos, lit ? &on : &off);
     }
-    rgblight_set();
-    anim->pos = (anim->pos + 1) % 2;
+    rgblight_send_changes();
+    anim->pos = (anim->pos + rgblight_effect_steps(anim)) % 2;
 }
 #endif
 
@@ -1466,9 +1619,10 @@ typedef struct PACKED {
 static TwinkleState led_twinkle_state[RGBLED_NUM];
 
 void rgblight_effect_twinkle(animation_status_t *anim) {
-    const bool random_color = anim->delta / 3;
-    const bool restart      = anim->pos == 0;
-    anim->pos               = 1;
+    const bool    random_color = anim->delta / 3;
+    const bool    restart      = anim->pos == 0;
+    const uint8_t steps        = rgblight_effect_steps(anim);
+    anim->pos                  = 1;
 
     const uint8_t bottom = breathe_calc(0);
     const uint8_t top    = breathe_calc(127);
@@ -1481,10 +1635,13 @@ void rgblight_effect_twinkle(animation_status_t *anim) {
     }
 
     const uint8_t trigger = scale((uint16_t)0xFF * RGBLIGHT_EFFECT_TWINKLE_PROBABILITY, 127 + rgblight_config.val / 2);
+    const bool    redraw  = rgblight_effect_redraw;
 
+    rgblight_effect_begin_frame();
     for (uint8_t i = 0; i < rgblight_ranges.effect_num_leds; i++) {
-        TwinkleState *t = &(led_twinkle_state[i]);
-        HSV *         c = &(t->hsv);
+        TwinkleState *t    = &(led_twinkle_state[i]);
+        HSV *         c    = &(t->hsv);
+        HSV           last = *c;
 
         if (!random_color) {
             c->h = rgblight_config.hue;
@@ -1497,7 +1654,7 @@ void rgblight_effect_twinkle(animation_status_t *anim) {
             c->v    = 0;
         } else if (t->life) {
             // This LED is already on, either brightening or dimming
-            t->life--;
+            t->life -= MIN(t->life, steps);
             uint8_t unscaled = frac(breathe_calc(frac(t->life, t->max_life)) - bottom, top - bottom);
             c->v             = scale(rgblight_config.val, unscaled);
         } else if ((rand() % 0xFF) < trigger) {
@@ -1513,10 +1670,14 @@ void rgblight_effect_twinkle(animation_status_t *anim) {
             // This LED is off, and was NOT selected to start brightening
         }
 
-        LED_TYPE *ledp = led + i + rgblight_ranges.effect_start_pos;
-        sethsv(c->h, c->s, c->v, ledp);
+        // Most LEDs are idle in any given frame, so only convert the ones which changed
+        if (redraw || restart || c->h != last.h || c->s != last.s || c->v != last.v) {
+            LED_TYPE color;
+            sethsv(c->h, c->s, c->v, &color);
+            rgblight_set_led(i + rgblight_ranges.effect_start_pos, &color);
+        }
     }
 
-    rgblight_set();
+    rgblight_send_changes();
 }
 #endif
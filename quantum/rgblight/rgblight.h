@@ -436,6 +436,7 @@ typedef struct _animation_status_t {
     uint16_t last_timer;
     uint8_t  delta; /* mode - base_mode */
     bool     restart;
+    uint8_t  steps; /* intervals passed since the last frame */
     union {
         uint16_t pos16;
         uint8_t  pos;
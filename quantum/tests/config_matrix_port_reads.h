@@ -0,0 +1,25 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "config_common.h"
+
+/* the mocked GPIO needs no locking */
+#define IGNORE_ATOMIC_BLOCK
+
+/* A ROW2COL matrix with more rows than a matrix_row_t has bits, as generated from info.json */
+#define MATRIX_ROWS 12
+#define MATRIX_COLS 8
+#define DIODE_DIRECTION ROW2COL
+
+#define MATRIX_ROW_PINS \
+    { B0, B1, B2, B3, B4, B5, B6, B7, C0, C1, C2, C3 }
+#define MATRIX_COL_PINS \
+    { D0, D1, D2, D3, D4, D5, D6, D7 }
+
+#define MATRIX_ROW_PORTS \
+    { B0, C0 }
+#define MATRIX_ROW_PORT_TERMS \
+    { {0, 0xFF, 0}, {1, 0xF, 8} }
+#define MATRIX_ROW_PORT_PINS \
+    { B0, B1, B2, B3, B4, B5, B6, B7, C0, C1, C2, C3 }
@@ -0,0 +1,58 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* GPIO of a made up MCU with 8 bit ports, the port number is kept in the upper bits of a pin */
+typedef uint8_t pin_t;
+typedef uint8_t port_data_t;
+
+#define PIN_PORT(pin) ((pin) >> 3)
+#define PIN_BIT(pin) ((pin)&7)
+
+#define B0 0x08
+#define B1 0x09
+#define B2 0x0A
+#define B3 0x0B
+#define B4 0x0C
+#define B5 0x0D
+#define B6 0x0E
+#define B7 0x0F
+#define C0 0x10
+#define C1 0x11
+#define C2 0x12
+#define C3 0x13
+#define D0 0x18
+#define D1 0x19
+#define D2 0x1A
+#define D3 0x1B
+#define D4 0x1C
+#define D5 0x1D
+#define D6 0x1E
+#define D7 0x1F
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void        setPinInputHigh(pin_t pin);
+void        setPinOutput(pin_t pin);
+void        writePinLow(pin_t pin);
+void        writePinHigh(pin_t pin);
+bool        readPin(pin_t pin);
+port_data_t readPort(pin_t pin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define setPinInput setPinInputHigh
+#define setPinInputLow setPinInputHigh
+#define setPinOutputPushPull setPinOutput
+#define setPinOutputOpenDrain setPinOutput
+#define writePin(pin, level) ((level) ? writePinHigh(pin) : writePinLow(pin))
+#define togglePin(pin) writePin(pin, !readPin(pin))
+/* readPort is a function here, matrix.c checks for the macro */
+#define readPort readPort
@@ -0,0 +1,63 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "gpio_mock.hpp"
+
+#include <set>
+#include <utility>
+
+namespace {
+std::set<pin_t>                    outputs_low;
+std::set<std::pair<pin_t, pin_t>> connections;
+
+bool pulled_low(pin_t pin) {
+    for (pin_t output : outputs_low) {
+        if (connections.count({pin, output}) || connections.count({output, pin})) {
+            return true;
+        }
+    }
+    return outputs_low.count(pin) != 0;
+}
+} // namespace
+
+void gpio_mock_reset(void) {
+    outputs_low.clear();
+    connections.clear();
+}
+
+void gpio_mock_connect(pin_t a, pin_t b, bool connected) {
+    if (connected) {
+        connections.insert({a, b});
+    } else {
+        connections.erase({a, b});
+    }
+}
+
+extern "C" {
+void setPinInputHigh(pin_t pin) {
+    outputs_low.erase(pin);
+}
+
+void setPinOutput(pin_t pin) {}
+
+void writePinLow(pin_t pin) {
+    outputs_low.insert(pin);
+}
+
+void writePinHigh(pin_t pin) {
+    outputs_low.erase(pin);
+}
+
+bool readPin(pin_t pin) {
+    return !pulled_low(pin);
+}
+
+port_data_t readPort(pin_t pin) {
+    port_data_t data = 0;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        if (readPin((PIN_PORT(pin) << 3) | bit)) {
+            data |= 1 << bit;
+        }
+    }
+    return data;
+}
+}
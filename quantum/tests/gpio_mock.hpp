@@ -0,0 +1,11 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+extern "C" {
+#include "gpio.h"
+}
+
+void gpio_mock_reset(void);
+/* Closes or opens a switch between two pins */
+void gpio_mock_connect(pin_t a, pin_t b, bool connected = true);
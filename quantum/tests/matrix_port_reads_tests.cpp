@@ -0,0 +1,45 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "gtest/gtest.h"
+#include "gpio_mock.hpp"
+
+extern "C" {
+#include "matrix.h"
+
+matrix_row_t raw_matrix[MATRIX_ROWS];
+matrix_row_t matrix[MATRIX_ROWS];
+
+void matrix_output_select_delay(void) {}
+void matrix_output_unselect_delay(uint8_t line, bool key_pressed) {}
+void matrix_init_quantum(void) {}
+void matrix_scan_quantum(void) {}
+void debounce_init(uint8_t num_rows) {}
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    memcpy(cooked, raw, num_rows * sizeof(matrix_row_t));
+    return changed;
+}
+}
+
+class MatrixPortReads : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        gpio_mock_reset();
+        matrix_init();
+    }
+};
+
+TEST_F(MatrixPortReads, RowsPastTheRowTypeAreRead) {
+    static const pin_t rows[] = {B0, B1, B2, B3, B4, B5, B6, B7, C0, C1, C2, C3};
+    static const pin_t cols[] = {D0, D1, D2, D3, D4, D5, D6, D7};
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        uint8_t col = row % MATRIX_COLS;
+        gpio_mock_connect(rows[row], cols[col]);
+        matrix_scan();
+
+        for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+            EXPECT_EQ(matrix[r], r == row ? 1 << col : 0) << "key at row " << (int)row;
+        }
+        gpio_mock_connect(rows[row], cols[col], false);
+    }
+}
@@ -0,0 +1,8 @@
+matrix_port_reads_CONFIG := $(QUANTUM_PATH)/tests/config_matrix_port_reads.h
+matrix_port_reads_INC := \
+	$(QUANTUM_PATH)/tests
+
+matrix_port_reads_SRC := \
+	$(QUANTUM_PATH)/tests/gpio_mock.cpp \
+	$(QUANTUM_PATH)/tests/matrix_port_reads_tests.cpp \
+	$(QUANTUM_PATH)/matrix.c
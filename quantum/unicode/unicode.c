@@ -30,6 +30,15 @@
 #    include "audio.h"
 #endif
 
+#if defined(UNICODE_HOST_HELPER)
+#    if !defined(RAW_ENABLE)
+#        error "UNICODE_HOST_HELPER requires RAW_ENABLE"
+#    endif
+#    include <string.h>
+#    include "raw_hid.h"
+#    include "timer.h"
+#endif
+
 #if defined(UNICODE_ENABLE) + defined(UNICODEMAP_ENABLE) + defined(UCIS_ENABLE) > 1
 #    error "Cannot enable more than one Unicode method (UNICODE, UNICODEMAP, UCIS) at the same time"
 #endif
@@ -61,6 +70,16 @@
 #    define UNICODE_TYPE_DELAY 10
 #endif
 
+// Raw HID command ID of the host helper's reports, see lib/python/qmk/unicode_helper.py
+#ifndef UNICODE_HOST_HELPER_ID
+#    define UNICODE_HOST_HELPER_ID 0x55
+#endif
+
+// How long the host helper is assumed to be running after it last said hello, in ms
+#ifndef UNICODE_HOST_HELPER_TIMEOUT
+#    define UNICODE_HOST_HELPER_TIMEOUT 2000
+#endif
+
 unicode_config_t unicode_config;
 uint8_t          unicode_saved_mods;
 led_t            unicode_saved_led_state;
@@ -141,7 +160,75 @@ static void unicode_play_song(uint8_t mode) {
 }
 #endif
 
+#ifdef UNICODE_HOST_HELPER
+// The helper says hello as long as it runs, with reports of the size to send it
+static bool     unicode_host_helper_seen = false;
+static uint32_t unicode_host_helper_time = 0;
+static uint8_t  unicode_host_helper_size = 0;
+
+static bool unicode_host_helper_command(uint8_t *data, uint8_t length) {
+    // data = [ command_id, UNICODE_HOST_HELLO ]
+    if (data[1] != UNICODE_HOST_HELLO || length < UNICODE_HOST_HEADER_SIZE + 4 || length > UNICODE_HOST_REPORT_MAX) {
+        return false;
+    }
+    unicode_host_helper_seen = true;
+    unicode_host_helper_time = timer_read32();
+    unicode_host_helper_size = length;
+    // Reply so the helper knows the keyboard supports it
+    return true;
+}
+
+bool unicode_host_helper_active(void) {
+    return unicode_host_helper_seen && timer_elapsed32(unicode_host_helper_time) < UNICODE_HOST_HELPER_TIMEOUT;
+}
+
+// Sends UTF-8 text to the helper, split over as many reports as needed.
+static void unicode_host_helper_send(const char *str, size_t size) {
+    // report = [ command_id, UNICODE_HOST_TEXT, size | UNICODE_HOST_MORE, UTF-8 ... ]
+    uint8_t report[UNICODE_HOST_REPORT_MAX];
+    uint8_t chunk_size = unicode_host_helper_size - UNICODE_HOST_HEADER_SIZE;
+
+    do {
+        uint8_t chunk = MIN(size, chunk_size);
+        memset(report, 0, sizeof(report));
+        report[0] = UNICODE_HOST_HELPER_ID;
+        report[1] = UNICODE_HOST_TEXT;
+        report[2] = chunk | (size > chunk ? UNICODE_HOST_MORE : 0);
+        memcpy(&report[UNICODE_HOST_HEADER_SIZE], str, chunk);
+        raw_hid_send(report, unicode_host_helper_size);
+        str += chunk;
+        size -= chunk;
+    } while (size > 0);
+}
+
+static uint8_t encode_utf8(uint32_t code_point, char *str) {
+    if (code_point < 0x80) {
+        str[0] = code_point;
+        return 1;
+    }
+    if (code_point < 0x800) {
+        str[0] = 0xC0 | (code_point >> 6);
+        str[1] = 0x80 | (code_point & 0x3F);
+        return 2;
+    }
+    if (code_point < 0x10000) {
+        str[0] = 0xE0 | (code_point >> 12);
+        str[1] = 0x80 | ((code_point >> 6) & 0x3F);
+        str[2] = 0x80 | (code_point & 0x3F);
+        return 3;
+    }
+    str[0] = 0xF0 | (code_point >> 18);
+    str[1] = 0x80 | ((code_point >> 12) & 0x3F);
+    str[2] = 0x80 | ((code_point >> 6) & 0x3F);
+    str[3] = 0x80 | (code_point & 0x3F);
+    return 4;
+}
+#endif
+
 void unicode_input_mode_init(void) {
+#ifdef UNICODE_HOST_HELPER
+    raw_hid_register_command(UNICODE_HOST_HELPER_ID, unicode_host_helper_command);
+#endif
     unicode_config.raw = eeprom_read_byte(EECONFIG_UNICODEMODE);
 #if UNICODE_SELECTED_MODES != -1
 #    if UNICODE_CYCLE_PERSIST
@@ -351,13 +438,11 @@ void register_hex32(uint32_t hex) {
     }
 }
 
-void register_unicode(uint32_t code_point) {
-    if (code_point > 0x10FFFF || (code_point > 0xFFFF && unicode_config.input_mode == UNICODE_MODE_WINDOWS)) {
-        // Code point out of range, do nothing
-        return;
-    }
+static bool unicode_hex_supported(uint32_t code_point) {
+    return code_point <= 0x10FFFF && !(code_point > 0xFFFF && unicode_config.input_mode == UNICODE_MODE_WINDOWS);
+}
 
-    unicode_input_start();
+static void register_unicode_hex(uint32_t code_point) {
     if (code_point > 0xFFFF && unicode_config.input_mode == UNICODE_MODE_MACOS) {
         // Convert code point to UTF-16 surrogate pair on macOS
         code_point -= 0x10000;
@@ -367,6 +452,29 @@ void register_unicode(uint32_t code_point) {
     } else {
         register_hex32(code_point);
     }
+}
+
+void register_unicode(uint32_t code_point) {
+    if (code_point > 0x10FFFF) {
+        // Code point out of range, do nothing
+        return;
+    }
+
+#ifdef UNICODE_HOST_HELPER
+    if (unicode_host_helper_active()) {
+        char str[4];
+        unicode_host_helper_send(str, encode_utf8(code_point, str));
+        return;
+    }
+#endif
+
+    if (!unicode_hex_supported(code_point)) {
+        // Code point out of range for the input mode, do nothing
+        return;
+    }
+
+    unicode_input_start();
+    register_unicode_hex(code_point);
     unicode_input_finish();
 }
 
@@ -375,12 +483,40 @@ void send_unicode_string(const char *str) {
         return;
     }
 
+#ifdef UNICODE_HOST_HELPER
+    if (unicode_host_helper_active()) {
+        if (*str) {
+            unicode_host_helper_send(str, strlen(str));
+        }
+        return;
+    }
+#endif
+
+    // macOS takes hex sequences for as long as the Unicode key is held, so the whole
+    // string is typed in one go instead of starting and finishing input for each code point
+    bool continuous = unicode_config.input_mode == UNICODE_MODE_MACOS;
+    bool started    = false;
+
     while (*str) {
         int32_t code_point = 0;
         str                = decode_utf8(str, &code_point);
 
-        if (code_point >= 0) {
-            register_unicode(code_point);
+        if (code_point < 0 || !unicode_hex_supported(code_point)) {
+            continue;
+        }
+
+        if (!started) {
+            unicode_input_start();
+            started = true;
         }
+        register_unicode_hex(code_point);
+        if (!continuous) {
+            unicode_input_finish();
+            started = false;
+        }
+    }
+
+    if (started) {
+        unicode_input_finish();
     }
 }
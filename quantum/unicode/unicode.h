@@ -59,6 +59,21 @@ void register_unicode(uint32_t code_point);
 
 void send_unicode_string(const char *str);
 
+// With UNICODE_HOST_HELPER, Unicode is sent as UTF-8 over raw HID while the helper runs on the host.
+// Reports between them start with [ UNICODE_HOST_HELPER_ID, type ], text reports carry on with
+// [ size | UNICODE_HOST_MORE, UTF-8 ... ], UNICODE_HOST_MORE is set while the text continues
+// in the next report.
+enum unicode_host_report_type {
+    UNICODE_HOST_HELLO = 0x01,
+    UNICODE_HOST_TEXT  = 0x02,
+};
+
+#define UNICODE_HOST_HEADER_SIZE 3
+#define UNICODE_HOST_MORE 0x80
+#define UNICODE_HOST_REPORT_MAX 64
+
+bool unicode_host_helper_active(void);
+
 // clang-format off
 
 #define UC_BSPC UC(0x0008) // (backspace)
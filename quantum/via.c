@@ -268,188 +268,341 @@ __attribute__((weak)) bool via_command_kb(uint8_t *data, uint8_t length) {
     return false;
 }
 
-void raw_hid_receive(uint8_t *data, uint8_t length) {
-    uint8_t *command_id   = &(data[0]);
-    uint8_t *command_data = &(data[1]);
+// Sends the requested number of reports from the keymap buffer, without waiting for the host in between.
+static void via_stream_get_buffer(uint8_t *data, uint8_t length) {
+    // data = [ command_id, report count, offset high, offset low ]
+    uint8_t  count  = MAX(1, MIN(data[1], VIA_STREAM_WINDOW_SIZE));
+    uint16_t offset = (data[2] << 8) | data[3];
+    uint16_t end    = dynamic_keymap_get_buffer_size();
+    uint8_t  size   = length - VIA_STREAM_HEADER_SIZE;
+
+    for (uint8_t seq = 0; seq < count; seq++) {
+        data[1] = seq;
+        data[2] = offset >> 8;
+        data[3] = offset & 0xFF;
+        // The size of the data still in the keymap, the rest is zeroed
+        data[4] = offset < end ? MIN(size, end - offset) : 0;
+        dynamic_keymap_get_buffer(offset, size, &data[VIA_STREAM_HEADER_SIZE]);
+        raw_hid_send(data, length);
+        offset += size;
+    }
+}
 
-    // If via_command_kb() returns true, the command was fully
-    // handled, including calling raw_hid_send()
-    if (via_command_kb(data, length)) {
-        return;
+static uint8_t via_stream_next_seq = 0;
+
+// Writes a report from the host to the keymap buffer. Only the last report of a window is
+// acknowledged, or the first one out of sequence, after which the host resends the window.
+// Returns whether to reply.
+static bool via_stream_set_buffer(uint8_t *data, uint8_t length) {
+    // data = [ command_id, sequence number, offset high, offset low, size, data ]
+    uint8_t  seq    = data[1] & ~VIA_STREAM_LAST_REPORT;
+    bool     last   = data[1] & VIA_STREAM_LAST_REPORT;
+    uint16_t offset = (data[2] << 8) | data[3];
+    uint8_t  size   = MIN(data[4], length - VIA_STREAM_HEADER_SIZE);
+
+    if (seq == 0) {
+        via_stream_next_seq = 0;
+    }
+    if (seq != via_stream_next_seq) {
+        // Ignore the rest of the window, only replying for the first report missed
+        bool reply          = via_stream_next_seq != UINT8_MAX;
+        data[1]             = id_stream_out_of_sequence;
+        data[2]             = via_stream_next_seq;
+        via_stream_next_seq = UINT8_MAX;
+        return reply;
     }
 
-    switch (*command_id) {
-        case id_get_protocol_version: {
-            command_data[0] = VIA_PROTOCOL_VERSION >> 8;
-            command_data[1] = VIA_PROTOCOL_VERSION & 0xFF;
-            break;
-        }
-        case id_get_keyboard_value: {
-            switch (command_data[0]) {
-                case id_uptime: {
-                    uint32_t value  = timer_read32();
-                    command_data[1] = (value >> 24) & 0xFF;
-                    command_data[2] = (value >> 16) & 0xFF;
-                    command_data[3] = (value >> 8) & 0xFF;
-                    command_data[4] = value & 0xFF;
-                    break;
-                }
-                case id_layout_options: {
-                    uint32_t value  = via_get_layout_options();
-                    command_data[1] = (value >> 24) & 0xFF;
-                    command_data[2] = (value >> 16) & 0xFF;
-                    command_data[3] = (value >> 8) & 0xFF;
-                    command_data[4] = value & 0xFF;
-                    break;
-                }
-                case id_switch_matrix_state: {
+    dynamic_keymap_set_buffer(offset, size, &data[VIA_STREAM_HEADER_SIZE]);
+    via_stream_next_seq++;
+
+    // Reply with the number of reports received in this window
+    data[1] = id_stream_ok;
+    data[2] = via_stream_next_seq;
+    return last;
+}
+
+// Command handlers, the data after the command ID is changed in place into the response.
+// They return whether to send the response.
+
+static bool via_handle_get_protocol_version(uint8_t *data, uint8_t length) {
+    uint8_t *command_data = &(data[1]);
+    command_data[0]       = VIA_PROTOCOL_VERSION >> 8;
+    command_data[1]       = VIA_PROTOCOL_VERSION & 0xFF;
+    return true;
+}
+
+static bool via_handle_get_keyboard_value(uint8_t *data, uint8_t length) {
+    uint8_t *command_id   = &(data[0]);
+    uint8_t *command_data = &(data[1]);
+    switch (command_data[0]) {
+        case id_uptime: {
+            uint32_t value  = timer_read32();
+            command_data[1] = (value >> 24) & 0xFF;
+            command_data[2] = (value >> 16) & 0xFF;
+            command_data[3] = (value >> 8) & 0xFF;
+            command_data[4] = value & 0xFF;
+            break;
+        }
+        case id_layout_options: {
+            uint32_t value  = via_get_layout_options();
+            command_data[1] = (value >> 24) & 0xFF;
+            command_data[2] = (value >> 16) & 0xFF;
+            command_data[3] = (value >> 8) & 0xFF;
+            command_data[4] = value & 0xFF;
+            break;
+        }
+        case id_switch_matrix_state: {
 // Round up to the nearest number of bytes required to hold row state.
 // Multiply by number of rows to get the required size in bytes.
 // Guard against this being too big for the HID message.
 #if (((MATRIX_COLS + 7) / 8) * MATRIX_ROWS <= 28)
-                    uint8_t i = 1;
-                    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
-                        matrix_row_t value = matrix_get_row(row);
+            uint8_t i = 1;
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                matrix_row_t value = matrix_get_row(row);
 #    if (MATRIX_COLS > 24)
-                        command_data[i++] = (value >> 24) & 0xFF;
+                command_data[i++] = (value >> 24) & 0xFF;
 #    endif
 #    if (MATRIX_COLS > 16)
-                        command_data[i++] = (value >> 16) & 0xFF;
+                command_data[i++] = (value >> 16) & 0xFF;
 #    endif
 #    if (MATRIX_COLS > 8)
-                        command_data[i++] = (value >> 8) & 0xFF;
+                command_data[i++] = (value >> 8) & 0xFF;
 #    endif
-                        command_data[i++] = value & 0xFF;
-                    }
-#endif
-                    break;
-                }
-                case id_firmware_version: {
-                    uint32_t value  = VIA_FIRMWARE_VERSION;
-                    command_data[1] = (value >> 24) & 0xFF;
-                    command_data[2] = (value >> 16) & 0xFF;
-                    command_data[3] = (value >> 8) & 0xFF;
-                    command_data[4] = value & 0xFF;
-                    break;
-                }
-                default: {
-                    // The value ID is not known
-                    // Return the unhandled state
-                    *command_id = id_unhandled;
-                    break;
-                }
-            }
-            break;
-        }
-        case id_set_keyboard_value: {
-            switch (command_data[0]) {
-                case id_layout_options: {
-                    uint32_t value = ((uint32_t)command_data[1] << 24) | ((uint32_t)command_data[2] << 16) | ((uint32_t)command_data[3] << 8) | (uint32_t)command_data[4];
-                    via_set_layout_options(value);
-                    break;
-                }
-                case id_device_indication: {
-                    uint8_t value = command_data[1];
-                    via_set_device_indication(value);
-                    break;
-                }
-                default: {
-                    // The value ID is not known
-                    // Return the unhandled state
-                    *command_id = id_unhandled;
-                    break;
-                }
+                command_data[i++] = value & 0xFF;
             }
-            break;
-        }
-        case id_dynamic_keymap_get_keycode: {
-            uint16_t keycode = dynamic_keymap_get_keycode(command_data[0], command_data[1], command_data[2]);
-            command_data[3]  = keycode >> 8;
-            command_data[4]  = keycode & 0xFF;
-            break;
-        }
-        case id_dynamic_keymap_set_keycode: {
-            dynamic_keymap_set_keycode(command_data[0], command_data[1], command_data[2], (command_data[3] << 8) | command_data[4]);
-            break;
-        }
-        case id_dynamic_keymap_reset: {
-            dynamic_keymap_reset();
-            break;
-        }
-        case id_custom_set_value:
-        case id_custom_get_value:
-        case id_custom_save: {
-            via_custom_value_command(data, length);
-            break;
-        }
-#ifdef VIA_EEPROM_ALLOW_RESET
-        case id_eeprom_reset: {
-            via_eeprom_set_valid(false);
-            eeconfig_init_via();
-            break;
-        }
 #endif
-        case id_dynamic_keymap_macro_get_count: {
-            command_data[0] = dynamic_keymap_macro_get_count();
-            break;
-        }
-        case id_dynamic_keymap_macro_get_buffer_size: {
-            uint16_t size   = dynamic_keymap_macro_get_buffer_size();
-            command_data[0] = size >> 8;
-            command_data[1] = size & 0xFF;
-            break;
-        }
-        case id_dynamic_keymap_macro_get_buffer: {
-            uint16_t offset = (command_data[0] << 8) | command_data[1];
-            uint16_t size   = command_data[2]; // size <= 28
-            dynamic_keymap_macro_get_buffer(offset, size, &command_data[3]);
-            break;
-        }
-        case id_dynamic_keymap_macro_set_buffer: {
-            uint16_t offset = (command_data[0] << 8) | command_data[1];
-            uint16_t size   = command_data[2]; // size <= 28
-            dynamic_keymap_macro_set_buffer(offset, size, &command_data[3]);
-            break;
-        }
-        case id_dynamic_keymap_macro_reset: {
-            dynamic_keymap_macro_reset();
-            break;
-        }
-        case id_dynamic_keymap_get_layer_count: {
-            command_data[0] = dynamic_keymap_get_layer_count();
             break;
         }
-        case id_dynamic_keymap_get_buffer: {
-            uint16_t offset = (command_data[0] << 8) | command_data[1];
-            uint16_t size   = command_data[2]; // size <= 28
-            dynamic_keymap_get_buffer(offset, size, &command_data[3]);
+        case id_firmware_version: {
+            uint32_t value  = VIA_FIRMWARE_VERSION;
+            command_data[1] = (value >> 24) & 0xFF;
+            command_data[2] = (value >> 16) & 0xFF;
+            command_data[3] = (value >> 8) & 0xFF;
+            command_data[4] = value & 0xFF;
             break;
         }
-        case id_dynamic_keymap_set_buffer: {
-            uint16_t offset = (command_data[0] << 8) | command_data[1];
-            uint16_t size   = command_data[2]; // size <= 28
-            dynamic_keymap_set_buffer(offset, size, &command_data[3]);
+        default: {
+            // The value ID is not known
+            // Return the unhandled state
+            *command_id = id_unhandled;
             break;
         }
-#ifdef ENCODER_MAP_ENABLE
-        case id_dynamic_keymap_get_encoder: {
-            uint16_t keycode = dynamic_keymap_get_encoder(command_data[0], command_data[1], command_data[2] != 0);
-            command_data[3]  = keycode >> 8;
-            command_data[4]  = keycode & 0xFF;
+    }
+    return true;
+}
+
+static bool via_handle_set_keyboard_value(uint8_t *data, uint8_t length) {
+    uint8_t *command_id   = &(data[0]);
+    uint8_t *command_data = &(data[1]);
+    switch (command_data[0]) {
+        case id_layout_options: {
+            uint32_t value = ((uint32_t)command_data[1] << 24) | ((uint32_t)command_data[2] << 16) | ((uint32_t)command_data[3] << 8) | (uint32_t)command_data[4];
+            via_set_layout_options(value);
             break;
         }
-        case id_dynamic_keymap_set_encoder: {
-            dynamic_keymap_set_encoder(command_data[0], command_data[1], command_data[2] != 0, (command_data[3] << 8) | command_data[4]);
+        case id_device_indication: {
+            uint8_t value = command_data[1];
+            via_set_device_indication(value);
             break;
         }
-#endif
         default: {
-            // The command ID is not known
+            // The value ID is not known
             // Return the unhandled state
             *command_id = id_unhandled;
             break;
         }
     }
+    return true;
+}
+
+static bool via_handle_dynamic_keymap_get_keycode(uint8_t *data, uint8_t length) {
+    uint8_t *command_data = &(data[1]);
+    uint16_t keycode      = dynamic_keymap_get_keycode(command_data[0], command_data[1], command_data[2]);
+    command_data[3]       = keycode >> 8;
+    command_data[4]       = keycode & 0xFF;
+    return true;
+}
+
+static bool via_handle_dynamic_keymap_set_keycode(uint8_t *data, uint8_t length) {
+    uint8_t *command_data = &(data[1]);
+    dynamic_keymap_set_keycode(command_data[0], command_data[1], command_data[2], (command_data[3] << 8) | command_data[4]);
+    return true;
+}
+
+static uint8_t via_reset_layer = 0;
+
+// Resets a layer per task rather than the whole keymap at once, which could stall
+// the keyboard for seconds on AVR EEPROM.
+static bool via_dynamic_keymap_reset_task(uint8_t *data, uint8_t length) {
+    dynamic_keymap_reset_layer(via_reset_layer++);
+    return via_reset_layer >= dynamic_keymap_get_layer_count();
+}
+
+static bool via_handle_dynamic_keymap_reset(uint8_t *data, uint8_t length) {
+    via_reset_layer = 0;
+    raw_hid_defer(via_dynamic_keymap_reset_task);
+    return false;
+}
+
+static bool via_handle_custom_value(uint8_t *data, uint8_t length) {
+    via_custom_value_command(data, length);
+    return true;
+}
+
+#ifdef VIA_EEPROM_ALLOW_RESET
+static bool via_handle_eeprom_reset(uint8_t *data, uint8_t length) {
+    via_eeprom_set_valid(false);
+    eeconfig_init_via();
+    return true;
+}
+#endif
+
+static bool via_handle_dynamic_keymap_macro_get_count(uint8_t *data, uint8_t length) {
+    uint8_t *command_data = &(data[1]);
+    command_data[0]       = dynamic_keymap_macro_get_count();
+    return true;
+}
+
+static bool via_handle_dynamic_keymap_macro_get_buffer_size(uint8_t *data, uint8_t length) {
+    uint8_t *command_data = &(data[1]);
+    uint16_t size         = dynamic_keymap_macro_get_buffer_size();
+    command_data[0]       = size >> 8;
+    command_data[1]       = size & 0xFF;
+    return true;
+}
+
+static bool via_handle_dynamic_keymap_macro_get_buffer(uint8_t *data, uint8_t length) {
+    uint8_t *command_data = &(data[1]);
+    uint16_t offset       = (command_data[0] << 8) | command_data[1];
+    uint16_t size         = command_data[2]; // size <= 28
+    dynamic_keymap_macro_get_buffer(offset, size, &command_data[3]);
+    return true;
+}
+
+static bool via_handle_dynamic_keymap_macro_set_buffer(uint8_t *data, uint8_t length) {
+    uint8_t *command_data = &(data[1]);
+    uint16_t offset       = (command_data[0] << 8) | command_data[1];
+    uint16_t size         = command_data[2]; // size <= 28
+    dynamic_keymap_macro_set_buffer(offset, size, &command_data[3]);
+    return true;
+}
+
+static bool via_handle_dynamic_keymap_macro_reset(uint8_t *data, uint8_t length) {
+    dynamic_keymap_macro_reset();
+    return true;
+}
+
+static bool via_handle_dynamic_keymap_get_layer_count(uint8_t *data, uint8_t length) {
+    uint8_t *command_data = &(data[1]);
+    command_data[0]       = dynamic_keymap_get_layer_count();
+    return true;
+}
+
+static bool via_handle_dynamic_keymap_get_buffer(uint8_t *data, uint8_t length) {
+    uint8_t *command_data = &(data[1]);
+    uint16_t offset       = (command_data[0] << 8) | command_data[1];
+    uint16_t size         = command_data[2]; // size <= 28
+    dynamic_keymap_get_buffer(offset, size, &command_data[3]);
+    return true;
+}
+
+static bool via_handle_dynamic_keymap_set_buffer(uint8_t *data, uint8_t length) {
+    uint8_t *command_data = &(data[1]);
+    uint16_t offset       = (command_data[0] << 8) | command_data[1];
+    uint16_t size         = command_data[2]; // size <= 28
+    dynamic_keymap_set_buffer(offset, size, &command_data[3]);
+    return true;
+}
+
+static bool via_handle_dynamic_keymap_get_layer_crcs(uint8_t *data, uint8_t length) {
+    // command_data = [ first layer, count, (crc high, crc low) ... ]
+    uint8_t *command_data = &(data[1]);
+    uint8_t  layer        = command_data[0];
+    uint8_t  count        = 0;
+    uint8_t *crc          = &command_data[2];
+    while (layer < dynamic_keymap_get_layer_count() && crc + 2 <= data + length) {
+        uint16_t value = dynamic_keymap_get_layer_crc(layer++);
+        *crc++         = value >> 8;
+        *crc++         = value & 0xFF;
+        count++;
+    }
+    command_data[1] = count;
+    return true;
+}
+
+static bool via_handle_dynamic_keymap_stream_get_buffer(uint8_t *data, uint8_t length) {
+    // The reports are sent as they are read
+    via_stream_get_buffer(data, length);
+    return false;
+}
+
+#ifdef ENCODER_MAP_ENABLE
+static bool via_handle_dynamic_keymap_get_encoder(uint8_t *data, uint8_t length) {
+    uint8_t *command_data = &(data[1]);
+    uint16_t keycode      = dynamic_keymap_get_encoder(command_data[0], command_data[1], command_data[2] != 0);
+    command_data[3]       = keycode >> 8;
+    command_data[4]       = keycode & 0xFF;
+    return true;
+}
+
+static bool via_handle_dynamic_keymap_set_encoder(uint8_t *data, uint8_t length) {
+    uint8_t *command_data = &(data[1]);
+    dynamic_keymap_set_encoder(command_data[0], command_data[1], command_data[2] != 0, (command_data[3] << 8) | command_data[4]);
+    return true;
+}
+#endif
+
+// Indexed by command ID, commands without a handler are unhandled
+static const raw_hid_command_handler_t via_commands[] PROGMEM = {
+    [id_get_protocol_version]                 = via_handle_get_protocol_version,
+    [id_get_keyboard_value]                   = via_handle_get_keyboard_value,
+    [id_set_keyboard_value]                   = via_handle_set_keyboard_value,
+    [id_dynamic_keymap_get_keycode]           = via_handle_dynamic_keymap_get_keycode,
+    [id_dynamic_keymap_set_keycode]           = via_handle_dynamic_keymap_set_keycode,
+    [id_dynamic_keymap_reset]                 = via_handle_dynamic_keymap_reset,
+    [id_custom_set_value]                     = via_handle_custom_value,
+    [id_custom_get_value]                     = via_handle_custom_value,
+    [id_custom_save]                          = via_handle_custom_value,
+#ifdef VIA_EEPROM_ALLOW_RESET
+    [id_eeprom_reset]                         = via_handle_eeprom_reset,
+#endif
+    [id_dynamic_keymap_macro_get_count]       = via_handle_dynamic_keymap_macro_get_count,
+    [id_dynamic_keymap_macro_get_buffer_size] = via_handle_dynamic_keymap_macro_get_buffer_size,
+    [id_dynamic_keymap_macro_get_buffer]      = via_handle_dynamic_keymap_macro_get_buffer,
+    [id_dynamic_keymap_macro_set_buffer]      = via_handle_dynamic_keymap_macro_set_buffer,
+    [id_dynamic_keymap_macro_reset]           = via_handle_dynamic_keymap_macro_reset,
+    [id_dynamic_keymap_get_layer_count]       = via_handle_dynamic_keymap_get_layer_count,
+    [id_dynamic_keymap_get_buffer]            = via_handle_dynamic_keymap_get_buffer,
+    [id_dynamic_keymap_set_buffer]            = via_handle_dynamic_keymap_set_buffer,
+#ifdef ENCODER_MAP_ENABLE
+    [id_dynamic_keymap_get_encoder]           = via_handle_dynamic_keymap_get_encoder,
+    [id_dynamic_keymap_set_encoder]           = via_handle_dynamic_keymap_set_encoder,
+#endif
+    [id_dynamic_keymap_get_layer_crcs]        = via_handle_dynamic_keymap_get_layer_crcs,
+    [id_dynamic_keymap_stream_get_buffer]     = via_handle_dynamic_keymap_stream_get_buffer,
+    [id_dynamic_keymap_stream_set_buffer]     = via_stream_set_buffer,
+};
+
+void raw_hid_receive(uint8_t *data, uint8_t length) {
+    uint8_t *command_id = &(data[0]);
+
+    // If via_command_kb() returns true, the command was fully
+    // handled, including calling raw_hid_send()
+    if (via_command_kb(data, length)) {
+        return;
+    }
+
+    raw_hid_command_handler_t handler = NULL;
+    if (*command_id < ARRAY_SIZE(via_commands)) {
+        handler = pgm_read_ptr(&via_commands[*command_id]);
+    }
+    if (handler == NULL) {
+        // The command ID is not known
+        // Return the unhandled state
+        *command_id = id_unhandled;
+    } else if (!handler(data, length)) {
+        return;
+    }
 
     // Return the same buffer, optionally with values changed
     // (i.e. returning state to the host, or the unhandled state).
@@ -92,9 +92,28 @@ enum via_command_id {
     id_dynamic_keymap_set_buffer            = 0x13,
     id_dynamic_keymap_get_encoder           = 0x14,
     id_dynamic_keymap_set_encoder           = 0x15,
+    id_dynamic_keymap_get_layer_crcs        = 0x16,
+    id_dynamic_keymap_stream_get_buffer     = 0x17,
+    id_dynamic_keymap_stream_set_buffer     = 0x18,
     id_unhandled                            = 0xFF,
 };
 
+// Keymap streaming moves several reports per request, each one starting with
+// [ command_id, sequence number, offset high, offset low, size ]
+#define VIA_STREAM_HEADER_SIZE 5
+// Set on the sequence number of the last report of a window written by the host
+#define VIA_STREAM_LAST_REPORT 0x80
+
+// The most reports sent back for a single id_dynamic_keymap_stream_get_buffer
+#ifndef VIA_STREAM_WINDOW_SIZE
+#    define VIA_STREAM_WINDOW_SIZE 16
+#endif
+
+enum via_stream_status {
+    id_stream_ok              = 0x00,
+    id_stream_out_of_sequence = 0x01,
+};
+
 enum via_keyboard_value_id {
     id_uptime              = 0x01,
     id_layout_options      = 0x02,
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 void virtser_init(void);
 
 /* Define this function in your code to process incoming bytes */
@@ -7,3 +9,8 @@ void virtser_recv(const uint8_t ch);
 
 /* Call this to send a character over the Virtual Serial Device */
 void virtser_send(const uint8_t byte);
+
+/* Call this to send several characters at once, without waiting for the port.
+ * Returns how many of them were taken, the rest should be sent again later.
+ */
+uint8_t virtser_send_buffer(const uint8_t *data, uint8_t length);
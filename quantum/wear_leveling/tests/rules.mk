@@ -63,4 +63,18 @@ wear_leveling_8byte_SRC := \
 	$(wear_leveling_common_SRC) \
 	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_8byte.cpp
 wear_leveling_8byte_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_background_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=256 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=128 \
+	-DWEAR_LEVELING_BATCH_WRITES \
+	-DWEAR_LEVELING_BACKGROUND_CONSOLIDATION \
+	-DWEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE=32
+wear_leveling_background_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_background.cpp
+wear_leveling_background_INC := \
 	$(wear_leveling_common_INC)
\ No newline at end of file
@@ -0,0 +1,220 @@
+// Copyright 2022 Nick Brassel (@tzarc)
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <numeric>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+class WearLevelingBackground : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        MockBackingStore::Instance().reset_instance();
+        wear_leveling_init();
+    }
+
+    // Each entry is a 5-byte multibyte write, i.e. 8 bytes of write log
+    static constexpr int entry_count = (WEAR_LEVELING_BACKING_SIZE - WEAR_LEVELING_LOGICAL_SIZE - 8) / 8;
+
+    // Commits one 5-byte write per entry in the write log, leaving the log full
+    void fill_write_log(std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE>& expected) {
+        for (int i = 0; i < entry_count; ++i) {
+            std::uint32_t address = 0x40 + (i * 5) % 0x3C;
+            std::uint8_t  value[5];
+            std::iota(std::begin(value), std::end(value), 0x20 + i);
+            EXPECT_EQ(wear_leveling_write(address, value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+            EXPECT_EQ(wear_leveling_commit(), WEAR_LEVELING_SUCCESS) << "Commit returned incorrect status";
+            std::copy(std::begin(value), std::end(value), expected.begin() + address);
+        }
+    }
+
+    void expect_readback(const std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE>& expected) {
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> actual;
+        EXPECT_EQ(wear_leveling_read(0, actual.data(), actual.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+        for (int i = 0; i < WEAR_LEVELING_LOGICAL_SIZE; ++i) {
+            EXPECT_EQ(actual[i], expected[i]) << "Invalid readback at offset " << i;
+        }
+    }
+};
+
+/**
+ * This test verifies that adjacent writes are not written to the backing store until committed, and are then combined into a single log entry.
+ */
+TEST_F(WearLevelingBackground, BatchedWrites_CombinedIntoSingleEntry) {
+    auto& inst        = MockBackingStore::Instance();
+    auto  write_count = inst.write_invoke_count();
+
+    for (int i = 0; i < 5; ++i) {
+        std::uint8_t value = 0x30 + i;
+        EXPECT_EQ(wear_leveling_write(0x40 + i, &value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    }
+    EXPECT_EQ(inst.write_invoke_count(), write_count) << "Batched writes should not reach the backing store";
+    EXPECT_TRUE(wear_leveling_busy()) << "Batched writes should be reported as busy";
+
+    EXPECT_EQ(wear_leveling_commit(), WEAR_LEVELING_SUCCESS) << "Commit returned incorrect status";
+    EXPECT_EQ(inst.write_invoke_count(), write_count + 4) << "5-byte multibyte log entry should be 4 backing store writes";
+    EXPECT_FALSE(wear_leveling_busy()) << "Nothing should be pending after commit";
+
+    // Re-init and make sure the data survives
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected{};
+    std::iota(expected.begin() + 0x40, expected.begin() + 0x45, 0x30);
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    expect_readback(expected);
+}
+
+/**
+ * This test verifies that repeated writes to the same location only result in the latest value being logged.
+ */
+TEST_F(WearLevelingBackground, BatchedWrites_LatestValueLogged) {
+    auto& inst        = MockBackingStore::Instance();
+    auto  write_count = inst.write_invoke_count();
+
+    for (std::uint8_t value = 1; value <= 10; ++value) {
+        EXPECT_EQ(wear_leveling_write(0x50, &value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    }
+    EXPECT_EQ(wear_leveling_commit(), WEAR_LEVELING_SUCCESS) << "Commit returned incorrect status";
+    EXPECT_EQ(inst.write_invoke_count(), write_count + 2) << "1-byte multibyte log entry should be 2 backing store writes";
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected{};
+    expected[0x50] = 10;
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    expect_readback(expected);
+}
+
+/**
+ * This test verifies that filling the write log does not erase in-line, and that each task invocation performs a single step of the consolidation.
+ */
+TEST_F(WearLevelingBackground, FullLog_ConsolidatesInSteps) {
+    auto& inst = MockBackingStore::Instance();
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected{};
+    auto                                                 erase_count = inst.erase_invoke_count();
+    fill_write_log(expected);
+    EXPECT_EQ(inst.erase_invoke_count(), erase_count) << "Filling the write log should not erase in-line";
+    EXPECT_TRUE(wear_leveling_busy()) << "Pending consolidation should be reported as busy";
+
+    // First step erases
+    EXPECT_EQ(wear_leveling_task(), WEAR_LEVELING_SUCCESS) << "Task returned incorrect status";
+    EXPECT_EQ(inst.erase_invoke_count(), erase_count + 1) << "First step should erase the backing store";
+
+    // Following steps write a chunk each, the last also writing the checksum
+    constexpr int chunks = WEAR_LEVELING_LOGICAL_SIZE / WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE;
+    for (int i = 0; i < chunks; ++i) {
+        auto write_count = inst.write_invoke_count();
+        EXPECT_EQ(wear_leveling_task(), i == chunks - 1 ? WEAR_LEVELING_CONSOLIDATED : WEAR_LEVELING_SUCCESS) << "Task returned incorrect status";
+        EXPECT_EQ(inst.write_invoke_count() - write_count, (WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE / BACKING_STORE_WRITE_SIZE) + (i == chunks - 1 ? 8 / BACKING_STORE_WRITE_SIZE : 0)) << "Step wrote an unexpected amount";
+    }
+    EXPECT_FALSE(wear_leveling_busy()) << "Nothing should be pending after consolidation";
+    EXPECT_EQ(wear_leveling_task(), WEAR_LEVELING_SUCCESS) << "Idle task returned incorrect status";
+    EXPECT_EQ(inst.erase_invoke_count(), erase_count + 1) << "Idle task should not erase";
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    expect_readback(expected);
+}
+
+/**
+ * This test verifies that writes made while a consolidation is pending or in progress are not lost, whether to chunks already written or not.
+ */
+TEST_F(WearLevelingBackground, WritesDuringConsolidation_Preserved) {
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected{};
+    fill_write_log(expected);
+
+    // Pending -- nothing can be logged, so it has to be picked up by the consolidation
+    std::uint8_t value = 0x55;
+    EXPECT_EQ(wear_leveling_write(0x7E, &value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    EXPECT_EQ(wear_leveling_commit(), WEAR_LEVELING_SUCCESS) << "Commit returned incorrect status";
+    expected[0x7E] = value;
+
+    // Erase, then write the first chunk
+    EXPECT_EQ(wear_leveling_task(), WEAR_LEVELING_SUCCESS) << "Task returned incorrect status";
+    EXPECT_EQ(wear_leveling_task(), WEAR_LEVELING_SUCCESS) << "Task returned incorrect status";
+
+    // Modify both an already-written chunk and one yet to be written
+    value = 0x66;
+    EXPECT_EQ(wear_leveling_write(0x04, &value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    expected[0x04] = value;
+    value          = 0x77;
+    EXPECT_EQ(wear_leveling_write(0x41, &value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    expected[0x41] = value;
+    EXPECT_EQ(wear_leveling_commit(), WEAR_LEVELING_SUCCESS) << "Commit returned incorrect status";
+
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_CONSOLIDATED) << "Flush returned incorrect status";
+    EXPECT_FALSE(wear_leveling_busy()) << "Nothing should be pending after flush";
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    expect_readback(expected);
+}
+
+/**
+ * This test verifies that a consolidation interrupted by a write failure resumes where it left off, without rewriting anything.
+ */
+TEST_F(WearLevelingBackground, InterruptedChunk_Resumes) {
+    auto& inst = MockBackingStore::Instance();
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected{};
+    fill_write_log(expected);
+    EXPECT_EQ(wear_leveling_task(), WEAR_LEVELING_SUCCESS) << "Erase step returned incorrect status";
+    EXPECT_EQ(wear_leveling_task(), WEAR_LEVELING_SUCCESS) << "First chunk returned incorrect status";
+
+    // Fail part way through the second chunk
+    inst.set_write_callback([](std::uint64_t count, std::uint32_t address) { return address != WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE + 10; });
+    EXPECT_EQ(wear_leveling_task(), WEAR_LEVELING_FAILED) << "Interrupted chunk returned incorrect status";
+    EXPECT_TRUE(wear_leveling_busy()) << "Interrupted consolidation should be reported as busy";
+
+    // Resume -- the mock fails the test if any location is written twice
+    inst.set_write_callback([](std::uint64_t count, std::uint32_t address) { return true; });
+    auto erase_count = inst.erase_invoke_count();
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_CONSOLIDATED) << "Flush returned incorrect status";
+    EXPECT_EQ(inst.erase_invoke_count(), erase_count) << "Resuming should not erase again";
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    expect_readback(expected);
+}
+
+/**
+ * This test verifies that losing power while a consolidation is pending leaves the write log intact, and the consolidation is re-requested on init.
+ */
+TEST_F(WearLevelingBackground, PowerLossBeforeErase_DataKept) {
+    auto& inst = MockBackingStore::Instance();
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected{};
+    fill_write_log(expected);
+    EXPECT_TRUE(wear_leveling_busy()) << "Pending consolidation should be reported as busy";
+
+    // Re-init without running the task, emulating a power cycle
+    auto erase_count = inst.erase_invoke_count();
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    EXPECT_EQ(inst.erase_invoke_count(), erase_count) << "Init should leave consolidation to the task";
+    EXPECT_TRUE(wear_leveling_busy()) << "Full write log should result in a pending consolidation";
+    expect_readback(expected);
+
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_CONSOLIDATED) << "Flush returned incorrect status";
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    EXPECT_FALSE(wear_leveling_busy()) << "Nothing should be pending after consolidation";
+    expect_readback(expected);
+}
+
+/**
+ * This test verifies that a failed checksum write restarts the consolidation from the erase.
+ */
+TEST_F(WearLevelingBackground, ChecksumFailure_Restarts) {
+    auto& inst = MockBackingStore::Instance();
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected{};
+    fill_write_log(expected);
+
+    auto erase_count = inst.erase_invoke_count();
+    inst.set_write_callback([](std::uint64_t count, std::uint32_t address) { return address != WEAR_LEVELING_LOGICAL_SIZE + 2; });
+    wear_leveling_status_t status;
+    do {
+        status = wear_leveling_task();
+    } while (status == WEAR_LEVELING_SUCCESS);
+    EXPECT_EQ(status, WEAR_LEVELING_FAILED) << "Checksum write failure should be reported";
+    EXPECT_TRUE(wear_leveling_busy()) << "Failed consolidation should be reported as busy";
+
+    inst.set_write_callback([](std::uint64_t count, std::uint32_t address) { return true; });
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_CONSOLIDATED) << "Flush returned incorrect status";
+    EXPECT_EQ(inst.erase_invoke_count(), erase_count + 2) << "Consolidation should have restarted with an erase";
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    expect_readback(expected);
+}
@@ -61,6 +61,20 @@
             to other subsystems performing reads/writes. This must be a multiple
             of the write size.
 
+        - WEAR_LEVELING_BATCH_WRITES: If defined, writes only update the cache
+            and are tracked in a dirty bitmap, requiring an extra bit of RAM per
+            byte of logical data. wear_leveling_commit() then writes each run of
+            dirty bytes to the write log, so repeated and adjacent writes share
+            log entries.
+
+        - WEAR_LEVELING_BACKGROUND_CONSOLIDATION: If defined, a full write log
+            is consolidated by wear_leveling_task() a step at a time, instead of
+            in-line with the write that filled it.
+
+        - WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE: The number of bytes of
+            consolidated data written by each background consolidation step.
+            This must be a multiple of the write size.
+
     General algorithm:
 
         During initialization:
@@ -76,6 +90,19 @@
             * A new write log entry is appended to the log.
             * If the log's full, data is consolidated and the write log cleared.
 
+        During background consolidation:
+            * Once the log's full, nothing more is logged -- later writes are
+                only made to the cache, which is about to be consolidated.
+            * The first step erases the backing store.
+            * Each following step writes the next chunk of the cache to the
+                consolidated data section, hashing exactly what was written.
+                Writes in the meantime are logged as usual, as they may be to
+                chunks which have already been written. Playing back the log
+                on top of the consolidated data always gives the latest data.
+            * The last step writes the hash. Until then, the backing store is
+                not valid -- wear_leveling_busy() reports this so that power
+                isn't removed before wear_leveling_flush().
+
     Write log structure:
 
         The first 8 bytes of the write log are a FNV1a_64 hash of the contents
@@ -155,6 +182,17 @@
         ╚════════════════╝
         0 <= Address <= 0x3FFE (16382) */
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+/**
+ * Background consolidation state.
+ */
+typedef enum wear_leveling_consolidation_t {
+    CONSOLIDATION_IDLE,    //< No consolidation required
+    CONSOLIDATION_PENDING, //< The write log is full, the backing store needs to be erased
+    CONSOLIDATION_WRITING, //< The backing store has been erased, the cache is being written in chunks
+} wear_leveling_consolidation_t;
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
 /**
  * Storage area for the wear-leveling cache.
  */
@@ -162,6 +200,15 @@ static struct __attribute__((__aligned__(BACKING_STORE_WRITE_SIZE))) {
     __attribute__((__aligned__(BACKING_STORE_WRITE_SIZE))) uint8_t cache[(WEAR_LEVELING_LOGICAL_SIZE)];
     uint32_t                                                       write_address;
     bool                                                           unlocked;
+#ifdef WEAR_LEVELING_BATCH_WRITES
+    uint8_t dirty[((WEAR_LEVELING_LOGICAL_SIZE) + 7) / 8]; // one bit per byte of the cache not yet written to the log
+    bool    any_dirty;
+#endif // WEAR_LEVELING_BATCH_WRITES
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    wear_leveling_consolidation_t consolidation;
+    uint32_t                      consolidated_bytes; // number of bytes of the cache written to the consolidated data so far
+    uint64_t                      consolidated_hash;  // FNV1a_64 of the consolidated data written so far
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
 } wear_leveling;
 
 /**
@@ -197,12 +244,45 @@ static inline backing_store_lock_status_t wear_leveling_lock(void) {
     return STATUS_SUCCESS;
 }
 
+#ifdef WEAR_LEVELING_BATCH_WRITES
+/**
+ * Batching helper: flags the bytes in the range as not yet written to the log
+ */
+static void wear_leveling_mark_dirty(uint32_t address, size_t length) {
+    for (uint32_t i = address; i < address + length; ++i) {
+        wear_leveling.dirty[i / 8] |= (1 << (i % 8));
+    }
+    wear_leveling.any_dirty = true;
+}
+
+/**
+ * Batching helper: whether the byte at the address has not yet been written to the log
+ */
+static inline bool wear_leveling_is_dirty(uint32_t address) {
+    return (wear_leveling.dirty[address / 8] & (1 << (address % 8))) != 0;
+}
+
+/**
+ * Batching helper: flags everything as written, such as after the whole cache has been consolidated
+ */
+static void wear_leveling_clear_dirty(void) {
+    memset(wear_leveling.dirty, 0, sizeof(wear_leveling.dirty));
+    wear_leveling.any_dirty = false;
+}
+#endif // WEAR_LEVELING_BATCH_WRITES
+
 /**
  * Resets the cache, ensuring the write address is correctly initialised.
  */
 static void wear_leveling_clear_cache(void) {
     memset(wear_leveling.cache, 0, (WEAR_LEVELING_LOGICAL_SIZE));
     wear_leveling.write_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 is due to the FNV1a_64 of the consolidated buffer
+#ifdef WEAR_LEVELING_BATCH_WRITES
+    wear_leveling_clear_dirty();
+#endif // WEAR_LEVELING_BATCH_WRITES
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    wear_leveling.consolidation = CONSOLIDATION_IDLE;
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
 }
 
 /**
@@ -248,6 +328,22 @@ static wear_leveling_status_t wear_leveling_read_consolidated(void) {
     return status;
 }
 
+/**
+ * Writes the FNV1a_64 of the consolidated data after the consolidated data area.
+ */
+static bool wear_leveling_write_checksum(uint64_t checksum) {
+    write_log_entry_t entry;
+    entry.raw64 = checksum;
+    wl_dprintf("Writing checksum\n");
+#if BACKING_STORE_WRITE_SIZE == 2
+    return backing_store_write_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw16, 4);
+#elif BACKING_STORE_WRITE_SIZE == 4
+    return backing_store_write_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw32, 2);
+#elif BACKING_STORE_WRITE_SIZE == 8
+    return backing_store_write((WEAR_LEVELING_LOGICAL_SIZE), entry.raw64);
+#endif
+}
+
 /**
  * Writes the current cache to consolidated data at the beginning of the backing store.
  * Does not clear the write log.
@@ -265,27 +361,9 @@ static wear_leveling_status_t wear_leveling_write_consolidated(void) {
 
     if (status != WEAR_LEVELING_FAILED) {
         // Write out the FNV1a_64 result of the consolidated data
-        write_log_entry_t entry;
-        entry.raw64 = fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT);
-        wl_dprintf("Writing checksum\n");
-        do {
-#if BACKING_STORE_WRITE_SIZE == 2
-            if (!backing_store_write_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw16, 4)) {
-                status = WEAR_LEVELING_FAILED;
-                break;
-            }
-#elif BACKING_STORE_WRITE_SIZE == 4
-            if (!backing_store_write_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw32, 2)) {
-                status = WEAR_LEVELING_FAILED;
-                break;
-            }
-#elif BACKING_STORE_WRITE_SIZE == 8
-            if (!backing_store_write((WEAR_LEVELING_LOGICAL_SIZE), entry.raw64)) {
-                status = WEAR_LEVELING_FAILED;
-                break;
-            }
-#endif
-        } while (0);
+        if (!wear_leveling_write_checksum(fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT))) {
+            status = WEAR_LEVELING_FAILED;
+        }
     }
 
     if (lock_status == STATUS_SUCCESS) {
@@ -318,9 +396,84 @@ static wear_leveling_status_t wear_leveling_consolidate_force(void) {
     // Next write of the log occurs after the consolidated values at the start of the backing store.
     wear_leveling.write_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    // Any background consolidation has been superseded
+    wear_leveling.consolidation = CONSOLIDATION_IDLE;
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+#ifdef WEAR_LEVELING_BATCH_WRITES
+    // The entire cache is now in the consolidated area, so nothing needs to be logged
+    if (status != WEAR_LEVELING_FAILED) {
+        wear_leveling_clear_dirty();
+    }
+#endif // WEAR_LEVELING_BATCH_WRITES
+
     return status;
 }
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+/**
+ * Performs the next step of background consolidation, if any. Steps which fail are retried on the next invocation.
+ *
+ * @return WEAR_LEVELING_CONSOLIDATED once the consolidation has completed
+ */
+static wear_leveling_status_t wear_leveling_consolidate_step(void) {
+    switch (wear_leveling.consolidation) {
+        case CONSOLIDATION_PENDING:
+            wl_dprintf("Erasing backing store\n");
+            if (!backing_store_erase()) {
+                wl_dprintf("Failed to erase backing store\n");
+                return WEAR_LEVELING_FAILED;
+            }
+
+            // Everything currently in the cache ends up in the consolidated area, only later writes need logging.
+#    ifdef WEAR_LEVELING_BATCH_WRITES
+            wear_leveling_clear_dirty();
+#    endif // WEAR_LEVELING_BATCH_WRITES
+            wear_leveling.write_address      = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
+            wear_leveling.consolidated_bytes = 0;
+            wear_leveling.consolidated_hash  = FNV1A_64_INIT;
+            wear_leveling.consolidation      = CONSOLIDATION_WRITING;
+            return WEAR_LEVELING_SUCCESS;
+
+        case CONSOLIDATION_WRITING: {
+            uint32_t end = wear_leveling.consolidated_bytes + (WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE);
+            if (end > (WEAR_LEVELING_LOGICAL_SIZE)) {
+                end = (WEAR_LEVELING_LOGICAL_SIZE);
+            }
+
+            wl_dprintf("Writing consolidated data 0x%04X-0x%04X\n", (int)wear_leveling.consolidated_bytes, (int)end);
+            while (wear_leveling.consolidated_bytes < end) {
+                // The cache may change between steps, so the checksum is of exactly what was written
+                backing_store_int_t value = *(backing_store_int_t *)&wear_leveling.cache[wear_leveling.consolidated_bytes];
+                if (!backing_store_write(wear_leveling.consolidated_bytes, value)) {
+                    wl_dprintf("Failed to write to backing store\n");
+                    return WEAR_LEVELING_FAILED;
+                }
+                wear_leveling.consolidated_hash = fnv_64a_buf(&value, sizeof(value), wear_leveling.consolidated_hash);
+                wear_leveling.consolidated_bytes += (BACKING_STORE_WRITE_SIZE);
+            }
+
+            if (wear_leveling.consolidated_bytes < (WEAR_LEVELING_LOGICAL_SIZE)) {
+                return WEAR_LEVELING_SUCCESS;
+            }
+
+            if (!wear_leveling_write_checksum(wear_leveling.consolidated_hash)) {
+                // The checksum may have been partially written, so start again from the erase
+                wl_dprintf("Failed to write checksum, restarting consolidation\n");
+                wear_leveling.consolidation = CONSOLIDATION_PENDING;
+                return WEAR_LEVELING_FAILED;
+            }
+
+            wear_leveling.consolidation = CONSOLIDATION_IDLE;
+            return WEAR_LEVELING_CONSOLIDATED;
+        }
+
+        default:
+            return WEAR_LEVELING_SUCCESS;
+    }
+}
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
 /**
  * Potential write of the current cache to the backing store.
  * Skipped if the current write log position is not at the end of the backing store.
@@ -330,7 +483,15 @@ static wear_leveling_status_t wear_leveling_consolidate_force(void) {
  */
 static wear_leveling_status_t wear_leveling_consolidate_if_needed(void) {
     if (wear_leveling.write_address >= (WEAR_LEVELING_BACKING_SIZE)) {
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+        // Leave it to wear_leveling_task() -- if a consolidation was already being written, the log filled up again
+        // before it finished, so it needs to start over.
+        wl_dprintf("Write log full, consolidation pending\n");
+        wear_leveling.consolidation = CONSOLIDATION_PENDING;
+        return WEAR_LEVELING_SUCCESS;
+#else
         return wear_leveling_consolidate_force();
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
     }
 
     return WEAR_LEVELING_SUCCESS;
@@ -342,6 +503,12 @@ static wear_leveling_status_t wear_leveling_consolidate_if_needed(void) {
  * @return true if consolidation occurred
  */
 static wear_leveling_status_t wear_leveling_append_raw(backing_store_int_t value) {
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    // The pending consolidation writes out the entire cache, so there's nothing to log until the log is erased
+    if (wear_leveling.consolidation == CONSOLIDATION_PENDING) {
+        return WEAR_LEVELING_SUCCESS;
+    }
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
     bool ok = backing_store_write(wear_leveling.write_address, value);
     if (!ok) {
         wl_dprintf("Failed to write to backing store\n");
@@ -363,6 +530,21 @@ static wear_leveling_status_t wear_leveling_write_raw_multibyte(uint32_t address
         log.raw8[3 + i] = p[i];
     }
 
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    // Entries must not be split by the end of the log, as nothing more is logged until the consolidation erases it
+#    if BACKING_STORE_WRITE_SIZE == 2
+    const uint32_t entry_size = (2 + (length > 1 ? 1 : 0) + (length > 3 ? 1 : 0)) * (BACKING_STORE_WRITE_SIZE);
+#    elif BACKING_STORE_WRITE_SIZE == 4
+    const uint32_t entry_size = (1 + (length > 1 ? 1 : 0)) * (BACKING_STORE_WRITE_SIZE);
+#    elif BACKING_STORE_WRITE_SIZE == 8
+    const uint32_t entry_size = (BACKING_STORE_WRITE_SIZE);
+#    endif
+    if (wear_leveling.consolidation != CONSOLIDATION_PENDING && wear_leveling.write_address + entry_size > (WEAR_LEVELING_BACKING_SIZE)) {
+        wl_dprintf("Write log entry does not fit, consolidation pending\n");
+        wear_leveling.consolidation = CONSOLIDATION_PENDING;
+    }
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+
     // Write to the backing store. See the multi-byte log format in the documentation header at the top of the file.
     wear_leveling_status_t status;
 #if BACKING_STORE_WRITE_SIZE == 2
@@ -691,6 +873,12 @@ wear_leveling_status_t wear_leveling_write(const uint32_t address, const void *v
     // Update the cache before writing to the backing store -- if we hit the end of the backing store during writes to the log then we'll force a consolidation in-line
     memcpy(&wear_leveling.cache[address], value, length);
 
+#ifdef WEAR_LEVELING_BATCH_WRITES
+    // Leave it to wear_leveling_commit() to write the log, combined with any other writes in the meantime
+    wear_leveling_mark_dirty(address, length);
+    return WEAR_LEVELING_SUCCESS;
+#endif // WEAR_LEVELING_BATCH_WRITES
+
     // Unlock the backing store
     backing_store_lock_status_t lock_status = wear_leveling_unlock();
     if (lock_status == STATUS_FAILURE) {
@@ -726,6 +914,132 @@ wear_leveling_status_t wear_leveling_write(const uint32_t address, const void *v
     return status;
 }
 
+/**
+ * Writes batched logical data into the write log.
+ */
+wear_leveling_status_t wear_leveling_commit(void) {
+#ifdef WEAR_LEVELING_BATCH_WRITES
+    if (!wear_leveling.any_dirty) {
+        return WEAR_LEVELING_SUCCESS;
+    }
+
+    // Unlock the backing store
+    backing_store_lock_status_t lock_status = wear_leveling_unlock();
+    if (lock_status == STATUS_FAILURE) {
+        wear_leveling_lock();
+        return WEAR_LEVELING_FAILED;
+    }
+
+    // Log each run of dirty bytes, stopping early if a consolidation wrote out the entire cache
+    wear_leveling_status_t status  = WEAR_LEVELING_SUCCESS;
+    uint32_t               address = 0;
+    while (status == WEAR_LEVELING_SUCCESS && address < (WEAR_LEVELING_LOGICAL_SIZE)) {
+        if (wear_leveling.dirty[address / 8] == 0) {
+            address = (address / 8 + 1) * 8;
+            continue;
+        }
+        if (!wear_leveling_is_dirty(address)) {
+            ++address;
+            continue;
+        }
+
+        uint32_t end = address + 1;
+        while (end < (WEAR_LEVELING_LOGICAL_SIZE) && wear_leveling_is_dirty(end)) {
+            ++end;
+        }
+
+        wl_dprintf("Commit ");
+        wl_dump(address, &wear_leveling.cache[address], end - address);
+        status = wear_leveling_write_raw(address, &wear_leveling.cache[address], end - address);
+        if (status == WEAR_LEVELING_SUCCESS) {
+            // Consolidate the cache + write log if required
+            status = wear_leveling_consolidate_if_needed();
+        }
+        if (status == WEAR_LEVELING_SUCCESS) {
+            for (uint32_t i = address; i < end; ++i) {
+                wear_leveling.dirty[i / 8] &= ~(1 << (i % 8));
+            }
+        }
+        address = end;
+    }
+
+    // Anything left dirty after a failure is retried on the next commit
+    if (status != WEAR_LEVELING_FAILED) {
+        wear_leveling_clear_dirty();
+    }
+
+    if (lock_status == STATUS_SUCCESS) {
+        if (wear_leveling_lock() == STATUS_FAILURE) {
+            status = WEAR_LEVELING_FAILED;
+        }
+    }
+
+    return status;
+#else
+    return WEAR_LEVELING_SUCCESS;
+#endif // WEAR_LEVELING_BATCH_WRITES
+}
+
+/**
+ * Performs the next step of a background consolidation.
+ */
+wear_leveling_status_t wear_leveling_task(void) {
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    if (wear_leveling.consolidation == CONSOLIDATION_IDLE) {
+        return WEAR_LEVELING_SUCCESS;
+    }
+
+    // Unlock the backing store
+    backing_store_lock_status_t lock_status = wear_leveling_unlock();
+    if (lock_status == STATUS_FAILURE) {
+        wear_leveling_lock();
+        return WEAR_LEVELING_FAILED;
+    }
+
+    wear_leveling_status_t status = wear_leveling_consolidate_step();
+
+    if (lock_status == STATUS_SUCCESS) {
+        if (wear_leveling_lock() == STATUS_FAILURE) {
+            status = WEAR_LEVELING_FAILED;
+        }
+    }
+
+    return status;
+#else
+    return WEAR_LEVELING_SUCCESS;
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+}
+
+/**
+ * Commits batched writes and completes any background consolidation.
+ */
+wear_leveling_status_t wear_leveling_flush(void) {
+    wear_leveling_status_t status = wear_leveling_commit();
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    while (status != WEAR_LEVELING_FAILED && wear_leveling.consolidation != CONSOLIDATION_IDLE) {
+        status = wear_leveling_task();
+    }
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    return status;
+}
+
+/**
+ * Whether there is data only held in RAM.
+ */
+bool wear_leveling_busy(void) {
+#ifdef WEAR_LEVELING_BATCH_WRITES
+    if (wear_leveling.any_dirty) {
+        return true;
+    }
+#endif // WEAR_LEVELING_BATCH_WRITES
+#ifdef WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    if (wear_leveling.consolidation != CONSOLIDATION_IDLE) {
+        return true;
+    }
+#endif // WEAR_LEVELING_BACKGROUND_CONSOLIDATION
+    return false;
+}
+
 /**
  * Reads logical data from the cache.
  */
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdlib.h>
 
 /**
@@ -52,3 +53,39 @@ wear_leveling_status_t wear_leveling_write(uint32_t address, const void* value,
  * @return Status of the request
  */
 wear_leveling_status_t wear_leveling_read(uint32_t address, void* value, size_t length);
+
+/**
+ * Writes any batched logical writes to the write log.
+ *
+ * Only relevant if WEAR_LEVELING_BATCH_WRITES is defined, in which case wear_leveling_write() only updates the cache --
+ * data written since the last commit is combined into as few log entries as possible.
+ *
+ * @return Status of the request
+ */
+wear_leveling_status_t wear_leveling_commit(void);
+
+/**
+ * Performs the next step of a background consolidation.
+ *
+ * Only relevant if WEAR_LEVELING_BACKGROUND_CONSOLIDATION is defined, in which case a full write log no longer
+ * consolidates in-line. Instead, each invocation either erases the backing store or writes the next
+ * WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE bytes of consolidated data. Steps that fail are retried on the next invocation.
+ *
+ * @return Status of the request, WEAR_LEVELING_CONSOLIDATED once the consolidation has completed
+ */
+wear_leveling_status_t wear_leveling_task(void);
+
+/**
+ * Commits batched writes and completes any background consolidation before returning.
+ *
+ * @return Status of the request
+ */
+wear_leveling_status_t wear_leveling_flush(void);
+
+/**
+ * Whether there is data only held in RAM, either batched writes or a consolidation in progress. Power should not be
+ * removed until wear_leveling_flush() has been invoked.
+ *
+ * @return true if the backing store is not yet up to date
+ */
+bool wear_leveling_busy(void);
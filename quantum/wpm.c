@@ -21,6 +21,7 @@
 #include "quantum_keycodes.h"
 #include "action_util.h"
 #include <math.h>
+#include <string.h>
 
 // WPM Stuff
 static uint8_t  current_wpm = 0;
@@ -28,19 +29,34 @@ static uint32_t wpm_timer   = 0;
 
 /* The WPM calculation works by specifying a certain number of 'periods' inside
  * a ring buffer, and we count the number of keypresses which occur in each of
- * those periods.  Then to calculate WPM, we add up all of the keypresses in
+ * those periods.  Then to calculate WPM, we take the number of keypresses in
  * the whole ring buffer, divide by the number of keypresses in a 'word', and
  * then adjust for how much time is captured by our ring buffer.  The size
  * of the ring buffer can be configured using the keymap configuration
  * value `WPM_SAMPLE_PERIODS`.
  *
+ * The keypresses in the ring buffer are kept as a running sum, which is
+ * updated as keys are pressed and as periods drop out of the buffer, and the
+ * WPM is only recalculated when one of those happens.
  */
 #define MAX_PERIODS (WPM_SAMPLE_PERIODS)
 #define PERIOD_DURATION (1000 * WPM_SAMPLE_SECONDS / MAX_PERIODS)
 
 static int16_t period_presses[MAX_PERIODS] = {0};
+static int32_t presses                     = 0;
 static uint8_t current_period              = 0;
 static uint8_t periods                     = 1;
+static bool    presses_changed             = false;
+static int32_t wpm_now                     = 0;
+
+#if defined(WPM_BURST_SAMPLES)
+/* Burst WPM is measured over the last `WPM_BURST_SAMPLES` keypresses, from
+ * the time between the first and last of them.
+ */
+static uint32_t burst_timestamps[WPM_BURST_SAMPLES] = {0};
+static uint8_t  burst_next                          = 0;
+static uint8_t  burst_count                         = 0;
+#endif
 
 #if !defined(WPM_UNFILTERED)
 /* LATENCY is used as part of filtering, and controls how quickly the reported
@@ -50,16 +66,37 @@ static uint8_t periods                     = 1;
  * smoothly-moving reported WPM value which nevertheless is never more than
  * 0.1 seconds behind the typist's actual current WPM.
  *
+ * With WPM_SMOOTHING_EXPONENTIAL, the reported WPM instead moves a fraction
+ * (1 / 2^WPM_SMOOTHING_SHIFT) of the way towards the measured WPM every
+ * LATENCY milliseconds.
+ *
  * LATENCY is not used if WPM_UNFILTERED is defined.
  */
 #    define LATENCY (100)
 static uint32_t smoothing_timer = 0;
-static uint8_t  prev_wpm        = 0;
-static uint8_t  next_wpm        = 0;
+#    if defined(WPM_SMOOTHING_EXPONENTIAL)
+static uint16_t smoothed_wpm = 0; // 8.8 fixed point
+#    else
+static uint8_t prev_wpm = 0;
+static uint8_t next_wpm = 0;
+#    endif
 #endif
 
+__attribute__((weak)) void wpm_changed_kb(uint8_t wpm) {
+    wpm_changed_user(wpm);
+}
+
+__attribute__((weak)) void wpm_changed_user(uint8_t wpm) {}
+
+static void wpm_set(uint8_t new_wpm) {
+    if (new_wpm != current_wpm) {
+        current_wpm = new_wpm;
+        wpm_changed_kb(new_wpm);
+    }
+}
+
 void set_current_wpm(uint8_t new_wpm) {
-    current_wpm = new_wpm;
+    wpm_set(new_wpm);
 }
 uint8_t get_current_wpm(void) {
     return current_wpm;
@@ -107,45 +144,75 @@ __attribute__((weak)) uint8_t wpm_regress_count(uint16_t keycode) {
 }
 #endif
 
+#if defined(WPM_BURST_SAMPLES)
+uint8_t get_burst_wpm(void) {
+    if (burst_count < 2) {
+        return 0;
+    }
+    uint8_t  first    = (burst_next + WPM_BURST_SAMPLES - burst_count) % WPM_BURST_SAMPLES;
+    uint8_t  last     = (burst_next + WPM_BURST_SAMPLES - 1) % WPM_BURST_SAMPLES;
+    uint32_t duration = burst_timestamps[last] - burst_timestamps[first];
+    if (duration == 0 || timer_elapsed32(burst_timestamps[last]) > WPM_SAMPLE_SECONDS * 1000) {
+        return 0;
+    }
+    uint32_t wpm = (60000 * (uint32_t)(burst_count - 1)) / (duration * WPM_ESTIMATED_WORD_SIZE);
+    return wpm > 255 ? 255 : wpm;
+}
+#endif
+
 // Outside 'raw' mode we smooth results over time.
 
 void update_wpm(uint16_t keycode) {
     if (wpm_keycode(keycode) && period_presses[current_period] < INT16_MAX) {
         period_presses[current_period]++;
+        presses++;
+        presses_changed = true;
+#if defined(WPM_BURST_SAMPLES)
+        burst_timestamps[burst_next] = timer_read32();
+        burst_next                   = (burst_next + 1) % WPM_BURST_SAMPLES;
+        if (burst_count < WPM_BURST_SAMPLES) {
+            burst_count++;
+        }
+#endif
     }
 #if defined(WPM_ALLOW_COUNT_REGRESSION)
     uint8_t regress = wpm_regress_count(keycode);
     if (regress && period_presses[current_period] > INT16_MIN) {
         period_presses[current_period]--;
+        presses--;
+        presses_changed = true;
     }
 #endif
 }
 
-void decay_wpm(void) {
-    int32_t presses = period_presses[0];
-    for (int i = 1; i <= periods; i++) {
-        presses += period_presses[i];
-    }
-    if (presses < 0) {
-        presses = 0;
-    }
-    int32_t  elapsed  = timer_elapsed32(wpm_timer);
+static void calculate_wpm(int32_t elapsed) {
+    int32_t  counted  = presses < 0 ? 0 : presses;
     uint32_t duration = (((periods)*PERIOD_DURATION) + elapsed);
-    int32_t  wpm_now  = (60000 * presses) / (duration * WPM_ESTIMATED_WORD_SIZE);
+    wpm_now           = (60000 * counted) / (duration * WPM_ESTIMATED_WORD_SIZE);
 
     if (wpm_now < 0) // set some reasonable WPM measurement limits
         wpm_now = 0;
     if (wpm_now > 240) wpm_now = 240;
+    if (counted < 2) // don't guess high WPM based on a single keypress.
+        wpm_now = 0;
+}
 
+void decay_wpm(void) {
+    int32_t elapsed = timer_elapsed32(wpm_timer);
     if (elapsed > PERIOD_DURATION) {
-        current_period                 = (current_period + 1) % MAX_PERIODS;
+        // The measured rate only changes as periods are dropped, or as keys are pressed
+        calculate_wpm(elapsed);
+        presses_changed = false;
+
+        current_period = (current_period + 1) % MAX_PERIODS;
+        presses -= period_presses[current_period];
         period_presses[current_period] = 0;
         periods                        = (periods < MAX_PERIODS - 1) ? periods + 1 : MAX_PERIODS - 1;
-        elapsed                        = 0;
         wpm_timer                      = timer_read32();
+    } else if (presses_changed) {
+        calculate_wpm(elapsed);
+        presses_changed = false;
     }
-    if (presses < 2) // don't guess high WPM based on a single keypress.
-        wpm_now = 0;
 
 #if defined(WPM_LAUNCH_CONTROL)
     /*
@@ -155,24 +222,37 @@ void decay_wpm(void) {
      * immediately reach the correct value even before a full sampling buffer
      * has been filled.
      */
-    if (presses == 0) {
-        current_period    = 0;
-        periods           = 0;
-        wpm_now           = 0;
-        period_presses[0] = 0;
+    if (presses == 0 && periods != 0) {
+        current_period = 0;
+        periods        = 0;
+        wpm_now        = 0;
+        memset(period_presses, 0, sizeof(period_presses));
     }
 #endif // WPM_LAUNCH_CONTROL
 
 #if defined(WPM_UNFILTERED)
-    current_wpm = wpm_now;
+    wpm_set(wpm_now);
+#elif defined(WPM_SMOOTHING_EXPONENTIAL)
+    if (timer_elapsed32(smoothing_timer) > LATENCY) {
+        smoothing_timer = timer_read32();
+        smoothed_wpm += ((int32_t)(wpm_now << 8) - smoothed_wpm) >> WPM_SMOOTHING_SHIFT;
+        wpm_set((smoothed_wpm + 0x80) >> 8);
+    }
 #else
+    if (prev_wpm == next_wpm && next_wpm == wpm_now && current_wpm == wpm_now) {
+        // Nothing to interpolate, the next change starts a fresh interval
+        smoothing_timer = timer_read32();
+        return;
+    }
+
     int32_t latency = timer_elapsed32(smoothing_timer);
     if (latency > LATENCY) {
         smoothing_timer = timer_read32();
         prev_wpm        = current_wpm;
         next_wpm        = wpm_now;
+        latency         = 0;
     }
 
-    current_wpm = prev_wpm + (latency * ((int)next_wpm - (int)prev_wpm) / LATENCY);
+    wpm_set(prev_wpm + (latency * ((int)next_wpm - (int)prev_wpm) / LATENCY));
 #endif
 }
@@ -29,6 +29,9 @@
 #ifndef WPM_SAMPLE_PERIODS
 #    define WPM_SAMPLE_PERIODS 25
 #endif
+#ifndef WPM_SMOOTHING_SHIFT
+#    define WPM_SMOOTHING_SHIFT 2
+#endif
 
 bool wpm_keycode(uint16_t keycode);
 bool wpm_keycode_kb(uint16_t keycode);
@@ -42,4 +45,11 @@ void    set_current_wpm(uint8_t);
 uint8_t get_current_wpm(void);
 void    update_wpm(uint16_t);
 
+#ifdef WPM_BURST_SAMPLES
+uint8_t get_burst_wpm(void);
+#endif
+
+void wpm_changed_kb(uint8_t wpm);
+void wpm_changed_user(uint8_t wpm);
+
 void decay_wpm(void);
@@ -0,0 +1,9 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define EECONFIG_DEFERRED_FLUSH_MS 100
+#define EECONFIG_DEFERRED_MAX_PENDING 2
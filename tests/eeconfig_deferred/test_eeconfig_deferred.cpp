@@ -0,0 +1,128 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+
+static int      flushes_a;
+static int      flushes_b;
+static int      flushes_c;
+static uint32_t user_config;
+
+static void flush_a(void) {
+    flushes_a++;
+    eeconfig_update_user(user_config);
+}
+
+static void flush_b(void) {
+    flushes_b++;
+}
+
+static void flush_c(void) {
+    flushes_c++;
+}
+
+class EeconfigDeferred : public TestFixture {
+   public:
+    void SetUp() override {
+        eeconfig_deferred_flush();
+        flushes_a   = 0;
+        flushes_b   = 0;
+        flushes_c   = 0;
+        user_config = 0;
+        eeconfig_update_user(0);
+    }
+};
+
+TEST_F(EeconfigDeferred, RepeatedChangesWrittenOnce) {
+    TestDriver driver;
+
+    uint32_t avoided = eeconfig_deferred_writes_avoided();
+
+    // Changes faster than the quiet period keep deferring the write
+    for (user_config = 1; user_config <= 10; user_config++) {
+        eeconfig_defer_flush(flush_a);
+        idle_for(EECONFIG_DEFERRED_FLUSH_MS / 2);
+    }
+    user_config--;
+    EXPECT_EQ(flushes_a, 0);
+    EXPECT_EQ(eeconfig_read_user(), 0);
+
+    idle_for(EECONFIG_DEFERRED_FLUSH_MS);
+    EXPECT_EQ(flushes_a, 1);
+    EXPECT_EQ(eeconfig_read_user(), 10);
+    EXPECT_EQ(eeconfig_deferred_writes_avoided() - avoided, 9);
+
+    // Nothing pending, so nothing more is written
+    idle_for(EECONFIG_DEFERRED_FLUSH_MS * 2);
+    EXPECT_EQ(flushes_a, 1);
+}
+
+TEST_F(EeconfigDeferred, PendingWritesFlushedTogether) {
+    TestDriver driver;
+
+    eeconfig_defer_flush(flush_a);
+    idle_for(EECONFIG_DEFERRED_FLUSH_MS / 2);
+    eeconfig_defer_flush(flush_b);
+    idle_for(EECONFIG_DEFERRED_FLUSH_MS / 2 + 1);
+    EXPECT_EQ(flushes_a, 0);
+    EXPECT_EQ(flushes_b, 0);
+
+    idle_for(EECONFIG_DEFERRED_FLUSH_MS / 2);
+    EXPECT_EQ(flushes_a, 1);
+    EXPECT_EQ(flushes_b, 1);
+}
+
+TEST_F(EeconfigDeferred, FlushWritesImmediately) {
+    TestDriver driver;
+
+    user_config = 42;
+    eeconfig_defer_flush(flush_a);
+    eeconfig_defer_flush(flush_b);
+
+    eeconfig_deferred_flush();
+    EXPECT_EQ(flushes_a, 1);
+    EXPECT_EQ(flushes_b, 1);
+    EXPECT_EQ(eeconfig_read_user(), 42);
+
+    idle_for(EECONFIG_DEFERRED_FLUSH_MS * 2);
+    EXPECT_EQ(flushes_a, 1);
+    EXPECT_EQ(flushes_b, 1);
+}
+
+TEST_F(EeconfigDeferred, SuspendFlushes) {
+    TestDriver driver;
+
+    eeconfig_defer_flush(flush_a);
+
+    suspend_power_down_quantum();
+    EXPECT_EQ(flushes_a, 1);
+}
+
+TEST_F(EeconfigDeferred, FullPendingListWritesImmediately) {
+    TestDriver driver;
+
+    eeconfig_defer_flush(flush_a);
+    eeconfig_defer_flush(flush_b);
+    eeconfig_defer_flush(flush_c);
+    EXPECT_EQ(flushes_a, 0);
+    EXPECT_EQ(flushes_b, 0);
+    EXPECT_EQ(flushes_c, 1);
+
+    idle_for(EECONFIG_DEFERRED_FLUSH_MS + 1);
+    EXPECT_EQ(flushes_a, 1);
+    EXPECT_EQ(flushes_b, 1);
+    EXPECT_EQ(flushes_c, 1);
+}
+
+TEST_F(EeconfigDeferred, EeconfigInitDropsPending) {
+    TestDriver driver;
+
+    user_config = 42;
+    eeconfig_defer_flush(flush_a);
+
+    eeconfig_init();
+    idle_for(EECONFIG_DEFERRED_FLUSH_MS * 2);
+    EXPECT_EQ(flushes_a, 0);
+    EXPECT_EQ(eeconfig_read_user(), 0);
+}
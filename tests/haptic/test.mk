@@ -0,0 +1,9 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# --------------------------------------------------------------------------------
+# Keep this file, even if it is empty, as a marker that this folder contains tests
+# --------------------------------------------------------------------------------
+
+HAPTIC_ENABLE = yes
+HAPTIC_DRIVER = DRV2605L
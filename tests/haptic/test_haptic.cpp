@@ -0,0 +1,117 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+extern "C" {
+#include "haptic.h"
+#include "DRV2605L.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+extern "C" void advance_time(uint32_t ms);
+
+// HAPTIC_QUEUE_INTERVAL
+static const uint32_t queue_interval = 20;
+
+// The register written to, followed by the data
+typedef std::vector<uint8_t> transfer_t;
+
+static std::vector<transfer_t> transfers;
+
+extern "C" {
+void i2c_init(void) {}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    transfers.push_back(transfer_t(data, data + length));
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    transfer_t transfer = {regaddr};
+    transfer.insert(transfer.end(), data, data + length);
+    transfers.push_back(transfer);
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t *data, uint16_t length, uint16_t timeout) {
+    return I2C_STATUS_SUCCESS;
+}
+}
+
+class Haptic : public TestFixture {
+   public:
+    void SetUp() override {
+        // Let whatever played last finish
+        advance_time(queue_interval);
+        transfers.clear();
+    }
+
+    // Stopping what is playing, and starting the sequence in a single transfer
+    std::vector<transfer_t> played(std::vector<uint8_t> sequence) {
+        transfer_t start = {DRV_WAVEFORM_SEQ_1};
+        start.insert(start.end(), sequence.begin(), sequence.end());
+        start.resize(1 + DRV_SEQUENCE_LENGTH);
+        start.push_back(0x01);
+        return {{DRV_GO, 0x00}, start};
+    }
+};
+
+TEST_F(Haptic, KeyPressesInTheSameScanArePlayedOnce) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    auto key_a = KeymapKey(0, 0, 0, KC_A);
+    auto key_b = KeymapKey(0, 1, 0, KC_B);
+    set_keymap({key_a, key_b});
+
+    key_a.press();
+    key_b.press();
+    run_one_scan_loop();
+    EXPECT_EQ(transfers, played({haptic_get_mode()}));
+
+    key_a.release();
+    key_b.release();
+    run_one_scan_loop();
+}
+
+TEST_F(Haptic, RapidFireWaitsForTheInterval) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    auto key_a = KeymapKey(0, 0, 0, KC_A);
+    auto key_b = KeymapKey(0, 1, 0, KC_B);
+    set_keymap({key_a, key_b});
+
+    key_a.press();
+    run_one_scan_loop();
+    EXPECT_EQ(transfers.size(), 2);
+
+    transfers.clear();
+    key_a.release();
+    run_one_scan_loop();
+    key_b.press();
+    run_one_scan_loop();
+    EXPECT_TRUE(transfers.empty());
+
+    idle_for(queue_interval);
+    EXPECT_EQ(transfers, played({haptic_get_mode()}));
+
+    key_b.release();
+    run_one_scan_loop();
+}
+
+TEST_F(Haptic, SequencesAreWrittenAtOnce) {
+    TestDriver driver;
+    const uint8_t pattern[] = {strong_click, DRV_WAIT_MS(100), soft_bump};
+
+    haptic_play_sequence(pattern, sizeof(pattern));
+    EXPECT_TRUE(transfers.empty());
+
+    run_one_scan_loop();
+    EXPECT_EQ(transfers, played({strong_click, 0x8A, soft_bump}));
+}
@@ -0,0 +1,41 @@
+// Copyright 2026 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*******************************************************************************
+  88888888888 888      d8b                .d888 d8b 888               d8b
+      888     888      Y8P               d88P"  Y8P 888               Y8P
+      888     888                        888        888
+      888     88888b.  888 .d8888b       888888 888 888  .d88b.       888 .d8888b
+      888     888 "88b 888 88K           888    888 888 d8P  Y8b      888 88K
+      888     888  888 888 "Y8888b.      888    888 888 88888888      888 "Y8888b.
+      888     888  888 888      X88      888    888 888 Y8b.          888      X88
+      888     888  888 888  88888P'      888    888 888  "Y8888       888  88888P'
+                                                        888                 888
+                                                        888                 888
+                                                        888                 888
+     .d88b.   .d88b.  88888b.   .d88b.  888d888 8888b.  888888 .d88b.   .d88888
+    d88P"88b d8P  Y8b 888 "88b d8P  Y8b 888P"      "88b 888   d8P  Y8b d88" 888
+    888  888 88888888 888  888 88888888 888    .d888888 888   88888888 888  888
+    Y88b 888 Y8b.     888  888 Y8b.     888    888  888 Y88b. Y8b.     Y88b 888
+     "Y88888  "Y8888  888  888  "Y8888  888    "Y888888  "Y888 "Y8888   "Y88888
+         888
+    Y8b d88P
+     "Y88P"
+*******************************************************************************/
+
+#pragma once
+
+_Static_assert(MATRIX_ROWS == 4 && MATRIX_COLS == 10, "compressed_keymap.h was generated for a different matrix");
+
+static const uint32_t PROGMEM compressed_keymap_present[COMPRESSED_KEYMAP_WORDS] = {0xBFFFFFFF, 0x0000007F};
+
+static const uint16_t PROGMEM compressed_keymap_keycodes_0[] = {KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L, KC_M, KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W, KC_X, KC_Y, KC_Z, KC_0, KC_1, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_SPC, MO(1)};
+static const uint16_t PROGMEM compressed_keymap_keycodes_1[] = {KC_ESC, KC_LEFT, KC_DOWN, KC_UP, KC_RGHT, TG(2)};
+static const uint16_t PROGMEM compressed_keymap_keycodes_2[] = {KC_1, KC_2, KC_ENT, _______, _______};
+
+static const compressed_keymap_layer_t PROGMEM compressed_keymap[] = {
+    [_BASE] = {.bitmap = {0xBFFFFFFF, 0x0000007F}, .rank = {0, 31}, .filler = KC_TRNS, .keycodes = compressed_keymap_keycodes_0},
+    [_NAV] = {.bitmap = {0x00007801, 0x00000010}, .rank = {0, 5}, .filler = KC_TRNS, .keycodes = compressed_keymap_keycodes_1},
+    [_NUM] = {.bitmap = {0x00000060, 0x00000064}, .rank = {0, 2}, .filler = KC_NO, .keycodes = compressed_keymap_keycodes_2},
+    [_EMPTY] = {.bitmap = {0x00000000, 0x00000000}, .rank = {0, 0}, .filler = KC_TRNS, .keycodes = NULL},
+};
@@ -0,0 +1,49 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+// Leaves out the corners of the bottom row, they have no key
+// clang-format off
+#define LAYOUT( \
+    k00, k01, k02, k03, k04, k05, k06, k07, k08, k09, \
+    k10, k11, k12, k13, k14, k15, k16, k17, k18, k19, \
+    k20, k21, k22, k23, k24, k25, k26, k27, k28, k29, \
+         k31, k32, k33, k34, k35, k36, k37, k38       \
+) { \
+    {k00,   k01, k02, k03, k04, k05, k06, k07, k08, k09  }, \
+    {k10,   k11, k12, k13, k14, k15, k16, k17, k18, k19  }, \
+    {k20,   k21, k22, k23, k24, k25, k26, k27, k28, k29  }, \
+    {KC_NO, k31, k32, k33, k34, k35, k36, k37, k38, KC_NO}  \
+}
+
+enum layers { _BASE, _NAV, _NUM, _EMPTY };
+
+// The layers of compressed_keymap.h, regenerate it after changing them
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [_BASE] = LAYOUT(
+        KC_A  , KC_B  , KC_C  , KC_D  , KC_E  , KC_F  , KC_G  , KC_H  , KC_I  , KC_J  ,
+        KC_K  , KC_L  , KC_M  , KC_N  , KC_O  , KC_P  , KC_Q  , KC_R  , KC_S  , KC_T  ,
+        KC_U  , KC_V  , KC_W  , KC_X  , KC_Y  , KC_Z  , KC_0  , KC_1  , KC_2  , KC_3  ,
+                KC_4  , KC_5  , KC_6  , KC_7  , KC_8  , KC_9  , KC_SPC, MO(1)
+    ),
+    [_NAV] = LAYOUT(
+        KC_ESC , _______, _______, _______, _______, _______, _______, _______, _______, _______,
+        _______, KC_LEFT, KC_DOWN, KC_UP  , KC_RGHT, _______, _______, _______, _______, _______,
+        _______, _______, _______, _______, _______, _______, _______, _______, _______, _______,
+                 _______, _______, _______, _______, _______, TG(2)  , _______, _______
+    ),
+    [_NUM] = LAYOUT(
+        XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, KC_1   , KC_2   , XXXXXXX, XXXXXXX, XXXXXXX,
+        XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+        XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+                 XXXXXXX, XXXXXXX, XXXXXXX, KC_ENT , XXXXXXX, XXXXXXX, _______, _______
+    ),
+    [_EMPTY] = LAYOUT(
+        _______, _______, _______, _______, _______, _______, _______, _______, _______, _______,
+        _______, _______, _______, _______, _______, _______, _______, _______, _______, _______,
+        _______, _______, _______, _______, _______, _______, _______, _______, _______, _______,
+                 _______, _______, _______, _______, _______, _______, _______, _______
+    ),
+};
+// clang-format on
@@ -0,0 +1,71 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+extern "C" {
+#include "keymap_introspection.h"
+
+// The uncompressed layers, from keymap.c
+extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
+}
+
+class KeymapCompressed : public TestFixture {};
+
+TEST_F(KeymapCompressed, MatchesTheKeymap) {
+    ASSERT_EQ(keymap_layer_count(), 4);
+    for (uint8_t layer = 0; layer < keymap_layer_count(); layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                EXPECT_EQ(keycode_at_keymap_location_raw(layer, row, col), keymaps[layer][row][col]) << "layer " << +layer << " row " << +row << " col " << +col;
+            }
+        }
+    }
+}
+
+TEST_F(KeymapCompressed, OutOfBoundsIsKcNo) {
+    EXPECT_EQ(keycode_at_keymap_location_raw(keymap_layer_count(), 0, 0), KC_NO);
+    EXPECT_EQ(keycode_at_keymap_location_raw(0, MATRIX_ROWS, 0), KC_NO);
+    EXPECT_EQ(keycode_at_keymap_location_raw(0, 0, MATRIX_COLS), KC_NO);
+}
+
+TEST_F(KeymapCompressed, TransparentKeys) {
+    for (uint8_t layer = 0; layer < keymap_layer_count(); layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                if (keymap_location_is_transparent_raw(layer, row, col)) {
+                    EXPECT_EQ(keymaps[layer][row][col], KC_TRNS) << "layer " << +layer << " row " << +row << " col " << +col;
+                }
+            }
+        }
+    }
+
+    EXPECT_TRUE(keymap_location_is_transparent_raw(1, 0, 3));
+    EXPECT_FALSE(keymap_location_is_transparent_raw(1, 1, 1));
+    // Keys outside of the layout are KC_NO
+    EXPECT_FALSE(keymap_location_is_transparent_raw(3, 3, 0));
+    // Transparent keys on a layer which is mostly KC_NO are stored, they are found by their action instead
+    EXPECT_FALSE(keymap_location_is_transparent_raw(2, 3, 7));
+}
+
+TEST_F(KeymapCompressed, TransparentLayersAreSkipped) {
+    TestDriver driver;
+    InSequence s;
+    // Only the base layer is mapped, looking up the key on the navigation layer would fail the test
+    auto key_d = KeymapKey(0, 3, 0, KC_D);
+
+    set_keymap({key_d});
+    layer_on(1);
+
+    EXPECT_REPORT(driver, (KC_D));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_d);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    layer_clear();
+}
@@ -0,0 +1,122 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "mousekey.h"
+
+extern "C" {
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+
+struct MouseTotals {
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t v = 0;
+    int32_t h = 0;
+};
+
+class MousekeysIntegrated : public TestFixture {
+   protected:
+    // Holds the given keys for duration ms, running the scan loop every scan_period ms, and sums up the reports sent.
+    MouseTotals hold(TestDriver& driver, std::initializer_list<KeymapKey> keymap, uint32_t duration, uint32_t scan_period) {
+        std::vector<KeymapKey> keys(keymap);
+        MouseTotals totals;
+        EXPECT_CALL(driver, send_mouse_mock(_)).WillRepeatedly([&totals](report_mouse_t& report) {
+            totals.x += report.x;
+            totals.y += report.y;
+            totals.v += report.v;
+            totals.h += report.h;
+        });
+
+        set_keymap(keymap);
+        for (auto& key : keys) {
+            key.press();
+        }
+        keyboard_task();
+        for (uint32_t elapsed = 0; elapsed < duration; elapsed += scan_period) {
+            advance_time(scan_period);
+            keyboard_task();
+        }
+        for (auto& key : keys) {
+            key.release();
+        }
+        keyboard_task();
+        testing::Mock::VerifyAndClearExpectations(&driver);
+        return totals;
+    }
+};
+
+TEST_F(MousekeysIntegrated, DistanceDoesNotDependOnScanRate) {
+    TestDriver  driver;
+    MouseTotals reference = hold(driver, {KeymapKey(0, 0, 0, KC_MS_RIGHT)}, 1200, 1);
+
+    EXPECT_GT(reference.x, 0);
+    EXPECT_EQ(reference.y, 0);
+
+    for (uint32_t scan_period : {2, 3, 5, 8, 10, 25}) {
+        MouseTotals totals = hold(driver, {KeymapKey(0, 0, 0, KC_MS_RIGHT)}, 1200, scan_period);
+        EXPECT_EQ(totals.x, reference.x) << "Scan period " << scan_period << "ms";
+        EXPECT_EQ(totals.y, 0);
+    }
+}
+
+TEST_F(MousekeysIntegrated, ReachesBaseSpeed) {
+    TestDriver driver;
+
+    MouseTotals short_hold = hold(driver, {KeymapKey(0, 0, 0, KC_MS_LEFT)}, 2000, 1);
+    MouseTotals long_hold  = hold(driver, {KeymapKey(0, 0, 0, KC_MS_LEFT)}, 3000, 1);
+
+    // Past the end of the curve, one more second of travel covers MOUSEKEY_BASE_SPEED counts
+    EXPECT_NEAR(short_hold.x - long_hold.x, MOUSEKEY_BASE_SPEED, 1);
+}
+
+TEST_F(MousekeysIntegrated, DiagonalIsScaled) {
+    TestDriver driver;
+
+    MouseTotals straight = hold(driver, {KeymapKey(0, 0, 0, KC_MS_DOWN)}, 1000, 1);
+    MouseTotals diagonal = hold(driver, {KeymapKey(0, 0, 0, KC_MS_DOWN), KeymapKey(0, 1, 0, KC_MS_LEFT)}, 1000, 1);
+
+    EXPECT_GT(straight.y, 0);
+    // only the first key of the chord moves the initial single count
+    EXPECT_NEAR(diagonal.y, -diagonal.x, 1);
+    EXPECT_NEAR(diagonal.y, straight.y * 181 / 256, 2);
+}
+
+TEST_F(MousekeysIntegrated, LongDiagonalIsScaled) {
+    TestDriver driver;
+
+    // Long enough for the distance to be rebased twice
+    MouseTotals straight = hold(driver, {KeymapKey(0, 0, 0, KC_MS_UP)}, 65000, 5);
+    MouseTotals diagonal = hold(driver, {KeymapKey(0, 0, 0, KC_MS_UP), KeymapKey(0, 1, 0, KC_MS_RIGHT)}, 65000, 5);
+
+    EXPECT_NEAR(diagonal.y, -diagonal.x, 1);
+    EXPECT_NEAR(diagonal.y, straight.y * 181 / 256, 2);
+}
+
+TEST_F(MousekeysIntegrated, WheelDistanceDoesNotDependOnScanRate) {
+    TestDriver  driver;
+    MouseTotals reference = hold(driver, {KeymapKey(0, 0, 0, KC_MS_WH_UP)}, 900, 1);
+
+    EXPECT_GT(reference.v, 0);
+    for (uint32_t scan_period : {4, 9, 30}) {
+        MouseTotals totals = hold(driver, {KeymapKey(0, 0, 0, KC_MS_WH_UP)}, 900, scan_period);
+        EXPECT_EQ(totals.v, reference.v) << "Scan period " << scan_period << "ms";
+    }
+}
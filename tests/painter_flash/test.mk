@@ -0,0 +1,7 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+QUANTUM_PAINTER_ENABLE = yes
+QUANTUM_PAINTER_DRIVERS = rgb565_surface
+QUANTUM_PAINTER_FLASH_ASSETS_ENABLE = yes
+FLASH_DRIVER = custom
@@ -0,0 +1,369 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _Static_assert static_assert
+#include "test_common.hpp"
+extern "C" {
+#include "flash_spi.h"
+#include "qgf.h"
+#include "qff.h"
+#include "qap.h"
+#include "qp_comms.h"
+}
+#undef _Static_assert
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+using testing::Test;
+
+static constexpr uint16_t IMAGE_WIDTH  = 64;
+static constexpr uint16_t IMAGE_HEIGHT = 32;
+static constexpr uint8_t  GLYPH_WIDTH  = 2;
+static constexpr uint8_t  GLYPH_HEIGHT = 4;
+
+// Simulated external flash, counting the transfers made
+static std::vector<uint8_t> flash_memory(0x4000, 0xFF);
+static uint32_t             flash_reads;
+static uint32_t             flash_bytes_read;
+static bool                 display_selected_during_read;
+static std::string          bus_log; // display and flash operations, in the order they happened
+
+extern "C" {
+void flash_init(void) {}
+
+flash_status_t flash_read_block(uint32_t addr, void *buf, size_t len) {
+    if (addr + len > flash_memory.size()) {
+        return FLASH_STATUS_BAD_ADDRESS;
+    }
+    // Nothing may be started on the (shared) bus while the flash is read
+    display_selected_during_read |= !qp_comms_idle();
+    bus_log += 'R';
+    std::copy_n(flash_memory.begin() + addr, len, (uint8_t *)buf);
+    flash_reads++;
+    flash_bytes_read += len;
+    return FLASH_STATUS_SUCCESS;
+}
+}
+
+static void put_u8(std::vector<uint8_t> &out, uint8_t value) {
+    out.push_back(value);
+}
+
+static void put_u16(std::vector<uint8_t> &out, uint16_t value) {
+    out.insert(out.end(), {(uint8_t)value, (uint8_t)(value >> 8)});
+}
+
+static void put_u24(std::vector<uint8_t> &out, uint32_t value) {
+    out.insert(out.end(), {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16)});
+}
+
+static void put_u32(std::vector<uint8_t> &out, uint32_t value) {
+    put_u24(out, value);
+    put_u8(out, value >> 24);
+}
+
+static void put_block_header(std::vector<uint8_t> &out, uint8_t type_id, uint32_t length) {
+    put_u8(out, type_id);
+    put_u8(out, ~type_id);
+    put_u24(out, length);
+}
+
+static void set_total_size(std::vector<uint8_t> &data) {
+    uint32_t size = data.size();
+    for (int i = 0; i < 4; i++) {
+        data[9 + i]  = size >> (8 * i);
+        data[13 + i] = ~size >> (8 * i);
+    }
+}
+
+/* Builds an uncompressed 4bpp grayscale QGF image, large enough to span several flash cache blocks. */
+static std::vector<uint8_t> make_image() {
+    std::vector<uint8_t> qgf;
+    put_block_header(qgf, 0x00, 18);
+    put_u24(qgf, QGF_MAGIC);
+    put_u8(qgf, 0x01);
+    put_u32(qgf, 0); // total size, filled in below
+    put_u32(qgf, 0);
+    put_u16(qgf, IMAGE_WIDTH);
+    put_u16(qgf, IMAGE_HEIGHT);
+    put_u16(qgf, 1);
+
+    put_block_header(qgf, 0x01, 4);
+    put_u32(qgf, qgf.size() + 4);
+
+    put_block_header(qgf, 0x02, 6);
+    put_u8(qgf, GRAYSCALE_4BPP);
+    put_u8(qgf, 0);
+    put_u8(qgf, IMAGE_UNCOMPRESSED);
+    put_u8(qgf, 0xFF);
+    put_u16(qgf, 0);
+
+    put_block_header(qgf, 0x05, IMAGE_WIDTH * IMAGE_HEIGHT / 2);
+    for (uint32_t i = 0; i < IMAGE_WIDTH * IMAGE_HEIGHT / 2; i++) {
+        put_u8(qgf, (uint8_t)(i * 37 + (i >> 5)));
+    }
+
+    set_total_size(qgf);
+    return qgf;
+}
+
+/* Builds a 1bpp QFF font with an ascii table only. */
+static std::vector<uint8_t> make_font() {
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> ascii_table;
+    for (uint32_t code_point = 0x20; code_point < 0x7F; code_point++) {
+        put_u24(ascii_table, (data.size() << 6) | GLYPH_WIDTH);
+        data.push_back((uint8_t)(code_point * 37));
+    }
+
+    std::vector<uint8_t> qff;
+    put_block_header(qff, 0x00, 20);
+    put_u24(qff, QFF_MAGIC);
+    put_u8(qff, 0x01);
+    put_u32(qff, 0); // total size, filled in below
+    put_u32(qff, 0);
+    put_u8(qff, GLYPH_HEIGHT);
+    put_u8(qff, 1); // has ascii table
+    put_u16(qff, 0);
+    put_u8(qff, GRAYSCALE_1BPP);
+    put_u8(qff, 0);
+    put_u8(qff, IMAGE_UNCOMPRESSED);
+    put_u8(qff, 0xFF);
+
+    put_block_header(qff, 0x01, ascii_table.size());
+    qff.insert(qff.end(), ascii_table.begin(), ascii_table.end());
+    put_block_header(qff, 0x04, data.size());
+    qff.insert(qff.end(), data.begin(), data.end());
+
+    set_total_size(qff);
+    return qff;
+}
+
+/* Same layout as `qmk painter-make-asset-pack`, with 4-byte aligned assets. */
+static std::vector<uint8_t> make_asset_pack(const std::map<std::string, std::vector<uint8_t>> &assets) {
+    uint32_t             offset = 5 + 14 + 5 + assets.size() * 32;
+    std::vector<uint8_t> directory;
+    std::vector<uint8_t> data;
+    for (auto &[name, contents] : assets) {
+        while (offset % 4) {
+            data.push_back(0);
+            offset++;
+        }
+        std::string padded = name;
+        padded.resize(24, '\0');
+        directory.insert(directory.end(), padded.begin(), padded.end());
+        put_u32(directory, offset);
+        put_u32(directory, contents.size());
+        data.insert(data.end(), contents.begin(), contents.end());
+        offset += contents.size();
+    }
+
+    std::vector<uint8_t> pack;
+    put_block_header(pack, 0x00, 14);
+    put_u24(pack, 0x504151);
+    put_u8(pack, 0x01);
+    put_u32(pack, offset);
+    put_u32(pack, ~offset);
+    put_u16(pack, assets.size());
+    put_block_header(pack, 0x01, directory.size());
+    pack.insert(pack.end(), directory.begin(), directory.end());
+    pack.insert(pack.end(), data.begin(), data.end());
+    return pack;
+}
+
+/* Wraps the surface's vtables, logging viewports as 'V', pixel data as 'P', and comms starts and stops as 'S' and 'X'. */
+static const painter_driver_vtable_t *surface_driver_vtable;
+static const painter_comms_vtable_t  *surface_comms_vtable;
+
+static bool log_viewport(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom) {
+    bus_log += 'V';
+    return surface_driver_vtable->viewport(device, left, top, right, bottom);
+}
+
+static bool log_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count) {
+    bus_log += 'P';
+    return surface_driver_vtable->pixdata(device, pixel_data, native_pixel_count);
+}
+
+static bool log_comms_start(painter_device_t device) {
+    bus_log += 'S';
+    return surface_comms_vtable->comms_start(device);
+}
+
+static void log_comms_stop(painter_device_t device) {
+    bus_log += 'X';
+    surface_comms_vtable->comms_stop(device);
+}
+
+class PainterFlash : public Test {
+   protected:
+    // The surface driver has a fixed number of devices, so the surface is shared between tests
+    static std::vector<uint16_t> buffer;
+    static painter_device_t      device;
+    static std::vector<uint8_t>  image;
+    static std::vector<uint8_t>  font;
+
+    static void SetUpTestSuite() {
+        buffer.assign(IMAGE_WIDTH * IMAGE_HEIGHT, 0);
+        device = qp_rgb565_make_surface(IMAGE_WIDTH, IMAGE_HEIGHT, buffer.data());
+
+        // Flash contents are cached by the streams, so they're written once for all tests
+        image                     = make_image();
+        font                      = make_font();
+        std::vector<uint8_t> pack = make_asset_pack({{"logo", image}, {"font", font}, {"a", font}, {"zzz", image}});
+        std::copy(pack.begin(), pack.end(), flash_memory.begin() + QUANTUM_PAINTER_ASSET_PACK_ADDRESS);
+    }
+
+    void SetUp() override {
+        ASSERT_TRUE(qp_init(device, QP_ROTATION_0));
+        qp_clear(device);
+    }
+};
+
+std::vector<uint16_t> PainterFlash::buffer;
+painter_device_t      PainterFlash::device;
+std::vector<uint8_t>  PainterFlash::image;
+std::vector<uint8_t>  PainterFlash::font;
+
+TEST_F(PainterFlash, ImageMatchesMemoryImage) {
+    painter_image_handle_t mem_image = qp_load_image_mem(image.data());
+    ASSERT_NE(mem_image, nullptr);
+    EXPECT_TRUE(qp_drawimage(device, 0, 0, mem_image));
+    std::vector<uint16_t> expected = buffer;
+    qp_close_image(mem_image);
+    qp_clear(device);
+
+    painter_image_handle_t flash_image = qp_load_image_asset("logo");
+    ASSERT_NE(flash_image, nullptr);
+    EXPECT_EQ(flash_image->width, IMAGE_WIDTH);
+    EXPECT_EQ(flash_image->height, IMAGE_HEIGHT);
+    EXPECT_TRUE(qp_drawimage(device, 0, 0, flash_image));
+    EXPECT_EQ(buffer, expected);
+    qp_close_image(flash_image);
+}
+
+TEST_F(PainterFlash, FontMatchesMemoryFont) {
+    const char *text = "Hello, flash!";
+
+    painter_font_handle_t mem_font = qp_load_font_mem(font.data());
+    ASSERT_NE(mem_font, nullptr);
+    EXPECT_EQ(qp_drawtext(device, 0, 0, mem_font, text), strlen(text) * GLYPH_WIDTH);
+    std::vector<uint16_t> expected = buffer;
+    qp_close_font(mem_font);
+    qp_clear(device);
+
+    painter_font_handle_t flash_font = qp_load_font_asset("font");
+    ASSERT_NE(flash_font, nullptr);
+    EXPECT_EQ(qp_drawtext(device, 0, 0, flash_font, text), strlen(text) * GLYPH_WIDTH);
+    EXPECT_EQ(buffer, expected);
+    qp_close_font(flash_font);
+}
+
+TEST_F(PainterFlash, DrawingReadsWholeBlocks) {
+    painter_image_handle_t flash_image = qp_load_image_asset("zzz");
+    ASSERT_NE(flash_image, nullptr);
+
+    flash_reads                  = 0;
+    flash_bytes_read             = 0;
+    display_selected_during_read = false;
+    EXPECT_TRUE(qp_drawimage(device, 0, 0, flash_image));
+    qp_close_image(flash_image);
+    EXPECT_FALSE(display_selected_during_read);
+
+    // Every block of the image is read once, rather than a transfer per byte
+    uint32_t blocks = (image.size() + QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE - 1) / QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE + 1;
+    EXPECT_LE(flash_reads, blocks);
+    EXPECT_LE(flash_bytes_read, blocks * QUANTUM_PAINTER_FLASH_CACHE_BLOCK_SIZE);
+    RecordProperty("flash_reads", (int)flash_reads);
+}
+
+TEST_F(PainterFlash, FindsEveryAsset) {
+    for (const char *name : {"a", "font", "logo", "zzz"}) {
+        uint32_t address;
+        EXPECT_TRUE(qap_find_flash_asset(name, &address)) << name;
+        EXPECT_GT(address, QUANTUM_PAINTER_ASSET_PACK_ADDRESS) << name;
+        EXPECT_EQ(address % 4, 0) << name;
+    }
+}
+
+TEST_F(PainterFlash, MissingAsset) {
+    EXPECT_EQ(qp_load_image_asset("missing"), nullptr);
+    EXPECT_EQ(qp_load_image_asset("log"), nullptr);
+    EXPECT_EQ(qp_load_font_asset("this_name_is_longer_than_24_bytes"), nullptr);
+}
+
+TEST_F(PainterFlash, AssetOutsidePack) {
+    std::vector<uint8_t> pack = make_asset_pack({{"logo", image}});
+    uint32_t             offset, size;
+
+    // Directory entries start after the 5+14 byte pack descriptor and the 5 byte directory header, each is 24 bytes of name then offset and size
+    auto set_entry = [&pack](uint32_t entry_offset, uint32_t entry_size) {
+        for (int i = 0; i < 4; i++) {
+            pack[5 + 14 + 5 + 24 + i] = entry_offset >> (8 * i);
+            pack[5 + 14 + 5 + 28 + i] = entry_size >> (8 * i);
+        }
+    };
+
+    qp_memory_stream_t stream = qp_make_memory_stream(pack.data(), pack.size());
+    EXPECT_TRUE(qap_find_asset((qp_stream_t *)&stream, "logo", &offset, &size));
+    EXPECT_EQ(offset + size, pack.size());
+
+    set_entry(offset, size + 1);
+    EXPECT_FALSE(qap_find_asset((qp_stream_t *)&stream, "logo", &offset, &size));
+
+    // Wrapping around doesn't get it past the check either
+    set_entry(0xFFFFFF00, 0x200);
+    EXPECT_FALSE(qap_find_asset((qp_stream_t *)&stream, "logo", &offset, &size));
+}
+
+TEST_F(PainterFlash, WrongAssetType) {
+    // Font data isn't a valid image, and vice versa
+    EXPECT_EQ(qp_load_image_asset("font"), nullptr);
+    EXPECT_EQ(qp_load_font_asset("logo"), nullptr);
+}
+
+TEST_F(PainterFlash, DisplayIsReselectedMidImage) {
+    painter_image_handle_t flash_image = qp_load_image_asset("logo");
+    ASSERT_NE(flash_image, nullptr);
+
+    struct painter_driver_t *driver = (struct painter_driver_t *)device;
+    surface_driver_vtable           = driver->driver_vtable;
+    surface_comms_vtable            = driver->comms_vtable;
+
+    painter_driver_vtable_t driver_vtable = *surface_driver_vtable;
+    painter_comms_vtable_t  comms_vtable  = *surface_comms_vtable;
+    driver_vtable.viewport                = log_viewport;
+    driver_vtable.pixdata                 = log_pixdata;
+    comms_vtable.comms_start              = log_comms_start;
+    comms_vtable.comms_stop               = log_comms_stop;
+    driver->driver_vtable                 = &driver_vtable;
+    driver->comms_vtable                  = &comms_vtable;
+
+    bus_log.clear();
+    EXPECT_TRUE(qp_drawimage(device, 0, 0, flash_image));
+    driver->driver_vtable = surface_driver_vtable;
+    driver->comms_vtable  = surface_comms_vtable;
+    qp_close_image(flash_image);
+
+    // The viewport is set once, pixel data is then sent around flash reads, each with the display deselected
+    std::string drawing = bus_log.substr(bus_log.find('V'));
+    EXPECT_EQ(std::count(drawing.begin(), drawing.end(), 'V'), 1) << bus_log;
+    EXPECT_NE(drawing.find("PXRSP"), std::string::npos) << bus_log;
+    EXPECT_EQ(bus_log.find("SR"), std::string::npos) << bus_log;
+}
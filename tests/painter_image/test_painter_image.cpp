@@ -0,0 +1,258 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _Static_assert static_assert
+#include "test_common.hpp"
+extern "C" {
+#include "qp_internal_driver.h"
+#include "qp_draw.h"
+#include "qgf.h"
+}
+#undef _Static_assert
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using testing::Test;
+using testing::TestWithParam;
+
+static constexpr uint16_t SCREEN_WIDTH  = 240;
+static constexpr uint16_t SCREEN_HEIGHT = 320;
+static constexpr uint32_t SCREEN_PIXELS = (uint32_t)SCREEN_WIDTH * SCREEN_HEIGHT;
+
+/* Palette indices for a full screen image, with flat areas as well as detail so that RLE has both kinds of run. */
+static std::vector<uint8_t> make_indices(uint8_t bpp) {
+    std::vector<uint8_t> indices(SCREEN_PIXELS);
+    uint32_t             seed = 1;
+    for (uint32_t i = 0; i < SCREEN_PIXELS; i++) {
+        uint16_t x = i % SCREEN_WIDTH, y = i / SCREEN_WIDTH;
+        if (y < SCREEN_HEIGHT / 4) {
+            indices[i] = 0;
+        } else if (y < SCREEN_HEIGHT / 2) {
+            indices[i] = (x / 16) & ((1 << bpp) - 1);
+        } else {
+            seed       = seed * 1103515245 + 12345;
+            indices[i] = (seed >> 16) & ((1 << bpp) - 1);
+        }
+    }
+    return indices;
+}
+
+/* Packs indices the way the QGF converter does: least significant bits first, rows are not padded. */
+static std::vector<uint8_t> pack(const std::vector<uint8_t>& indices, uint8_t bpp) {
+    uint8_t              pixels_per_byte = 8 / bpp;
+    std::vector<uint8_t> packed((indices.size() + pixels_per_byte - 1) / pixels_per_byte);
+    for (size_t i = 0; i < indices.size(); i++) {
+        packed[i / pixels_per_byte] |= indices[i] << ((i % pixels_per_byte) * bpp);
+    }
+    return packed;
+}
+
+/* Same scheme as the QGF converter: repeated runs of up to 127 bytes, or literal runs of up to 128 bytes. */
+static std::vector<uint8_t> rle(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> out;
+    size_t               i = 0;
+    while (i < data.size()) {
+        size_t repeat = 1;
+        while (i + repeat < data.size() && repeat < 127 && data[i + repeat] == data[i]) {
+            repeat++;
+        }
+        if (repeat >= 3) {
+            out.push_back(repeat);
+            out.push_back(data[i]);
+            i += repeat;
+            continue;
+        }
+        size_t literal = 0;
+        while (i + literal < data.size() && literal < 128 && !(i + literal + 2 < data.size() && data[i + literal] == data[i + literal + 1] && data[i + literal] == data[i + literal + 2])) {
+            literal++;
+        }
+        out.push_back(literal + 127);
+        out.insert(out.end(), data.begin() + i, data.begin() + i + literal);
+        i += literal;
+    }
+    return out;
+}
+
+static void put_u8(std::vector<uint8_t>& out, uint8_t value) {
+    out.push_back(value);
+}
+
+static void put_u16(std::vector<uint8_t>& out, uint16_t value) {
+    out.insert(out.end(), {(uint8_t)value, (uint8_t)(value >> 8)});
+}
+
+static void put_u24(std::vector<uint8_t>& out, uint32_t value) {
+    out.insert(out.end(), {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16)});
+}
+
+static void put_u32(std::vector<uint8_t>& out, uint32_t value) {
+    put_u24(out, value);
+    put_u8(out, value >> 24);
+}
+
+static void put_block_header(std::vector<uint8_t>& out, uint8_t type_id, uint32_t length) {
+    put_u8(out, type_id);
+    put_u8(out, ~type_id);
+    put_u24(out, length);
+}
+
+static qgf_palette_entry_v1_t palette_entry(uint16_t index) {
+    return {(uint8_t)(index * 67), (uint8_t)(255 - index / 2), (uint8_t)(64 + (index * 3) % 192)};
+}
+
+/* Builds a single frame, full screen, palette format QGF image. */
+static std::vector<uint8_t> make_qgf(const std::vector<uint8_t>& indices, uint8_t bpp, painter_compression_t compression) {
+    std::vector<uint8_t> data = pack(indices, bpp);
+    if (compression == IMAGE_COMPRESSED_RLE) {
+        data = rle(data);
+    }
+
+    std::vector<uint8_t> qgf;
+    put_block_header(qgf, 0x00, 18);
+    put_u24(qgf, QGF_MAGIC);
+    put_u8(qgf, 0x01);
+    put_u32(qgf, 0); // total size, filled in below
+    put_u32(qgf, 0);
+    put_u16(qgf, SCREEN_WIDTH);
+    put_u16(qgf, SCREEN_HEIGHT);
+    put_u16(qgf, 1);
+
+    put_block_header(qgf, 0x01, 4);
+    put_u32(qgf, qgf.size() + 4);
+
+    put_block_header(qgf, 0x02, 6);
+    put_u8(qgf, PALETTE_1BPP + (bpp == 1 ? 0 : bpp == 2 ? 1 : bpp == 4 ? 2 : 3));
+    put_u8(qgf, 0);
+    put_u8(qgf, compression);
+    put_u8(qgf, 0xFF);
+    put_u16(qgf, 0);
+
+    put_block_header(qgf, 0x03, (1 << bpp) * 3);
+    for (uint16_t i = 0; i < (1 << bpp); i++) {
+        qgf_palette_entry_v1_t entry = palette_entry(i);
+        qgf.insert(qgf.end(), {entry.h, entry.s, entry.v});
+    }
+
+    put_block_header(qgf, 0x05, data.size());
+    qgf.insert(qgf.end(), data.begin(), data.end());
+
+    uint32_t size = qgf.size();
+    for (int i = 0; i < 4; i++) {
+        qgf[9 + i]  = size >> (8 * i);
+        qgf[13 + i] = ~size >> (8 * i);
+    }
+    return qgf;
+}
+
+class PainterImage : public TestWithParam<std::tuple<uint8_t, painter_compression_t>> {
+   protected:
+    // The surface driver has a fixed number of devices, so the surface is shared between tests
+    static std::vector<uint16_t> buffer;
+    static painter_device_t      device;
+
+    static void SetUpTestSuite() {
+        buffer.assign(SCREEN_PIXELS, 0);
+        device = qp_rgb565_make_surface(SCREEN_WIDTH, SCREEN_HEIGHT, buffer.data());
+    }
+
+    void SetUp() override {
+        ASSERT_TRUE(qp_init(device, QP_ROTATION_0));
+    }
+
+    // The image palette, converted to native pixels by the surface
+    static std::vector<qp_pixel_t> converted_palette(uint8_t bpp) {
+        std::vector<qp_pixel_t> palette(1 << bpp);
+        for (uint16_t i = 0; i < palette.size(); i++) {
+            qgf_palette_entry_v1_t entry = palette_entry(i);
+            palette[i].hsv888.h          = entry.h;
+            palette[i].hsv888.s          = entry.s;
+            palette[i].hsv888.v          = entry.v;
+        }
+        auto driver = (struct painter_driver_t*)device;
+        driver->driver_vtable->palette_convert(device, palette.size(), palette.data());
+        return palette;
+    }
+
+    // Decodes one pixel at a time through the byte input and pixel output callbacks, as used for the same data before span decoding
+    static bool decode_streaming(const std::vector<uint8_t>& data, uint8_t bpp, painter_compression_t compression, qp_pixel_t* palette) {
+        auto               driver = (struct painter_driver_t*)device;
+        qp_memory_stream_t stream = qp_make_memory_stream((void*)data.data(), data.size());
+
+        struct qp_internal_byte_input_state   input_state    = {.device = device, .src_stream = (qp_stream_t*)&stream};
+        qp_internal_byte_input_callback       input_callback = qp_internal_prepare_input_state(&input_state, compression);
+        struct qp_internal_pixel_output_state output_state   = {.device = device, .pixel_write_pos = 0, .max_pixels = qp_internal_num_pixels_in_buffer(device)};
+
+        driver->driver_vtable->viewport(device, 0, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1);
+        bool ret = qp_internal_decode_palette(device, SCREEN_PIXELS, bpp, input_callback, &input_state, palette, qp_internal_pixel_appender, &output_state);
+        if (ret && output_state.pixel_write_pos > 0) {
+            ret = driver->driver_vtable->pixdata(device, qp_internal_global_pixdata_buffer, output_state.pixel_write_pos);
+        }
+        return ret;
+    }
+};
+
+std::vector<uint16_t> PainterImage::buffer;
+painter_device_t      PainterImage::device;
+
+TEST_P(PainterImage, DrawFullScreen) {
+    auto [bpp, compression]         = GetParam();
+    std::vector<uint8_t>    indices = make_indices(bpp);
+    std::vector<uint8_t>    qgf     = make_qgf(indices, bpp, compression);
+    std::vector<qp_pixel_t> palette = converted_palette(bpp);
+
+    painter_image_handle_t image = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(qp_drawimage(device, 0, 0, image));
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    RecordProperty("span_draw_us", (int)elapsed.count());
+
+    for (uint32_t i = 0; i < SCREEN_PIXELS; i++) {
+        ASSERT_EQ(buffer[i], palette[indices[i]].rgb565) << "pixel " << i;
+    }
+
+    qp_close_image(image);
+}
+
+TEST_P(PainterImage, MatchesStreamingDecoder) {
+    auto [bpp, compression]      = GetParam();
+    std::vector<uint8_t> indices = make_indices(bpp);
+    std::vector<uint8_t> data    = pack(indices, bpp);
+    if (compression == IMAGE_COMPRESSED_RLE) {
+        data = rle(data);
+    }
+    std::vector<qp_pixel_t> palette = converted_palette(bpp);
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(decode_streaming(data, bpp, compression, palette.data()));
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    RecordProperty("streaming_draw_us", (int)elapsed.count());
+
+    std::vector<uint16_t> streamed = buffer;
+    qp_clear(device);
+
+    std::vector<uint8_t>   qgf   = make_qgf(indices, bpp, compression);
+    painter_image_handle_t image = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+    EXPECT_TRUE(qp_drawimage(device, 0, 0, image));
+    EXPECT_EQ(buffer, streamed);
+    qp_close_image(image);
+}
+
+INSTANTIATE_TEST_CASE_P(Formats, PainterImage, testing::Combine(testing::Values(1, 2, 4, 8), testing::Values(IMAGE_UNCOMPRESSED, IMAGE_COMPRESSED_RLE)), [](const testing::TestParamInfo<PainterImage::ParamType>& info) { return std::to_string(std::get<0>(info.param)) + "bpp" + (std::get<1>(info.param) == IMAGE_COMPRESSED_RLE ? "Rle" : "Uncompressed"); });
@@ -0,0 +1,9 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define RGB565_SURFACE_NUM_DEVICES 2
+#define QUANTUM_PAINTER_PALETTE_CACHE_SIZE 4
@@ -0,0 +1,352 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _Static_assert static_assert
+#include "test_common.hpp"
+extern "C" {
+#include "color.h"
+#include "qp_internal_driver.h"
+#include "qp_draw.h"
+#include "qgf.h"
+extern const struct painter_driver_vtable_t rgb565_surface_driver_vtable;
+}
+#undef _Static_assert
+
+#include <vector>
+
+using testing::Test;
+
+static constexpr uint16_t WIDTH  = 16;
+static constexpr uint16_t HEIGHT = 4;
+
+static void put_u8(std::vector<uint8_t>& out, uint8_t value) {
+    out.push_back(value);
+}
+
+static void put_u16(std::vector<uint8_t>& out, uint16_t value) {
+    out.insert(out.end(), {(uint8_t)value, (uint8_t)(value >> 8)});
+}
+
+static void put_u24(std::vector<uint8_t>& out, uint32_t value) {
+    out.insert(out.end(), {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16)});
+}
+
+static void put_u32(std::vector<uint8_t>& out, uint32_t value) {
+    put_u24(out, value);
+    put_u8(out, value >> 24);
+}
+
+static void put_block_header(std::vector<uint8_t>& out, uint8_t type_id, uint32_t length) {
+    put_u8(out, type_id);
+    put_u8(out, ~type_id);
+    put_u24(out, length);
+}
+
+static void fix_total_size(std::vector<uint8_t>& data) {
+    uint32_t size = data.size();
+    for (int i = 0; i < 4; i++) {
+        data[9 + i]  = size >> (8 * i);
+        data[13 + i] = ~size >> (8 * i);
+    }
+}
+
+/* Builds a single frame, uncompressed, 4bpp QGF image where pixel i uses index i % 16. Grayscale if there's no palette. */
+static std::vector<uint8_t> make_qgf(const std::vector<qgf_palette_entry_v1_t>& palette) {
+    std::vector<uint8_t> qgf;
+    put_block_header(qgf, 0x00, 18);
+    put_u24(qgf, QGF_MAGIC);
+    put_u8(qgf, 0x01);
+    put_u32(qgf, 0); // total size, filled in below
+    put_u32(qgf, 0);
+    put_u16(qgf, WIDTH);
+    put_u16(qgf, HEIGHT);
+    put_u16(qgf, 1);
+
+    put_block_header(qgf, 0x01, 4);
+    put_u32(qgf, qgf.size() + 4);
+
+    put_block_header(qgf, 0x02, 6);
+    put_u8(qgf, palette.empty() ? GRAYSCALE_4BPP : PALETTE_4BPP);
+    put_u8(qgf, 0);
+    put_u8(qgf, IMAGE_UNCOMPRESSED);
+    put_u8(qgf, 0xFF);
+    put_u16(qgf, 0);
+
+    if (!palette.empty()) {
+        put_block_header(qgf, 0x03, palette.size() * 3);
+        for (auto entry : palette) {
+            qgf.insert(qgf.end(), {entry.h, entry.s, entry.v});
+        }
+    }
+
+    put_block_header(qgf, 0x05, WIDTH * HEIGHT / 2);
+    for (uint16_t i = 0; i < WIDTH * HEIGHT / 2; i++) {
+        put_u8(qgf, (((2 * i + 1) % 16) << 4) | ((2 * i) % 16));
+    }
+
+    fix_total_size(qgf);
+    return qgf;
+}
+
+/* Builds a QFF font with a 1bpp, 2x4 glyph for each ascii character. */
+static std::vector<uint8_t> make_font(void) {
+    std::vector<uint8_t> font;
+    put_block_header(font, 0x00, 20);
+    put_u24(font, 0x464651);
+    put_u8(font, 0x01);
+    put_u32(font, 0); // total size, filled in below
+    put_u32(font, 0);
+    put_u8(font, HEIGHT);
+    put_u8(font, 1); // has ascii table
+    put_u16(font, 0);
+    put_u8(font, GRAYSCALE_1BPP);
+    put_u8(font, 0);    // flags
+    put_u8(font, IMAGE_UNCOMPRESSED);
+    put_u8(font, 0xFF); // transparency index
+
+    put_block_header(font, 0x01, 95 * 3);
+    for (uint32_t i = 0; i < 95; i++) {
+        put_u24(font, (i << 6) | 2);
+    }
+    put_block_header(font, 0x04, 95);
+    for (uint32_t i = 0; i < 95; i++) {
+        put_u8(font, 0x5A ^ i);
+    }
+
+    fix_total_size(font);
+    return font;
+}
+
+static uint16_t rgb565_swapped(qgf_palette_entry_v1_t entry) {
+    RGB      rgb    = hsv_to_rgb_nocie({entry.h, entry.s, entry.v});
+    uint16_t rgb565 = (((uint16_t)rgb.r) >> 3) << 11 | (((uint16_t)rgb.g) >> 2) << 5 | (((uint16_t)rgb.b) >> 3);
+    return __builtin_bswap16(rgb565);
+}
+
+static std::vector<qgf_palette_entry_v1_t> make_palette(uint8_t seed) {
+    std::vector<qgf_palette_entry_v1_t> palette;
+    for (uint8_t i = 0; i < 16; i++) {
+        palette.push_back({(uint8_t)(seed + i * 17), (uint8_t)(255 - i * 8), (uint8_t)(128 + i * 7)});
+    }
+    return palette;
+}
+
+static int                            convert_calls = 0;
+static struct painter_driver_vtable_t counting_vtable;
+
+static bool counting_palette_convert(painter_device_t device, int16_t palette_size, qp_pixel_t* palette) {
+    convert_calls++;
+    return rgb565_surface_driver_vtable.palette_convert(device, palette_size, palette);
+}
+
+class PainterPalette : public Test {
+   protected:
+    // The surface driver has a fixed number of devices, so the surfaces are shared between tests
+    static std::vector<uint16_t> buffers[2];
+    static painter_device_t      devices[2];
+
+    static void SetUpTestSuite() {
+        counting_vtable                 = rgb565_surface_driver_vtable;
+        counting_vtable.palette_convert = counting_palette_convert;
+        for (int i = 0; i < 2; i++) {
+            buffers[i].assign(WIDTH * HEIGHT, 0);
+            devices[i] = qp_rgb565_make_surface(WIDTH, HEIGHT, buffers[i].data());
+            ((struct painter_driver_t*)devices[i])->driver_vtable = &counting_vtable;
+        }
+    }
+
+    void SetUp() override {
+        // Initialising the surfaces also forgets any palettes converted by earlier tests
+        for (int i = 0; i < 2; i++) {
+            ASSERT_TRUE(qp_init(devices[i], QP_ROTATION_0));
+        }
+        convert_calls = 0;
+    }
+
+    static void expect_palette_image(int device, const std::vector<qgf_palette_entry_v1_t>& palette) {
+        for (uint16_t i = 0; i < WIDTH * HEIGHT; i++) {
+            ASSERT_EQ(buffers[device][i], rgb565_swapped(palette[i % 16])) << "pixel " << i;
+        }
+    }
+};
+
+std::vector<uint16_t> PainterPalette::buffers[2];
+painter_device_t      PainterPalette::devices[2];
+
+TEST_F(PainterPalette, RedrawingImageConvertsOnce) {
+    auto                   palette = make_palette(0);
+    std::vector<uint8_t>   qgf     = make_qgf(palette);
+    painter_image_handle_t image   = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+
+    for (int i = 0; i < 3; i++) {
+        qp_clear(devices[0]);
+        ASSERT_TRUE(qp_drawimage(devices[0], 0, 0, image));
+        expect_palette_image(0, palette);
+    }
+    EXPECT_EQ(convert_calls, 1);
+
+    qp_close_image(image);
+}
+
+TEST_F(PainterPalette, SwitchingImagesRestoresCachedPalettes) {
+    auto                   palette_a = make_palette(0);
+    auto                   palette_b = make_palette(100);
+    std::vector<uint8_t>   qgf_a     = make_qgf(palette_a);
+    std::vector<uint8_t>   qgf_b     = make_qgf(palette_b);
+    painter_image_handle_t image_a   = qp_load_image_mem(qgf_a.data());
+    painter_image_handle_t image_b   = qp_load_image_mem(qgf_b.data());
+    ASSERT_NE(image_a, nullptr);
+    ASSERT_NE(image_b, nullptr);
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(qp_drawimage(devices[0], 0, 0, image_a));
+        expect_palette_image(0, palette_a);
+        ASSERT_TRUE(qp_drawimage(devices[0], 0, 0, image_b));
+        expect_palette_image(0, palette_b);
+    }
+    EXPECT_EQ(convert_calls, 2);
+
+    qp_close_image(image_a);
+    qp_close_image(image_b);
+}
+
+TEST_F(PainterPalette, ClosedImageIsNotConfusedWithItsReplacement) {
+    auto                   palette_a = make_palette(0);
+    auto                   palette_b = make_palette(100);
+    std::vector<uint8_t>   qgf_a     = make_qgf(palette_a);
+    std::vector<uint8_t>   qgf_b     = make_qgf(palette_b);
+    painter_image_handle_t image     = qp_load_image_mem(qgf_a.data());
+    ASSERT_NE(image, nullptr);
+    ASSERT_TRUE(qp_drawimage(devices[0], 0, 0, image));
+    qp_close_image(image);
+
+    // The replacement gets the same handle, and its palette is at the same location in its stream
+    painter_image_handle_t replacement = qp_load_image_mem(qgf_b.data());
+    ASSERT_EQ(replacement, image);
+    ASSERT_TRUE(qp_drawimage(devices[0], 0, 0, replacement));
+    expect_palette_image(0, palette_b);
+    EXPECT_EQ(convert_calls, 2);
+
+    qp_close_image(replacement);
+}
+
+TEST_F(PainterPalette, RecolorIsKeyedByColors) {
+    std::vector<uint8_t>   qgf   = make_qgf({});
+    painter_image_handle_t image = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+
+    ASSERT_TRUE(qp_drawimage_recolor(devices[0], 0, 0, image, 0, 255, 255, 0, 0, 0));
+    std::vector<uint16_t> red = buffers[0];
+    ASSERT_TRUE(qp_drawimage_recolor(devices[0], 0, 0, image, 170, 255, 255, 0, 0, 0));
+    std::vector<uint16_t> blue = buffers[0];
+    EXPECT_NE(red, blue);
+    EXPECT_EQ(convert_calls, 2);
+
+    ASSERT_TRUE(qp_drawimage_recolor(devices[0], 0, 0, image, 0, 255, 255, 0, 0, 0));
+    EXPECT_EQ(buffers[0], red);
+    ASSERT_TRUE(qp_drawimage_recolor(devices[0], 0, 0, image, 170, 255, 255, 0, 0, 0));
+    EXPECT_EQ(buffers[0], blue);
+    EXPECT_EQ(convert_calls, 2);
+
+    // The interpolated palette only depends on the colors, so another image with the same colors shares it
+    std::vector<uint8_t>   other_qgf = make_qgf({});
+    painter_image_handle_t other     = qp_load_image_mem(other_qgf.data());
+    ASSERT_NE(other, nullptr);
+    ASSERT_TRUE(qp_drawimage_recolor(devices[0], 0, 0, other, 0, 255, 255, 0, 0, 0));
+    EXPECT_EQ(buffers[0], red);
+    EXPECT_EQ(convert_calls, 2);
+
+    qp_close_image(other);
+    qp_close_image(image);
+}
+
+TEST_F(PainterPalette, LeastRecentlyUsedPaletteIsReplaced) {
+    std::vector<uint8_t>   qgf   = make_qgf({});
+    painter_image_handle_t image = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+
+    // One more color than fits in the cache, so the first is replaced
+    for (uint8_t hue = 0; hue <= QUANTUM_PAINTER_PALETTE_CACHE_SIZE; hue++) {
+        ASSERT_TRUE(qp_drawimage_recolor(devices[0], 0, 0, image, hue * 10, 255, 255, 0, 0, 0));
+    }
+    EXPECT_EQ(convert_calls, QUANTUM_PAINTER_PALETTE_CACHE_SIZE + 1);
+
+    ASSERT_TRUE(qp_drawimage_recolor(devices[0], 0, 0, image, 0, 255, 255, 0, 0, 0));
+    EXPECT_EQ(convert_calls, QUANTUM_PAINTER_PALETTE_CACHE_SIZE + 2);
+    ASSERT_TRUE(qp_drawimage_recolor(devices[0], 0, 0, image, 20, 255, 255, 0, 0, 0));
+    EXPECT_EQ(convert_calls, QUANTUM_PAINTER_PALETTE_CACHE_SIZE + 2);
+
+    qp_close_image(image);
+}
+
+TEST_F(PainterPalette, DevicesHaveTheirOwnPalettes) {
+    auto                   palette = make_palette(0);
+    std::vector<uint8_t>   qgf     = make_qgf(palette);
+    painter_image_handle_t image   = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+
+    for (int i = 0; i < 3; i++) {
+        for (int device = 0; device < 2; device++) {
+            ASSERT_TRUE(qp_drawimage(devices[device], 0, 0, image));
+            expect_palette_image(device, palette);
+        }
+    }
+    EXPECT_EQ(convert_calls, 2);
+
+    qp_close_image(image);
+}
+
+TEST_F(PainterPalette, RedrawingTextConvertsOnce) {
+    std::vector<uint8_t>  data = make_font();
+    painter_font_handle_t font = qp_load_font_mem(data.data());
+    ASSERT_NE(font, nullptr);
+
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(qp_drawtext_recolor(devices[0], 0, 0, font, "QMK", 85, 255, 255, 0, 0, 0), 6);
+    }
+    std::vector<uint16_t> green = buffers[0];
+    EXPECT_EQ(convert_calls, 1);
+
+    // Redrawing after an image with its own palette picks the text colors back up from the cache
+    auto                   palette = make_palette(0);
+    std::vector<uint8_t>   qgf     = make_qgf(palette);
+    painter_image_handle_t image   = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+    ASSERT_TRUE(qp_drawimage(devices[0], 0, 0, image));
+    EXPECT_EQ(qp_drawtext_recolor(devices[0], 0, 0, font, "QMK", 85, 255, 255, 0, 0, 0), 6);
+    EXPECT_EQ(std::vector<uint16_t>(buffers[0].begin(), buffers[0].begin() + 6), std::vector<uint16_t>(green.begin(), green.begin() + 6));
+    EXPECT_EQ(convert_calls, 2);
+
+    qp_close_image(image);
+    qp_close_font(font);
+}
+
+TEST_F(PainterPalette, BatchedConversionMatchesPerEntryConversion) {
+    // Runs of the same color, greys, and black padding as written by the QGF converter
+    std::vector<qgf_palette_entry_v1_t> entries = {{0, 255, 255}, {0, 255, 255}, {0, 255, 255}, {85, 128, 200}, {0, 0, 77}, {0, 0, 77}, {200, 0, 77}, {43, 255, 10}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+    std::vector<qp_pixel_t>             palette(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        palette[i].hsv888.h = entries[i].h;
+        palette[i].hsv888.s = entries[i].s;
+        palette[i].hsv888.v = entries[i].v;
+    }
+
+    ASSERT_TRUE(rgb565_surface_driver_vtable.palette_convert(devices[0], palette.size(), palette.data()));
+    for (size_t i = 0; i < entries.size(); i++) {
+        EXPECT_EQ(palette[i].rgb565, rgb565_swapped(entries[i])) << "entry " << i;
+    }
+}
@@ -0,0 +1,31 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define QUANTUM_PAINTER_SPI_ASYNC 1
+#define QUANTUM_PAINTER_SPI_ASYNC_BUFFER_SIZE 64
+#define ST7789_NUM_DEVICES 2
+
+/* Here, "pins" are just non-zero identifiers for the mocked SPI bus and GPIO. */
+#include <stdint.h>
+#include <stdbool.h>
+typedef uint8_t pin_t;
+
+#define DISPLAY_CS_PIN 1
+#define DISPLAY_DC_PIN 2
+#define OTHER_DISPLAY_CS_PIN 3
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void mock_gpio_write(pin_t pin, bool level);
+#ifdef __cplusplus
+}
+#endif
+
+#define setPinOutput(pin)
+#define writePinHigh(pin) mock_gpio_write(pin, true)
+#define writePinLow(pin) mock_gpio_write(pin, false)
@@ -0,0 +1,9 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+QUANTUM_PAINTER_ENABLE = yes
+QUANTUM_PAINTER_DRIVERS = st7789_spi rgb565_surface
+
+# Mocked SPI bus
+VPATH += $(DRIVER_PATH)/sensors/tests
+SRC += $(DRIVER_PATH)/sensors/tests/spi_mock.cpp
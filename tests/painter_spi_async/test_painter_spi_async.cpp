@@ -0,0 +1,282 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _Static_assert static_assert
+#include "test_common.hpp"
+#include "spi_mock.hpp"
+#undef _Static_assert
+
+extern "C" {
+#include "qp_comms.h"
+#include "qp_comms_spi.h"
+}
+
+#include <vector>
+
+using testing::Test;
+
+static constexpr uint16_t SURFACE_WIDTH  = 40;
+static constexpr uint16_t SURFACE_HEIGHT = 20;
+static constexpr uint8_t  ST7789_RAMWR   = 0x2C;
+
+extern "C" void mock_gpio_write(pin_t pin, bool level) {
+    EXPECT_FALSE(MockSpi::Instance().async_pending()) << "Pin " << (int)pin << " changed while a transfer was in flight";
+}
+
+class PainterSpiAsync : public Test {
+   protected:
+    static painter_device_t      display;
+    static painter_device_t      other_display;
+    static painter_device_t      surface;
+    static std::vector<uint16_t> surface_buffer;
+
+    static void SetUpTestSuite() {
+        display       = qp_st7789_make_spi_device(240, 240, DISPLAY_CS_PIN, DISPLAY_DC_PIN, NO_PIN, 8, 0);
+        other_display = qp_st7789_make_spi_device(240, 240, OTHER_DISPLAY_CS_PIN, DISPLAY_DC_PIN, NO_PIN, 8, 0);
+        surface_buffer.assign(SURFACE_WIDTH * SURFACE_HEIGHT, 0);
+        surface = qp_rgb565_make_surface(SURFACE_WIDTH, SURFACE_HEIGHT, surface_buffer.data());
+    }
+
+    void SetUp() override {
+        auto& spi = MockSpi::Instance();
+        spi.reset_instance();
+        // Transfers finish by themselves after a few polls, as if the hardware was sending them
+        spi.set_async_polls(3);
+        ASSERT_TRUE(qp_init(display, QP_ROTATION_0));
+        ASSERT_TRUE(qp_init(other_display, QP_ROTATION_0));
+        ASSERT_TRUE(qp_init(surface, QP_ROTATION_0));
+        wait_for_completion(display);
+        wait_for_completion(other_display);
+        spi.clear_log();
+    }
+
+    static void wait_for_completion(painter_device_t device) {
+        for (int i = 0; i < 100 && !qp_flush_complete(device); i++) {
+        }
+        ASSERT_TRUE(qp_flush_complete(device));
+    }
+
+    // All data sent in the background since the last pixel data command
+    static std::vector<uint8_t> pixel_data() {
+        std::vector<uint8_t> data;
+        for (auto& entry : MockSpi::Instance().get_log()) {
+            if (entry.op == MockSpiOp::write && entry.data[0] == ST7789_RAMWR) {
+                data.clear();
+            } else if (entry.op == MockSpiOp::transmit_async) {
+                data.insert(data.end(), entry.data.begin(), entry.data.end());
+            }
+        }
+        return data;
+    }
+};
+
+painter_device_t      PainterSpiAsync::display;
+painter_device_t      PainterSpiAsync::other_display;
+painter_device_t      PainterSpiAsync::surface;
+std::vector<uint16_t> PainterSpiAsync::surface_buffer;
+
+TEST_F(PainterSpiAsync, PixelDataIsSentInBackground) {
+    auto& spi = MockSpi::Instance();
+
+    // Returns as soon as the last chunk is queued, the display stays selected until it's out
+    EXPECT_TRUE(qp_rect(display, 0, 0, 15, 15, 0, 0, 255, true));
+    EXPECT_TRUE(spi.async_pending());
+    EXPECT_EQ(spi.selected_pin(), DISPLAY_CS_PIN);
+    EXPECT_FALSE(qp_flush_complete(display));
+    EXPECT_TRUE(qp_flush_complete(other_display));
+
+    wait_for_completion(display);
+    EXPECT_EQ(spi.selected_pin(), 0);
+    EXPECT_EQ(spi.get_log().back().op, MockSpiOp::stop);
+
+    std::vector<uint8_t> data = pixel_data();
+    EXPECT_EQ(data.size(), 16 * 16 * 2);
+    EXPECT_EQ(data, std::vector<uint8_t>(16 * 16 * 2, 0xFF));
+}
+
+TEST_F(PainterSpiAsync, CallerBufferIsReusableWhileInFlight) {
+    auto& spi = MockSpi::Instance();
+    spi.set_async_polls(0);
+
+    std::vector<uint16_t> pixels = {0x1234, 0x5678, 0x9ABC};
+    EXPECT_TRUE(qp_pixdata(display, pixels.data(), pixels.size()));
+    ASSERT_TRUE(spi.async_pending());
+    EXPECT_FALSE(qp_flush_complete(display));
+
+    // The data was staged, so changing the caller's buffer doesn't change what goes out
+    pixels.assign(pixels.size(), 0);
+    spi.complete_async();
+    EXPECT_TRUE(qp_flush_complete(display));
+    EXPECT_EQ(spi.selected_pin(), 0);
+
+    ASSERT_EQ(spi.get_log().size(), 3);
+    EXPECT_EQ(spi.get_log()[0].op, MockSpiOp::start);
+    EXPECT_EQ(spi.get_log()[1].op, MockSpiOp::transmit_async);
+    EXPECT_EQ(spi.get_log()[1].data, std::vector<uint8_t>({0x34, 0x12, 0x78, 0x56, 0xBC, 0x9A}));
+    EXPECT_EQ(spi.get_log()[2].op, MockSpiOp::stop);
+}
+
+TEST_F(PainterSpiAsync, SameDisplayCarriesOnWithoutReleasingBus) {
+    auto& spi = MockSpi::Instance();
+
+    EXPECT_TRUE(qp_rect(display, 0, 0, 7, 7, 0, 0, 255, true));
+    EXPECT_TRUE(qp_rect(display, 8, 8, 15, 15, 0, 0, 0, true));
+    wait_for_completion(display);
+
+    int starts = 0;
+    for (auto& entry : spi.get_log()) {
+        starts += entry.op == MockSpiOp::start;
+    }
+    EXPECT_EQ(starts, 1);
+}
+
+TEST_F(PainterSpiAsync, OtherDisplayWaitsForBus) {
+    auto& spi = MockSpi::Instance();
+
+    EXPECT_TRUE(qp_rect(display, 0, 0, 15, 15, 0, 0, 255, true));
+    EXPECT_TRUE(qp_rect(other_display, 0, 0, 15, 15, 0, 0, 255, true));
+    wait_for_completion(other_display);
+
+    // The first display is released before the second is selected
+    std::vector<std::pair<MockSpiOp, pin_t>> selection;
+    for (auto& entry : spi.get_log()) {
+        if (entry.op == MockSpiOp::start || entry.op == MockSpiOp::stop) {
+            selection.push_back({entry.op, entry.pin});
+        }
+    }
+    std::vector<std::pair<MockSpiOp, pin_t>> expected = {
+        {MockSpiOp::start, DISPLAY_CS_PIN},
+        {MockSpiOp::stop, DISPLAY_CS_PIN},
+        {MockSpiOp::start, OTHER_DISPLAY_CS_PIN},
+        {MockSpiOp::stop, OTHER_DISPLAY_CS_PIN},
+    };
+    EXPECT_EQ(selection, expected);
+}
+
+TEST_F(PainterSpiAsync, SurfaceIsSentInOrder) {
+    for (uint16_t i = 0; i < surface_buffer.size(); i++) {
+        EXPECT_TRUE(qp_setpixel(surface, i % SURFACE_WIDTH, i / SURFACE_WIDTH, i, 255, 255));
+    }
+
+    EXPECT_TRUE(qp_rgb565_surface_draw(surface, display, 0, 0));
+    wait_for_completion(display);
+
+    std::vector<uint8_t> expected;
+    for (auto pixel : surface_buffer) {
+        expected.push_back(pixel & 0xFF);
+        expected.push_back(pixel >> 8);
+    }
+    EXPECT_EQ(pixel_data(), expected);
+}
+
+TEST_F(PainterSpiAsync, DataIsGatheredWhileTransferIsInFlight) {
+    auto& spi = MockSpi::Instance();
+    // Slow transfers, so the next buffer fills up before the previous one is out
+    spi.set_async_polls(50);
+
+    EXPECT_TRUE(qp_rect(display, 0, 0, 15, 15, 0, 0, 255, true));
+    EXPECT_TRUE(spi.async_pending());
+
+    int transfers = 0;
+    for (auto& entry : spi.get_log()) {
+        if (entry.op == MockSpiOp::write && entry.data[0] == ST7789_RAMWR) {
+            transfers = 0;
+        } else if (entry.op == MockSpiOp::transmit_async) {
+            EXPECT_LE(entry.data.size(), QUANTUM_PAINTER_SPI_ASYNC_BUFFER_SIZE);
+            transfers++;
+        }
+    }
+    // The first chunk goes out straight away, the rest in whole buffers
+    EXPECT_LE(transfers, 1 + (16 * 16 * 2) / QUANTUM_PAINTER_SPI_ASYNC_BUFFER_SIZE);
+
+    wait_for_completion(display);
+    EXPECT_EQ(pixel_data(), std::vector<uint8_t>(16 * 16 * 2, 0xFF));
+}
+
+TEST_F(PainterSpiAsync, BusyIsPerDisplay) {
+    auto& spi = MockSpi::Instance();
+    spi.set_async_polls(0);
+
+    std::vector<uint16_t> pixels = {0x1234, 0x5678, 0x9ABC};
+    EXPECT_TRUE(qp_pixdata(display, pixels.data(), pixels.size()));
+    ASSERT_TRUE(spi.async_pending());
+
+    EXPECT_TRUE(qp_comms_spi_busy(display));
+    EXPECT_FALSE(qp_comms_spi_busy(other_display));
+
+    spi.complete_async();
+    EXPECT_FALSE(qp_comms_spi_busy(display));
+    EXPECT_TRUE(qp_flush_complete(display));
+}
+
+TEST_F(PainterSpiAsync, ViewportIsResentAfterSuspend) {
+    auto&                    spi    = MockSpi::Instance();
+    struct painter_driver_t* driver = (struct painter_driver_t*)display;
+
+    // The windows addressed, as {left, top, right, bottom}, and the number of pixels sent after each
+    auto windows = [&spi]() {
+        std::vector<std::vector<uint16_t>> result;
+        uint8_t                            command = 0;
+        for (auto& entry : spi.get_log()) {
+            if (entry.op == MockSpiOp::write) {
+                command = entry.data[0];
+                if (command == ST7789_RAMWR) {
+                    result.back().push_back(0);
+                }
+            } else if (entry.op == MockSpiOp::transmit_async) {
+                if (command == 0x2A) { // CASET
+                    result.push_back({(uint16_t)(entry.data[0] << 8 | entry.data[1]), 0, (uint16_t)(entry.data[2] << 8 | entry.data[3]), 0});
+                } else if (command == 0x2B) { // RASET
+                    result.back()[1] = entry.data[0] << 8 | entry.data[1];
+                    result.back()[3] = entry.data[2] << 8 | entry.data[3];
+                } else if (command == ST7789_RAMWR) {
+                    result.back().back() += entry.data.size() / 2;
+                }
+            }
+        }
+        return result;
+    };
+
+    std::vector<uint16_t> pixels(6, 0xFFFF);
+    ASSERT_TRUE(qp_comms_start(display));
+    driver->driver_vtable->viewport(display, 10, 20, 13, 23);
+    driver->driver_vtable->pixdata(display, pixels.data(), 6);
+
+    // Deselected part way along the second row
+    EXPECT_EQ(qp_comms_suspend(), display);
+    EXPECT_EQ(spi.selected_pin(), 0);
+    qp_comms_resume(display);
+    driver->driver_vtable->pixdata(display, pixels.data(), 6);
+
+    // Deselected at the start of the last row, which only needs the viewport once
+    EXPECT_EQ(qp_comms_suspend(), display);
+    qp_comms_resume(display);
+    driver->driver_vtable->pixdata(display, pixels.data(), 4);
+
+    // Nothing is left to write once the viewport is filled
+    EXPECT_EQ(qp_comms_suspend(), display);
+    qp_comms_resume(display);
+    qp_comms_stop(display);
+    wait_for_completion(display);
+
+    std::vector<std::vector<uint16_t>> expected = {
+        {10, 20, 13, 23, 6},
+        {12, 21, 13, 21, 2},
+        {10, 22, 13, 23, 4},
+        {10, 23, 13, 23, 4},
+    };
+    EXPECT_EQ(windows(), expected);
+}
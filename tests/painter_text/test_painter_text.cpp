@@ -0,0 +1,217 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _Static_assert static_assert
+#include "test_common.hpp"
+#undef _Static_assert
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using testing::Test;
+
+// Every glyph is 2x4 pixels at 1bpp, i.e. a single byte of data
+static constexpr uint8_t GLYPH_WIDTH  = 2;
+static constexpr uint8_t GLYPH_HEIGHT = 4;
+
+static uint8_t glyph_bits(uint32_t code_point) {
+    return (uint8_t)((code_point * 37) ^ (code_point >> 8));
+}
+
+static void put_u8(std::vector<uint8_t>& out, uint8_t value) {
+    out.push_back(value);
+}
+
+static void put_u24(std::vector<uint8_t>& out, uint32_t value) {
+    out.insert(out.end(), {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16)});
+}
+
+static void put_u32(std::vector<uint8_t>& out, uint32_t value) {
+    put_u24(out, value);
+    put_u8(out, value >> 24);
+}
+
+static void put_block_header(std::vector<uint8_t>& out, uint8_t type_id, uint32_t length) {
+    put_u8(out, type_id);
+    put_u8(out, ~type_id);
+    put_u24(out, length);
+}
+
+/* Builds a QFF font with a full ascii table and the given unicode glyphs, in the given table order. */
+static std::vector<uint8_t> make_font(const std::vector<uint32_t>& unicode_glyphs) {
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> ascii_table;
+    std::vector<uint8_t> unicode_table;
+    for (uint32_t code_point = 0x20; code_point < 0x7F; code_point++) {
+        put_u24(ascii_table, (data.size() << 6) | GLYPH_WIDTH);
+        data.push_back(glyph_bits(code_point));
+    }
+    for (auto code_point : unicode_glyphs) {
+        put_u24(unicode_table, code_point);
+        put_u24(unicode_table, (data.size() << 6) | GLYPH_WIDTH);
+        data.push_back(glyph_bits(code_point));
+    }
+
+    std::vector<uint8_t> font;
+    put_block_header(font, 0x00, 20);
+    put_u24(font, 0x464651);
+    put_u8(font, 0x01);
+    put_u32(font, 0); // total size, filled in below
+    put_u32(font, 0);
+    put_u8(font, GLYPH_HEIGHT);
+    put_u8(font, 1); // has ascii table
+    put_u8(font, unicode_glyphs.size() & 0xFF);
+    put_u8(font, unicode_glyphs.size() >> 8);
+    put_u8(font, 0x00); // GRAYSCALE_1BPP
+    put_u8(font, 0);    // flags
+    put_u8(font, 0);    // IMAGE_UNCOMPRESSED
+    put_u8(font, 0xFF); // transparency index
+
+    put_block_header(font, 0x01, ascii_table.size());
+    font.insert(font.end(), ascii_table.begin(), ascii_table.end());
+    put_block_header(font, 0x02, unicode_table.size());
+    font.insert(font.end(), unicode_table.begin(), unicode_table.end());
+    put_block_header(font, 0x04, data.size());
+    font.insert(font.end(), data.begin(), data.end());
+
+    uint32_t size = font.size();
+    for (int i = 0; i < 4; i++) {
+        font[9 + i]  = size >> (8 * i);
+        font[13 + i] = ~size >> (8 * i);
+    }
+    return font;
+}
+
+static std::string to_utf8(const std::vector<uint32_t>& code_points) {
+    std::string out;
+    for (auto cp : code_points) {
+        if (cp < 0x80) {
+            out += (char)cp;
+        } else if (cp < 0x800) {
+            out += (char)(0xC0 | (cp >> 6));
+            out += (char)(0x80 | (cp & 0x3F));
+        } else {
+            out += (char)(0xE0 | (cp >> 12));
+            out += (char)(0x80 | ((cp >> 6) & 0x3F));
+            out += (char)(0x80 | (cp & 0x3F));
+        }
+    }
+    return out;
+}
+
+// Wide enough for the longest string rendered by the tests
+static constexpr uint16_t SURFACE_WIDTH = 2000;
+
+class PainterText : public Test {
+   protected:
+    // The surface driver has a fixed number of devices, so the surface is shared between tests
+    static std::vector<uint16_t> buffer;
+    static painter_device_t      device;
+
+    static void SetUpTestSuite() {
+        buffer.assign(SURFACE_WIDTH * GLYPH_HEIGHT, 0);
+        device = qp_rgb565_make_surface(SURFACE_WIDTH, GLYPH_HEIGHT, buffer.data());
+    }
+
+    void SetUp() override {
+        std::fill(buffer.begin(), buffer.end(), 0x1234);
+        ASSERT_TRUE(qp_init(device, QP_ROTATION_0));
+    }
+
+    // Checks the pixels drawn for each code point against its glyph data
+    void expect_glyphs(const std::vector<uint32_t>& code_points) {
+        for (size_t i = 0; i < code_points.size(); i++) {
+            uint8_t bits = glyph_bits(code_points[i]);
+            for (uint8_t pixel = 0; pixel < GLYPH_WIDTH * GLYPH_HEIGHT; pixel++) {
+                uint16_t x        = i * GLYPH_WIDTH + pixel % GLYPH_WIDTH;
+                uint16_t y        = pixel / GLYPH_WIDTH;
+                uint16_t expected = (bits >> pixel) & 1 ? 0xFFFF : 0x0000;
+                ASSERT_EQ(buffer[y * SURFACE_WIDTH + x], expected) << "glyph " << i << " (U+" << std::hex << code_points[i] << ") pixel " << std::dec << (int)pixel;
+            }
+        }
+    }
+};
+
+std::vector<uint16_t> PainterText::buffer;
+painter_device_t      PainterText::device;
+
+TEST_F(PainterText, SortedUnicodeTable) {
+    std::vector<uint32_t> glyphs = {0xA9, 0x3B1, 0x2603, 0x4E00, 0x4E01, 0x4E02, 0x4E03};
+    std::vector<uint8_t>  font   = make_font(glyphs);
+    painter_font_handle_t handle = qp_load_font_mem(font.data());
+    ASSERT_NE(handle, nullptr);
+
+    // Includes repeats so that glyphs come out of the glyph cache as well as the table
+    std::vector<uint32_t> text = {0x4E03, 'A', 0xA9, 0x4E00, 0x2603, 0x4E03, 0x3B1, 0xA9, 0x4E01, 0x4E02};
+    EXPECT_EQ(qp_drawtext(device, 0, 0, handle, to_utf8(text).c_str()), text.size() * GLYPH_WIDTH);
+    expect_glyphs(text);
+
+    qp_close_font(handle);
+}
+
+TEST_F(PainterText, UnsortedUnicodeTable) {
+    std::vector<uint32_t> glyphs = {0x4E03, 0x2603, 0xA9, 0x4E00, 0x3B1};
+    std::vector<uint8_t>  font   = make_font(glyphs);
+    painter_font_handle_t handle = qp_load_font_mem(font.data());
+    ASSERT_NE(handle, nullptr);
+
+    std::vector<uint32_t> text = {0xA9, 0x4E00, 0x3B1, 0x4E03, 0x2603};
+    EXPECT_EQ(qp_drawtext(device, 0, 0, handle, to_utf8(text).c_str()), text.size() * GLYPH_WIDTH);
+    expect_glyphs(text);
+
+    qp_close_font(handle);
+}
+
+TEST_F(PainterText, MissingGlyph) {
+    std::vector<uint8_t>  font   = make_font({0x4E00, 0x4E02});
+    painter_font_handle_t handle = qp_load_font_mem(font.data());
+    ASSERT_NE(handle, nullptr);
+
+    EXPECT_EQ(qp_textwidth(handle, to_utf8({0x4E00, 0x4E01}).c_str()), 0);
+    EXPECT_EQ(qp_textwidth(handle, to_utf8({0x4E02, 0x4E00}).c_str()), 2 * GLYPH_WIDTH);
+
+    qp_close_font(handle);
+}
+
+TEST_F(PainterText, Render1000CharacterString) {
+    // A CJK block sized font, and a string of pseudo-random characters from it
+    std::vector<uint32_t> glyphs;
+    for (uint32_t code_point = 0x4E00; code_point < 0x4E00 + 3000; code_point++) {
+        glyphs.push_back(code_point);
+    }
+    std::vector<uint8_t>  font   = make_font(glyphs);
+    painter_font_handle_t handle = qp_load_font_mem(font.data());
+    ASSERT_NE(handle, nullptr);
+
+    std::vector<uint32_t> text;
+    uint32_t              seed = 1;
+    for (int i = 0; i < 1000; i++) {
+        seed = seed * 1103515245 + 12345;
+        text.push_back(glyphs[(seed >> 16) % glyphs.size()]);
+    }
+    std::string str = to_utf8(text);
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(qp_drawtext(device, 0, 0, handle, str.c_str()), text.size() * GLYPH_WIDTH);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    expect_glyphs(text);
+    RecordProperty("render_1000_chars_us", (int)elapsed.count());
+
+    qp_close_font(handle);
+}
@@ -0,0 +1,154 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+#include "pointing_device.h"
+
+extern "C" {
+void advance_time(uint32_t ms);
+
+static report_mouse_t sensor_report;
+static int16_t        sensor_x;
+
+// custom driver reading the made up sensor
+report_mouse_t pointing_device_driver_get_report(report_mouse_t mouse_report) {
+    if (sensor_x) {
+        pointing_device_motion_add(sensor_x, 0, 0, 0);
+    }
+    mouse_report.buttons = sensor_report.buttons;
+    return mouse_report;
+}
+}
+
+using testing::_;
+
+class PointingDeviceMotion : public TestFixture {
+   protected:
+    void SetUp() override {
+        sensor_report = {};
+        sensor_x      = 0;
+        pointing_device_motion_reset();
+        // start right after a flush
+        advance_time(POINTING_DEVICE_MOTION_REPORT_MS);
+        pointing_device_task();
+    }
+
+    // Moves the sensor by x counts every read_period ms for duration ms, and sums up the motion sent.
+    int32_t move(TestDriver& driver, int16_t x, uint32_t duration, uint32_t read_period) {
+        int32_t total = 0;
+        EXPECT_CALL(driver, send_mouse_mock(_)).WillRepeatedly([&total](report_mouse_t& report) { total += report.x; });
+
+        sensor_x = x;
+        for (uint32_t elapsed = 0; elapsed < duration; elapsed += read_period) {
+            advance_time(read_period);
+            pointing_device_task();
+        }
+        sensor_x = 0;
+        testing::Mock::VerifyAndClearExpectations(&driver);
+        return total;
+    }
+};
+
+TEST_F(PointingDeviceMotion, MotionIsSentOncePerInterval) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(0);
+    sensor_x = 1;
+    for (int i = 0; i < POINTING_DEVICE_MOTION_REPORT_MS - 1; i++) {
+        advance_time(1);
+        pointing_device_task();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(1);
+    advance_time(1);
+    pointing_device_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(PointingDeviceMotion, ButtonsAreNotHeldBack) {
+    TestDriver driver;
+
+    // the report interval has not elapsed, but the button change goes out at once
+    EXPECT_CALL(driver, send_mouse_mock(_)).WillOnce([](report_mouse_t& report) {
+        EXPECT_EQ(report.buttons, 1);
+        EXPECT_EQ(report.x, 0);
+    });
+    sensor_report.buttons = 1;
+    advance_time(1);
+    pointing_device_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_mouse_mock(_)).WillOnce([](report_mouse_t& report) { EXPECT_EQ(report.buttons, 0); });
+    sensor_report.buttons = 0;
+    advance_time(1);
+    pointing_device_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(PointingDeviceMotion, AccelerationDoesNotDependOnReadRate) {
+    TestDriver driver;
+
+    // 2000 counts per second, read every 1 ms and every 4 ms
+    move(driver, 2, 100, 1);
+    int32_t fast = move(driver, 2, 400, 1);
+    move(driver, 8, 100, 4);
+    int32_t slow = move(driver, 8, 400, 4);
+
+    // accelerated well past the raw 800 counts
+    EXPECT_GT(fast, 2000);
+    EXPECT_NEAR(slow, fast, 2);
+}
+
+TEST_F(PointingDeviceMotion, CarriedMotionIsBounded) {
+    TestDriver driver;
+
+    EXPECT_EQ(move(driver, 1000, 1, 1) + move(driver, 0, 200, 1), POINTING_DEVICE_MOTION_CARRY_MAX);
+}
+
+TEST_F(PointingDeviceMotion, CpiChangeDropsAccumulatedMotion) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(0);
+    sensor_x = 20;
+    advance_time(1);
+    pointing_device_task();
+    sensor_x = 0;
+    pointing_device_set_cpi(800);
+    for (int i = 0; i < 2 * POINTING_DEVICE_MOTION_REPORT_MS; i++) {
+        advance_time(1);
+        pointing_device_task();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(PointingDeviceMotion, WakeupDropsAccumulatedMotion) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(0);
+    sensor_x = 20;
+    advance_time(1);
+    pointing_device_task();
+    sensor_x = 0;
+    suspend_wakeup_init_quantum();
+    for (int i = 0; i < 2 * POINTING_DEVICE_MOTION_REPORT_MS; i++) {
+        advance_time(1);
+        pointing_device_task();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
@@ -0,0 +1,6 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+RGBLIGHT_ENABLE = yes
+
+# The bitbang WS2812 driver is replaced by the recording mock in this folder
@@ -0,0 +1,138 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "rgblight.h"
+#include "timer.h"
+
+void advance_time(uint32_t ms);
+
+extern LED_TYPE ws2812_mock_strip[RGBLED_NUM];
+extern uint32_t ws2812_mock_writes;
+extern uint32_t ws2812_mock_leds_written;
+}
+
+typedef void (*effect_func_t)(animation_status_t *anim);
+
+struct Effect {
+    const char   *name;
+    effect_func_t func;
+    uint8_t       variants;
+};
+
+static const Effect effects[] = {
+    {"breathing", rgblight_effect_breathing, 4},
+    {"rainbow_mood", rgblight_effect_rainbow_mood, 3},
+    {"rainbow_swirl", rgblight_effect_rainbow_swirl, 6},
+    {"snake", rgblight_effect_snake, 6},
+    {"knight", rgblight_effect_knight, 3},
+    {"christmas", rgblight_effect_christmas, 1},
+    {"rgbtest", rgblight_effect_rgbtest, 1},
+    {"alternating", rgblight_effect_alternating, 1},
+    {"twinkle", rgblight_effect_twinkle, 6},
+};
+
+class RgblightFrames : public TestFixture {
+   public:
+    void SetUp() override {
+        rgblight_enable_noeeprom();
+        // A static mode, so that the effects are only run by the tests
+        rgblight_mode_noeeprom(RGBLIGHT_MODE_STATIC_LIGHT);
+        rgblight_sethsv_noeeprom(HSV_RED);
+        // The next frame is drawn in full
+        rgblight_set();
+        ws2812_mock_writes       = 0;
+        ws2812_mock_leds_written = 0;
+    }
+
+    static bool strip_matches_buffer(void) {
+        return memcmp(ws2812_mock_strip, led, sizeof(led)) == 0;
+    }
+};
+
+TEST_F(RgblightFrames, RenderEveryMode) {
+    const unsigned frames = 1000;
+
+    for (const Effect &effect : effects) {
+        for (uint8_t delta = 0; delta < effect.variants; delta++) {
+            SetUp();
+            animation_status_t anim = {};
+            anim.delta              = delta;
+
+            auto start = std::chrono::steady_clock::now();
+            for (unsigned frame = 0; frame < frames; frame++) {
+                anim.steps = 1;
+                effect.func(&anim);
+                ASSERT_TRUE(strip_matches_buffer()) << effect.name << " " << (int)delta << " frame " << frame;
+            }
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+            EXPECT_LE(ws2812_mock_writes, frames) << effect.name;
+            EXPECT_LE(ws2812_mock_leds_written, frames * RGBLED_NUM) << effect.name;
+
+            std::string key = std::string(effect.name) + "_" + std::to_string(delta);
+            RecordProperty(key + "_ns_per_frame", std::to_string(elapsed / frames));
+            RecordProperty(key + "_writes", std::to_string(ws2812_mock_writes));
+            RecordProperty(key + "_leds_written", std::to_string(ws2812_mock_leds_written));
+        }
+    }
+}
+
+TEST_F(RgblightFrames, SnakeOnlySendsUpToTheLastChangedLed) {
+    animation_status_t anim = {};
+    anim.delta              = 1; // counting up
+
+    for (unsigned frame = 0; frame < RGBLED_NUM; frame++) {
+        anim.steps = 1;
+        rgblight_effect_snake(&anim);
+        ASSERT_TRUE(strip_matches_buffer());
+    }
+
+    EXPECT_EQ(ws2812_mock_writes, RGBLED_NUM);
+    EXPECT_LT(ws2812_mock_leds_written, RGBLED_NUM * RGBLED_NUM);
+}
+
+TEST_F(RgblightFrames, UnchangedFramesAreNotSent) {
+    animation_status_t anim = {};
+
+    // Two steps of the alternating effect bring it back to the same frame
+    for (int frame = 0; frame < 10; frame++) {
+        anim.steps = 2;
+        rgblight_effect_alternating(&anim);
+    }
+    EXPECT_EQ(ws2812_mock_writes, 1);
+    EXPECT_TRUE(strip_matches_buffer());
+}
+
+TEST_F(RgblightFrames, StalledTaskCatchesUp) {
+    // Run every millisecond
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_RAINBOW_MOOD);
+    rgblight_task();
+    for (int ms = 0; ms < 1319; ms++) {
+        advance_time(1);
+        rgblight_task();
+    }
+    int8_t   hue = animation_status.current_hue;
+    LED_TYPE frame[RGBLED_NUM];
+    memcpy(frame, led, sizeof(led));
+
+    // Stall for most of the same time span, the effect is back in step on the frame after the stall
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_STATIC_LIGHT);
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_RAINBOW_MOOD);
+    rgblight_task();
+    advance_time(1199);
+    rgblight_task();
+    EXPECT_EQ(animation_status.current_hue, (int8_t)(hue - 1));
+    advance_time(120);
+    rgblight_task();
+
+    EXPECT_EQ(animation_status.current_hue, hue);
+    EXPECT_EQ(memcmp(frame, led, sizeof(led)), 0);
+    EXPECT_TRUE(strip_matches_buffer());
+}
@@ -0,0 +1,18 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Stands in for the WS2812 driver, keeping what a real strip would be showing
+
+#include <string.h>
+#include "ws2812.h"
+
+LED_TYPE ws2812_mock_strip[RGBLED_NUM];
+uint32_t ws2812_mock_writes;
+uint32_t ws2812_mock_leds_written;
+
+void ws2812_setleds(LED_TYPE *ledarray, uint16_t number_of_leds) {
+    // LEDs past the end of the data keep their color
+    memcpy(ws2812_mock_strip, ledarray, number_of_leds * sizeof(LED_TYPE));
+    ws2812_mock_writes++;
+    ws2812_mock_leds_written += number_of_leds;
+}
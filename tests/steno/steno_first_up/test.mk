@@ -0,0 +1,7 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+STENO_ENABLE = yes
+STENO_PROTOCOL = geminipr
+
+SRC += tests/steno/virtser_mock.cpp
@@ -0,0 +1,88 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+#include "keymap_steno.h"
+#include "../virtser_mock.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::ElementsAre;
+
+class StenoFirstUp : public TestFixture {
+   public:
+    KeymapKey key_w = KeymapKey(0, 0, 0, STN_WL);
+    KeymapKey key_a = KeymapKey(0, 1, 0, STN_A);
+    KeymapKey key_z = KeymapKey(0, 2, 0, STN_ZR);
+
+    void SetUp() override {
+        MockVirtser::Instance().reset();
+        set_keymap({key_w, key_a, key_z});
+    }
+};
+
+TEST_F(StenoFirstUp, ChordIsSentWhenTheFirstKeyIsReleased) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    auto &port = MockVirtser::Instance();
+
+    key_w.press();
+    run_one_scan_loop();
+    key_a.press();
+    run_one_scan_loop();
+    key_w.release();
+    run_one_scan_loop();
+    EXPECT_THAT(port.received, ElementsAre(0x80, 0x02, 0x20, 0x00, 0x00, 0x00));
+
+    // Releasing the rest of the chord doesn't send it again
+    key_a.release();
+    run_one_scan_loop();
+    EXPECT_EQ(port.received.size(), GEMINI_STROKE_SIZE);
+}
+
+TEST_F(StenoFirstUp, HeldKeysCarryOverToTheNextChord) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    auto &port = MockVirtser::Instance();
+
+    key_a.press();
+    run_one_scan_loop();
+    key_w.press();
+    run_one_scan_loop();
+    key_w.release();
+    run_one_scan_loop();
+
+    // A is still held, so it is part of the next chord too
+    key_z.press();
+    run_one_scan_loop();
+    key_z.release();
+    run_one_scan_loop();
+    key_a.release();
+    run_one_scan_loop();
+
+    EXPECT_THAT(port.received, ElementsAre(0x80, 0x02, 0x20, 0x00, 0x00, 0x00, 0x80, 0x00, 0x20, 0x00, 0x00, 0x01));
+}
+
+TEST_F(StenoFirstUp, ReleasedKeysLeaveTheNextChord) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    auto &port = MockVirtser::Instance();
+
+    key_w.press();
+    run_one_scan_loop();
+    key_a.press();
+    run_one_scan_loop();
+    key_w.release();
+    run_one_scan_loop();
+
+    // A was carried over, but is released before any other key is pressed
+    key_a.release();
+    run_one_scan_loop();
+    key_z.press();
+    run_one_scan_loop();
+    key_z.release();
+    run_one_scan_loop();
+
+    EXPECT_THAT(port.received, ElementsAre(0x80, 0x02, 0x20, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x01));
+}
@@ -0,0 +1,126 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+#include "keymap_steno.h"
+#include "virtser_mock.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::ElementsAre;
+
+static uint16_t chord_duration;
+
+extern "C" bool send_steno_chord_user(steno_mode_t mode, uint8_t chord[MAX_STROKE_SIZE]) {
+    chord_duration = steno_chord_end_time() - steno_chord_start_time();
+    return true;
+}
+
+class Steno : public TestFixture {
+   public:
+    KeymapKey key_w = KeymapKey(0, 0, 0, STN_WL);
+    KeymapKey key_a = KeymapKey(0, 1, 0, STN_A);
+    KeymapKey key_z = KeymapKey(0, 2, 0, STN_ZR);
+
+    void SetUp() override {
+        MockVirtser::Instance().reset();
+        steno_set_mode(STENO_MODE_GEMINI);
+        set_keymap({key_w, key_a, key_z});
+    }
+};
+
+TEST_F(Steno, SendsGeminiChord) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    tap_combo({key_w, key_a, key_z});
+
+    EXPECT_THAT(MockVirtser::Instance().received, ElementsAre(0x80, 0x02, 0x20, 0x00, 0x00, 0x01));
+}
+
+TEST_F(Steno, SendsBoltChord) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    steno_set_mode(STENO_MODE_BOLT);
+    tap_combo({key_w, key_a, key_z});
+
+    EXPECT_THAT(MockVirtser::Instance().received, ElementsAre(0x10, 0x42, 0xC8, 0x00));
+}
+
+TEST_F(Steno, ChordIsSentWhenAllKeysAreReleased) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    key_w.press();
+    run_one_scan_loop();
+    key_a.press();
+    run_one_scan_loop();
+    key_w.release();
+    run_one_scan_loop();
+    EXPECT_TRUE(MockVirtser::Instance().received.empty());
+
+    idle_for(20);
+    key_a.release();
+    run_one_scan_loop();
+    EXPECT_THAT(MockVirtser::Instance().received, ElementsAre(0x80, 0x02, 0x20, 0x00, 0x00, 0x00));
+    EXPECT_EQ(chord_duration, 22);
+}
+
+TEST_F(Steno, ChordsAreQueuedWhileThePortIsBusy) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    auto &port = MockVirtser::Instance();
+
+    port.busy = true;
+    for (int i = 0; i < 4; i++) {
+        tap_combo({key_w, key_a, key_z});
+    }
+    EXPECT_TRUE(port.received.empty());
+
+    // The queued chords go out together
+    port.busy = false;
+    run_one_scan_loop();
+    EXPECT_EQ(port.calls, 1);
+    ASSERT_EQ(port.received.size(), 4 * GEMINI_STROKE_SIZE);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(port.received[i * GEMINI_STROKE_SIZE], 0x80);
+    }
+}
+
+TEST_F(Steno, ChordThroughput) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    auto &port = MockVirtser::Instance();
+
+    // Full speed USB serial, a 64 byte packet every scan at most, from a writer well above 200 WPM:
+    // a stroke every 40ms, with the next stroke starting before the last one is fully released.
+    const unsigned chords = 1000;
+    port.packet_size      = 64;
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < chords; i++) {
+        key_w.press();
+        run_one_scan_loop();
+        key_a.press();
+        run_one_scan_loop();
+        key_z.press();
+        idle_for(30);
+        key_w.release();
+        key_a.release();
+        run_one_scan_loop();
+        key_z.release();
+        idle_for(8);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    ASSERT_EQ(port.received.size(), chords * GEMINI_STROKE_SIZE);
+    for (unsigned i = 0; i < chords; i++) {
+        ASSERT_EQ(port.received[i * GEMINI_STROKE_SIZE], 0x80) << "chord " << i;
+    }
+    RecordProperty("ns_per_chord", std::to_string(elapsed / chords));
+}
@@ -0,0 +1,25 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include "virtser_mock.hpp"
+
+extern "C" {
+
+void virtser_init(void) {}
+
+void virtser_send(const uint8_t byte) {
+    MockVirtser::Instance().received.push_back(byte);
+}
+
+uint8_t virtser_send_buffer(const uint8_t *data, uint8_t length) {
+    auto &inst = MockVirtser::Instance();
+    if (inst.busy) {
+        return 0;
+    }
+    uint8_t sent = std::min(length, inst.packet_size);
+    inst.received.insert(inst.received.end(), data, data + sent);
+    inst.calls++;
+    return sent;
+}
+}
@@ -0,0 +1,25 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Records what is sent over the virtual serial port, taking at most `packet_size` bytes per call
+// to stand in for the USB endpoint, and nothing at all while `busy`.
+struct MockVirtser {
+    std::vector<uint8_t> received;
+    unsigned             calls       = 0;
+    uint8_t              packet_size = 64;
+    bool                 busy        = false;
+
+    static MockVirtser& Instance() {
+        static MockVirtser instance;
+        return instance;
+    }
+
+    void reset() {
+        *this = MockVirtser();
+    }
+};
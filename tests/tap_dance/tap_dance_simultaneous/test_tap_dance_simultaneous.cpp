@@ -0,0 +1,164 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_keymap_key.hpp"
+#include "tap_dance_defs.h"
+
+using testing::_;
+using testing::InSequence;
+
+class TapDanceSimultaneous : public TestFixture {
+   protected:
+    KeymapKey key_ab{0, 1, 0, TD(TD_A_B)};
+    KeymapKey key_cd{0, 2, 0, TD(TD_C_D)};
+    KeymapKey key_ef{0, 3, 0, TD(TD_E_F)};
+    KeymapKey key_g{0, 4, 0, KC_G};
+
+    void SetUp() override {
+        set_keymap({key_ab, key_cd, key_ef, key_g});
+        tap_dance_clear_latency();
+    }
+};
+
+TEST_F(TapDanceSimultaneous, SecondDanceDoesNotInterruptFirst) {
+    TestDriver driver;
+    InSequence s;
+
+    /* Neither dance is decided by the other one */
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_ab);
+    tap_key(key_cd);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Both time out in the order they were started */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAPPING_TERM);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(TapDanceSimultaneous, RepeatedTapDecidesEarlierDances) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_ab);
+    tap_key(key_cd);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* The double tap registers right away, so the dance started before it goes first */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_D));
+    key_cd.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_cd.release();
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(TapDanceSimultaneous, HeldDanceIsNotInterruptedByAnotherDance) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_NO_REPORT(driver);
+    key_ab.press();
+    run_one_scan_loop();
+    tap_key(key_cd);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* The held dance finishes first and stays registered */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_C));
+    EXPECT_REPORT(driver, (KC_A));
+    idle_for(TAPPING_TERM);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_ab.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(TapDanceSimultaneous, OtherKeyInterruptsAllDances) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_ab);
+    tap_key(key_cd);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_G));
+    key_g.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_g.release();
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(TapDanceSimultaneous, FullPoolInterruptsOldestDance) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_ab);
+    tap_key(key_cd);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* A third dance needs a slot, so the first one is decided */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_ef);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_E));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAPPING_TERM);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(TapDanceSimultaneous, ReportsResolutionLatency) {
+    TestDriver driver;
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_REPORT(driver, (KC_G));
+    EXPECT_EMPTY_REPORT(driver).Times(3);
+
+    /* Timed out dance */
+    tap_key(key_ab);
+    idle_for(TAPPING_TERM);
+    tap_dance_latency_t latency = tap_dance_get_latency();
+    EXPECT_EQ(latency.count, 1);
+    EXPECT_EQ(latency.last, TAPPING_TERM + 1);
+    EXPECT_EQ(latency.max, TAPPING_TERM + 1);
+
+    /* Interrupted dance */
+    tap_key(key_cd, 5);
+    tap_key(key_g);
+    latency = tap_dance_get_latency();
+    EXPECT_EQ(latency.count, 2);
+    EXPECT_EQ(latency.last, 6);
+    EXPECT_EQ(latency.max, TAPPING_TERM + 1);
+}
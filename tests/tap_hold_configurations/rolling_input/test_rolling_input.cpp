@@ -0,0 +1,206 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+#include "timer.h"
+
+using testing::_;
+
+struct RollStroke {
+    KeymapKey* key;
+    uint8_t    tap_keycode;
+    uint32_t   press_time;
+    uint32_t   release_time;
+};
+
+class RollingInput : public TestFixture {
+   protected:
+    KeymapKey key_f{0, 1, 0, LSFT_T(KC_F)};
+    KeymapKey key_d{0, 2, 0, LCTL_T(KC_D)};
+    KeymapKey key_j{0, 7, 0, RSFT_T(KC_J)};
+    KeymapKey key_k{0, 8, 0, RCTL_T(KC_K)};
+    KeymapKey key_e{0, 3, 1, KC_E};
+
+    struct SentReport {
+        uint32_t          time;
+        report_keyboard_t report;
+    };
+
+    std::vector<SentReport> reports;
+
+    void SetUp() override {
+        set_keymap({key_f, key_d, key_j, key_k, key_e});
+    }
+
+    /* Replays the strokes one millisecond per scan and records every report along with the time it was sent. */
+    void replay(TestDriver& driver, std::vector<RollStroke>& strokes) {
+        uint32_t start = timer_read32();
+        uint32_t end   = 0;
+
+        reports.clear();
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly([this](report_keyboard_t& report) {
+            reports.push_back({timer_read32(), report});
+        });
+
+        for (auto& stroke : strokes) {
+            stroke.press_time += start;
+            stroke.release_time += start;
+            end = std::max(end, stroke.release_time);
+        }
+        for (uint32_t now = start; now <= end + TAPPING_TERM; now = timer_read32()) {
+            for (auto& stroke : strokes) {
+                if (stroke.press_time == now) stroke.key->press();
+                if (stroke.release_time == now) stroke.key->release();
+            }
+            run_one_scan_loop();
+        }
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+
+    /* Time of the first report that carries the tap keycode, or 0 if there is none. */
+    uint32_t tap_time(uint8_t keycode) {
+        for (auto& sent : reports) {
+            for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+                if (sent.report.keys[i] == keycode) return sent.time;
+            }
+        }
+        return 0;
+    }
+
+    /* Tap keycodes in the order they were first reported. */
+    std::vector<uint8_t> typed() {
+        std::vector<uint8_t> keycodes;
+        for (auto& sent : reports) {
+            for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+                uint8_t keycode = sent.report.keys[i];
+                if (keycode != KC_NO && std::find(keycodes.begin(), keycodes.end(), keycode) == keycodes.end()) {
+                    keycodes.push_back(keycode);
+                }
+            }
+        }
+        return keycodes;
+    }
+};
+
+TEST_F(RollingInput, home_row_rolls_on_both_hands_are_taps_in_order) {
+    TestDriver driver;
+
+    /* Fast typing: every key overlaps the next one, all of them are released within TAPPING_TERM. */
+    std::vector<RollStroke> strokes;
+    const uint8_t           order[] = {0, 2, 1, 3, 0, 3, 2, 1};
+    KeymapKey*              keys[]  = {&key_f, &key_d, &key_j, &key_k};
+    const uint8_t           taps[]  = {KC_F, KC_D, KC_J, KC_K};
+    for (uint8_t i = 0; i < sizeof(order); i++) {
+        uint32_t press = 60 * i;
+        strokes.push_back({keys[order[i]], taps[order[i]], press, press + 85});
+    }
+
+    replay(driver, strokes);
+
+    std::vector<uint8_t> expected;
+    for (auto& stroke : strokes) {
+        if (std::find(expected.begin(), expected.end(), stroke.tap_keycode) == expected.end()) {
+            expected.push_back(stroke.tap_keycode);
+        }
+    }
+    EXPECT_EQ(typed(), expected);
+    EXPECT_FALSE(reports.empty());
+    EXPECT_EQ(reports.back().report.mods, 0);
+}
+
+TEST_F(RollingInput, decision_latency_under_rolling_input) {
+    TestDriver driver;
+
+    /* Alternate hands with increasing overlap between strokes, up to three keys down at once. */
+    std::vector<RollStroke> strokes;
+    KeymapKey*              keys[] = {&key_f, &key_j, &key_d, &key_k};
+    const uint8_t           taps[] = {KC_F, KC_J, KC_D, KC_K};
+    for (uint8_t i = 0; i < 4; i++) {
+        uint32_t press = 25 * i;
+        strokes.push_back({keys[i], taps[i], press, press + 40 + 15 * i});
+    }
+
+    replay(driver, strokes);
+
+    /* Every key is settled as a tap no later than the scan after its release, which is the earliest a tap can be
+     * told apart from a hold. */
+    uint32_t max_latency = 0;
+    for (auto& stroke : strokes) {
+        uint32_t decided = tap_time(stroke.tap_keycode);
+        ASSERT_NE(decided, 0u) << "tap of keycode " << (int)stroke.tap_keycode << " not sent";
+        EXPECT_GE(decided, stroke.release_time);
+        max_latency = std::max(max_latency, decided - stroke.release_time);
+    }
+    RecordProperty("max_decision_latency_ms", max_latency);
+    EXPECT_LE(max_latency, 1u);
+}
+
+TEST_F(RollingInput, decision_latency_of_held_mod_with_rolled_keys) {
+    TestDriver driver;
+
+    /* Hold a mod on the left hand while rolling over regular keys, the hold is decided exactly at TAPPING_TERM. */
+    std::vector<RollStroke> strokes = {
+        {&key_f, KC_F, 0, TAPPING_TERM + 50},
+        {&key_e, KC_E, 20, 50},
+    };
+
+    replay(driver, strokes);
+
+    uint32_t start = strokes[0].press_time;
+    ASSERT_FALSE(reports.empty());
+    EXPECT_EQ(reports.front().report.mods, MOD_BIT(KC_LSFT));
+    // event timestamps are rounded up to odd values, so the hold can settle one scan early
+    EXPECT_GE(reports.front().time - start, (uint32_t)TAPPING_TERM - 1);
+    EXPECT_LE(reports.front().time - start, (uint32_t)TAPPING_TERM);
+    EXPECT_EQ(tap_time(KC_E), reports.front().time);
+    EXPECT_EQ(tap_time(KC_F), 0u);
+}
+
+TEST_F(RollingInput, concurrent_holds_on_both_hands_are_decided_at_their_own_tapping_term) {
+    TestDriver driver;
+
+    /* A mod held on each hand, the second one pressed while the first is still undecided. */
+    std::vector<RollStroke> strokes = {
+        {&key_f, KC_F, 0, TAPPING_TERM + 150},
+        {&key_j, KC_J, 60, TAPPING_TERM + 150},
+    };
+
+    replay(driver, strokes);
+
+    uint32_t left_hold = 0, both_held = 0;
+    for (auto& sent : reports) {
+        if (!left_hold && sent.report.mods == MOD_BIT(KC_LSFT)) left_hold = sent.time;
+        if (!both_held && sent.report.mods == (MOD_BIT(KC_LSFT) | MOD_BIT(KC_RSFT))) both_held = sent.time;
+    }
+    ASSERT_NE(left_hold, 0u);
+    ASSERT_NE(both_held, 0u);
+    // event timestamps are rounded up to odd values, so each hold can settle one scan early
+    EXPECT_GE(left_hold - strokes[0].press_time, (uint32_t)TAPPING_TERM - 1);
+    EXPECT_LE(left_hold - strokes[0].press_time, (uint32_t)TAPPING_TERM);
+    EXPECT_GE(both_held - strokes[1].press_time, (uint32_t)TAPPING_TERM - 1);
+    EXPECT_LE(both_held - strokes[1].press_time, (uint32_t)TAPPING_TERM);
+    EXPECT_EQ(tap_time(KC_F), 0u);
+    EXPECT_EQ(tap_time(KC_J), 0u);
+    EXPECT_EQ(reports.back().report.mods, 0);
+}
@@ -0,0 +1,153 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+extern "C" {
+#include "unicode.h"
+#include "raw_hid.h"
+}
+
+using testing::_;
+
+extern "C" void advance_time(uint32_t ms);
+
+// RAW_EPSIZE of the USB protocols
+static const uint8_t report_size = 32;
+// UNICODE_HOST_HELPER_ID and UNICODE_HOST_HELPER_TIMEOUT
+static const uint8_t  helper_id      = 0x55;
+static const uint32_t helper_timeout = 2000;
+
+typedef std::array<uint8_t, report_size> raw_report_t;
+
+static std::vector<raw_report_t> sent;
+
+extern "C" void raw_hid_send(uint8_t *data, uint8_t length) {
+    raw_report_t report = {};
+    std::copy(data, data + length, report.begin());
+    sent.push_back(report);
+}
+
+extern "C" void raw_hid_receive(uint8_t *data, uint8_t length) {}
+
+class Unicode : public TestFixture {
+   public:
+    std::vector<report_keyboard_t> reports;
+
+    void SetUp() override {
+        // Forget about the helper
+        advance_time(helper_timeout);
+        sent.clear();
+    }
+
+    void record(TestDriver &driver) {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly([this](report_keyboard_t &report) { reports.push_back(report); });
+    }
+
+    void hello(void) {
+        raw_report_t report = {helper_id, UNICODE_HOST_HELLO};
+        raw_hid_dispatch(report.data(), report.size());
+    }
+
+    size_t count_key(uint8_t key) {
+        size_t count = 0;
+        for (const report_keyboard_t &report : reports) {
+            count += std::count(std::begin(report.keys), std::end(report.keys), key);
+        }
+        return count;
+    }
+};
+
+TEST_F(Unicode, MacosTypesAStringInOneInputSequence) {
+    TestDriver driver;
+    record(driver);
+    set_unicode_input_mode(UNICODE_MODE_MACOS);
+
+    send_unicode_string("ab€");
+
+    ASSERT_GT(reports.size(), 2);
+    // Option is held throughout, and released at the end
+    for (size_t i = 0; i < reports.size() - 1; i++) {
+        EXPECT_TRUE(reports[i].mods & MOD_BIT(KC_LEFT_ALT)) << "report " << i;
+    }
+    EXPECT_EQ(reports.back(), report_keyboard_t{});
+    // 0061 0062 20AC
+    EXPECT_EQ(count_key(KC_0), 5);
+    EXPECT_EQ(count_key(KC_6), 2);
+    EXPECT_EQ(count_key(KC_A), 1);
+    EXPECT_TRUE(sent.empty());
+}
+
+TEST_F(Unicode, LinuxFinishesEachCodePoint) {
+    TestDriver driver;
+    record(driver);
+    set_unicode_input_mode(UNICODE_MODE_LINUX);
+
+    send_unicode_string("ab€");
+
+    EXPECT_EQ(count_key(KC_U), 3);
+    EXPECT_EQ(count_key(KC_SPACE), 3);
+    EXPECT_TRUE(sent.empty());
+}
+
+TEST_F(Unicode, HostHelperGetsUtf8) {
+    TestDriver driver;
+    EXPECT_NO_REPORT(driver);
+
+    hello();
+    ASSERT_EQ(sent.size(), 1);
+    EXPECT_EQ(sent[0][0], helper_id);
+    EXPECT_EQ(sent[0][1], UNICODE_HOST_HELLO);
+    ASSERT_TRUE(unicode_host_helper_active());
+
+    std::string text;
+    for (int i = 0; i < 20; i++) {
+        text += "😀";
+    }
+    sent.clear();
+    send_unicode_string(text.c_str());
+
+    // 80 bytes, split over reports without regard for code points
+    const uint8_t chunk = report_size - UNICODE_HOST_HEADER_SIZE;
+    ASSERT_EQ(sent.size(), (text.size() + chunk - 1) / chunk);
+    std::string received;
+    for (size_t i = 0; i < sent.size(); i++) {
+        EXPECT_EQ(sent[i][0], helper_id);
+        EXPECT_EQ(sent[i][1], UNICODE_HOST_TEXT);
+        EXPECT_EQ((bool)(sent[i][2] & UNICODE_HOST_MORE), i < sent.size() - 1);
+        uint8_t size = sent[i][2] & ~UNICODE_HOST_MORE;
+        received.append(sent[i].begin() + UNICODE_HOST_HEADER_SIZE, sent[i].begin() + UNICODE_HOST_HEADER_SIZE + size);
+    }
+    EXPECT_EQ(received, text);
+
+    // Single code points, beyond what the input mode could type
+    set_unicode_input_mode(UNICODE_MODE_WINDOWS);
+    sent.clear();
+    register_unicode(0x1F600);
+    ASSERT_EQ(sent.size(), 1);
+    EXPECT_EQ(sent[0][2], 4);
+    EXPECT_EQ(std::string(sent[0].begin() + UNICODE_HOST_HEADER_SIZE, sent[0].begin() + UNICODE_HOST_HEADER_SIZE + 4), "😀");
+}
+
+TEST_F(Unicode, HexInputWhenTheHelperStops) {
+    TestDriver driver;
+    record(driver);
+    set_unicode_input_mode(UNICODE_MODE_LINUX);
+
+    hello();
+    idle_for(helper_timeout / 2);
+    EXPECT_TRUE(unicode_host_helper_active());
+    idle_for(helper_timeout / 2);
+    EXPECT_FALSE(unicode_host_helper_active());
+
+    sent.clear();
+    register_unicode(0x20AC);
+    EXPECT_TRUE(sent.empty());
+    EXPECT_EQ(count_key(KC_SPACE), 1);
+}
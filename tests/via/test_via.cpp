@@ -0,0 +1,276 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "via.h"
+#include "raw_hid.h"
+#include "dynamic_keymap.h"
+#include "eeprom.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+// RAW_EPSIZE of the USB protocols
+static const uint8_t report_size = 32;
+
+typedef std::array<uint8_t, report_size> report_t;
+
+static std::vector<report_t> sent;
+
+extern "C" void raw_hid_send(uint8_t *data, uint8_t length) {
+    report_t report = {};
+    std::copy(data, data + length, report.begin());
+    sent.push_back(report);
+}
+
+static uint16_t crc16(const uint8_t *data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+class Via : public TestFixture {
+   public:
+    const uint16_t keymap_size  = dynamic_keymap_get_layer_count() * MATRIX_ROWS * MATRIX_COLS * 2;
+    const uint8_t  stream_chunk = report_size - VIA_STREAM_HEADER_SIZE;
+
+    void SetUp() override {
+        dynamic_keymap_reset();
+        eeconfig_deferred_flush();
+        sent.clear();
+    }
+
+    // Kept for deferred commands, as the USB protocols do
+    report_t buffer;
+
+    void receive(report_t report) {
+        buffer = report;
+        raw_hid_dispatch(buffer.data(), buffer.size());
+    }
+
+    std::vector<uint8_t> keymap(void) {
+        std::vector<uint8_t> buffer(keymap_size);
+        dynamic_keymap_get_buffer(0, buffer.size(), buffer.data());
+        return buffer;
+    }
+
+    report_t write_report(uint8_t seq, uint16_t offset, const std::vector<uint8_t> &data) {
+        report_t report = {id_dynamic_keymap_stream_set_buffer, seq, (uint8_t)(offset >> 8), (uint8_t)(offset & 0xFF), (uint8_t)data.size()};
+        std::copy(data.begin(), data.end(), report.begin() + VIA_STREAM_HEADER_SIZE);
+        return report;
+    }
+};
+
+TEST_F(Via, StreamReadsTheKeymap) {
+    dynamic_keymap_set_keycode(0, 0, 0, KC_A);
+    dynamic_keymap_set_keycode(3, MATRIX_ROWS - 1, MATRIX_COLS - 1, KC_Z);
+
+    std::vector<uint8_t> received;
+    unsigned             requests = 0;
+    while (received.size() < keymap_size) {
+        uint16_t offset = received.size();
+        sent.clear();
+        receive({id_dynamic_keymap_stream_get_buffer, VIA_STREAM_WINDOW_SIZE, (uint8_t)(offset >> 8), (uint8_t)(offset & 0xFF)});
+        requests++;
+
+        ASSERT_EQ(sent.size(), VIA_STREAM_WINDOW_SIZE);
+        for (uint8_t seq = 0; seq < sent.size(); seq++) {
+            const report_t &report = sent[seq];
+            EXPECT_EQ(report[0], id_dynamic_keymap_stream_get_buffer);
+            EXPECT_EQ(report[1], seq);
+            EXPECT_EQ((report[2] << 8) | report[3], offset + seq * stream_chunk);
+            received.insert(received.end(), report.begin() + VIA_STREAM_HEADER_SIZE, report.begin() + VIA_STREAM_HEADER_SIZE + report[4]);
+        }
+    }
+
+    EXPECT_EQ(received, keymap());
+    EXPECT_EQ((received[0] << 8) | received[1], KC_A);
+    EXPECT_EQ((received[keymap_size - 2] << 8) | received[keymap_size - 1], KC_Z);
+    // The legacy command moves 28 bytes per round trip
+    RecordProperty("stream_requests", std::to_string(requests));
+    RecordProperty("get_buffer_requests", std::to_string((keymap_size + 27) / 28));
+}
+
+TEST_F(Via, StreamReadPastTheEndIsEmpty) {
+    receive({id_dynamic_keymap_stream_get_buffer, 2, (uint8_t)(keymap_size >> 8), (uint8_t)(keymap_size & 0xFF)});
+
+    ASSERT_EQ(sent.size(), 2);
+    for (const report_t &report : sent) {
+        EXPECT_EQ(report[4], 0);
+        EXPECT_TRUE(std::all_of(report.begin() + VIA_STREAM_HEADER_SIZE, report.end(), [](uint8_t b) { return b == 0; }));
+    }
+}
+
+TEST_F(Via, LayerCrcs) {
+    receive({id_dynamic_keymap_get_layer_crcs, 0});
+    ASSERT_EQ(sent.size(), 1);
+    report_t before = sent[0];
+    ASSERT_EQ(before[2], dynamic_keymap_get_layer_count());
+
+    std::vector<uint8_t> buffer = keymap();
+    size_t               layer  = MATRIX_ROWS * MATRIX_COLS * 2;
+    for (uint8_t i = 0; i < dynamic_keymap_get_layer_count(); i++) {
+        EXPECT_EQ((before[3 + i * 2] << 8) | before[4 + i * 2], crc16(&buffer[i * layer], layer)) << "layer " << +i;
+    }
+
+    // Only the layer which changed has a different CRC
+    dynamic_keymap_set_keycode(2, 1, 1, KC_B);
+    receive({id_dynamic_keymap_get_layer_crcs, 0});
+    ASSERT_EQ(sent.size(), 2);
+    for (uint8_t i = 0; i < dynamic_keymap_get_layer_count(); i++) {
+        bool same = sent[1][3 + i * 2] == before[3 + i * 2] && sent[1][4 + i * 2] == before[4 + i * 2];
+        EXPECT_EQ(same, i != 2) << "layer " << +i;
+    }
+
+    // Starting from a later layer
+    receive({id_dynamic_keymap_get_layer_crcs, 3});
+    ASSERT_EQ(sent.size(), 3);
+    EXPECT_EQ(sent[2][2], 1);
+    EXPECT_EQ(sent[2][3], before[3 + 3 * 2]);
+    EXPECT_EQ(sent[2][4], before[4 + 3 * 2]);
+}
+
+TEST_F(Via, StreamWriteOnlyAcknowledgesTheWindow) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    std::vector<uint8_t> data(stream_chunk * 3);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = i;
+    }
+
+    for (uint8_t seq = 0; seq < 3; seq++) {
+        std::vector<uint8_t> chunk(data.begin() + seq * stream_chunk, data.begin() + (seq + 1) * stream_chunk);
+        receive(write_report(seq | (seq == 2 ? VIA_STREAM_LAST_REPORT : 0), 10 + seq * stream_chunk, chunk));
+    }
+
+    ASSERT_EQ(sent.size(), 1);
+    EXPECT_EQ(sent[0][0], id_dynamic_keymap_stream_set_buffer);
+    EXPECT_EQ(sent[0][1], id_stream_ok);
+    EXPECT_EQ(sent[0][2], 3);
+
+    std::vector<uint8_t> buffer = keymap();
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), buffer.begin() + 10));
+
+    // The EEPROM is written once the writes settle
+    uint8_t *eeprom = (uint8_t *)dynamic_keymap_key_to_eeprom_address(0, 0, 0) + 10;
+    idle_for(EECONFIG_DEFERRED_FLUSH_MS + 10);
+    for (size_t i = 0; i < data.size(); i++) {
+        ASSERT_EQ(eeprom_read_byte(eeprom + i), data[i]) << "byte " << i;
+    }
+}
+
+TEST_F(Via, StreamWriteOutOfSequence) {
+    std::vector<uint8_t> ones(stream_chunk, 0x11), twos(stream_chunk, 0x22), threes(stream_chunk, 0x33);
+
+    receive(write_report(0, 0, ones));
+    receive(write_report(2, 2 * stream_chunk, threes));
+    ASSERT_EQ(sent.size(), 1);
+    EXPECT_EQ(sent[0][1], id_stream_out_of_sequence);
+    EXPECT_EQ(sent[0][2], 1);
+
+    // The rest of the window is dropped without replying again
+    receive(write_report(3 | VIA_STREAM_LAST_REPORT, 3 * stream_chunk, threes));
+    EXPECT_EQ(sent.size(), 1);
+    std::vector<uint8_t> buffer = keymap();
+    EXPECT_EQ(buffer[2 * stream_chunk], 0);
+
+    // Until the window is sent again
+    receive(write_report(0, 0, ones));
+    receive(write_report(1, stream_chunk, twos));
+    receive(write_report(2 | VIA_STREAM_LAST_REPORT, 2 * stream_chunk, threes));
+    ASSERT_EQ(sent.size(), 2);
+    EXPECT_EQ(sent[1][1], id_stream_ok);
+    EXPECT_EQ(sent[1][2], 3);
+    buffer = keymap();
+    EXPECT_EQ(buffer[0], 0x11);
+    EXPECT_EQ(buffer[stream_chunk], 0x22);
+    EXPECT_EQ(buffer[2 * stream_chunk], 0x33);
+}
+
+TEST_F(Via, GetBufferReadsTheMirror) {
+    dynamic_keymap_set_keycode(1, 0, 2, KC_C);
+    uint16_t offset = (MATRIX_ROWS * MATRIX_COLS + 2) * 2;
+    receive({id_dynamic_keymap_get_buffer, (uint8_t)(offset >> 8), (uint8_t)(offset & 0xFF), 2});
+
+    ASSERT_EQ(sent.size(), 1);
+    EXPECT_EQ((sent[0][4] << 8) | sent[0][5], KC_C);
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 0, 2), KC_C);
+}
+
+TEST_F(Via, UnknownCommandIsUnhandled) {
+    receive({0x7F, 1, 2, 3});
+    ASSERT_EQ(sent.size(), 1);
+    EXPECT_EQ(sent[0][0], id_unhandled);
+    EXPECT_EQ(sent[0][1], 1);
+}
+
+TEST_F(Via, DynamicKeymapResetIsDeferred) {
+    dynamic_keymap_set_keycode(0, 0, 0, KC_A);
+    dynamic_keymap_set_keycode(3, 0, 0, KC_B);
+
+    receive({id_dynamic_keymap_reset});
+    EXPECT_TRUE(sent.empty());
+
+    // A layer is reset per task, and nothing else is read until the reply is sent
+    unsigned tasks = 1;
+    while (!raw_hid_ready()) {
+        EXPECT_TRUE(sent.empty());
+        ASSERT_LT(tasks++, 10);
+    }
+    EXPECT_EQ(tasks, dynamic_keymap_get_layer_count());
+    ASSERT_EQ(sent.size(), 1);
+    EXPECT_EQ(sent[0][0], id_dynamic_keymap_reset);
+    EXPECT_NE(dynamic_keymap_get_keycode(0, 0, 0), KC_A);
+    EXPECT_EQ(dynamic_keymap_get_keycode(3, 0, 0), KC_TRANSPARENT);
+
+    EXPECT_TRUE(raw_hid_ready());
+    EXPECT_EQ(sent.size(), 1);
+}
+
+static bool echo_reversed(uint8_t *data, uint8_t length) {
+    std::reverse(data + 1, data + length);
+    return true;
+}
+
+static bool ignore(uint8_t *data, uint8_t length) {
+    return false;
+}
+
+static bool forward_to_via(uint8_t *data, uint8_t length) {
+    raw_hid_receive(data, length);
+    return false;
+}
+
+TEST_F(Via, RegisteredCommandsComeFirst) {
+    ASSERT_TRUE(raw_hid_register_command(0x80, echo_reversed));
+    receive({0x80, 1, 2});
+    ASSERT_EQ(sent.size(), 1);
+    EXPECT_EQ(sent[0][0], 0x80);
+    EXPECT_EQ(sent[0][report_size - 1], 1);
+    EXPECT_EQ(sent[0][report_size - 2], 2);
+
+    // Commands handled by VIA can be taken over
+    ASSERT_TRUE(raw_hid_register_command(id_get_protocol_version, ignore));
+    receive({id_get_protocol_version});
+    EXPECT_EQ(sent.size(), 1);
+
+    // And given back
+    ASSERT_TRUE(raw_hid_register_command(id_get_protocol_version, forward_to_via));
+    receive({id_get_protocol_version});
+    ASSERT_EQ(sent.size(), 2);
+    EXPECT_EQ((sent[1][1] << 8) | sent[1][2], VIA_PROTOCOL_VERSION);
+}
@@ -0,0 +1,7 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+// Normally generated by the build, VIA uses the date as its EEPROM magic
+#define QMK_BUILDDATE "2022-11-05-11:29:54"
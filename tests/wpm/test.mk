@@ -0,0 +1,4 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+WPM_ENABLE = yes
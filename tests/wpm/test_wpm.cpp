@@ -0,0 +1,130 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+
+using ::testing::_;
+using ::testing::AnyNumber;
+
+static int     wpm_changes;
+static uint8_t wpm_changed_to;
+static uint8_t wpm_changed_max;
+
+void wpm_changed_user(uint8_t wpm) {
+    wpm_changes++;
+    wpm_changed_to  = wpm;
+    wpm_changed_max = wpm > wpm_changed_max ? wpm : wpm_changed_max;
+}
+
+class Wpm : public TestFixture {
+   public:
+    void SetUp() override {
+        TestDriver driver;
+        // Let any previous typing fall out of the sample buffer
+        idle_for(WPM_SAMPLE_SECONDS * 2000);
+        ASSERT_EQ(get_current_wpm(), 0);
+        wpm_changes     = 0;
+        wpm_changed_max = 0;
+    }
+
+    // Taps the key every interval_ms, for duration_ms
+    void type(KeymapKey key, unsigned interval_ms, unsigned duration_ms) {
+        for (unsigned elapsed = 0; elapsed < duration_ms; elapsed += interval_ms) {
+            tap_key(key);
+            idle_for(interval_ms - 2);
+        }
+    }
+};
+
+TEST_F(Wpm, SteadyTyping) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    set_keymap({key_a});
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    // 10 characters a second is 120 WPM, with 5 characters per word
+    type(key_a, 100, 10000);
+    EXPECT_GE(get_current_wpm(), 110);
+    EXPECT_LE(get_current_wpm(), 125);
+
+    // Decays to zero once the typing is out of the sample buffer
+    idle_for(WPM_SAMPLE_SECONDS * 1000 / 2);
+    EXPECT_GT(get_current_wpm(), 0);
+    EXPECT_LT(get_current_wpm(), 110);
+    idle_for(WPM_SAMPLE_SECONDS * 1000);
+    EXPECT_EQ(get_current_wpm(), 0);
+}
+
+TEST_F(Wpm, IgnoredKeycodes) {
+    TestDriver driver;
+    auto       key_f1 = KeymapKey(0, 0, 0, KC_F1);
+    set_keymap({key_f1});
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    type(key_f1, 100, 5000);
+    EXPECT_EQ(get_current_wpm(), 0);
+    EXPECT_EQ(wpm_changes, 0);
+}
+
+TEST_F(Wpm, ChangeCallback) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    set_keymap({key_a});
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    type(key_a, 100, 3000);
+    EXPECT_GT(wpm_changes, 0);
+    EXPECT_EQ(wpm_changed_to, get_current_wpm());
+
+    // No further changes once it has settled at zero
+    idle_for(WPM_SAMPLE_SECONDS * 2000);
+    EXPECT_EQ(wpm_changed_to, 0);
+    int changes = wpm_changes;
+    idle_for(1000);
+    EXPECT_EQ(wpm_changes, changes);
+
+    set_current_wpm(42);
+    EXPECT_EQ(wpm_changed_to, 42);
+    EXPECT_EQ(wpm_changes, changes + 1);
+}
+
+TEST_F(Wpm, TypingAfterIdle) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    set_keymap({key_a});
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    idle_for(60000);
+
+    // Two key presses over the whole sample buffer are a handful of WPM, not a spike
+    tap_key(key_a);
+    tap_key(key_a);
+    idle_for(1000);
+    EXPECT_GT(wpm_changes, 0);
+    EXPECT_LE(wpm_changed_max, 10);
+    EXPECT_LE(get_current_wpm(), 10);
+}
+
+TEST_F(Wpm, BurstWpm) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    set_keymap({key_a});
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    EXPECT_EQ(get_burst_wpm(), 0);
+
+    // A short burst at 20 characters a second is 240 WPM, well before the averaged WPM catches up
+    type(key_a, 50, 8 * 50);
+    EXPECT_GE(get_burst_wpm(), 235);
+    EXPECT_LE(get_burst_wpm(), 245);
+    EXPECT_LT(get_current_wpm(), 120);
+
+    // Slower typing replaces the burst
+    type(key_a, 200, 8 * 200);
+    EXPECT_GE(get_burst_wpm(), 55);
+    EXPECT_LE(get_burst_wpm(), 65);
+
+    idle_for(WPM_SAMPLE_SECONDS * 1000 + 1);
+    EXPECT_EQ(get_burst_wpm(), 0);
+}
@@ -249,7 +249,7 @@ void main_subtask_usb_extra_device(void) {
 
 #ifdef RAW_ENABLE
 void main_subtask_raw(void) {
-    udi_hid_raw_receive_report();
+    raw_hid_task();
 }
 #endif
 
@@ -15,6 +15,7 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <string.h>
 #include "samd51j18a.h"
 #include "conf_usb.h"
 #include "udd.h"
@@ -104,9 +105,15 @@ void main_mou_disable(void) {
 #endif
 
 #ifdef RAW_ENABLE
-volatile bool main_b_raw_enable = false;
-bool          main_raw_enable(void) {
-    main_b_raw_enable = true;
+volatile bool        main_b_raw_enable = false;
+static volatile bool main_b_raw_received; // a report is waiting for raw_hid_task()
+static bool          main_b_raw_dispatched;
+static uint8_t       main_raw_report[UDI_HID_RAW_REPORT_SIZE];
+
+bool main_raw_enable(void) {
+    main_b_raw_received   = false;
+    main_b_raw_dispatched = false;
+    main_b_raw_enable     = true;
     return true;
 }
 
@@ -115,6 +122,35 @@ void main_raw_disable(void) {
 }
 
 void main_raw_receive(uint8_t *buffer, uint8_t len) {
-    raw_hid_receive(buffer, len);
+    // Called from the USB interrupt, the report is handled from the main loop in raw_hid_task()
+    memcpy(main_raw_report, buffer, len < sizeof(main_raw_report) ? len : sizeof(main_raw_report));
+    main_b_raw_received = true;
+}
+
+void raw_hid_task(void) {
+    static bool running = false;
+
+    // Also run while waiting to send keyboard reports, which a command may be doing
+    if (running || !main_b_raw_enable) {
+        return;
+    }
+    running = true;
+
+    if (main_b_raw_received) {
+        if (!main_b_raw_dispatched) {
+            raw_hid_dispatch(main_raw_report, sizeof(main_raw_report));
+            main_b_raw_dispatched = true;
+        }
+        // Further reports are left with the host until the command is finished
+        if (raw_hid_ready()) {
+            main_b_raw_dispatched = false;
+            main_b_raw_received   = false;
+        }
+    }
+    if (!main_b_raw_received) {
+        udi_hid_raw_receive_report();
+    }
+
+    running = false;
 }
 #endif
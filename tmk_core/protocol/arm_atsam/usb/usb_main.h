@@ -96,6 +96,7 @@ extern volatile bool main_b_raw_enable;
 bool                 main_raw_enable(void);
 void                 main_raw_disable(void);
 void                 main_raw_receive(uint8_t *buffer, uint8_t len);
+void                 raw_hid_task(void);
 #endif // RAW_ENABLE
 
 #endif // _MAIN_H_
@@ -27,6 +27,7 @@
 
 #include <ch.h>
 #include <hal.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "usb_main.h"
@@ -35,6 +36,9 @@
 #include "chibios_config.h"
 #include "debug.h"
 #include "suspend.h"
+#ifdef CONSOLE_BINARY_ENABLE
+#    include "binary_log.h"
+#endif
 #ifdef SLEEP_LED_ENABLE
 #    include "sleep_led.h"
 #    include "led.h"
@@ -43,6 +47,7 @@
 #include "usb_device_state.h"
 #include "usb_descriptor.h"
 #include "usb_driver.h"
+#include "usb_report_queue.h"
 
 #ifdef NKRO_ENABLE
 #    include "keycode_config.h"
@@ -50,6 +55,10 @@
 extern keymap_config_t keymap_config;
 #endif
 
+#ifdef RAW_ENABLE
+#    include "raw_hid.h"
+#endif
+
 /* ---------------------------------------------------------
  *       Global interface variables and declarations
  * ---------------------------------------------------------
@@ -120,24 +129,25 @@ static const USBDescriptor *usb_get_descriptor_cb(USBDriver *usbp, uint8_t dtype
         return &desc;
 }
 
-/*
- * USB notification callback that does nothing.  Needed to work around bugs in
- * some USB LLDs that fail to resume the waiting thread when the notification
- * callback pointer is NULL.
+/* ---------------------------------------------------------
+ *                   IN report queues
+ * ---------------------------------------------------------
  */
-static void dummy_usb_cb(USBDriver *usbp, usbep_t ep) {
-    (void)usbp;
-    (void)ep;
-}
+
+static usb_report_queue_stats_t report_queue_stats;
+
+static void usb_report_queue_in_cb(USBDriver *usbp, usbep_t ep);
 
 #ifndef KEYBOARD_SHARED_EP
 /* keyboard endpoint state structure */
 static USBInEndpointState kbd_ep_state;
+/* keyboard endpoint report queue */
+static usb_report_queue_t kbd_report_queue;
 /* keyboard endpoint initialization structure (IN) - see USBEndpointConfig comment at top of file */
 static const USBEndpointConfig kbd_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_queue_in_cb, /* IN notification callback */
     NULL,                   /* OUT notification callback */
     KEYBOARD_EPSIZE,        /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -150,12 +160,14 @@ static const USBEndpointConfig kbd_ep_config = {
 #if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
 /* mouse endpoint state structure */
 static USBInEndpointState mouse_ep_state;
+/* mouse endpoint report queue */
+static usb_report_queue_t mouse_report_queue;
 
 /* mouse endpoint initialization structure (IN) - see USBEndpointConfig comment at top of file */
 static const USBEndpointConfig mouse_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_queue_in_cb, /* IN notification callback */
     NULL,                   /* OUT notification callback */
     MOUSE_EPSIZE,           /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -168,12 +180,14 @@ static const USBEndpointConfig mouse_ep_config = {
 #ifdef SHARED_EP_ENABLE
 /* shared endpoint state structure */
 static USBInEndpointState shared_ep_state;
+/* shared endpoint report queue */
+static usb_report_queue_t shared_report_queue;
 
 /* shared endpoint initialization structure (IN) - see USBEndpointConfig comment at top of file */
 static const USBEndpointConfig shared_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_queue_in_cb, /* IN notification callback */
     NULL,                   /* OUT notification callback */
     SHARED_EPSIZE,          /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -186,12 +200,14 @@ static const USBEndpointConfig shared_ep_config = {
 #if defined(JOYSTICK_ENABLE) && !defined(JOYSTICK_SHARED_EP)
 /* joystick endpoint state structure */
 static USBInEndpointState joystick_ep_state;
+/* joystick endpoint report queue */
+static usb_report_queue_t joystick_report_queue;
 
 /* joystick endpoint initialization structure (IN) - see USBEndpointConfig comment at top of file */
 static const USBEndpointConfig joystick_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_queue_in_cb, /* IN notification callback */
     NULL,                   /* OUT notification callback */
     JOYSTICK_EPSIZE,        /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -204,12 +220,14 @@ static const USBEndpointConfig joystick_ep_config = {
 #if defined(DIGITIZER_ENABLE) && !defined(DIGITIZER_SHARED_EP)
 /* digitizer endpoint state structure */
 static USBInEndpointState digitizer_ep_state;
+/* digitizer endpoint report queue */
+static usb_report_queue_t digitizer_report_queue;
 
 /* digitizer endpoint initialization structure (IN) - see USBEndpointConfig comment at top of file */
 static const USBEndpointConfig digitizer_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_queue_in_cb, /* IN notification callback */
     NULL,                   /* OUT notification callback */
     DIGITIZER_EPSIZE,       /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -219,6 +237,116 @@ static const USBEndpointConfig digitizer_ep_config = {
 };
 #endif
 
+/* report queue of each interrupt IN endpoint, indexed by endpoint number */
+static usb_report_queue_t *const report_queues[USB_MAX_ENDPOINTS + 1] = {
+#ifndef KEYBOARD_SHARED_EP
+    [KEYBOARD_IN_EPNUM] = &kbd_report_queue,
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+    [MOUSE_IN_EPNUM] = &mouse_report_queue,
+#endif
+#ifdef SHARED_EP_ENABLE
+    [SHARED_IN_EPNUM] = &shared_report_queue,
+#endif
+#if defined(JOYSTICK_ENABLE) && !defined(JOYSTICK_SHARED_EP)
+    [JOYSTICK_IN_EPNUM] = &joystick_report_queue,
+#endif
+#if defined(DIGITIZER_ENABLE) && !defined(DIGITIZER_SHARED_EP)
+    [DIGITIZER_IN_EPNUM] = &digitizer_report_queue,
+#endif
+};
+
+/* Drops every waiting report and wakes up senders waiting for room. Needed
+ * whenever the endpoints are reinitialized or the bus is suspended, as the
+ * driver then drops a transfer in flight without calling the IN callback.
+ * called from ISR, locked state */
+static void usb_report_queue_reset_I(USBDriver *usbp) {
+    for (int i = 0; i <= USB_MAX_ENDPOINTS; i++) {
+        if (report_queues[i]) {
+            usb_report_queue_reset(report_queues[i]);
+            if (usbp->epc[i] && usbp->epc[i]->in_state) {
+                osalThreadResumeI(&usbp->epc[i]->in_state->thread, MSG_RESET);
+            }
+        }
+    }
+}
+
+/* Starts transmitting the oldest waiting report if the endpoint is idle
+ * locked state */
+static void usb_report_queue_start_I(USBDriver *usbp, usbep_t ep) {
+    if (usbGetTransmitStatusI(usbp, ep)) {
+        return;
+    }
+
+    usb_report_entry_t *entry = usb_report_queue_start(report_queues[ep]);
+    if (entry) {
+        usbStartTransmitI(usbp, ep, (uint8_t *)&entry->report + entry->offset, entry->size);
+    }
+}
+
+/* IN transfer complete, hands the next report to the driver
+ * callback (called from ISR, unlocked state) */
+static void usb_report_queue_in_cb(USBDriver *usbp, usbep_t ep) {
+    osalSysLockFromISR();
+    usb_report_queue_complete(report_queues[ep]);
+    usb_report_queue_start_I(usbp, ep);
+    osalSysUnlockFromISR();
+}
+
+/* Queues a report for an interrupt IN endpoint, waiting up to timeout for
+ * room when the queue is full. Reports that carry the whole state then
+ * replace the newest waiting one, so the host still ends up with the latest
+ * state, others are dropped.
+ * not callable from ISR or locked state */
+static void usb_report_queue_send(usbep_t ep, const void *report, uint8_t report_id, uint8_t offset, uint8_t size, usb_report_collapse_t collapse, sysinterval_t timeout) {
+    usb_report_queue_t *queue = report_queues[ep];
+
+    osalSysLock();
+    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
+        goto unlock;
+    }
+
+    usb_report_queue_result_t result;
+    while ((result = usb_report_queue_add(queue, report, report_id, offset, size, collapse)) == USB_REPORT_QUEUE_FULL) {
+        /* Need to either suspend, or loop and call unlock/lock during
+         * every iteration - otherwise the system will remain locked,
+         * no interrupts served, so USB not going through as well.
+         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
+        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[ep]->in_state->thread, timeout) == MSG_TIMEOUT || usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
+            if (collapse == USB_REPORT_COLLAPSE_MOUSE || usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE || !usb_report_queue_replace_last(queue, report, report_id, offset, size)) {
+                report_queue_stats.dropped++;
+                goto unlock;
+            }
+            result = USB_REPORT_QUEUE_COLLAPSED;
+            break;
+        }
+    }
+
+    if (result == USB_REPORT_QUEUE_COLLAPSED) {
+        report_queue_stats.collapsed++;
+        goto unlock;
+    }
+
+    usb_report_queue_start_I(&USB_DRIVER, ep);
+    if (queue->count > 1 || !queue->in_flight) {
+        /* the endpoint is busy, the report goes out from the transfer complete callback */
+        report_queue_stats.queued++;
+    }
+
+unlock:
+    osalSysUnlock();
+}
+
+/* Counters of the IN report queues */
+usb_report_queue_stats_t usb_get_report_queue_stats(void) {
+    usb_report_queue_stats_t stats;
+
+    osalSysLock();
+    stats = report_queue_stats;
+    osalSysUnlock();
+    return stats;
+}
+
 #ifdef USB_ENDPOINTS_ARE_REORDERABLE
 typedef struct {
     size_t              queue_capacity_in;
@@ -513,6 +641,7 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
 #if defined(DIGITIZER_ENABLE) && !defined(DIGITIZER_SHARED_EP)
             usbInitEndpointI(usbp, DIGITIZER_IN_EPNUM, &digitizer_ep_config);
 #endif
+            usb_report_queue_reset_I(usbp);
             for (int i = 0; i < NUM_USB_DRIVERS; i++) {
 #ifdef USB_ENDPOINTS_ARE_REORDERABLE
                 usbInitEndpointI(usbp, drivers.array[i].config.bulk_in, &drivers.array[i].inout_ep_config);
@@ -537,6 +666,9 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
             /* Falls into.*/
         case USB_EVENT_RESET:
             usb_event_queue_enqueue(event);
+            osalSysLockFromISR();
+            usb_report_queue_reset_I(usbp);
+            osalSysUnlockFromISR();
             for (int i = 0; i < NUM_USB_DRIVERS; i++) {
                 chSysLockFromISR();
                 /* Disconnection event on suspend.*/
@@ -547,6 +679,9 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
 
         case USB_EVENT_WAKEUP:
             // TODO: from ISR! print("[W]");
+            osalSysLockFromISR();
+            usb_report_queue_reset_I(usbp);
+            osalSysUnlockFromISR();
             for (int i = 0; i < NUM_USB_DRIVERS; i++) {
                 chSysLockFromISR();
                 /* Disconnection event on suspend.*/
@@ -839,61 +974,21 @@ uint8_t keyboard_leds(void) {
 /* prepare and start sending a report IN
  * not callable from ISR or locked state */
 void send_keyboard(report_keyboard_t *report) {
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        goto unlock;
-    }
-
 #ifdef NKRO_ENABLE
     if (keymap_config.nkro && keyboard_protocol) { /* NKRO protocol */
-        /* need to wait until the previous packet has made it through */
-        /* can rewrite this using the synchronous API, then would wait
-         * until *after* the packet has been transmitted. I think
-         * this is more efficient */
-        /* busy wait, should be short and not very common */
-        if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-            /* Need to either suspend, or loop and call unlock/lock during
-             * every iteration - otherwise the system will remain locked,
-             * no interrupts served, so USB not going through as well.
-             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-            osalThreadSuspendS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread);
-
-            /* after osalThreadSuspendS returns USB status might have changed */
-            if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-                goto unlock;
-            }
-        }
-        usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)report, sizeof(struct nkro_report));
+        usb_report_queue_send(SHARED_IN_EPNUM, report, REPORT_ID_NKRO, 0, sizeof(struct nkro_report), USB_REPORT_COLLAPSE_IDENTICAL, TIME_MS2I(USB_KEYBOARD_REPORT_TIMEOUT_MS));
     } else
 #endif /* NKRO_ENABLE */
     {  /* regular protocol */
-        /* need to wait until the previous packet has made it through */
-        /* busy wait, should be short and not very common */
-        if (usbGetTransmitStatusI(&USB_DRIVER, KEYBOARD_IN_EPNUM)) {
-            /* Need to either suspend, or loop and call unlock/lock during
-             * every iteration - otherwise the system will remain locked,
-             * no interrupts served, so USB not going through as well.
-             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-            osalThreadSuspendS(&(&USB_DRIVER)->epc[KEYBOARD_IN_EPNUM]->in_state->thread);
-
-            /* after osalThreadSuspendS returns USB status might have changed */
-            if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-                goto unlock;
-            }
-        }
-        uint8_t *data, size;
         if (keyboard_protocol) {
-            data = (uint8_t *)report;
-            size = KEYBOARD_REPORT_SIZE;
+            usb_report_queue_send(KEYBOARD_IN_EPNUM, report, REPORT_ID_KEYBOARD, 0, KEYBOARD_REPORT_SIZE, USB_REPORT_COLLAPSE_IDENTICAL, TIME_MS2I(USB_KEYBOARD_REPORT_TIMEOUT_MS));
         } else { /* boot protocol */
-            data = &report->mods;
-            size = 8;
+            usb_report_queue_send(KEYBOARD_IN_EPNUM, report, REPORT_ID_KEYBOARD, offsetof(report_keyboard_t, mods), 8, USB_REPORT_COLLAPSE_IDENTICAL, TIME_MS2I(USB_KEYBOARD_REPORT_TIMEOUT_MS));
         }
-        usbStartTransmitI(&USB_DRIVER, KEYBOARD_IN_EPNUM, data, size);
     }
-    keyboard_report_sent = *report;
 
-unlock:
+    osalSysLock();
+    keyboard_report_sent = *report;
     osalSysUnlock();
 }
 
@@ -904,24 +999,7 @@ unlock:
 
 #ifdef MOUSE_ENABLE
 void send_mouse(report_mouse_t *report) {
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    if (usbGetTransmitStatusI(&USB_DRIVER, MOUSE_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[MOUSE_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-    usbStartTransmitI(&USB_DRIVER, MOUSE_IN_EPNUM, (uint8_t *)report, sizeof(report_mouse_t));
-    osalSysUnlock();
+    usb_report_queue_send(MOUSE_IN_EPNUM, report, REPORT_ID_MOUSE, 0, sizeof(report_mouse_t), USB_REPORT_COLLAPSE_MOUSE, TIME_MS2I(10));
 }
 
 #else  /* MOUSE_ENABLE */
@@ -937,97 +1015,25 @@ void send_mouse(report_mouse_t *report) {
 
 void send_extra(report_extra_t *report) {
 #ifdef EXTRAKEY_ENABLE
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-
-    usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)report, sizeof(report_extra_t));
-    osalSysUnlock();
+    usb_report_queue_send(SHARED_IN_EPNUM, report, report->report_id, 0, sizeof(report_extra_t), USB_REPORT_COLLAPSE_IDENTICAL, TIME_MS2I(10));
 #endif
 }
 
 void send_programmable_button(report_programmable_button_t *report) {
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-
-    usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)report, sizeof(report_programmable_button_t));
-    osalSysUnlock();
+    usb_report_queue_send(SHARED_IN_EPNUM, report, REPORT_ID_PROGRAMMABLE_BUTTON, 0, sizeof(report_programmable_button_t), USB_REPORT_COLLAPSE_IDENTICAL, TIME_MS2I(10));
 #endif
 }
 
 void send_joystick(report_joystick_t *report) {
 #ifdef JOYSTICK_ENABLE
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    if (usbGetTransmitStatusI(&USB_DRIVER, JOYSTICK_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[JOYSTICK_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-
-    usbStartTransmitI(&USB_DRIVER, JOYSTICK_IN_EPNUM, (uint8_t *)report, sizeof(report_joystick_t));
-    osalSysUnlock();
+    usb_report_queue_send(JOYSTICK_IN_EPNUM, report, REPORT_ID_JOYSTICK, 0, sizeof(report_joystick_t), USB_REPORT_COLLAPSE_STATE, TIME_MS2I(10));
 #endif
 }
 
 void send_digitizer(report_digitizer_t *report) {
 #ifdef DIGITIZER_ENABLE
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    if (usbGetTransmitStatusI(&USB_DRIVER, DIGITIZER_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[DIGITIZER_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-
-    usbStartTransmitI(&USB_DRIVER, DIGITIZER_IN_EPNUM, (uint8_t *)report, sizeof(report_digitizer_t));
-    osalSysUnlock();
+    usb_report_queue_send(DIGITIZER_IN_EPNUM, report, REPORT_ID_DIGITIZER, 0, sizeof(report_digitizer_t), USB_REPORT_COLLAPSE_STATE, TIME_MS2I(10));
 #endif
 }
 
@@ -1038,6 +1044,30 @@ void send_digitizer(report_digitizer_t *report) {
 
 #ifdef CONSOLE_ENABLE
 
+#    ifdef CONSOLE_BINARY_ENABLE
+static uint8_t console_packet[CONSOLE_EPSIZE];
+static uint8_t console_packet_sent = CONSOLE_EPSIZE;
+
+/* Raw characters would break up the binary records, so they are logged as
+ * text records instead */
+int8_t sendchar(uint8_t c) {
+    binary_log_char(c);
+    return 1;
+}
+
+/* Hands at most one packet of binary log records per call to the console
+ * endpoint, without waiting for the host */
+static void console_binary_task(void) {
+    if (console_packet_sent == CONSOLE_EPSIZE) {
+        if (!binary_log_packet_ready(CONSOLE_EPSIZE)) {
+            return;
+        }
+        binary_log_packet(console_packet, CONSOLE_EPSIZE);
+        console_packet_sent = 0;
+    }
+    console_packet_sent += chnWriteTimeout(&drivers.console_driver.driver, &console_packet[console_packet_sent], CONSOLE_EPSIZE - console_packet_sent, TIME_IMMEDIATE);
+}
+#    else
 int8_t sendchar(uint8_t c) {
     static bool timed_out = false;
     /* The `timed_out` state is an approximation of the ideal `is_listener_disconnected?` state.
@@ -1066,6 +1096,7 @@ int8_t sendchar(uint8_t c) {
     timed_out                   = (result == 0);
     return result;
 }
+#    endif
 
 // Just a dummy function for now, this could be exposed as a weak function
 // Or connected to the actual QMK console
@@ -1083,6 +1114,10 @@ void console_task(void) {
             console_receive(buffer, size);
         }
     } while (size > 0);
+
+#    ifdef CONSOLE_BINARY_ENABLE
+    console_binary_task();
+#    endif
 }
 
 #endif /* CONSOLE_ENABLE */
@@ -1103,14 +1138,12 @@ __attribute__((weak)) void raw_hid_receive(uint8_t *data, uint8_t length) {
 }
 
 void raw_hid_task(void) {
-    uint8_t buffer[RAW_EPSIZE];
-    size_t  size = 0;
-    do {
-        size = chnReadTimeout(&drivers.raw_driver.driver, buffer, sizeof(buffer), TIME_IMMEDIATE);
-        if (size > 0) {
-            raw_hid_receive(buffer, size);
-        }
-    } while (size > 0);
+    // Commands are handled in place, and deferred ones keep using the buffer
+    static uint8_t buffer[RAW_EPSIZE];
+    size_t         size = 0;
+    while (raw_hid_ready() && (size = chnReadTimeout(&drivers.raw_driver.driver, buffer, sizeof(buffer), TIME_IMMEDIATE)) > 0) {
+        raw_hid_dispatch(buffer, size);
+    }
 }
 
 #endif
@@ -1146,6 +1179,10 @@ void virtser_send(const uint8_t byte) {
     chnWrite(&drivers.serial_driver.driver, &byte, 1);
 }
 
+uint8_t virtser_send_buffer(const uint8_t *data, uint8_t length) {
+    return chnWriteTimeout(&drivers.serial_driver.driver, data, length, TIME_IMMEDIATE);
+}
+
 __attribute__((weak)) void virtser_recv(uint8_t c) {
     // Ignore by default
 }
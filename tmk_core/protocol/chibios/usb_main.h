@@ -47,6 +47,26 @@ void usb_event_queue_init(void);
 /* Task to dequeue and execute any handlers for the USB events on the main thread */
 void usb_event_queue_task(void);
 
+/* -----------------
+ * IN report queues
+ * -----------------
+ */
+
+/* How long sending a keyboard report waits for room in a full queue before
+ * it replaces the newest waiting report */
+#ifndef USB_KEYBOARD_REPORT_TIMEOUT_MS
+#    define USB_KEYBOARD_REPORT_TIMEOUT_MS 100
+#endif
+
+typedef struct {
+    uint32_t queued;    /* reports that waited for a previous transfer to complete */
+    uint32_t collapsed; /* reports merged into one that was still waiting */
+    uint32_t dropped;   /* reports lost because the queue stayed full */
+} usb_report_queue_stats_t;
+
+/* Counters of all IN report queues since startup */
+usb_report_queue_stats_t usb_get_report_queue_stats(void);
+
 /* --------------
  * Console header
  * --------------
@@ -157,13 +157,17 @@ __attribute__((weak)) void raw_hid_receive(uint8_t *data, uint8_t length) {
  * FIXME: Needs doc
  */
 static void raw_hid_task(void) {
-    // Create a temporary buffer to hold the read in data from the host
-    uint8_t data[RAW_EPSIZE];
-    bool    data_read = false;
+    // Buffer to hold the data read in from the host, commands are handled in place and
+    // deferred ones keep using it
+    static uint8_t data[RAW_EPSIZE];
+    bool           data_read = false;
 
     // Device must be connected and configured for the task to run
     if (USB_DeviceState != DEVICE_STATE_Configured) return;
 
+    // Leave the packet in the endpoint until the previous command is finished
+    if (!raw_hid_ready()) return;
+
     Endpoint_SelectEndpoint(RAW_OUT_EPNUM);
 
     // Check to see if a packet has been sent from the host
@@ -179,7 +183,7 @@ static void raw_hid_task(void) {
         Endpoint_ClearOUT();
 
         if (data_read) {
-            raw_hid_receive(data, sizeof(data));
+            raw_hid_dispatch(data, sizeof(data));
         }
     }
 }
@@ -785,6 +789,39 @@ void virtser_send(const uint8_t byte) {
         Endpoint_SelectEndpoint(ep);
     }
 }
+
+/** \brief Virtual Serial Send Buffer
+ *
+ * Fills the IN endpoint bank with as much of the data as fits, without waiting for the host
+ */
+uint8_t virtser_send_buffer(const uint8_t *data, uint8_t length) {
+    uint8_t sent = 0;
+    uint8_t ep   = Endpoint_GetCurrentEndpoint();
+
+    if (!(cdc_device.State.ControlLineStates.HostToDevice & CDC_CONTROL_LINE_OUT_DTR)) {
+        // Nobody is listening, so the data is dropped like in virtser_send()
+        return length;
+    }
+
+    /* IN packet */
+    Endpoint_SelectEndpoint(cdc_device.Config.DataINEndpoint.Address);
+
+    if (!Endpoint_IsEnabled() || !Endpoint_IsConfigured()) {
+        Endpoint_SelectEndpoint(ep);
+        return length;
+    }
+
+    while (sent < length && Endpoint_IsReadWriteAllowed()) {
+        Endpoint_Write_8(data[sent++]);
+    }
+
+    if (sent) {
+        Endpoint_ClearIN();
+    }
+
+    Endpoint_SelectEndpoint(ep);
+    return sent;
+}
 #endif
 
 /*******************************************************************************
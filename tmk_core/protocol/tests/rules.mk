@@ -0,0 +1,7 @@
+usb_report_queue_DEFS := -DUSB_REPORT_QUEUE_SIZE=3
+usb_report_queue_INC := \
+	$(TMK_PATH)/protocol
+
+usb_report_queue_SRC := \
+	$(TMK_PATH)/protocol/tests/usb_report_queue_tests.cpp \
+	$(TMK_PATH)/protocol/usb_report_queue.c
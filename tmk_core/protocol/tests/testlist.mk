@@ -0,0 +1 @@
+TEST_LIST += usb_report_queue
@@ -0,0 +1,104 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "usb_report_queue.h"
+}
+
+class UsbReportQueue : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        usb_report_queue_reset(&queue);
+    }
+
+    usb_report_queue_result_t add_keyboard(uint8_t mods) {
+        report_keyboard_t report = {};
+        report.mods              = mods;
+        return usb_report_queue_add(&queue, &report, REPORT_ID_KEYBOARD, 0, sizeof(report), USB_REPORT_COLLAPSE_IDENTICAL);
+    }
+
+    usb_report_queue_result_t add_mouse(uint8_t buttons, int8_t x) {
+        report_mouse_t report = {};
+        report.buttons        = buttons;
+        report.x              = x;
+        return usb_report_queue_add(&queue, &report, REPORT_ID_MOUSE, 0, sizeof(report), USB_REPORT_COLLAPSE_MOUSE);
+    }
+
+    usb_report_queue_t queue;
+};
+
+TEST_F(UsbReportQueue, ReportsGoOutInOrder) {
+    EXPECT_EQ(add_keyboard(1), USB_REPORT_QUEUE_ADDED);
+    EXPECT_EQ(add_keyboard(2), USB_REPORT_QUEUE_ADDED);
+
+    for (uint8_t mods : {1, 2}) {
+        usb_report_entry_t *entry = usb_report_queue_start(&queue);
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(entry->report.keyboard.mods, mods);
+        // only one transfer at a time
+        EXPECT_EQ(usb_report_queue_start(&queue), nullptr);
+        usb_report_queue_complete(&queue);
+    }
+    EXPECT_EQ(usb_report_queue_start(&queue), nullptr);
+}
+
+TEST_F(UsbReportQueue, IdenticalReportIsDropped) {
+    add_keyboard(1);
+    EXPECT_EQ(add_keyboard(1), USB_REPORT_QUEUE_COLLAPSED);
+    EXPECT_EQ(queue.count, 1);
+}
+
+TEST_F(UsbReportQueue, ReportInFlightIsNotChanged) {
+    add_keyboard(1);
+    usb_report_queue_start(&queue);
+
+    // a report equal to the one being sent still has to go out after it
+    EXPECT_EQ(add_keyboard(1), USB_REPORT_QUEUE_ADDED);
+    EXPECT_EQ(add_mouse(0, 5), USB_REPORT_QUEUE_ADDED);
+    EXPECT_EQ(queue.count, 3);
+}
+
+TEST_F(UsbReportQueue, MouseMotionIsAddedUp) {
+    add_mouse(0, 5);
+    EXPECT_EQ(add_mouse(0, 7), USB_REPORT_QUEUE_COLLAPSED);
+    EXPECT_EQ(queue.entries[queue.head].report.mouse.x, 12);
+
+    // a button change and an overflow both need their own report
+    EXPECT_EQ(add_mouse(1, 0), USB_REPORT_QUEUE_ADDED);
+    EXPECT_EQ(add_mouse(1, 127), USB_REPORT_QUEUE_COLLAPSED);
+    EXPECT_EQ(add_mouse(1, 1), USB_REPORT_QUEUE_ADDED);
+    EXPECT_EQ(queue.count, 3);
+}
+
+TEST_F(UsbReportQueue, FullQueueReplacesNewestState) {
+    add_keyboard(1);
+    usb_report_queue_start(&queue);
+    add_keyboard(2);
+    add_keyboard(3);
+    EXPECT_EQ(add_keyboard(4), USB_REPORT_QUEUE_FULL);
+
+    EXPECT_TRUE(usb_report_queue_replace_last(&queue, &queue.entries[0].report, REPORT_ID_KEYBOARD, 0, sizeof(report_keyboard_t)));
+    EXPECT_EQ(queue.entries[(queue.head + 2) % USB_REPORT_QUEUE_SIZE].report.keyboard.mods, 1);
+
+    // the report in flight is never replaced
+    usb_report_queue_reset(&queue);
+    add_keyboard(1);
+    usb_report_queue_start(&queue);
+    EXPECT_FALSE(usb_report_queue_replace_last(&queue, &queue.entries[0].report, REPORT_ID_KEYBOARD, 0, sizeof(report_keyboard_t)));
+}
+
+TEST_F(UsbReportQueue, ResetForgetsTransferInFlight) {
+    add_keyboard(1);
+    usb_report_queue_start(&queue);
+    add_keyboard(2);
+    add_keyboard(3);
+
+    // the driver dropped the transfer on suspend, the IN callback never comes
+    usb_report_queue_reset(&queue);
+
+    EXPECT_EQ(add_keyboard(4), USB_REPORT_QUEUE_ADDED);
+    usb_report_entry_t *entry = usb_report_queue_start(&queue);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->report.keyboard.mods, 4);
+}
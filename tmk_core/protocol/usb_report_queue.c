@@ -0,0 +1,123 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "usb_report_queue.h"
+
+#ifdef MOUSE_EXTENDED_REPORT
+#    define MOUSE_REPORT_XY_MIN INT16_MIN
+#    define MOUSE_REPORT_XY_MAX INT16_MAX
+#else
+#    define MOUSE_REPORT_XY_MIN INT8_MIN
+#    define MOUSE_REPORT_XY_MAX INT8_MAX
+#endif
+
+/* Drops every waiting report, including one the driver may have lost */
+void usb_report_queue_reset(usb_report_queue_t *queue) {
+    queue->head      = 0;
+    queue->count     = 0;
+    queue->in_flight = false;
+}
+
+/* Merges a report into the last waiting one of the same kind
+ * returns true if nothing needs to be queued */
+static bool usb_report_queue_collapse(usb_report_entry_t *last, const void *report, uint8_t length, usb_report_collapse_t collapse) {
+    if (memcmp(&last->report, report, length) == 0) {
+        return true;
+    }
+
+    switch (collapse) {
+        case USB_REPORT_COLLAPSE_STATE:
+            memcpy(&last->report, report, length);
+            return true;
+        case USB_REPORT_COLLAPSE_MOUSE: {
+            report_mouse_t *      waiting = &last->report.mouse;
+            const report_mouse_t *mouse   = (const report_mouse_t *)report;
+            int32_t               x       = (int32_t)waiting->x + mouse->x;
+            int32_t               y       = (int32_t)waiting->y + mouse->y;
+            int16_t               v       = (int16_t)waiting->v + mouse->v;
+            int16_t               h       = (int16_t)waiting->h + mouse->h;
+
+            if (waiting->buttons != mouse->buttons || x < MOUSE_REPORT_XY_MIN || x > MOUSE_REPORT_XY_MAX || y < MOUSE_REPORT_XY_MIN || y > MOUSE_REPORT_XY_MAX || v < INT8_MIN || v > INT8_MAX || h < INT8_MIN || h > INT8_MAX) {
+                return false;
+            }
+            waiting->x = x;
+            waiting->y = y;
+            waiting->v = v;
+            waiting->h = h;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+static void usb_report_entry_set(usb_report_entry_t *entry, const void *report, uint8_t report_id, uint8_t offset, uint8_t size) {
+    memcpy(&entry->report, report, offset + size);
+    entry->report_id = report_id;
+    entry->offset    = offset;
+    entry->size      = size;
+}
+
+/* Queues a report, merging it into the newest waiting one when possible */
+usb_report_queue_result_t usb_report_queue_add(usb_report_queue_t *queue, const void *report, uint8_t report_id, uint8_t offset, uint8_t size, usb_report_collapse_t collapse) {
+    /* the head entry can only be changed while it waits for the endpoint */
+    if (queue->count > (queue->in_flight ? 1 : 0)) {
+        usb_report_entry_t *last = &queue->entries[(queue->head + queue->count - 1) % USB_REPORT_QUEUE_SIZE];
+        if (last->report_id == report_id && last->offset == offset && usb_report_queue_collapse(last, report, offset + size, collapse)) {
+            return USB_REPORT_QUEUE_COLLAPSED;
+        }
+    }
+
+    if (queue->count == USB_REPORT_QUEUE_SIZE) {
+        return USB_REPORT_QUEUE_FULL;
+    }
+
+    usb_report_entry_set(&queue->entries[(queue->head + queue->count) % USB_REPORT_QUEUE_SIZE], report, report_id, offset, size);
+    queue->count++;
+    return USB_REPORT_QUEUE_ADDED;
+}
+
+/* Overwrites the newest waiting report, for a full queue of reports that
+ * each carry the whole state. Returns false if only the report being
+ * transmitted is left. */
+bool usb_report_queue_replace_last(usb_report_queue_t *queue, const void *report, uint8_t report_id, uint8_t offset, uint8_t size) {
+    if (queue->count <= (queue->in_flight ? 1 : 0)) {
+        return false;
+    }
+
+    usb_report_entry_set(&queue->entries[(queue->head + queue->count - 1) % USB_REPORT_QUEUE_SIZE], report, report_id, offset, size);
+    return true;
+}
+
+/* Returns the oldest waiting report if the endpoint is idle, marking it as in flight */
+usb_report_entry_t *usb_report_queue_start(usb_report_queue_t *queue) {
+    if (queue->in_flight || queue->count == 0) {
+        return NULL;
+    }
+
+    queue->in_flight = true;
+    return &queue->entries[queue->head];
+}
+
+/* Drops the report that was in flight once its transfer completed */
+void usb_report_queue_complete(usb_report_queue_t *queue) {
+    if (queue->in_flight) {
+        queue->in_flight = false;
+        queue->head      = (queue->head + 1) % USB_REPORT_QUEUE_SIZE;
+        queue->count--;
+    }
+}
@@ -0,0 +1,74 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "report.h"
+
+/* Reports waiting for an interrupt IN endpoint. The oldest one is handed to
+ * the USB driver, the next one is started once its transfer completes, so
+ * sending a report only has to wait when the queue is full.
+ *
+ * This file only keeps the queue, the caller is responsible for locking and
+ * for talking to the USB driver. */
+
+/* Number of reports each HID IN endpoint can hold while the host has not polled yet */
+#ifndef USB_REPORT_QUEUE_SIZE
+#    define USB_REPORT_QUEUE_SIZE 4
+#endif
+
+typedef union {
+    report_keyboard_t            keyboard;
+    report_mouse_t               mouse;
+    report_extra_t               extra;
+    report_programmable_button_t programmable_button;
+    report_joystick_t            joystick;
+    report_digitizer_t           digitizer;
+} usb_report_t;
+
+typedef struct {
+    usb_report_t report;
+    uint8_t      report_id; /* kind of report, a value of enum hid_report_ids */
+    uint8_t      offset;    /* first byte to transmit, used for the boot protocol */
+    uint8_t      size;
+} usb_report_entry_t;
+
+typedef struct {
+    usb_report_entry_t entries[USB_REPORT_QUEUE_SIZE];
+    uint8_t            head;
+    uint8_t            count;
+    bool               in_flight; /* the head entry is being transmitted */
+} usb_report_queue_t;
+
+typedef enum {
+    USB_REPORT_COLLAPSE_IDENTICAL, /* drop a report equal to the one still waiting, every change reaches the host */
+    USB_REPORT_COLLAPSE_STATE,     /* replace the report still waiting, only the newest state matters */
+    USB_REPORT_COLLAPSE_MOUSE,     /* add up motion into the report still waiting while the buttons are unchanged */
+} usb_report_collapse_t;
+
+typedef enum {
+    USB_REPORT_QUEUE_ADDED,     /* the report was appended */
+    USB_REPORT_QUEUE_COLLAPSED, /* the report was merged into one still waiting */
+    USB_REPORT_QUEUE_FULL,      /* no room, nothing was changed */
+} usb_report_queue_result_t;
+
+void                      usb_report_queue_reset(usb_report_queue_t *queue);
+usb_report_queue_result_t usb_report_queue_add(usb_report_queue_t *queue, const void *report, uint8_t report_id, uint8_t offset, uint8_t size, usb_report_collapse_t collapse);
+bool                      usb_report_queue_replace_last(usb_report_queue_t *queue, const void *report, uint8_t report_id, uint8_t offset, uint8_t size);
+usb_report_entry_t *      usb_report_queue_start(usb_report_queue_t *queue);
+void                      usb_report_queue_complete(usb_report_queue_t *queue);
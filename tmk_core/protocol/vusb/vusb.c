@@ -134,6 +134,7 @@ void vusb_transfer_keyboard(void) {
 
 static uint8_t raw_output_buffer[RAW_BUFFER_SIZE];
 static uint8_t raw_output_received_bytes = 0;
+static bool    raw_output_dispatched     = false;
 
 void raw_hid_send(uint8_t *data, uint8_t length) {
     if (length != RAW_BUFFER_SIZE) {
@@ -161,8 +162,13 @@ __attribute__((weak)) void raw_hid_receive(uint8_t *data, uint8_t length) {
 }
 
 void raw_hid_task(void) {
-    if (raw_output_received_bytes == RAW_BUFFER_SIZE) {
-        raw_hid_receive(raw_output_buffer, RAW_BUFFER_SIZE);
+    if (raw_output_received_bytes == RAW_BUFFER_SIZE && !raw_output_dispatched) {
+        raw_hid_dispatch(raw_output_buffer, RAW_BUFFER_SIZE);
+        raw_output_dispatched = true;
+    }
+    // The report is kept in the buffer until its command is finished, see usbFunctionWriteOut()
+    if (raw_output_dispatched && raw_hid_ready()) {
+        raw_output_dispatched     = false;
         raw_output_received_bytes = 0;
     }
 }
@@ -369,6 +375,11 @@ uchar usbFunctionWrite(uchar *data, uchar len) {
 
 void usbFunctionWriteOut(uchar *data, uchar len) {
 #ifdef RAW_ENABLE
+    if (raw_output_received_bytes == RAW_BUFFER_SIZE) {
+        dprint("RAW: busy\n");
+        return;
+    }
+
     // Data from host must be divided every 8bytes
     if (len != 8) {
         dprint("RAW: invalid length\n");